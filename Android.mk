@@ -14,6 +14,7 @@ SPVTOOLS_SRC_FILES := \
 		source/enum_string_mapping.cpp \
 		source/extensions.cpp \
 		source/libspirv.cpp \
+		source/module_index.cpp \
 		source/name_mapper.cpp \
 		source/opcode.cpp \
 		source/operand.cpp \
@@ -24,6 +24,11 @@ COMMON_COPTS = [
     ],
 })
 
+COMMON_LINKOPTS = select({
+    "@platforms//os:windows": [],
+    "//conditions:default": ["-pthread"],
+})
+
 TEST_COPTS = COMMON_COPTS + [
 ] + select({
     "@platforms//os:windows": [
@@ -104,6 +104,28 @@ typedef enum spv_endianness_t {
   SPV_FORCE_32_BIT_ENUM(spv_endianness_t)
 } spv_endianness_t;
 
+// The sections of the logical layout of a module, as recorded by a module
+// index.  See the "Logical Layout of a Module" in the SPIR-V specification.
+typedef enum spv_module_section_t {
+  SPV_MODULE_SECTION_CAPABILITY,
+  SPV_MODULE_SECTION_EXTENSION,
+  SPV_MODULE_SECTION_EXT_INST_IMPORT,
+  SPV_MODULE_SECTION_MEMORY_MODEL,
+  SPV_MODULE_SECTION_ENTRY_POINT,
+  SPV_MODULE_SECTION_EXECUTION_MODE,
+  // Debug strings, source and name instructions.
+  SPV_MODULE_SECTION_DEBUG,
+  // Decorations.
+  SPV_MODULE_SECTION_ANNOTATION,
+  // Types, constants, global variables, and anything else before the first
+  // function.
+  SPV_MODULE_SECTION_TYPES_VALUES,
+  // Function declarations and definitions.
+  SPV_MODULE_SECTION_FUNCTIONS,
+  SPV_MODULE_SECTION_COUNT,  // Keep this last.
+  SPV_FORCE_32_BIT_ENUM(spv_module_section_t)
+} spv_module_section_t;
+
 // The kinds of operands that an instruction may have.
 //
 // Some operand types are "concrete".  The binary parser uses a concrete
@@ -390,6 +412,9 @@ typedef enum spv_binary_to_text_options_t {
   // Reorder blocks to match the structured control flow of SPIR-V to increase
   // readability.
   SPV_BINARY_TO_TEXT_OPTION_REORDER_BLOCKS = SPV_BIT(9),
+  // Disassemble the function bodies on several threads.  The text is the same
+  // as without this option.
+  SPV_BINARY_TO_TEXT_OPTION_PARALLEL = SPV_BIT(10),
   SPV_FORCE_32_BIT_ENUM(spv_binary_to_text_options_t)
 } spv_binary_to_text_options_t;
 
@@ -492,6 +517,10 @@ typedef struct spv_fuzzer_options_t spv_fuzzer_options_t;
 
 typedef struct spv_optimizer_t spv_optimizer_t;
 
+typedef struct spv_binary_parser_t spv_binary_parser_t;
+
+typedef struct spv_module_index_t spv_module_index_t;
+
 // Type Definitions
 
 typedef spv_const_binary_t* spv_const_binary;
@@ -509,6 +538,9 @@ typedef spv_reducer_options_t* spv_reducer_options;
 typedef const spv_reducer_options_t* spv_const_reducer_options;
 typedef spv_fuzzer_options_t* spv_fuzzer_options;
 typedef const spv_fuzzer_options_t* spv_const_fuzzer_options;
+typedef spv_binary_parser_t* spv_binary_parser;
+typedef spv_module_index_t* spv_module_index;
+typedef const spv_module_index_t* spv_const_module_index;
 
 // Platform API
 
@@ -588,6 +620,26 @@ typedef enum {
   spv_validator_limit_max_id_bound,
 } spv_validator_limit;
 
+// How much of the SPIR-V rules the validator checks.  Each tier checks
+// everything the tiers before it check.  A module that passes a tier may
+// still break the rules of the tiers after it.
+typedef enum {
+  // Checks that the module is sound enough to be processed: the header, the
+  // logical layout of the module, that each id is defined once and that its
+  // definition dominates its uses, the operands and limits of each
+  // instruction, and the control flow graph and structured control flow of
+  // each function.  The rules of the individual opcodes, of decorations, of
+  // built-ins, of entry point interfaces and of the execution models are not
+  // checked.
+  spv_validator_tier_structural,
+  // Checks all the rules the validator knows.  This is the default.
+  spv_validator_tier_standard,
+  // Like the standard tier, but never relies on the results of an earlier
+  // validation, such as the functions that the validation after each pass of
+  // the optimizer or the fuzzer has already checked.
+  spv_validator_tier_exhaustive,
+} spv_validator_tier;
+
 // Returns a string describing the given SPIR-V target environment.
 SPIRV_TOOLS_EXPORT const char* spvTargetEnvDescription(spv_target_env env);
 
@@ -725,6 +777,16 @@ SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetAllowLocalSizeId(
 SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetFriendlyNames(
     spv_validator_options options, bool val);
 
+// Records whether or not the validator may check the function bodies on
+// several threads.  The result and the diagnostics are the same either way.
+SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetParallel(
+    spv_validator_options options, bool val);
+
+// Records how much of the rules the validator checks.  The default is
+// spv_validator_tier_standard.
+SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetTier(
+    spv_validator_options options, spv_validator_tier tier);
+
 // Creates an optimizer options object with default options. Returns a valid
 // options object. The object remains valid until it is passed into
 // |spvOptimizerOptionsDestroy|.
@@ -860,6 +922,25 @@ SPIRV_TOOLS_EXPORT spv_result_t spvBinaryToText(const spv_const_context context,
                                                 spv_text* text,
                                                 spv_diagnostic* diagnostic);
 
+// A pointer to a function that accepts the next piece of the text produced
+// by spvBinaryToTextStream.  The text is not null-terminated, and is only
+// valid until the function returns.  The function should return SPV_SUCCESS
+// if and only if disassembly should continue.
+typedef spv_result_t (*spv_text_sink_fn_t)(void* user_data, const char* text,
+                                           size_t length);
+
+// Like spvBinaryToText, but passes the text to the sink function in pieces of
+// at most 64 KiB as it is produced, instead of returning it in one string.
+// The disassembler only holds on to about one piece or one function of text
+// at a time, unless SPV_BINARY_TO_TEXT_OPTION_PARALLEL is given.  The option
+// SPV_BINARY_TO_TEXT_OPTION_PRINT is ignored.  If the sink returns anything
+// other than SPV_SUCCESS, then that status code is returned, no further text
+// is passed to the sink, and no diagnostic is emitted.
+SPIRV_TOOLS_EXPORT spv_result_t spvBinaryToTextStream(
+    const spv_const_context context, const uint32_t* binary,
+    const size_t word_count, const uint32_t options, void* user_data,
+    spv_text_sink_fn_t sink, spv_diagnostic* diagnostic);
+
 // Frees a binary stream from memory. This is a no-op if binary is a null
 // pointer.
 SPIRV_TOOLS_EXPORT void spvBinaryDestroy(spv_binary binary);
@@ -927,9 +1008,11 @@ typedef spv_result_t (*spv_parsed_header_fn_t)(
 // A pointer to a function that accepts a parsed SPIR-V instruction.
 // The parsed_instruction value is transient: it may be overwritten
 // or released immediately after the function has returned.  That also
-// applies to the words array member of the parsed instruction.  The
-// function should return SPV_SUCCESS if and only if parsing should
-// continue.
+// applies to the words array member of the parsed instruction, with one
+// exception: if the module is in host native endianness, then the words
+// array points directly into the binary being parsed, and remains valid for
+// as long as that binary does.  The function should return SPV_SUCCESS if
+// and only if parsing should continue.
 typedef spv_result_t (*spv_parsed_instruction_fn_t)(
     void* user_data, const spv_parsed_instruction_t* parsed_instruction);
 
@@ -951,6 +1034,116 @@ SPIRV_TOOLS_EXPORT spv_result_t spvBinaryParse(
     const size_t num_words, spv_parsed_header_fn_t parse_header,
     spv_parsed_instruction_fn_t parse_instruction, spv_diagnostic* diagnostic);
 
+// Creates an incremental binary parser.  The module is supplied piecewise
+// with spvBinaryParserFeedWords or spvBinaryParserFeedBytes, and its end is
+// signalled with spvBinaryParserFinish.  The callbacks and user_data have the
+// same meaning as for spvBinaryParse.  The parsed-header callback is issued
+// as soon as the header is available, and the parsed-instruction callback as
+// soon as each instruction is complete, so the whole module never has to be
+// held in memory at once.  If diagnostic is non-null, it must stay valid
+// until the parser is destroyed, and receives the diagnostic for the first
+// error, if any.  Otherwise the context's message consumer is used.  Returns
+// a null pointer if context is null.
+//
+// An instruction followed by more input is only given the words its word
+// count declares, so a malformed instruction may be diagnosed differently
+// than by spvBinaryParse, though it fails in both.
+SPIRV_TOOLS_EXPORT spv_binary_parser spvBinaryParserCreate(
+    const spv_const_context context, void* user_data,
+    spv_parsed_header_fn_t parse_header,
+    spv_parsed_instruction_fn_t parse_instruction, spv_diagnostic* diagnostic);
+
+// Supplies the next num_words words of the module to the given parser, and
+// issues callbacks for everything that can now be parsed.  Returns
+// SPV_SUCCESS if parsing can continue.  Otherwise returns the error code or
+// the non-success callback result that stopped parsing, which is then also
+// returned by every later call on this parser.
+SPIRV_TOOLS_EXPORT spv_result_t spvBinaryParserFeedWords(
+    spv_binary_parser parser, const uint32_t* words, const size_t num_words);
+
+// Like spvBinaryParserFeedWords, but supplies the next num_bytes bytes of the
+// module, as laid out in memory.  The bytes do not need to form whole words;
+// an incomplete word is kept until the rest of it arrives.
+SPIRV_TOOLS_EXPORT spv_result_t spvBinaryParserFeedBytes(
+    spv_binary_parser parser, const void* bytes, const size_t num_bytes);
+
+// Signals the end of the module being parsed by the given parser.  Returns
+// SPV_SUCCESS if the complete module parsed successfully.  Otherwise returns
+// an error code, for example for an incomplete header, a truncated final
+// instruction, or a byte count that is not a multiple of 4.
+SPIRV_TOOLS_EXPORT spv_result_t spvBinaryParserFinish(spv_binary_parser parser);
+
+// Destroys the given incremental binary parser.
+SPIRV_TOOLS_EXPORT void spvBinaryParserDestroy(spv_binary_parser parser);
+
+// Builds a table of contents of a SPIR-V module, specified as a counted
+// sequence of 32-bit words, without parsing the operands of its
+// instructions.  The index records where each section of the module's
+// logical layout and each function lies, and which instruction defines each
+// result id, so that parts of the module can later be parsed or
+// disassembled on their own.  All positions are word offsets from the start
+// of the module, and ranges are half-open.  The words must outlive the
+// index.  On success, returns SPV_SUCCESS and writes the index into *index.
+// Otherwise returns an error code, and emits a diagnostic if diagnostic is
+// non-null, or through the context's message consumer otherwise.
+//
+// The index only checks that the instructions are well delimited and have
+// known opcodes.  A malformed module may be indexed, and then fail when a
+// range of it is parsed.
+SPIRV_TOOLS_EXPORT spv_result_t spvModuleIndexCreate(
+    const spv_const_context context, const uint32_t* words,
+    const size_t num_words, spv_module_index* index,
+    spv_diagnostic* diagnostic);
+
+// Destroys the given module index.
+SPIRV_TOOLS_EXPORT void spvModuleIndexDestroy(spv_module_index index);
+
+// Gets the range of words spanned by the instructions of the given section.
+// Returns false, and leaves *begin and *end unchanged, if the section is
+// empty.  For a module that is not laid out in order, the range extends from
+// the first to the last instruction of the section, and may overlap others.
+SPIRV_TOOLS_EXPORT bool spvModuleIndexGetSection(
+    const spv_const_module_index index, const spv_module_section_t section,
+    size_t* begin, size_t* end);
+
+// Returns the number of functions in the indexed module.
+SPIRV_TOOLS_EXPORT size_t
+spvModuleIndexGetFunctionCount(const spv_const_module_index index);
+
+// Gets the result id, and the range of words from the OpFunction to the
+// OpFunctionEnd inclusive, of the function with the given position in the
+// module.  Returns false if there is no such function.
+SPIRV_TOOLS_EXPORT bool spvModuleIndexGetFunction(
+    const spv_const_module_index index, const size_t function_index,
+    uint32_t* id, size_t* begin, size_t* end);
+
+// Gets the range of words of the instruction defining the given result id.
+// Returns false if no instruction defines it.
+SPIRV_TOOLS_EXPORT bool spvModuleIndexGetIdDefinition(
+    const spv_const_module_index index, const uint32_t id, size_t* begin,
+    size_t* end);
+
+// Parses only the instructions in the range of words [begin, end) of the
+// indexed module, as spvBinaryParse would.  The range must start and end at
+// instruction boundaries, as the ranges given by the index do.  The
+// parsed-header callback is issued as usual, then the parsed-instruction
+// callback for each instruction in the range.  The instructions declaring
+// types and imports are parsed silently as needed, but no instruction after
+// the start of the function definitions is parsed outside the range.
+SPIRV_TOOLS_EXPORT spv_result_t spvModuleIndexParseRange(
+    const spv_const_context context, const spv_const_module_index index,
+    const size_t begin, const size_t end, void* user_data,
+    spv_parsed_header_fn_t parse_header,
+    spv_parsed_instruction_fn_t parse_instruction, spv_diagnostic* diagnostic);
+
+// Like spvModuleIndexParseRange, but disassembles the range as
+// spvBinaryToText would, with the given options.  Friendly names are taken
+// from the part of the module before the function definitions.
+SPIRV_TOOLS_EXPORT spv_result_t spvModuleIndexRangeToText(
+    const spv_const_context context, const spv_const_module_index index,
+    const size_t begin, const size_t end, const uint32_t options,
+    spv_text* text, spv_diagnostic* diagnostic);
+
 // The optimizer interface.
 
 // A pointer to a function that accepts a log message from an optimizer.
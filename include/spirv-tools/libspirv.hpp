@@ -16,6 +16,7 @@
 #define INCLUDE_SPIRV_TOOLS_LIBSPIRV_HPP_
 
 #include <functional>
+#include <iosfwd>
 #include <memory>
 #include <string>
 #include <vector>
@@ -158,6 +159,15 @@ class SPIRV_TOOLS_EXPORT ValidatorOptions {
     spvValidatorOptionsSetFriendlyNames(options_, val);
   }
 
+  // Checks the function bodies on several threads.  The result and the
+  // diagnostics are the same as when checking them on one thread.
+  void SetParallel(bool val) { spvValidatorOptionsSetParallel(options_, val); }
+
+  // Sets how much of the rules the validator checks.  See spv_validator_tier.
+  void SetTier(spv_validator_tier tier) {
+    spvValidatorOptionsSetTier(options_, tier);
+  }
+
  private:
   spv_validator_options options_;
 };
@@ -340,6 +350,12 @@ class SPIRV_TOOLS_EXPORT SpirvTools {
   bool Disassemble(const uint32_t* binary, size_t binary_size,
                    std::string* text,
                    uint32_t options = kDefaultDisassembleOption) const;
+  // Like the above, but writes the assembly to |out| as it is produced,
+  // instead of building it in one string.  Disassembly stops with a failure
+  // if writing to |out| fails.  SPV_BINARY_TO_TEXT_OPTION_PRINT is ignored.
+  bool Disassemble(const uint32_t* binary, size_t binary_size,
+                   std::ostream* out,
+                   uint32_t options = kDefaultDisassembleOption) const;
 
   // Parses a SPIR-V binary, specified as counted sequence of 32-bit words.
   // Parsing feedback is provided via two callbacks provided as std::function.
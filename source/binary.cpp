@@ -94,12 +94,59 @@ class Parser {
   spv_result_t parse(const uint32_t* words, size_t num_words,
                      spv_diagnostic* diagnostic);
 
+  // Like parse(), but only issues the parsed-instruction callback for the
+  // instructions in the word range [begin, end) of the module.  The
+  // instructions before context_end are parsed without callbacks first, so
+  // that the types and extended instruction imports they declare are known.
+  // Requires context_end <= begin, and that all three are at instruction
+  // boundaries.
+  spv_result_t parseRange(const uint32_t* words, size_t num_words,
+                          size_t context_end, size_t begin, size_t end,
+                          spv_diagnostic* diagnostic);
+
+  // Starts parsing a module whose words are supplied piecewise by later calls
+  // to feed() and finish().
+  void beginIncremental(spv_diagnostic* diagnostic);
+
+  // Appends the given words to the module being parsed incrementally, then
+  // parses the header and each instruction that is now complete, issuing
+  // their callbacks.  Returns SPV_SUCCESS if parsing can continue.
+  // Otherwise returns an error code and issues a diagnostic.  Once an error
+  // has been returned, every later call returns it again.
+  spv_result_t feed(const uint32_t* words, size_t num_words);
+
+  // Like feed(), but the input is given as bytes in host memory order.  The
+  // bytes do not have to cover a whole number of words.
+  spv_result_t feedBytes(const uint8_t* bytes, size_t num_bytes);
+
+  // Signals the end of the module being parsed incrementally.  Issues the
+  // same diagnostics as parse() for an incomplete header or a truncated
+  // final instruction.
+  spv_result_t finish();
+
  private:
   // All remaining methods work on the current module parse state.
 
   // Like the parse method, but works on the current module parse state.
   spv_result_t parseModule();
 
+  // Like the parseRange method, but works on the current module parse state.
+  spv_result_t parseModuleRange(size_t context_end, size_t begin, size_t end);
+
+  // Parses the header of the current module, and converts the module to host
+  // native endianness if needed.
+  spv_result_t prepareModule();
+
+  // Detects the endianness of the module and parses its header, issuing the
+  // parsed-header callback.  Assumes the module has at least one word.
+  spv_result_t parseHeader();
+
+  // Parses the header, if not already done, and each complete instruction
+  // held in the incremental input buffer, then discards the consumed words.
+  // If at_end is true, then there is no more input, and the remaining words
+  // are parsed even if they do not form a complete instruction.
+  spv_result_t parseBufferedWords(bool at_end);
+
   // Parses an instruction at the current position of the binary.  Assumes
   // the header has been parsed, the endian has been set, and the word index is
   // still in range.  Advances the parsing position past the instruction, and
@@ -160,13 +207,23 @@ class Parser {
                                         spv_operand_type_t type) {
     return diagnostic() << "End of input reached while decoding Op"
                         << spvOpcodeString(opcode) << " starting at word "
-                        << inst_offset
+                        << _.base_word_index + inst_offset
                         << ((_.word_index < _.num_words) ? ": truncated "
                                                          : ": missing ")
                         << spvOperandTypeStr(type) << " operand at word offset "
                         << _.word_index - inst_offset << ".";
   }
 
+  // Returns the number of characters in the literal string starting at the
+  // current position, not counting the terminating null.  Returns
+  // std::string::npos if the input ends before the terminating null.
+  // Decodes the words in place, so no temporary string is created.
+  size_t literalStringLength() const;
+
+  // Returns the literal string of the given length starting at the current
+  // position.
+  std::string literalStringAt(size_t length) const;
+
   // Returns the endian-corrected word at the current position.
   uint32_t peek() const { return peekAt(_.word_index); }
 
@@ -199,9 +256,11 @@ class Parser {
           num_words(num_words_arg),
           diagnostic(diagnostic_arg),
           word_index(0),
+          base_word_index(0),
           instruction_count(0),
           endian(),
-          requires_endian_conversion(false) {
+          requires_endian_conversion(false),
+          report_instructions(true) {
       // Temporary storage for parser state within a single instruction.
       // Most instructions require fewer than 25 words or operands.
       operands.reserve(25);
@@ -213,11 +272,16 @@ class Parser {
     size_t num_words;            // Number of words in the module.
     spv_diagnostic* diagnostic;  // Where diagnostics go.
     size_t word_index;           // The current position in words.
+    // The position of words[0] in the module.  Only non-zero for incremental
+    // parsing, where words holds just the unconsumed part of the module.
+    size_t base_word_index;
     size_t instruction_count;    // The count of processed instructions
     spv_endianness_t endian;     // The endianness of the binary.
     // Is the SPIR-V binary in a different endianness from the host native
     // endianness?
     bool requires_endian_conversion;
+    // Should the parsed-instruction callback be issued?
+    bool report_instructions;
 
     // Maps a result ID to its type ID.  By convention:
     //  - a result ID that is a type definition maps to itself.
@@ -229,11 +293,27 @@ class Parser {
     std::unordered_map<uint32_t, spv_ext_inst_type_t>
         import_id_to_ext_inst_type;
 
+    // The whole module converted to host native endianness, if parse() was
+    // given a module in the other endianness.
+    std::vector<uint32_t> native_words;
+
     // Used by parseOperand
     std::vector<spv_parsed_operand_t> operands;
     std::vector<uint32_t> endian_converted_words;
     spv_operand_pattern_t expected_operands;
   } _;
+
+  // The input state used to parse a module incrementally.
+  struct IncrementalState {
+    // Words received but not yet consumed by the parser.
+    std::vector<uint32_t> words;
+    // Bytes received that do not yet form a complete word.
+    uint8_t partial_word[4] = {};
+    size_t num_partial_bytes = 0;
+    bool header_parsed = false;
+    // The result of the last step.  Parsing stops at the first failure.
+    spv_result_t status = SPV_SUCCESS;
+  } incremental_;
 };
 
 spv_result_t Parser::parse(const uint32_t* words, size_t num_words,
@@ -248,9 +328,186 @@ spv_result_t Parser::parse(const uint32_t* words, size_t num_words,
   return result;
 }
 
+void Parser::beginIncremental(spv_diagnostic* diagnostic_arg) {
+  _ = State(nullptr, 0, diagnostic_arg);
+  incremental_ = IncrementalState();
+}
+
+spv_result_t Parser::feed(const uint32_t* words, size_t num_words) {
+  if (incremental_.status != SPV_SUCCESS) return incremental_.status;
+  incremental_.words.insert(incremental_.words.end(), words,
+                            words + num_words);
+  return incremental_.status = parseBufferedWords(false);
+}
+
+spv_result_t Parser::feedBytes(const uint8_t* bytes, size_t num_bytes) {
+  if (incremental_.status != SPV_SUCCESS) return incremental_.status;
+  const size_t kBytesPerWord = sizeof(uint32_t);
+  auto& partial = incremental_.partial_word;
+  auto& num_partial = incremental_.num_partial_bytes;
+  // Complete a word started by an earlier call.
+  while (num_partial > 0 && num_partial < kBytesPerWord && num_bytes > 0) {
+    partial[num_partial++] = *bytes++;
+    num_bytes--;
+  }
+  if (num_partial == kBytesPerWord) {
+    uint32_t word;
+    std::memcpy(&word, partial, kBytesPerWord);
+    incremental_.words.push_back(word);
+    num_partial = 0;
+  }
+  // Take whole words directly, and keep any leftover bytes for later.
+  const size_t num_words = num_bytes / kBytesPerWord;
+  const size_t old_size = incremental_.words.size();
+  incremental_.words.resize(old_size + num_words);
+  if (num_words) {
+    std::memcpy(incremental_.words.data() + old_size, bytes,
+                num_words * kBytesPerWord);
+  }
+  bytes += num_words * kBytesPerWord;
+  num_bytes -= num_words * kBytesPerWord;
+  for (; num_bytes > 0; num_bytes--) partial[num_partial++] = *bytes++;
+  return incremental_.status = parseBufferedWords(false);
+}
+
+spv_result_t Parser::finish() {
+  if (incremental_.status != SPV_SUCCESS) return incremental_.status;
+  if (incremental_.num_partial_bytes) {
+    return incremental_.status =
+               diagnostic() << "Module size is not a multiple of 4 bytes: "
+                            << incremental_.num_partial_bytes
+                            << " trailing bytes";
+  }
+  incremental_.status = parseBufferedWords(true);
+  // Clear the module state.  The tables might be big.
+  _ = State();
+  incremental_.words.clear();
+  incremental_.words.shrink_to_fit();
+  return incremental_.status;
+}
+
+spv_result_t Parser::parseBufferedWords(bool at_end) {
+  std::vector<uint32_t>& buffer = incremental_.words;
+  _.words = buffer.data();
+  _.num_words = buffer.size();
+  _.word_index = 0;
+
+  if (!incremental_.header_parsed) {
+    if (buffer.size() < SPV_INDEX_INSTRUCTION && !at_end) return SPV_SUCCESS;
+    if (auto error = parseHeader()) return error;
+    incremental_.header_parsed = true;
+    _.word_index = SPV_INDEX_INSTRUCTION;
+  }
+
+  const size_t available = buffer.size();
+  while (_.word_index < available) {
+    // Wait until the whole instruction has arrived, so it is parsed exactly
+    // as it would be in a whole module.  At the end of input, parse the
+    // remaining words so that truncation is diagnosed as usual.
+    uint16_t inst_word_count = 0;
+    uint16_t opcode = 0;
+    spvOpcodeSplit(spvFixWord(buffer[_.word_index], _.endian),
+                   &inst_word_count, &opcode);
+    size_t inst_end = _.word_index + std::max<size_t>(inst_word_count, 1);
+    if (inst_end > available) {
+      if (!at_end) break;
+      inst_end = available;
+    }
+    _.num_words = inst_end;
+    if (auto error = parseInstruction()) return error;
+  }
+
+  // Drop the consumed words.  What remains is at most one partial
+  // instruction, so the buffer stays bounded by the largest instruction.
+  buffer.erase(buffer.begin(), buffer.begin() + _.word_index);
+  _.base_word_index += _.word_index;
+  _.word_index = 0;
+  _.words = nullptr;
+  _.num_words = 0;
+  return SPV_SUCCESS;
+}
+
+spv_result_t Parser::parseRange(const uint32_t* words, size_t num_words,
+                                size_t context_end, size_t begin, size_t end,
+                                spv_diagnostic* diagnostic_arg) {
+  _ = State(words, num_words, diagnostic_arg);
+
+  const spv_result_t result = parseModuleRange(context_end, begin, end);
+
+  // Clear the module state.  The tables might be big.
+  _ = State();
+
+  return result;
+}
+
 spv_result_t Parser::parseModule() {
+  if (auto error = prepareModule()) return error;
+
+  // Process the instructions.
+  _.word_index = SPV_INDEX_INSTRUCTION;
+  while (_.word_index < _.num_words)
+    if (auto error = parseInstruction()) return error;
+
+  // Running off the end should already have been reported earlier.
+  assert(_.word_index == _.num_words);
+
+  return SPV_SUCCESS;
+}
+
+spv_result_t Parser::parseModuleRange(size_t context_end, size_t begin,
+                                      size_t end) {
+  if (auto error = prepareModule()) return error;
+  if (begin < SPV_INDEX_INSTRUCTION || context_end > begin || begin > end ||
+      end > _.num_words) {
+    return diagnostic(SPV_ERROR_INVALID_VALUE)
+           << "Invalid word range [" << begin << ", " << end
+           << ") for a module of " << _.num_words << " words";
+  }
+
+  // Collect the types and imports declared before the range.
+  _.word_index = SPV_INDEX_INSTRUCTION;
+  _.report_instructions = false;
+  while (_.word_index < context_end)
+    if (auto error = parseInstruction()) return error;
+  _.report_instructions = true;
+
+  if (_.word_index > begin) {
+    return diagnostic(SPV_ERROR_INVALID_VALUE)
+           << "Word " << begin << " is not at an instruction boundary";
+  }
+
+  _.word_index = begin;
+  while (_.word_index < end)
+    if (auto error = parseInstruction()) return error;
+
+  if (_.word_index != end) {
+    return diagnostic(SPV_ERROR_INVALID_VALUE)
+           << "Word " << end << " is not at an instruction boundary";
+  }
+
+  return SPV_SUCCESS;
+}
+
+spv_result_t Parser::prepareModule() {
   if (!_.words) return diagnostic() << "Missing module.";
 
+  if (auto error = parseHeader()) return error;
+
+  if (_.requires_endian_conversion) {
+    // Byte swap the whole module once, in bulk, rather than word by word as
+    // each operand is parsed.  The instructions then take the same path as a
+    // module in host native endianness.
+    _.native_words.resize(_.num_words);
+    spvFixWords(_.words, _.num_words, _.endian, _.native_words.data());
+    _.words = _.native_words.data();
+    _.endian = spvHostEndianness();
+    _.requires_endian_conversion = false;
+  }
+
+  return SPV_SUCCESS;
+}
+
+spv_result_t Parser::parseHeader() {
   if (_.num_words < SPV_INDEX_INSTRUCTION)
     return diagnostic() << "Module has incomplete header: only " << _.num_words
                         << " words instead of " << SPV_INDEX_INSTRUCTION;
@@ -279,14 +536,6 @@ spv_result_t Parser::parseModule() {
     }
   }
 
-  // Process the instructions.
-  _.word_index = SPV_INDEX_INSTRUCTION;
-  while (_.word_index < _.num_words)
-    if (auto error = parseInstruction()) return error;
-
-  // Running off the end should already have been reported earlier.
-  assert(_.word_index == _.num_words);
-
   return SPV_SUCCESS;
 }
 
@@ -301,9 +550,12 @@ spv_result_t Parser::parseInstruction() {
 
   // If the module's endianness is different from the host native endianness,
   // then converted_words contains the endian-translated words in the
-  // instruction.
-  _.endian_converted_words.clear();
-  _.endian_converted_words.push_back(first_word);
+  // instruction.  Otherwise it is not used at all, and the instruction words
+  // are read directly from the caller's buffer.
+  if (_.requires_endian_conversion) {
+    _.endian_converted_words.clear();
+    _.endian_converted_words.push_back(first_word);
+  }
 
   // After a successful parse of the instruction, the inst.operands member
   // will point to this vector's storage.
@@ -342,7 +594,8 @@ spv_result_t Parser::parseInstruction() {
     const uint16_t inst_word_index = uint16_t(_.word_index - inst_offset);
     if (_.expected_operands.empty()) {
       return diagnostic() << "Invalid instruction Op" << opcode_desc->name
-                          << " starting at word " << inst_offset
+                          << " starting at word "
+                          << _.base_word_index + inst_offset
                           << ": expected no more operands after "
                           << inst_word_index
                           << " words, but stated word count is "
@@ -363,13 +616,15 @@ spv_result_t Parser::parseInstruction() {
       !spvOperandIsOptional(_.expected_operands.back())) {
     return diagnostic() << "End of input reached while decoding Op"
                         << opcode_desc->name << " starting at word "
-                        << inst_offset << ": expected more operands after "
+                        << _.base_word_index + inst_offset
+                        << ": expected more operands after "
                         << inst_word_count << " words.";
   }
 
   if ((inst_offset + inst_word_count) != _.word_index) {
     return diagnostic() << "Invalid word count: Op" << opcode_desc->name
-                        << " starting at word " << inst_offset
+                        << " starting at word "
+                        << _.base_word_index + inst_offset
                         << " says it has " << inst_word_count
                         << " words, but found " << _.word_index - inst_offset
                         << " words instead.";
@@ -378,12 +633,10 @@ spv_result_t Parser::parseInstruction() {
   // Check the computed length of the endian-converted words vector against
   // the declared number of words in the instruction.  If endian conversion
   // is required, then they should match.  If no endian conversion was
-  // performed, then the vector only contains the initial opcode/word-count
-  // word.
+  // performed, then the vector is never touched.
   assert(!_.requires_endian_conversion ||
          (inst_word_count == _.endian_converted_words.size()));
-  assert(_.requires_endian_conversion ||
-         (_.endian_converted_words.size() == 1));
+  assert(_.requires_endian_conversion || _.endian_converted_words.empty());
 
   recordNumberType(inst_offset, &inst);
 
@@ -405,7 +658,7 @@ spv_result_t Parser::parseInstruction() {
 
   // Issue the callback.  The callee should know that all the storage in inst
   // is transient, and will disappear immediately afterward.
-  if (parsed_instruction_fn_) {
+  if (parsed_instruction_fn_ && _.report_instructions) {
     if (auto error = parsed_instruction_fn_(user_data_, &inst)) return error;
   }
 
@@ -595,18 +848,15 @@ spv_result_t Parser::parseOperand(size_t inst_offset,
 
     case SPV_OPERAND_TYPE_LITERAL_STRING:
     case SPV_OPERAND_TYPE_OPTIONAL_LITERAL_STRING: {
-      const size_t max_words = _.num_words - _.word_index;
-      std::string string =
-          spvtools::utils::MakeString(_.words + _.word_index, max_words, false);
-
-      if (string.length() == max_words * 4)
+      const size_t string_length = literalStringLength();
+      if (string_length == std::string::npos)
         return exhaustedInputDiagnostic(inst_offset, opcode, type);
 
       // Make sure we can record the word count without overflow.
       //
       // This error can't currently be triggered because of validity
       // checks elsewhere.
-      const size_t string_num_words = string.length() / 4 + 1;
+      const size_t string_num_words = string_length / 4 + 1;
       if (string_num_words > std::numeric_limits<uint16_t>::max()) {
         return diagnostic() << "Literal string is longer than "
                             << std::numeric_limits<uint16_t>::max()
@@ -619,6 +869,8 @@ spv_result_t Parser::parseOperand(size_t inst_offset,
         // Record the extended instruction type for the ID for this import.
         // There is only one string literal argument to OpExtInstImport,
         // so it's sufficient to guard this just on the opcode.
+        // This is the only string the parser needs to materialize.
+        const std::string string = literalStringAt(string_length);
         const spv_ext_inst_type_t ext_inst_type =
             spvExtInstImportTypeGet(string.c_str());
         if (SPV_EXT_INST_TYPE_NONE == ext_inst_type) {
@@ -823,6 +1075,28 @@ spv_result_t Parser::setNumericTypeInfoForType(
   return SPV_SUCCESS;
 }
 
+size_t Parser::literalStringLength() const {
+  for (size_t index = _.word_index; index < _.num_words; ++index) {
+    const uint32_t word = peekAt(index);
+    for (size_t byte_index = 0; byte_index < 4; ++byte_index) {
+      if (((word >> (8 * byte_index)) & 0xFF) == 0) {
+        return (index - _.word_index) * 4 + byte_index;
+      }
+    }
+  }
+  return std::string::npos;
+}
+
+std::string Parser::literalStringAt(size_t length) const {
+  std::string result;
+  result.reserve(length);
+  for (size_t i = 0; i < length; ++i) {
+    const uint32_t word = peekAt(_.word_index + i / 4);
+    result += static_cast<char>((word >> (8 * (i % 4))) & 0xFF);
+  }
+  return result;
+}
+
 void Parser::recordNumberType(size_t inst_offset,
                               const spv_parsed_instruction_t* inst) {
   const spv::Op opcode = static_cast<spv::Op>(inst->opcode);
@@ -857,6 +1131,73 @@ spv_result_t spvBinaryParse(const spv_const_context context, void* user_data,
   return parser.parse(code, num_words, diagnostic);
 }
 
+spv_result_t spvBinaryParseRange(
+    const spv_const_context context, void* user_data, const uint32_t* code,
+    const size_t num_words, const size_t context_end, const size_t begin,
+    const size_t end, spv_parsed_header_fn_t parsed_header,
+    spv_parsed_instruction_fn_t parsed_instruction,
+    spv_diagnostic* diagnostic) {
+  spv_context_t hijack_context = *context;
+  if (diagnostic) {
+    *diagnostic = nullptr;
+    spvtools::UseDiagnosticAsMessageConsumer(&hijack_context, diagnostic);
+  }
+  Parser parser(&hijack_context, user_data, parsed_header, parsed_instruction);
+  return parser.parseRange(code, num_words, context_end, begin, end,
+                           diagnostic);
+}
+
+struct spv_binary_parser_t {
+  spv_binary_parser_t(const spv_const_context context, void* user_data,
+                      spv_parsed_header_fn_t parsed_header,
+                      spv_parsed_instruction_fn_t parsed_instruction,
+                      spv_diagnostic* diagnostic)
+      : hijack_context(*context),
+        parser(&hijack_context, user_data, parsed_header, parsed_instruction) {
+    if (diagnostic) {
+      *diagnostic = nullptr;
+      spvtools::UseDiagnosticAsMessageConsumer(&hijack_context, diagnostic);
+    }
+    parser.beginIncremental(diagnostic);
+  }
+
+  // The parser refers to this context, so it must be declared first.
+  spv_context_t hijack_context;
+  Parser parser;
+};
+
+spv_binary_parser spvBinaryParserCreate(
+    const spv_const_context context, void* user_data,
+    spv_parsed_header_fn_t parsed_header,
+    spv_parsed_instruction_fn_t parsed_instruction,
+    spv_diagnostic* diagnostic) {
+  if (!context) return nullptr;
+  return new spv_binary_parser_t(context, user_data, parsed_header,
+                                 parsed_instruction, diagnostic);
+}
+
+spv_result_t spvBinaryParserFeedWords(spv_binary_parser parser,
+                                      const uint32_t* words,
+                                      const size_t num_words) {
+  if (!parser || (!words && num_words)) return SPV_ERROR_INVALID_POINTER;
+  return parser->parser.feed(words, num_words);
+}
+
+spv_result_t spvBinaryParserFeedBytes(spv_binary_parser parser,
+                                      const void* bytes,
+                                      const size_t num_bytes) {
+  if (!parser || (!bytes && num_bytes)) return SPV_ERROR_INVALID_POINTER;
+  return parser->parser.feedBytes(static_cast<const uint8_t*>(bytes),
+                                  num_bytes);
+}
+
+spv_result_t spvBinaryParserFinish(spv_binary_parser parser) {
+  if (!parser) return SPV_ERROR_INVALID_POINTER;
+  return parser->parser.finish();
+}
+
+void spvBinaryParserDestroy(spv_binary_parser parser) { delete parser; }
+
 // TODO(dneto): This probably belongs in text.cpp since that's the only place
 // that a spv_binary_t value is created.
 void spvBinaryDestroy(spv_binary binary) {
@@ -29,6 +29,19 @@ spv_result_t spvBinaryHeaderGet(const spv_const_binary binary,
                                 const spv_endianness_t endian,
                                 spv_header_t* header);
 
+// Like spvBinaryParse, but only issues the parsed-instruction callback for
+// the instructions in the word range [begin, end) of the module.  The
+// instructions in [SPV_INDEX_INSTRUCTION, context_end) are parsed silently
+// beforehand, so that the types and extended instruction imports needed to
+// parse the range are known.  Requires context_end <= begin <= end, each at
+// an instruction boundary.  A module index provides suitable ranges.
+spv_result_t spvBinaryParseRange(
+    const spv_const_context context, void* user_data, const uint32_t* code,
+    const size_t num_words, const size_t context_end, const size_t begin,
+    const size_t end, spv_parsed_header_fn_t parsed_header,
+    spv_parsed_instruction_fn_t parsed_instruction,
+    spv_diagnostic* diagnostic);
+
 // Returns the number of non-null characters in str before the first null
 // character, or strsz if there is no null character.  Examines at most the
 // first strsz characters in str.  Returns 0 if str is nullptr.  This is a
@@ -20,14 +20,17 @@
 #include "source/disassemble.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstring>
 #include <iomanip>
 #include <memory>
 #include <set>
 #include <stack>
+#include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "source/assembly_grammar.h"
 #include "source/binary.h"
@@ -40,6 +43,7 @@
 #include "source/spirv_endian.h"
 #include "source/util/hex_float.h"
 #include "source/util/make_unique.h"
+#include "source/util/parallel.h"
 #include "spirv-tools/libspirv.h"
 
 namespace spvtools {
@@ -109,6 +113,24 @@ struct ControlFlowGraph {
   std::vector<SingleBlock> blocks;
 };
 
+// The largest piece of text passed to a text sink at once.  Text is also
+// accumulated up to this size before it is passed on.
+constexpr size_t kTextPieceSize = 64 * 1024;
+
+// Passes the given text to |sink| in pieces of at most kTextPieceSize bytes.
+// Returns the first status other than SPV_SUCCESS returned by the sink, if
+// any.
+spv_result_t SendText(void* user_data, spv_text_sink_fn_t sink,
+                      const char* text, size_t length) {
+  while (length > 0) {
+    const size_t piece_length = std::min(length, kTextPieceSize);
+    if (auto error = sink(user_data, text, piece_length)) return error;
+    text += piece_length;
+    length -= piece_length;
+  }
+  return SPV_SUCCESS;
+}
+
 // A Disassembler instance converts a SPIR-V binary to its assembly
 // representation.
 class Disassembler {
@@ -120,6 +142,7 @@ class Disassembler {
             spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_NESTED_INDENT, options)),
         reorder_blocks_(
             spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_REORDER_BLOCKS, options)),
+        comment_(spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_COMMENT, options)),
         text_(),
         out_(print_ ? out_stream() : out_stream(text_)),
         instruction_disassembler_(grammar, out_.get(), options, name_mapper),
@@ -139,6 +162,49 @@ class Disassembler {
   // Returns SPV_SUCCESS on success.
   spv_result_t SaveTextResult(spv_text* text_result) const;
 
+  // Sets the word offset of the first instruction that will be handled, for
+  // when only part of the module is disassembled.
+  void SetFirstInstructionOffset(size_t word_offset) {
+    first_instruction_offset_ = word_offset;
+  }
+
+  // Prepares to disassemble a later part of the module than |other| did, as
+  // if the instructions |other| handled had been handled by this disassembler.
+  // If |follows_other| is true, the first instruction handled directly
+  // follows the last one |other| handled.
+  void ContinueFrom(const Disassembler& other, bool follows_other) {
+    inserted_decoration_space_ = other.inserted_decoration_space_;
+    inserted_debug_space_ = other.inserted_debug_space_;
+    inserted_type_space_ = other.inserted_type_space_;
+    instruction_disassembler_.ContinueFrom(other.instruction_disassembler_,
+                                           follows_other);
+  }
+
+  // Returns true if handling an instruction with the given opcode after the
+  // instructions handled so far would emit a section comment, or would add a
+  // comment to be shown with a later instruction.
+  bool ChangesComments(spv::Op opcode) const {
+    if (!comment_) return false;
+    return spvOpcodeIsDecoration(opcode) ||
+           (!inserted_debug_space_ && spvOpcodeIsDebug(opcode)) ||
+           (!inserted_type_space_ && spvOpcodeGeneratesType(opcode));
+  }
+
+  // Returns the accumulated text, if not printing.
+  std::string text() const { return text_.str(); }
+
+  // Makes the disassembler pass the text to |sink| once enough of it has
+  // accumulated, instead of keeping all of it.  Must not be used when
+  // printing.
+  void SetSink(void* user_data, spv_text_sink_fn_t sink) {
+    assert(!print_);
+    sink_user_data_ = user_data;
+    sink_ = sink;
+  }
+
+  // Passes the text accumulated so far to the sink, if there is one.
+  spv_result_t FlushText();
+
  private:
   void EmitCFG();
 
@@ -147,15 +213,21 @@ class Disassembler {
                               // control flow structure?
   const bool
       reorder_blocks_;       // Should the blocks be reordered for readability?
+  const bool comment_;       // Should we comment the source?
   spv_endianness_t endian_;  // The detected endianness of the binary.
   std::stringstream text_;   // Captures the text, if not printing.
   out_stream out_;  // The Output stream.  Either to text_ or standard output.
   disassemble::InstructionDisassembler instruction_disassembler_;
   const bool header_;   // Should we output header as the leading comment?
   size_t byte_offset_;  // The number of bytes processed so far.
+  // The word offset of the first instruction handled.
+  size_t first_instruction_offset_ = SPV_INDEX_INSTRUCTION;
   bool inserted_decoration_space_ = false;
   bool inserted_debug_space_ = false;
   bool inserted_type_space_ = false;
+  // Where to pass the text to, if anywhere.
+  void* sink_user_data_ = nullptr;
+  spv_text_sink_fn_t sink_ = nullptr;
 
   // The CFG for the current function
   ControlFlowGraph current_function_cfg_;
@@ -174,7 +246,7 @@ spv_result_t Disassembler::HandleHeader(spv_endianness_t endian,
     instruction_disassembler_.EmitHeaderSchema(schema);
   }
 
-  byte_offset_ = SPV_INDEX_INSTRUCTION * sizeof(uint32_t);
+  byte_offset_ = first_instruction_offset_ * sizeof(uint32_t);
 
   return SPV_SUCCESS;
 }
@@ -222,9 +294,19 @@ spv_result_t Disassembler::HandleInstruction(
 
   byte_offset_ += inst.num_words * sizeof(uint32_t);
 
+  if (sink_ && text_.tellp() >= static_cast<std::streamoff>(kTextPieceSize)) {
+    return FlushText();
+  }
   return SPV_SUCCESS;
 }
 
+spv_result_t Disassembler::FlushText() {
+  if (!sink_) return SPV_SUCCESS;
+  const std::string text = text_.str();
+  text_.str("");
+  return SendText(sink_user_data_, sink_, text.data(), text.size());
+}
+
 // Helper to get the operand of an instruction as an id.
 uint32_t GetOperand(const spv_parsed_instruction_t* instruction,
                     uint32_t operand) {
@@ -596,6 +678,153 @@ spv_result_t DisassembleTargetInstruction(
   return SPV_SUCCESS;
 }
 
+// The number of parts the function definitions are split into for each
+// thread, so that threads finishing early can take on more work.
+constexpr size_t kChunksPerThread = 4;
+
+// Disassembles the module with the function definitions split into chunks that
+// are rendered on up to |num_threads| threads.  Stores the text of the part of
+// the module before the functions, followed by the text of each chunk, in
+// |pieces|.  Returns false, without any text, if the text of a chunk could
+// depend on the chunks before it, or if the module is not worth splitting.
+// Also returns false if the module fails to parse, so that the caller can
+// disassemble it serially to report the error at the usual position.
+bool ParallelDisassemble(const spv_context_t& context,
+                         const AssemblyGrammar& grammar, const uint32_t* code,
+                         const size_t wordCount, const uint32_t options,
+                         const NameMapper& name_mapper,
+                         const uint32_t num_threads,
+                         std::vector<std::string>* pieces) {
+  // Colors may be printed by changing the console state as the text is
+  // printed.  Comments with byte offsets are aligned with those of the
+  // previous lines across function boundaries.
+  if ((spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_PRINT, options) &&
+       spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_COLOR, options)) ||
+      spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_SHOW_BYTE_OFFSET, options)) {
+    return false;
+  }
+  if (num_threads <= 1) return false;
+
+  // Errors are reported by the serial disassembly instead.
+  spv_context_t quiet_context = context;
+  quiet_context.consumer = nullptr;
+
+  spv_module_index index = nullptr;
+  if (spvModuleIndexCreate(&quiet_context, code, wordCount, &index, nullptr)) {
+    return false;
+  }
+  std::unique_ptr<spv_module_index_t, decltype(&spvModuleIndexDestroy)>
+      index_owner(index, &spvModuleIndexDestroy);
+  const size_t num_functions = spvModuleIndexGetFunctionCount(index);
+  size_t functions_begin = 0;
+  if (num_functions < 2 ||
+      !spvModuleIndexGetSection(index, SPV_MODULE_SECTION_FUNCTIONS,
+                                &functions_begin, nullptr)) {
+    return false;
+  }
+
+  // Split the functions into chunks of roughly equal size.  A chunk only
+  // starts at a function that directly follows an OpFunctionEnd, which
+  // emits no comment for the next line to be aligned with.
+  const size_t chunk_size = (wordCount - functions_begin) /
+                            (size_t{num_threads} * kChunksPerThread);
+  std::vector<size_t> chunk_begins = {functions_begin};
+  size_t previous_end = 0;
+  spvModuleIndexGetFunction(index, 0, nullptr, nullptr, &previous_end);
+  for (size_t i = 1; i < num_functions; ++i) {
+    size_t begin = 0;
+    size_t end = 0;
+    spvModuleIndexGetFunction(index, i, nullptr, &begin, &end);
+    if (begin == previous_end && begin - chunk_begins.back() >= chunk_size) {
+      chunk_begins.push_back(begin);
+    }
+    previous_end = end;
+  }
+  if (chunk_begins.size() < 2) return false;
+
+  // The text is printed once it is complete, so that nothing is printed if
+  // the serial disassembly has to take over.
+  const uint32_t text_options = options & ~SPV_BINARY_TO_TEXT_OPTION_PRINT;
+  Disassembler global(grammar, text_options, name_mapper);
+  if (spvBinaryParseRange(&quiet_context, &global, code, wordCount,
+                          SPV_INDEX_INSTRUCTION, SPV_INDEX_INSTRUCTION,
+                          functions_begin, DisassembleHeader,
+                          DisassembleInstruction, nullptr)) {
+    return false;
+  }
+
+  // Section comments and comments for decorated ids are emitted based on the
+  // instructions seen so far.  The chunks only see the instructions before
+  // the functions, so the functions must not contain any that would change
+  // the comments.
+  spv_endianness_t endian;
+  spv_const_binary_t binary = {code, wordCount};
+  if (spvBinaryEndianness(&binary, &endian)) return false;
+  for (size_t offset = functions_begin; offset < wordCount;) {
+    uint16_t word_count = 0;
+    uint16_t opcode = 0;
+    spvOpcodeSplit(spvFixWord(code[offset], endian), &word_count, &opcode);
+    if (word_count == 0) return false;
+    if (global.ChangesComments(static_cast<spv::Op>(opcode))) return false;
+    offset += word_count;
+  }
+
+  std::vector<std::string> texts(chunk_begins.size() + 1);
+  std::atomic<bool> failed(false);
+  utils::ParallelFor(
+      chunk_begins.size(), num_threads,
+      [&quiet_context, &grammar, code, wordCount, text_options, &name_mapper,
+       &global, &chunk_begins, functions_begin, &texts,
+       &failed](size_t i) {
+        if (failed) return;
+        const size_t begin = chunk_begins[i];
+        const size_t end =
+            i + 1 < chunk_begins.size() ? chunk_begins[i + 1] : wordCount;
+        Disassembler chunk(grammar,
+                           text_options | SPV_BINARY_TO_TEXT_OPTION_NO_HEADER,
+                           name_mapper);
+        chunk.ContinueFrom(global, i == 0);
+        chunk.SetFirstInstructionOffset(begin);
+        if (spvBinaryParseRange(&quiet_context, &chunk, code, wordCount,
+                                functions_begin, begin, end, DisassembleHeader,
+                                DisassembleInstruction, nullptr)) {
+          failed = true;
+          return;
+        }
+        texts[i + 1] = chunk.text();
+      });
+  if (failed) return false;
+
+  texts[0] = global.text();
+  *pieces = std::move(texts);
+  return true;
+}
+
+// Prints the given pieces of text in order if the options ask for printing,
+// and otherwise stores them, concatenated, in *pText.
+spv_result_t SaveTextPieces(const std::vector<std::string>& pieces,
+                            const uint32_t options, spv_text* pText) {
+  if (spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_PRINT, options)) {
+    out_stream out;
+    for (const auto& piece : pieces) out.get() << piece;
+    return SPV_SUCCESS;
+  }
+
+  size_t length = 0;
+  for (const auto& piece : pieces) length += piece.size();
+  char* str = new char[length + 1];
+  char* next = str;
+  for (const auto& piece : pieces) {
+    next = std::copy(piece.begin(), piece.end(), next);
+  }
+  *next = '\0';
+  spv_text text = new spv_text_t();
+  text->str = str;
+  text->length = length;
+  *pText = text;
+  return SPV_SUCCESS;
+}
+
 uint32_t GetLineLengthWithoutColor(const std::string line) {
   // Currently, every added color is in the form \x1b...m, so instead of doing a
   // lot of string comparisons with spvtools::clr::* strings, we just ignore
@@ -814,6 +1043,16 @@ void InstructionDisassembler::GenerateCommentForDecoratedId(
   id_comment << partial.str();
 }
 
+void InstructionDisassembler::ContinueFrom(
+    const InstructionDisassembler& other, bool follows_other) {
+  id_comments_.clear();
+  for (const auto& id_comment : other.id_comments_) {
+    id_comments_[id_comment.first] << id_comment.second.str();
+  }
+  last_instruction_comment_alignment_ =
+      follows_other ? other.last_instruction_comment_alignment_ : 0;
+}
+
 void InstructionDisassembler::EmitSectionComment(
     const spv_parsed_instruction_t& inst, bool& inserted_decoration_space,
     bool& inserted_debug_space, bool& inserted_type_space) {
@@ -1072,12 +1311,102 @@ std::string spvInstructionBinaryToText(const spv_target_env env,
 
   return output;
 }
+
+namespace {
+
+// Disassembles the module.  If |sink| is null, the text is printed or stored
+// in *pText, as for spvBinaryToText.  Otherwise it is passed to |sink|, as for
+// spvBinaryToTextStream.  With SPV_BINARY_TO_TEXT_OPTION_PARALLEL, up to
+// |num_threads| threads are used.
+spv_result_t DisassembleModule(const spv_const_context context,
+                               const uint32_t* code, const size_t wordCount,
+                               uint32_t options, const uint32_t num_threads,
+                               void* user_data,
+                               spv_text_sink_fn_t sink, spv_text* pText,
+                               spv_diagnostic* pDiagnostic) {
+  spv_context_t hijack_context = *context;
+  if (pDiagnostic) {
+    *pDiagnostic = nullptr;
+    UseDiagnosticAsMessageConsumer(&hijack_context, pDiagnostic);
+  }
+
+  const AssemblyGrammar grammar(&hijack_context);
+  if (!grammar.isValid()) return SPV_ERROR_INVALID_TABLE;
+
+  // Generate friendly names for Ids if requested.
+  std::unique_ptr<FriendlyNameMapper> friendly_mapper;
+  NameMapper name_mapper = GetTrivialNameMapper();
+  if (options & SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES) {
+    friendly_mapper =
+        MakeUnique<FriendlyNameMapper>(&hijack_context, code, wordCount);
+    name_mapper = friendly_mapper->GetNameMapper();
+  }
+
+  if (sink) options &= ~SPV_BINARY_TO_TEXT_OPTION_PRINT;
+
+  std::vector<std::string> pieces;
+  if (spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_PARALLEL, options) &&
+      ParallelDisassemble(hijack_context, grammar, code, wordCount, options,
+                          name_mapper, num_threads, &pieces)) {
+    if (!sink) return SaveTextPieces(pieces, options, pText);
+    for (const auto& piece : pieces) {
+      if (auto error = SendText(user_data, sink, piece.data(), piece.size())) {
+        return error;
+      }
+    }
+    return SPV_SUCCESS;
+  }
+
+  // Now disassemble!
+  Disassembler disassembler(grammar, options, name_mapper);
+  if (sink) disassembler.SetSink(user_data, sink);
+  if (auto error = spvBinaryParse(&hijack_context, &disassembler, code,
+                                  wordCount, DisassembleHeader,
+                                  DisassembleInstruction, pDiagnostic)) {
+    return error;
+  }
+
+  if (sink) return disassembler.FlushText();
+  return disassembler.SaveTextResult(pText);
+}
+
+}  // namespace
 }  // namespace spvtools
 
 spv_result_t spvBinaryToText(const spv_const_context context,
                              const uint32_t* code, const size_t wordCount,
                              const uint32_t options, spv_text* pText,
                              spv_diagnostic* pDiagnostic) {
+  return spvtools::spvBinaryToTextWithThreads(
+      context, code, wordCount, options, spvtools::utils::HardwareThreadCount(),
+      pText, pDiagnostic);
+}
+
+spv_result_t spvBinaryToTextStream(const spv_const_context context,
+                                   const uint32_t* code, const size_t wordCount,
+                                   const uint32_t options, void* user_data,
+                                   spv_text_sink_fn_t sink,
+                                   spv_diagnostic* pDiagnostic) {
+  if (!sink) return SPV_ERROR_INVALID_POINTER;
+  return spvtools::DisassembleModule(
+      context, code, wordCount, options, spvtools::utils::HardwareThreadCount(),
+      user_data, sink, nullptr, pDiagnostic);
+}
+
+spv_result_t spvtools::spvBinaryToTextWithThreads(
+    const spv_const_context context, const uint32_t* code,
+    const size_t wordCount, const uint32_t options, const uint32_t num_threads,
+    spv_text* pText, spv_diagnostic* pDiagnostic) {
+  return spvtools::DisassembleModule(context, code, wordCount, options,
+                                     num_threads, nullptr, nullptr, pText,
+                                     pDiagnostic);
+}
+
+spv_result_t spvtools::spvBinaryRangeToText(
+    const spv_const_context context, const uint32_t* code,
+    const size_t wordCount, const size_t contextEnd, const size_t begin,
+    const size_t end, const uint32_t options, spv_text* pText,
+    spv_diagnostic* pDiagnostic) {
   spv_context_t hijack_context = *context;
   if (pDiagnostic) {
     *pDiagnostic = nullptr;
@@ -1087,21 +1416,23 @@ spv_result_t spvBinaryToText(const spv_const_context context,
   const spvtools::AssemblyGrammar grammar(&hijack_context);
   if (!grammar.isValid()) return SPV_ERROR_INVALID_TABLE;
 
-  // Generate friendly names for Ids if requested.
+  // Generate friendly names for Ids if requested.  Only the part of the
+  // module before contextEnd is scanned.  That covers the debug names and the
+  // types the names are derived from.
   std::unique_ptr<spvtools::FriendlyNameMapper> friendly_mapper;
   spvtools::NameMapper name_mapper = spvtools::GetTrivialNameMapper();
   if (options & SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES) {
     friendly_mapper = spvtools::MakeUnique<spvtools::FriendlyNameMapper>(
-        &hijack_context, code, wordCount);
+        &hijack_context, code, std::min(contextEnd, wordCount));
     name_mapper = friendly_mapper->GetNameMapper();
   }
 
-  // Now disassemble!
   spvtools::Disassembler disassembler(grammar, options, name_mapper);
-  if (auto error =
-          spvBinaryParse(&hijack_context, &disassembler, code, wordCount,
-                         spvtools::DisassembleHeader,
-                         spvtools::DisassembleInstruction, pDiagnostic)) {
+  disassembler.SetFirstInstructionOffset(begin);
+  if (auto error = spvBinaryParseRange(
+          &hijack_context, &disassembler, code, wordCount,
+          std::min(contextEnd, begin), begin, end, spvtools::DisassembleHeader,
+          spvtools::DisassembleInstruction, pDiagnostic)) {
     return error;
   }
 
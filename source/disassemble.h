@@ -37,6 +37,30 @@ std::string spvInstructionBinaryToText(const spv_target_env env,
                                        const size_t word_count,
                                        const uint32_t options);
 
+// Like spvBinaryToText, but only disassembles the instructions in the word
+// range [begin, end) of the module.  The header is still emitted unless the
+// options say otherwise.  The instructions before contextEnd, which should be
+// the start of the function definitions, are scanned to learn the types,
+// imports and names that the range refers to.  See spvBinaryParseRange for
+// the requirements on the range.
+spv_result_t spvBinaryRangeToText(const spv_const_context context,
+                                  const uint32_t* code, const size_t wordCount,
+                                  const size_t contextEnd, const size_t begin,
+                                  const size_t end, const uint32_t options,
+                                  spv_text* pText, spv_diagnostic* pDiagnostic);
+
+// Like spvBinaryToText, but SPV_BINARY_TO_TEXT_OPTION_PARALLEL spreads the
+// function definitions over up to |num_threads| threads, instead of one per
+// hardware thread.  With fewer than 2 threads the module is disassembled
+// serially.
+spv_result_t spvBinaryToTextWithThreads(const spv_const_context context,
+                                        const uint32_t* code,
+                                        const size_t wordCount,
+                                        const uint32_t options,
+                                        const uint32_t num_threads,
+                                        spv_text* pText,
+                                        spv_diagnostic* pDiagnostic);
+
 class AssemblyGrammar;
 namespace disassemble {
 
@@ -70,6 +94,12 @@ class InstructionDisassembler {
                           bool& inserted_debug_space,
                           bool& inserted_type_space);
 
+  // Copies the comments gathered for decorated ids by |other|, so that this
+  // instance can disassemble a later part of the same module.  If
+  // |follows_other| is true, the next instruction directly follows the last
+  // one |other| emitted, and its comment is aligned with that one's.
+  void ContinueFrom(const InstructionDisassembler& other, bool follows_other);
+
   // Resets the output color, if color is turned on.
   void ResetColor();
   // Set the output color, if color is turned on.
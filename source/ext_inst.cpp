@@ -41,31 +41,41 @@
 #include "spv-amd-shader-trinary-minmax.insts.inc"
 
 static const spv_ext_inst_group_t kGroups_1_0[] = {
-    {SPV_EXT_INST_TYPE_GLSL_STD_450, ARRAY_SIZE(glsl_entries), glsl_entries},
-    {SPV_EXT_INST_TYPE_OPENCL_STD, ARRAY_SIZE(opencl_entries), opencl_entries},
+    {SPV_EXT_INST_TYPE_GLSL_STD_450, ARRAY_SIZE(glsl_entries), glsl_entries,
+     &glsl_name_hash},
+    {SPV_EXT_INST_TYPE_OPENCL_STD, ARRAY_SIZE(opencl_entries), opencl_entries,
+     &opencl_name_hash},
     {SPV_EXT_INST_TYPE_SPV_AMD_SHADER_EXPLICIT_VERTEX_PARAMETER,
      ARRAY_SIZE(spv_amd_shader_explicit_vertex_parameter_entries),
-     spv_amd_shader_explicit_vertex_parameter_entries},
+     spv_amd_shader_explicit_vertex_parameter_entries,
+     &spv_amd_shader_explicit_vertex_parameter_name_hash},
     {SPV_EXT_INST_TYPE_SPV_AMD_SHADER_TRINARY_MINMAX,
      ARRAY_SIZE(spv_amd_shader_trinary_minmax_entries),
-     spv_amd_shader_trinary_minmax_entries},
+     spv_amd_shader_trinary_minmax_entries,
+     &spv_amd_shader_trinary_minmax_name_hash},
     {SPV_EXT_INST_TYPE_SPV_AMD_GCN_SHADER,
-     ARRAY_SIZE(spv_amd_gcn_shader_entries), spv_amd_gcn_shader_entries},
+     ARRAY_SIZE(spv_amd_gcn_shader_entries), spv_amd_gcn_shader_entries,
+     &spv_amd_gcn_shader_name_hash},
     {SPV_EXT_INST_TYPE_SPV_AMD_SHADER_BALLOT,
-     ARRAY_SIZE(spv_amd_shader_ballot_entries), spv_amd_shader_ballot_entries},
+     ARRAY_SIZE(spv_amd_shader_ballot_entries), spv_amd_shader_ballot_entries,
+     &spv_amd_shader_ballot_name_hash},
     {SPV_EXT_INST_TYPE_DEBUGINFO, ARRAY_SIZE(debuginfo_entries),
-     debuginfo_entries},
+     debuginfo_entries, &debuginfo_name_hash},
     {SPV_EXT_INST_TYPE_OPENCL_DEBUGINFO_100,
-     ARRAY_SIZE(opencl_debuginfo_100_entries), opencl_debuginfo_100_entries},
+     ARRAY_SIZE(opencl_debuginfo_100_entries), opencl_debuginfo_100_entries,
+     &opencl_debuginfo_100_name_hash},
     {SPV_EXT_INST_TYPE_NONSEMANTIC_SHADER_DEBUGINFO_100,
      ARRAY_SIZE(nonsemantic_shader_debuginfo_100_entries),
-     nonsemantic_shader_debuginfo_100_entries},
+     nonsemantic_shader_debuginfo_100_entries,
+     &nonsemantic_shader_debuginfo_100_name_hash},
     {SPV_EXT_INST_TYPE_NONSEMANTIC_CLSPVREFLECTION,
      ARRAY_SIZE(nonsemantic_clspvreflection_entries),
-     nonsemantic_clspvreflection_entries},
+     nonsemantic_clspvreflection_entries,
+     &nonsemantic_clspvreflection_name_hash},
     {SPV_EXT_INST_TYPE_NONSEMANTIC_VKSPREFLECTION,
      ARRAY_SIZE(nonsemantic_vkspreflection_entries),
-     nonsemantic_vkspreflection_entries},
+     nonsemantic_vkspreflection_entries,
+     &nonsemantic_vkspreflection_name_hash},
 };
 
 static const spv_ext_inst_table_t kTable_1_0 = {ARRAY_SIZE(kGroups_1_0),
@@ -182,6 +192,13 @@ spv_result_t spvExtInstTableNameLookup(const spv_ext_inst_table table,
   for (uint32_t groupIndex = 0; groupIndex < table->count; groupIndex++) {
     const auto& group = table->groups[groupIndex];
     if (type != group.type) continue;
+    if (group.name_hash && group.name_hash->num_buckets) {
+      const auto& entry = group.entries[spvNameHashLookup(
+          *group.name_hash, name, strlen(name))];
+      if (strcmp(name, entry.name)) return SPV_ERROR_INVALID_LOOKUP;
+      *pEntry = &entry;
+      return SPV_SUCCESS;
+    }
     for (uint32_t index = 0; index < group.count; index++) {
       const auto& entry = group.entries[index];
       if (!strcmp(name, entry.name)) {
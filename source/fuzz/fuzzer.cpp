@@ -116,6 +116,7 @@ Fuzzer::Fuzzer(std::unique_ptr<opt::IRContext> ir_context,
       enable_all_passes_(enable_all_passes),
       validate_after_each_fuzzer_pass_(validate_after_each_fuzzer_pass),
       validator_options_(validator_options),
+      validator_(nullptr),
       num_repeated_passes_applied_(0),
       is_valid_(true),
       ir_context_(std::move(ir_context)),
@@ -135,6 +136,12 @@ Fuzzer::Fuzzer(std::unique_ptr<opt::IRContext> ir_context,
                                           consumer_) &&
          "IRContext is invalid");
 
+  if (validate_after_each_fuzzer_pass_) {
+    validator_ = MakeUnique<val::IncrementalValidator>(
+        ir_context_->grammar().target_env(), validator_options_);
+    validator_->SetMessageConsumer(consumer_);
+  }
+
   // The following passes are likely to be very useful: many other passes
   // introduce synonyms, irrelevant ids and constants that these passes can work
   // with.  We thus enable them with high probability.
@@ -279,7 +286,7 @@ void Fuzzer::MaybeAddFinalPass(std::vector<std::unique_ptr<FuzzerPass>>* passes,
 bool Fuzzer::ApplyPassAndCheckValidity(FuzzerPass* pass) const {
   pass->Apply();
   return !validate_after_each_fuzzer_pass_ ||
-         fuzzerutil::IsValidAndWellFormed(ir_context_.get(), validator_options_,
+         fuzzerutil::IsValidAndWellFormed(ir_context_.get(), validator_.get(),
                                           consumer_);
 }
 
@@ -149,6 +149,12 @@ class Fuzzer {
   // Options to control validation.
   const spv_validator_options validator_options_;
 
+  // Validates the module after each fuzzer pass, if
+  // |validate_after_each_fuzzer_pass_| holds.  A fuzzer pass usually changes
+  // few functions, and the validator skips the function-local checks of the
+  // others.
+  std::unique_ptr<val::IncrementalValidator> validator_;
+
   // The number of repeated fuzzer passes that have been applied is kept track
   // of, in order to enforce a hard limit on the number of times such passes
   // can be applied.
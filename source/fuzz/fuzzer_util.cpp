@@ -60,6 +60,55 @@ uint32_t MaybeGetOpConstant(opt::IRContext* ir_context,
   return 0;
 }
 
+// Returns true if and only if every basic block in |ir_context| has its
+// enclosing function as its parent, and every instruction in |ir_context| has
+// a distinct unique id.  |consumer| is used for error reporting.
+bool IsWellFormed(const opt::IRContext* ir_context,
+                  const MessageConsumer& consumer) {
+  // Check that all blocks in the module have appropriate parent functions.
+  for (auto& function : *ir_context->module()) {
+    for (auto& block : function) {
+      if (block.GetParent() == nullptr) {
+        std::stringstream ss;
+        ss << "Block " << block.id() << " has no parent; its parent should be "
+           << function.result_id() << " (set a breakpoint to inspect).";
+        consumer(SPV_MSG_INFO, nullptr, {}, ss.str().c_str());
+        return false;
+      }
+      if (block.GetParent() != &function) {
+        std::stringstream ss;
+        ss << "Block " << block.id() << " should have parent "
+           << function.result_id() << " but instead has parent "
+           << block.GetParent() << " (set a breakpoint to inspect).";
+        consumer(SPV_MSG_INFO, nullptr, {}, ss.str().c_str());
+        return false;
+      }
+    }
+  }
+
+  // Check that all instructions have distinct unique ids.  We map each unique
+  // id to the first instruction it is observed to be associated with so that
+  // if we encounter a duplicate we have access to the previous instruction -
+  // this is a useful aid to debugging.
+  std::unordered_map<uint32_t, opt::Instruction*> unique_ids;
+  bool found_duplicate = false;
+  ir_context->module()->ForEachInst([&consumer, &found_duplicate, ir_context,
+                                     &unique_ids](opt::Instruction* inst) {
+    (void)ir_context;  // Only used in an assertion; keep release-mode compilers
+                       // happy.
+    assert(inst->context() == ir_context &&
+           "Instruction has wrong IR context.");
+    if (unique_ids.count(inst->unique_id()) != 0) {
+      consumer(SPV_MSG_INFO, nullptr, {},
+               "Two instructions have the same unique id (set a breakpoint to "
+               "inspect).");
+      found_duplicate = true;
+    }
+    unique_ids.insert({inst->unique_id(), inst});
+  });
+  return !found_duplicate;
+}
+
 }  // namespace
 
 const spvtools::MessageConsumer kSilentMessageConsumer =
@@ -501,48 +550,22 @@ bool IsValidAndWellFormed(const opt::IRContext* ir_context,
              "Module is invalid (set a breakpoint to inspect).");
     return false;
   }
-  // Check that all blocks in the module have appropriate parent functions.
-  for (auto& function : *ir_context->module()) {
-    for (auto& block : function) {
-      if (block.GetParent() == nullptr) {
-        std::stringstream ss;
-        ss << "Block " << block.id() << " has no parent; its parent should be "
-           << function.result_id() << " (set a breakpoint to inspect).";
-        consumer(SPV_MSG_INFO, nullptr, {}, ss.str().c_str());
-        return false;
-      }
-      if (block.GetParent() != &function) {
-        std::stringstream ss;
-        ss << "Block " << block.id() << " should have parent "
-           << function.result_id() << " but instead has parent "
-           << block.GetParent() << " (set a breakpoint to inspect).";
-        consumer(SPV_MSG_INFO, nullptr, {}, ss.str().c_str());
-        return false;
-      }
-    }
-  }
+  return IsWellFormed(ir_context, consumer);
+}
 
-  // Check that all instructions have distinct unique ids.  We map each unique
-  // id to the first instruction it is observed to be associated with so that
-  // if we encounter a duplicate we have access to the previous instruction -
-  // this is a useful aid to debugging.
-  std::unordered_map<uint32_t, opt::Instruction*> unique_ids;
-  bool found_duplicate = false;
-  ir_context->module()->ForEachInst([&consumer, &found_duplicate, ir_context,
-                                     &unique_ids](opt::Instruction* inst) {
-    (void)ir_context;  // Only used in an assertion; keep release-mode compilers
-                       // happy.
-    assert(inst->context() == ir_context &&
-           "Instruction has wrong IR context.");
-    if (unique_ids.count(inst->unique_id()) != 0) {
-      consumer(SPV_MSG_INFO, nullptr, {},
-               "Two instructions have the same unique id (set a breakpoint to "
-               "inspect).");
-      found_duplicate = true;
-    }
-    unique_ids.insert({inst->unique_id(), inst});
-  });
-  return !found_duplicate;
+bool IsValidAndWellFormed(const opt::IRContext* ir_context,
+                          val::IncrementalValidator* validator,
+                          MessageConsumer consumer) {
+  std::vector<uint32_t> binary;
+  ir_context->module()->ToBinary(&binary, false);
+  if (!validator->Validate(binary)) {
+    // Expression to dump |ir_context| to /data/temp/shader.spv:
+    //    DumpShader(ir_context, "/data/temp/shader.spv")
+    consumer(SPV_MSG_INFO, nullptr, {},
+             "Module is invalid (set a breakpoint to inspect).");
+    return false;
+  }
+  return IsWellFormed(ir_context, consumer);
 }
 
 std::unique_ptr<opt::IRContext> CloneIRContext(opt::IRContext* context) {
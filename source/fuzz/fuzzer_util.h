@@ -25,6 +25,7 @@
 #include "source/opt/instruction.h"
 #include "source/opt/ir_context.h"
 #include "source/opt/module.h"
+#include "source/val/validate.h"
 #include "spirv-tools/libspirv.hpp"
 
 namespace spvtools {
@@ -187,6 +188,14 @@ bool IsValidAndWellFormed(const opt::IRContext* context,
                           spv_validator_options validator_options,
                           MessageConsumer consumer);
 
+// Like the above, but validates |context| with |validator|, which reports
+// validation errors to its own message consumer.  |validator| skips the
+// function-local checks of the functions unchanged since the last valid
+// module it saw.
+bool IsValidAndWellFormed(const opt::IRContext* context,
+                          val::IncrementalValidator* validator,
+                          MessageConsumer consumer);
+
 // Returns a clone of |context|, by writing |context| to a binary and then
 // parsing it again.
 std::unique_ptr<opt::IRContext> CloneIRContext(opt::IRContext* context);
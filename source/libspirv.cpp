@@ -108,6 +108,17 @@ bool SpirvTools::Disassemble(const uint32_t* binary, const size_t binary_size,
   return status == SPV_SUCCESS;
 }
 
+bool SpirvTools::Disassemble(const uint32_t* binary, const size_t binary_size,
+                             std::ostream* out, uint32_t options) const {
+  auto write = [](void* user_data, const char* text, size_t length) {
+    auto stream = static_cast<std::ostream*>(user_data);
+    stream->write(text, static_cast<std::streamsize>(length));
+    return stream->good() ? SPV_SUCCESS : SPV_REQUESTED_TERMINATION;
+  };
+  return spvBinaryToTextStream(impl_->context, binary, binary_size, options,
+                               out, write, nullptr) == SPV_SUCCESS;
+}
+
 struct CxxParserContext {
   const HeaderParser& header_parser;
   const InstructionParser& instruction_parser;
@@ -0,0 +1,273 @@
+// Copyright (c) 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "source/binary.h"
+#include "source/diagnostic.h"
+#include "source/disassemble.h"
+#include "source/opcode.h"
+#include "source/spirv_constant.h"
+#include "source/spirv_endian.h"
+#include "source/table.h"
+#include "spirv-tools/libspirv.h"
+
+struct spv_module_index_t {
+  // A function, as the range of words from its OpFunction to its
+  // OpFunctionEnd.
+  struct Function {
+    uint32_t id;
+    size_t begin;
+    size_t end;
+  };
+
+  const uint32_t* words = nullptr;
+  size_t num_words = 0;
+  spv_endianness_t endian = SPV_ENDIANNESS_LITTLE;
+  // The range of words of each section.  Empty sections have begin == end.
+  std::pair<size_t, size_t> sections[SPV_MODULE_SECTION_COUNT] = {};
+  std::vector<Function> functions;
+  // The offset of the instruction defining each id, or 0 if there is none.
+  // Covers the ids below the id bound, up to the size of the module.
+  std::vector<size_t> id_offsets;
+  // The offsets of the instructions defining the ids not in id_offsets.
+  std::unordered_map<uint32_t, size_t> sparse_id_offsets;
+
+  // Returns the end of the part of the module that declares what the
+  // functions refer to.
+  size_t context_end() const {
+    const auto& functions_section = sections[SPV_MODULE_SECTION_FUNCTIONS];
+    return functions_section.first != functions_section.second
+               ? functions_section.first
+               : num_words;
+  }
+};
+
+namespace {
+
+// Returns the section of the logical layout that holds the given opcode,
+// assuming it comes before the first function.
+spv_module_section_t SectionOf(spv::Op opcode) {
+  switch (opcode) {
+    case spv::Op::OpCapability:
+      return SPV_MODULE_SECTION_CAPABILITY;
+    case spv::Op::OpExtension:
+      return SPV_MODULE_SECTION_EXTENSION;
+    case spv::Op::OpExtInstImport:
+      return SPV_MODULE_SECTION_EXT_INST_IMPORT;
+    case spv::Op::OpMemoryModel:
+      return SPV_MODULE_SECTION_MEMORY_MODEL;
+    case spv::Op::OpEntryPoint:
+      return SPV_MODULE_SECTION_ENTRY_POINT;
+    case spv::Op::OpExecutionMode:
+    case spv::Op::OpExecutionModeId:
+      return SPV_MODULE_SECTION_EXECUTION_MODE;
+    case spv::Op::OpLine:
+    case spv::Op::OpNoLine:
+      // Line instructions are allowed among the types and values.
+      return SPV_MODULE_SECTION_TYPES_VALUES;
+    case spv::Op::OpDecorationGroup:
+      return SPV_MODULE_SECTION_ANNOTATION;
+    default:
+      break;
+  }
+  if (spvOpcodeIsDebug(opcode)) return SPV_MODULE_SECTION_DEBUG;
+  if (spvOpcodeIsDecoration(opcode)) return SPV_MODULE_SECTION_ANNOTATION;
+  return SPV_MODULE_SECTION_TYPES_VALUES;
+}
+
+}  // namespace
+
+spv_result_t spvModuleIndexCreate(const spv_const_context context,
+                                  const uint32_t* words,
+                                  const size_t num_words,
+                                  spv_module_index* pIndex,
+                                  spv_diagnostic* pDiagnostic) {
+  if (!context) return SPV_ERROR_INVALID_TABLE;
+  if (!pIndex) return SPV_ERROR_INVALID_POINTER;
+  spv_context_t hijack_context = *context;
+  if (pDiagnostic) {
+    *pDiagnostic = nullptr;
+    spvtools::UseDiagnosticAsMessageConsumer(&hijack_context, pDiagnostic);
+  }
+
+  size_t instruction_count = 0;
+  auto diagnostic = [&hijack_context, &instruction_count]() {
+    return spvtools::DiagnosticStream({0, 0, instruction_count},
+                                      hijack_context.consumer, "",
+                                      SPV_ERROR_INVALID_BINARY);
+  };
+
+  if (!words) return diagnostic() << "Missing module.";
+  if (num_words < SPV_INDEX_INSTRUCTION) {
+    return diagnostic() << "Module has incomplete header: only " << num_words
+                        << " words instead of " << SPV_INDEX_INSTRUCTION;
+  }
+
+  auto index = std::make_unique<spv_module_index_t>();
+  index->words = words;
+  index->num_words = num_words;
+  spv_const_binary_t binary{words, num_words};
+  if (spvBinaryEndianness(&binary, &index->endian)) {
+    return diagnostic() << "Invalid SPIR-V magic number '" << std::hex
+                        << words[0] << "'.";
+  }
+  spv_header_t header;
+  if (spvBinaryHeaderGet(&binary, index->endian, &header)) {
+    return diagnostic() << "Invalid SPIR-V header.";
+  }
+  // An id bound far larger than the module is possible, so the dense map
+  // only covers as many ids as the module could possibly define.
+  index->id_offsets.resize(std::min<size_t>(header.bound, num_words));
+
+  const auto env = hijack_context.target_env;
+  bool in_function = false;
+  bool in_functions_section = false;
+  for (size_t offset = SPV_INDEX_INSTRUCTION; offset < num_words;) {
+    ++instruction_count;
+    uint16_t word_count = 0;
+    uint16_t opcode_value = 0;
+    spvOpcodeSplit(spvFixWord(words[offset], index->endian), &word_count,
+                   &opcode_value);
+    const auto opcode = static_cast<spv::Op>(opcode_value);
+    if (word_count == 0) {
+      return diagnostic() << "Invalid instruction word count: 0";
+    }
+    spv_opcode_desc desc = nullptr;
+    if (spvOpcodeTableValueLookup(env, hijack_context.opcode_table, opcode,
+                                  &desc)) {
+      return diagnostic() << "Invalid opcode: " << opcode_value;
+    }
+    if (offset + word_count > num_words) {
+      return diagnostic() << "End of input reached while decoding Op"
+                          << desc->name << " starting at word " << offset
+                          << ": expected " << word_count
+                          << " words, but found " << num_words - offset << ".";
+    }
+
+    // Record the definition of the result id, if any.
+    uint32_t result_id = 0;
+    const size_t result_id_index = desc->hasType ? 2 : 1;
+    if (desc->hasResult && result_id_index < word_count) {
+      result_id = spvFixWord(words[offset + result_id_index], index->endian);
+      if (result_id < index->id_offsets.size()) {
+        index->id_offsets[result_id] = offset;
+      } else {
+        index->sparse_id_offsets[result_id] = offset;
+      }
+    }
+
+    const size_t next = offset + word_count;
+    if (opcode == spv::Op::OpFunction) {
+      in_function = true;
+      in_functions_section = true;
+      index->functions.push_back({result_id, offset, num_words});
+    } else if (opcode == spv::Op::OpFunctionEnd && in_function) {
+      in_function = false;
+      index->functions.back().end = next;
+    }
+
+    auto& section = index->sections[in_functions_section
+                                        ? SPV_MODULE_SECTION_FUNCTIONS
+                                        : SectionOf(opcode)];
+    if (section.first == section.second) section.first = offset;
+    section.second = next;
+
+    offset = next;
+  }
+
+  *pIndex = index.release();
+  return SPV_SUCCESS;
+}
+
+void spvModuleIndexDestroy(spv_module_index index) { delete index; }
+
+bool spvModuleIndexGetSection(const spv_const_module_index index,
+                              const spv_module_section_t section,
+                              size_t* begin, size_t* end) {
+  const auto section_index = static_cast<size_t>(section);
+  if (!index || section_index >= SPV_MODULE_SECTION_COUNT) return false;
+  const auto& range = index->sections[section_index];
+  if (range.first == range.second) return false;
+  if (begin) *begin = range.first;
+  if (end) *end = range.second;
+  return true;
+}
+
+size_t spvModuleIndexGetFunctionCount(const spv_const_module_index index) {
+  return index ? index->functions.size() : 0;
+}
+
+bool spvModuleIndexGetFunction(const spv_const_module_index index,
+                               const size_t function_index, uint32_t* id,
+                               size_t* begin, size_t* end) {
+  if (!index || function_index >= index->functions.size()) return false;
+  const auto& function = index->functions[function_index];
+  if (id) *id = function.id;
+  if (begin) *begin = function.begin;
+  if (end) *end = function.end;
+  return true;
+}
+
+bool spvModuleIndexGetIdDefinition(const spv_const_module_index index,
+                                   const uint32_t id, size_t* begin,
+                                   size_t* end) {
+  if (!index) return false;
+  size_t offset = 0;
+  if (id < index->id_offsets.size()) {
+    offset = index->id_offsets[id];
+  } else {
+    const auto it = index->sparse_id_offsets.find(id);
+    if (it != index->sparse_id_offsets.end()) offset = it->second;
+  }
+  if (offset == 0) return false;
+
+  uint16_t word_count = 0;
+  uint16_t opcode = 0;
+  spvOpcodeSplit(spvFixWord(index->words[offset], index->endian), &word_count,
+                 &opcode);
+  if (begin) *begin = offset;
+  if (end) *end = offset + word_count;
+  return true;
+}
+
+spv_result_t spvModuleIndexParseRange(
+    const spv_const_context context, const spv_const_module_index index,
+    const size_t begin, const size_t end, void* user_data,
+    spv_parsed_header_fn_t parsed_header,
+    spv_parsed_instruction_fn_t parsed_instruction,
+    spv_diagnostic* diagnostic) {
+  if (!context) return SPV_ERROR_INVALID_TABLE;
+  if (!index) return SPV_ERROR_INVALID_POINTER;
+  return spvBinaryParseRange(context, user_data, index->words,
+                             index->num_words,
+                             std::min(index->context_end(), begin), begin, end,
+                             parsed_header, parsed_instruction, diagnostic);
+}
+
+spv_result_t spvModuleIndexRangeToText(const spv_const_context context,
+                                       const spv_const_module_index index,
+                                       const size_t begin, const size_t end,
+                                       const uint32_t options, spv_text* text,
+                                       spv_diagnostic* diagnostic) {
+  if (!context) return SPV_ERROR_INVALID_TABLE;
+  if (!index) return SPV_ERROR_INVALID_POINTER;
+  return spvtools::spvBinaryRangeToText(context, index->words, index->num_words,
+                                        index->context_end(), begin, end,
+                                        options, text, diagnostic);
+}
@@ -37,8 +37,9 @@ struct OpcodeDescPtrLen {
 
 #include "core.insts-unified1.inc"
 
-static const spv_opcode_table_t kOpcodeTable = {ARRAY_SIZE(kOpcodeTableEntries),
-                                                kOpcodeTableEntries};
+static const spv_opcode_table_t kOpcodeTable = {
+    ARRAY_SIZE(kOpcodeTableEntries), kOpcodeTableEntries, &kOpcodeTableIndex,
+    &kOpcodeTableNameHash};
 
 // Represents a vendor tool entry in the SPIR-V XML Registry.
 struct VendorTool {
@@ -95,25 +96,35 @@ spv_result_t spvOpcodeTableNameLookup(spv_target_env env,
   if (!name || !pEntry) return SPV_ERROR_INVALID_POINTER;
   if (!table) return SPV_ERROR_INVALID_TABLE;
 
-  // TODO: This lookup of the Opcode table is suboptimal! Binary sort would be
-  // preferable but the table requires sorting on the Opcode name, but it's
-  // static const initialized and matches the order of the spec.
   const size_t nameLength = strlen(name);
   const auto version = spvVersionForTargetEnv(env);
+  // We considers the current opcode as available as long as
+  // 1. The target environment satisfies the minimal requirement of the
+  //    opcode; or
+  // 2. There is at least one extension enabling this opcode.
+  //
+  // Note that the second rule assumes the extension enabling this instruction
+  // is indeed requested in the SPIR-V code; checking that should be
+  // validator's work.
+  auto matches = [version, name, nameLength](const spv_opcode_desc_t& entry) {
+    return ((version >= entry.minVersion && version <= entry.lastVersion) ||
+            entry.numExtensions > 0u || entry.numCapabilities > 0u) &&
+           nameLength == strlen(entry.name) &&
+           !strncmp(name, entry.name, nameLength);
+  };
+
+  // The generated table has a perfect hash of its names, which are unique.
+  if (table->name_hash && table->name_hash->num_buckets) {
+    const uint16_t position =
+        spvNameHashLookup(*table->name_hash, name, nameLength);
+    if (!matches(table->entries[position])) return SPV_ERROR_INVALID_LOOKUP;
+    *pEntry = &table->entries[position];
+    return SPV_SUCCESS;
+  }
+
   for (uint64_t opcodeIndex = 0; opcodeIndex < table->count; ++opcodeIndex) {
     const spv_opcode_desc_t& entry = table->entries[opcodeIndex];
-    // We considers the current opcode as available as long as
-    // 1. The target environment satisfies the minimal requirement of the
-    //    opcode; or
-    // 2. There is at least one extension enabling this opcode.
-    //
-    // Note that the second rule assumes the extension enabling this instruction
-    // is indeed requested in the SPIR-V code; checking that should be
-    // validator's work.
-    if (((version >= entry.minVersion && version <= entry.lastVersion) ||
-         entry.numExtensions > 0u || entry.numCapabilities > 0u) &&
-        nameLength == strlen(entry.name) &&
-        !strncmp(name, entry.name, nameLength)) {
+    if (matches(entry)) {
       // NOTE: Found out Opcode!
       *pEntry = &entry;
       return SPV_SUCCESS;
@@ -133,21 +144,29 @@ spv_result_t spvOpcodeTableValueLookup(spv_target_env env,
   const auto beg = table->entries;
   const auto end = table->entries + table->count;
 
-  spv_opcode_desc_t needle = {"",    opcode, 0, nullptr, 0,   {},
-                              false, false,  0, nullptr, ~0u, ~0u};
-
-  auto comp = [](const spv_opcode_desc_t& lhs, const spv_opcode_desc_t& rhs) {
-    return lhs.opcode < rhs.opcode;
-  };
+  // Find the first entry for the opcode.  The generated table has an index
+  // for that.  Otherwise, assume the table is sorted by opcode value.
+  const spv_opcode_desc_t* first = end;
+  if (table->index) {
+    const uint16_t position =
+        spvTableIndexLookup(*table->index, static_cast<uint32_t>(opcode));
+    if (position != kNoTableIndex) first = beg + position;
+  } else {
+    spv_opcode_desc_t needle = {"",    opcode, 0, nullptr, 0,   {},
+                                false, false,  0, nullptr, ~0u, ~0u};
+    auto comp = [](const spv_opcode_desc_t& lhs,
+                   const spv_opcode_desc_t& rhs) {
+      return lhs.opcode < rhs.opcode;
+    };
+    first = std::lower_bound(beg, end, needle, comp);
+  }
 
   // We need to loop here because there can exist multiple symbols for the same
   // opcode value, and they can be introduced in different target environments,
   // which means they can have different minimal version requirements.
-  // Assumes the underlying table is already sorted ascendingly according to
-  // opcode value.
+  // Entries with the same opcode are adjacent in the table.
   const auto version = spvVersionForTargetEnv(env);
-  for (auto it = std::lower_bound(beg, end, needle, comp);
-       it != end && it->opcode == opcode; ++it) {
+  for (auto it = first; it != end && it->opcode == opcode; ++it) {
     // We considers the current opcode as available as long as
     // 1. The target environment satisfies the minimal requirement of the
     //    opcode; or
@@ -184,20 +203,9 @@ void spvInstructionCopy(const uint32_t* words, const spv::Op opcode,
 }
 
 const char* spvOpcodeString(const uint32_t opcode) {
-  const auto beg = kOpcodeTableEntries;
-  const auto end = kOpcodeTableEntries + ARRAY_SIZE(kOpcodeTableEntries);
-  spv_opcode_desc_t needle = {"",    static_cast<spv::Op>(opcode),
-                              0,     nullptr,
-                              0,     {},
-                              false, false,
-                              0,     nullptr,
-                              ~0u,   ~0u};
-  auto comp = [](const spv_opcode_desc_t& lhs, const spv_opcode_desc_t& rhs) {
-    return lhs.opcode < rhs.opcode;
-  };
-  auto it = std::lower_bound(beg, end, needle, comp);
-  if (it != end && it->opcode == spv::Op(opcode)) {
-    return it->name;
+  const uint16_t position = spvTableIndexLookup(kOpcodeTableIndex, opcode);
+  if (position != kNoTableIndex) {
+    return kOpcodeTableEntries[position].name;
   }
 
   assert(0 && "Unreachable!");
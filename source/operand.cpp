@@ -20,12 +20,14 @@
 #include <string.h>
 
 #include <algorithm>
+#include <array>
 
 #include "DebugInfo.h"
 #include "OpenCLDebugInfo100.h"
 #include "source/macro.h"
 #include "source/opcode.h"
 #include "source/spirv_constant.h"
+#include "source/util/bitutils.h"
 
 // For now, assume unified1 contains up to SPIR-V 1.3 and no later
 // SPIR-V version.
@@ -39,6 +41,38 @@ static const spv_operand_table_t kOperandTable = {
     ARRAY_SIZE(pygen_variable_OperandInfoTable),
     pygen_variable_OperandInfoTable};
 
+namespace {
+
+// Returns the group of the given operand table for the given operand type, or
+// nullptr if it has none.
+const spv_operand_desc_group_t* FindOperandGroup(
+    const spv_operand_table table, const spv_operand_type_t type) {
+  if (table == &kOperandTable) {
+    // Map each operand type to its group once, rather than scanning the
+    // table on every lookup.
+    static const auto groups = [] {
+      std::array<const spv_operand_desc_group_t*,
+                 SPV_OPERAND_TYPE_NUM_OPERAND_TYPES>
+          result{};
+      for (uint32_t i = 0; i < kOperandTable.count; ++i) {
+        const auto& group = kOperandTable.types[i];
+        assert(!result[group.type] && "Operand type has several groups");
+        result[group.type] = &group;
+      }
+      return result;
+    }();
+    const auto index = static_cast<size_t>(type);
+    return index < groups.size() ? groups[index] : nullptr;
+  }
+
+  for (uint64_t typeIndex = 0; typeIndex < table->count; ++typeIndex) {
+    if (type == table->types[typeIndex].type) return &table->types[typeIndex];
+  }
+  return nullptr;
+}
+
+}  // namespace
+
 spv_result_t spvOperandTableGet(spv_operand_table* pOperandTable,
                                 spv_target_env) {
   if (!pOperandTable) return SPV_ERROR_INVALID_POINTER;
@@ -56,19 +90,27 @@ spv_result_t spvOperandTableNameLookup(spv_target_env,
   if (!table) return SPV_ERROR_INVALID_TABLE;
   if (!name || !pEntry) return SPV_ERROR_INVALID_POINTER;
 
-  for (uint64_t typeIndex = 0; typeIndex < table->count; ++typeIndex) {
-    const auto& group = table->types[typeIndex];
-    if (type != group.type) continue;
-    for (uint64_t index = 0; index < group.count; ++index) {
-      const auto& entry = group.entries[index];
-      // We consider the current operand as available as long as
-      // it is in the grammar.  It might not be *valid* to use,
-      // but that should be checked by the validator, not by parsing.
-      if (nameLength == strlen(entry.name) &&
-          !strncmp(entry.name, name, nameLength)) {
-        *pEntry = &entry;
-        return SPV_SUCCESS;
-      }
+  const spv_operand_desc_group_t* group = FindOperandGroup(table, type);
+  if (!group) return SPV_ERROR_INVALID_LOOKUP;
+  if (group->name_hash.num_buckets) {
+    const auto& entry =
+        group->entries[spvNameHashLookup(group->name_hash, name, nameLength)];
+    if (nameLength != strlen(entry.name) ||
+        strncmp(entry.name, name, nameLength)) {
+      return SPV_ERROR_INVALID_LOOKUP;
+    }
+    *pEntry = &entry;
+    return SPV_SUCCESS;
+  }
+  for (uint64_t index = 0; index < group->count; ++index) {
+    const auto& entry = group->entries[index];
+    // We consider the current operand as available as long as
+    // it is in the grammar.  It might not be *valid* to use,
+    // but that should be checked by the validator, not by parsing.
+    if (nameLength == strlen(entry.name) &&
+        !strncmp(entry.name, name, nameLength)) {
+      *pEntry = &entry;
+      return SPV_SUCCESS;
     }
   }
 
@@ -83,29 +125,42 @@ spv_result_t spvOperandTableValueLookup(spv_target_env,
   if (!table) return SPV_ERROR_INVALID_TABLE;
   if (!pEntry) return SPV_ERROR_INVALID_POINTER;
 
+  const spv_operand_desc_group_t* group = FindOperandGroup(table, type);
+  if (!group) return SPV_ERROR_INVALID_LOOKUP;
+
+  // The current operand is considered available as long as
+  // it is in the grammar.  It might not be *valid* to use,
+  // but that should be checked by the validator, not by parsing.
+  if (group->index.num_pages) {
+    uint32_t key = value;
+    if (group->is_bit_enum) {
+      // Only single bits and zero are in the grammar.
+      if (value & (value - 1)) return SPV_ERROR_INVALID_LOOKUP;
+      key = value ? static_cast<uint32_t>(
+                        spvtools::utils::CountTrailingZeros(value) + 1)
+                  : 0;
+    }
+    const uint16_t position = spvTableIndexLookup(group->index, key);
+    if (position == kNoTableIndex) return SPV_ERROR_INVALID_LOOKUP;
+    *pEntry = group->entries + position;
+    return SPV_SUCCESS;
+  }
+
   spv_operand_desc_t needle = {"", value, 0, nullptr, 0, nullptr, {}, ~0u, ~0u};
 
   auto comp = [](const spv_operand_desc_t& lhs, const spv_operand_desc_t& rhs) {
     return lhs.value < rhs.value;
   };
 
-  for (uint64_t typeIndex = 0; typeIndex < table->count; ++typeIndex) {
-    const auto& group = table->types[typeIndex];
-    if (type != group.type) continue;
-
-    const auto beg = group.entries;
-    const auto end = group.entries + group.count;
-
-    // Assumes the underlying table is already sorted ascendingly according to
-    // opcode value.
-    auto it = std::lower_bound(beg, end, needle, comp);
-    if (it != end && it->value == value) {
-      // The current operand is considered available as long as
-      // it is in the grammar.  It might not be *valid* to use,
-      // but that should be checked by the validator, not by parsing.
-      *pEntry = it;
-      return SPV_SUCCESS;
-    }
+  const auto beg = group->entries;
+  const auto end = group->entries + group->count;
+
+  // Assumes the underlying table is already sorted ascendingly according to
+  // operand value.
+  auto it = std::lower_bound(beg, end, needle, comp);
+  if (it != end && it->value == value) {
+    *pEntry = it;
+    return SPV_SUCCESS;
   }
 
   return SPV_ERROR_INVALID_LOOKUP;
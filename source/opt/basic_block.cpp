@@ -28,8 +28,13 @@ constexpr uint32_t kLoopMergeMergeBlockIdInIdx = 0;
 constexpr uint32_t kSelectionMergeMergeBlockIdInIdx = 0;
 }  // namespace
 
+void* BasicBlock::operator new(size_t size, IRContext* context) {
+  return utils::SlabAllocator::Allocate(
+      context ? context->slab_allocator() : nullptr, size);
+}
+
 BasicBlock* BasicBlock::Clone(IRContext* context) const {
-  BasicBlock* clone = new BasicBlock(
+  BasicBlock* clone = new (context) BasicBlock(
       std::unique_ptr<Instruction>(GetLabelInst()->Clone(context)));
   for (const auto& inst : insts_) {
     // Use the incoming context
@@ -50,6 +50,20 @@ class BasicBlock {
 
   explicit BasicBlock(const BasicBlock& bb) = delete;
 
+  // Like instructions, "new (context) BasicBlock(...)" allocates a block out
+  // of the slabs of |context|, while a plain "new" allocates it from the
+  // heap.
+  static void* operator new(size_t size) {
+    return utils::SlabAllocator::Allocate(nullptr, size);
+  }
+  static void* operator new(size_t size, IRContext* context);
+  static void operator delete(void* block) {
+    utils::SlabAllocator::Free(block);
+  }
+  static void operator delete(void* block, IRContext*) {
+    utils::SlabAllocator::Free(block);
+  }
+
   // Creates a clone of the basic block in the given |context|
   //
   // The parent function will default to null and needs to be explicitly set by
@@ -48,6 +48,8 @@ class BlockMergePass : public Pass {
            IRContext::kAnalysisTypes;
   }
 
+  bool ReportsModifiedFunctions() const override { return true; }
+
  private:
 
   // Search |func| for blocks which have a single Branch to a block
@@ -46,6 +46,17 @@ CFG::CFG(Module* module)
   }
 }
 
+void CFG::Rebuild() {
+  block2structured_succs_.clear();
+  label2preds_.clear();
+  id2block_.clear();
+  for (auto& fn : *module_) {
+    for (auto& blk : fn) {
+      RegisterBlock(&blk);
+    }
+  }
+}
+
 void CFG::AddEdges(BasicBlock* blk) {
   uint32_t blk_id = blk->id();
   // Force the creation of an entry, not all basic block have predecessors
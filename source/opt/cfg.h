@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "source/opt/basic_block.h"
+#include "source/util/id_map.h"
 
 namespace spvtools {
 namespace opt {
@@ -30,6 +31,11 @@ class CFG {
  public:
   explicit CFG(Module* module);
 
+  // Forgets all the blocks and edges, and registers the blocks of the module
+  // again.  The pseudo entry and exit blocks are kept, so the dominator trees
+  // built from this CFG still refer to them.
+  void Rebuild();
+
   // Return the list of predecessors for basic block with label |blkid|.
   // TODO(dnovillo): Move this to BasicBlock.
   const std::vector<uint32_t>& preds(uint32_t blk_id) const {
@@ -177,10 +183,10 @@ class CFG {
   BasicBlock pseudo_exit_block_;
 
   // Map from block's label id to its predecessor blocks ids
-  std::unordered_map<uint32_t, std::vector<uint32_t>> label2preds_;
+  utils::IdMap<std::vector<uint32_t>> label2preds_;
 
   // Map from block's label id to block.
-  std::unordered_map<uint32_t, BasicBlock*> id2block_;
+  utils::IdMap<BasicBlock*> id2block_;
 };
 
 }  // namespace opt
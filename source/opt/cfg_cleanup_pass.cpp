@@ -26,7 +26,7 @@ namespace opt {
 Pass::Status CFGCleanupPass::Process() {
   // Process all entry point functions.
   ProcessFunction pfn = [this](Function* fp) { return CFGCleanup(fp); };
-  bool modified = context()->ProcessReachableCallTree(pfn);
+  bool modified = ProcessReachableCallTree(pfn);
   return modified ? Pass::Status::SuccessWithChange
                   : Pass::Status::SuccessWithoutChange;
 }
@@ -33,6 +33,8 @@ class CFGCleanupPass : public MemPass {
     return IRContext::kAnalysisDefUse | IRContext::kAnalysisConstants |
            IRContext::kAnalysisTypes;
   }
+
+  bool ReportsModifiedFunctions() const override { return true; }
 };
 
 }  // namespace opt
@@ -27,6 +27,7 @@
 #include "source/opt/type_manager.h"
 #include "source/opt/types.h"
 #include "source/util/hex_float.h"
+#include "source/util/id_map.h"
 #include "source/util/make_unique.h"
 
 namespace spvtools {
@@ -726,7 +727,7 @@ class ConstantManager {
   // Constant instances. All Normal Constants in the module, either
   // existing ones before optimization or the newly generated ones, should have
   // their Constant instance stored and their result id registered in this map.
-  std::unordered_map<uint32_t, const Constant*> id_to_const_val_;
+  utils::IdMap<const Constant*> id_to_const_val_;
 
   // A mapping from the Constant instance of Normal Constants to their
   // result id in the module. This is a mirror map of |id_to_const_val_|. All
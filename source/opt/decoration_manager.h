@@ -22,6 +22,7 @@
 
 #include "source/opt/instruction.h"
 #include "source/opt/module.h"
+#include "source/util/id_map.h"
 
 namespace spvtools {
 namespace opt {
@@ -200,7 +201,7 @@ class DecorationManager {
   // referencing that id, be it directly (spv::Op::OpDecorate,
   // spv::Op::OpMemberDecorate and spv::Op::OpDecorateId), or indirectly
   // (spv::Op::OpGroupDecorate, spv::Op::OpMemberGroupDecorate).
-  std::unordered_map<uint32_t, TargetData> id_to_decoration_insts_;
+  utils::IdMap<TargetData> id_to_decoration_insts_;
   // The enclosing module.
   Module* module_;
 };
@@ -34,16 +34,16 @@ void DefUseManager::AnalyzeInstDef(Instruction* inst) {
 }
 
 void DefUseManager::AnalyzeInstUse(Instruction* inst) {
-  // Create entry for the given instruction. Note that the instruction may
-  // not have any in-operands. In such cases, we still need a entry for those
+  // Mark the given instruction as analyzed. Note that the instruction may
+  // not have any in-operands. In such cases, we still need to mark those
   // instructions so this manager knows it has seen the instruction later.
-  auto* used_ids = &inst_to_used_ids_[inst];
-  if (used_ids->size()) {
-    EraseUseRecordsOfOperandIds(inst);
-    used_ids = &inst_to_used_ids_[inst];
-  }
-  used_ids->clear();  // It might have existed before.
+  InstRecords& records = inst_to_records_[inst];
+  EraseUses(&records);  // It might have been analyzed before.
+  records.analyzed = true;
 
+  // The uses are linked as they are added, so the vector must not grow past
+  // its capacity.
+  records.uses.reserve(inst->NumOperands());
   for (uint32_t i = 0; i < inst->NumOperands(); ++i) {
     switch (inst->GetOperand(i).type) {
       // For any id type but result id type
@@ -54,8 +54,11 @@ void DefUseManager::AnalyzeInstUse(Instruction* inst) {
         uint32_t use_id = inst->GetSingleWordOperand(i);
         Instruction* def = GetDef(use_id);
         assert(def && "Definition is not registered.");
-        id_to_users_.insert(UserEntry{def, inst});
-        used_ids->push_back(use_id);
+        records.uses.push_back(Use{def, inst, nullptr, nullptr, nullptr});
+        if (!LinkUse(&inst_to_records_[def].users, &records.uses.back())) {
+          // |inst| already uses |def| in an earlier operand.
+          records.uses.pop_back();
+        }
       } break;
       default:
         break;
@@ -94,21 +97,52 @@ const Instruction* DefUseManager::GetDef(uint32_t id) const {
   return iter->second;
 }
 
-DefUseManager::IdToUsersMap::const_iterator DefUseManager::UsersBegin(
-    const Instruction* def) const {
-  return id_to_users_.lower_bound(
-      UserEntry{const_cast<Instruction*>(def), nullptr});
+bool DefUseManager::LinkUse(UseList* list, Use* use) {
+  const uint32_t user_id = use->user->unique_id();
+  // Find the last use whose user is not newer.  Unless |use| goes at the end,
+  // the search starts at the use linked last, and may go either way.
+  Use* prev = list->last;
+  if (prev && user_id < prev->user->unique_id()) {
+    prev = list->hint;
+    while (prev->next && prev->next->user->unique_id() <= user_id) {
+      prev = prev->next;
+    }
+    while (prev && user_id < prev->user->unique_id()) prev = prev->prev;
+  }
+  if (prev && prev->user == use->user) return false;
+
+  Use* next = prev ? prev->next : list->first;
+  use->list = list;
+  use->prev = prev;
+  use->next = next;
+  (prev ? prev->next : list->first) = use;
+  (next ? next->prev : list->last) = use;
+  list->hint = use;
+  return true;
 }
 
-bool DefUseManager::UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                                const IdToUsersMap::const_iterator& cached_end,
-                                const Instruction* inst) const {
-  return (iter != cached_end && iter->def == inst);
+void DefUseManager::UnlinkUse(Use* use) {
+  UseList* list = use->list;
+  if (!list) return;
+  if (list->hint == use) list->hint = use->prev ? use->prev : use->next;
+  (use->prev ? use->prev->next : list->first) = use->next;
+  (use->next ? use->next->prev : list->last) = use->prev;
+  use->list = nullptr;
+  use->prev = nullptr;
+  use->next = nullptr;
 }
 
-bool DefUseManager::UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                                const Instruction* inst) const {
-  return UsersNotEnd(iter, id_to_users_.end(), inst);
+const DefUseManager::UseList* DefUseManager::GetUsers(
+    const Instruction* def) const {
+  const auto iter = inst_to_records_.find(def);
+  if (iter == inst_to_records_.end()) return nullptr;
+  return &iter->second.users;
+}
+
+void DefUseManager::EraseUses(InstRecords* records) {
+  for (Use& use : records->uses) UnlinkUse(&use);
+  records->uses.clear();
+  records->analyzed = false;
 }
 
 bool DefUseManager::WhileEachUser(
@@ -118,9 +152,13 @@ bool DefUseManager::WhileEachUser(
          "Definition is not registered.");
   if (!def->HasResultId()) return true;
 
-  auto end = id_to_users_.end();
-  for (auto iter = UsersBegin(def); UsersNotEnd(iter, end, def); ++iter) {
-    if (!f(iter->user)) return false;
+  const UseList* users = GetUsers(def);
+  if (!users) return true;
+  for (const Use* use = users->first; use;) {
+    // Move on first, in case |f| analyzes the user again.
+    const Use* next = use->next;
+    if (!f(use->user)) return false;
+    use = next;
   }
   return true;
 }
@@ -151,9 +189,12 @@ bool DefUseManager::WhileEachUse(
          "Definition is not registered.");
   if (!def->HasResultId()) return true;
 
-  auto end = id_to_users_.end();
-  for (auto iter = UsersBegin(def); UsersNotEnd(iter, end, def); ++iter) {
-    Instruction* user = iter->user;
+  const UseList* users = GetUsers(def);
+  if (!users) return true;
+  for (const Use* use = users->first; use;) {
+    // Move on first, in case |f| analyzes the user again.
+    const Use* next = use->next;
+    Instruction* user = use->user;
     for (uint32_t idx = 0; idx != user->NumOperands(); ++idx) {
       const Operand& op = user->GetOperand(idx);
       if (op.type != SPV_OPERAND_TYPE_RESULT_ID && spvIsIdType(op.type)) {
@@ -162,6 +203,7 @@ bool DefUseManager::WhileEachUse(
         }
       }
     }
+    use = next;
   }
   return true;
 }
@@ -230,33 +272,36 @@ void DefUseManager::AnalyzeDefUse(Module* module) {
 }
 
 void DefUseManager::ClearInst(Instruction* inst) {
-  auto iter = inst_to_used_ids_.find(inst);
-  if (iter != inst_to_used_ids_.end()) {
-    EraseUseRecordsOfOperandIds(inst);
-    if (inst->result_id() != 0) {
-      // Remove all uses of this inst.
-      auto users_begin = UsersBegin(inst);
-      auto end = id_to_users_.end();
-      auto new_end = users_begin;
-      for (; UsersNotEnd(new_end, end, inst); ++new_end) {
-      }
-      id_to_users_.erase(users_begin, new_end);
-      id_to_def_.erase(inst->result_id());
+  auto iter = inst_to_records_.find(inst);
+  if (iter == inst_to_records_.end() || !iter->second.analyzed) return;
+
+  InstRecords& records = iter->second;
+  EraseUses(&records);
+  if (inst->result_id() != 0) {
+    // Remove all uses of this inst.  The records belong to the users, which
+    // drop them when they are analyzed again.
+    for (Use* use = records.users.first; use;) {
+      Use* next = use->next;
+      use->list = nullptr;
+      use->prev = nullptr;
+      use->next = nullptr;
+      use = next;
     }
+    records.users = UseList();
+    id_to_def_.erase(inst->result_id());
   }
+  if (!records.users.first) inst_to_records_.erase(iter);
 }
 
 void DefUseManager::EraseUseRecordsOfOperandIds(const Instruction* inst) {
   // Go through all ids used by this instruction, remove this instruction's
   // uses of them.
-  auto iter = inst_to_used_ids_.find(inst);
-  if (iter != inst_to_used_ids_.end()) {
-    for (auto use_id : iter->second) {
-      id_to_users_.erase(
-          UserEntry{GetDef(use_id), const_cast<Instruction*>(inst)});
-    }
-    inst_to_used_ids_.erase(iter);
-  }
+  auto iter = inst_to_records_.find(inst);
+  if (iter == inst_to_records_.end() || !iter->second.analyzed) return;
+
+  EraseUses(&iter->second);
+  // Keep the records of the users of |inst|.
+  if (!iter->second.users.first) inst_to_records_.erase(iter);
 }
 
 bool CompareAndPrintDifferences(const DefUseManager& lhs,
@@ -277,34 +322,52 @@ bool CompareAndPrintDifferences(const DefUseManager& lhs,
     same = false;
   }
 
-  if (lhs.id_to_users_ != rhs.id_to_users_) {
-    for (auto p : lhs.id_to_users_) {
-      if (rhs.id_to_users_.count(p) == 0) {
-        printf("Diff in id_to_users: missing value in rhs\n");
+  // Returns the users of |def| in |mgr|.
+  const auto users_of = [](const DefUseManager& mgr, const Instruction* def) {
+    std::vector<const Instruction*> users;
+    if (const DefUseManager::UseList* list = mgr.GetUsers(def)) {
+      for (const auto* use = list->first; use; use = use->next) {
+        users.push_back(use->user);
       }
     }
-    for (auto p : rhs.id_to_users_) {
-      if (lhs.id_to_users_.count(p) == 0) {
-        printf("Diff in id_to_users: missing value in lhs\n");
+    return users;
+  };
+  // Returns the definitions used by |inst| in |mgr|, with a null entry at
+  // the end if |inst| was analyzed.
+  const auto uses_of = [](const DefUseManager& mgr, const Instruction* inst) {
+    std::vector<const Instruction*> defs;
+    const auto iter = mgr.inst_to_records_.find(inst);
+    if (iter != mgr.inst_to_records_.end() && iter->second.analyzed) {
+      for (const auto& use : iter->second.uses) {
+        if (use.list) defs.push_back(use.def);
       }
+      defs.push_back(nullptr);
     }
-    same = false;
-  }
+    return defs;
+  };
 
-  if (lhs.inst_to_used_ids_ != rhs.inst_to_used_ids_) {
-    for (auto p : lhs.inst_to_used_ids_) {
-      if (rhs.inst_to_used_ids_.count(p.first) == 0) {
-        printf("Diff in inst_to_used_ids: missing value in rhs\n");
-      }
+  for (const auto& p : lhs.inst_to_records_) {
+    if (users_of(lhs, p.first) != users_of(rhs, p.first)) {
+      printf("Diff in users: different users in rhs\n");
+      same = false;
     }
-    for (auto p : rhs.inst_to_used_ids_) {
-      if (lhs.inst_to_used_ids_.count(p.first) == 0) {
-        printf("Diff in inst_to_used_ids: missing value in lhs\n");
+    if (uses_of(lhs, p.first) != uses_of(rhs, p.first)) {
+      printf("Diff in uses: different uses in rhs\n");
+      same = false;
+    }
+  }
+  for (const auto& p : rhs.inst_to_records_) {
+    if (lhs.inst_to_records_.count(p.first) == 0) {
+      if (p.second.users.first) {
+        printf("Diff in users: missing value in lhs\n");
+        same = false;
+      }
+      if (p.second.analyzed) {
+        printf("Diff in uses: missing value in lhs\n");
+        same = false;
       }
     }
-    same = false;
   }
-
   return same;
 }
 
@@ -15,66 +15,22 @@
 #ifndef SOURCE_OPT_DEF_USE_MANAGER_H_
 #define SOURCE_OPT_DEF_USE_MANAGER_H_
 
-#include <set>
 #include <unordered_map>
 #include <vector>
 
 #include "source/opt/instruction.h"
 #include "source/opt/module.h"
+#include "source/util/id_map.h"
 #include "spirv-tools/libspirv.hpp"
 
 namespace spvtools {
 namespace opt {
 namespace analysis {
 
-// Definition should never be null. User can be null, however, such an entry
-// should be used only for searching (e.g. all users of a particular definition)
-// and never stored in a container.
-struct UserEntry {
-  Instruction* def;
-  Instruction* user;
-};
-
-inline bool operator==(const UserEntry& lhs, const UserEntry& rhs) {
-  return lhs.def == rhs.def && lhs.user == rhs.user;
-}
-
-// Orders UserEntry for use in associative containers (i.e. less than ordering).
-//
-// The definition of an UserEntry is treated as the major key and the users as
-// the minor key so that all the users of a particular definition are
-// consecutive in a container.
-//
-// A null user always compares less than a real user. This is done to provide
-// easy values to search for the beginning of the users of a particular
-// definition (i.e. using {def, nullptr}).
-struct UserEntryLess {
-  bool operator()(const UserEntry& lhs, const UserEntry& rhs) const {
-    // If lhs.def and rhs.def are both null, fall through to checking the
-    // second entries.
-    if (!lhs.def && rhs.def) return true;
-    if (lhs.def && !rhs.def) return false;
-
-    // If neither definition is null, then compare unique ids.
-    if (lhs.def && rhs.def) {
-      if (lhs.def->unique_id() < rhs.def->unique_id()) return true;
-      if (rhs.def->unique_id() < lhs.def->unique_id()) return false;
-    }
-
-    // Return false on equality.
-    if (!lhs.user && !rhs.user) return false;
-    if (!lhs.user) return true;
-    if (!rhs.user) return false;
-
-    // If neither user is null then compare unique ids.
-    return lhs.user->unique_id() < rhs.user->unique_id();
-  }
-};
-
 // A class for analyzing and managing defs and uses in an Module.
 class DefUseManager {
  public:
-  using IdToDefMap = std::unordered_map<uint32_t, Instruction*>;
+  using IdToDefMap = utils::IdMap<Instruction*>;
 
   // Constructs a def-use manager from the given |module|. All internal messages
   // will be communicated to the outside via the given message |consumer|. This
@@ -193,34 +149,70 @@ class DefUseManager {
   void UpdateDefUse(Instruction* inst);
 
  private:
-  using IdToUsersMap = std::set<UserEntry, UserEntryLess>;
-  using InstToUsedIdsMap =
-      std::unordered_map<const Instruction*, std::vector<uint32_t>>;
-
-  // Returns the first location that {|def|, nullptr} could be inserted into the
-  // users map without violating ordering.
-  IdToUsersMap::const_iterator UsersBegin(const Instruction* def) const;
-
-  // Returns true if |iter| has not reached the end of |def|'s users.
-  //
-  // In the first version |iter| is compared against the end of the map for
-  // validity before other checks. In the second version, |iter| is compared
-  // against |cached_end| for validity before other checks. This allows caching
-  // the map's end which is a performance improvement on some platforms.
-  bool UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                   const Instruction* def) const;
-  bool UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                   const IdToUsersMap::const_iterator& cached_end,
-                   const Instruction* def) const;
+  struct UseList;
+
+  // The record that |user| uses the result id of |def|.  An instruction that
+  // uses an id in several operands has a single record for it.
+  struct Use {
+    Instruction* def;
+    Instruction* user;
+    // The list of the users of |def| that holds this record, or null once
+    // |def| is cleared.
+    UseList* list;
+    Use* prev;
+    Use* next;
+  };
+
+  // An intrusive doubly linked list of the uses of a definition, ordered by
+  // the unique ids of the users.
+  struct UseList {
+    Use* first = nullptr;
+    Use* last = nullptr;
+    // The use linked last, or a neighbour of it if it was unlinked since.
+    Use* hint = nullptr;
+  };
+
+  // The def-use records of an instruction.
+  struct InstRecords {
+    // The uses of the result id of the instruction.
+    UseList users;
+    // The uses of the operand ids of the instruction, one per used
+    // definition.  The records are linked into the lists of the definitions,
+    // so the vector never grows once they are.
+    std::vector<Use> uses;
+    // Whether the uses of the instruction were analyzed.
+    bool analyzed = false;
+  };
+
+  using InstToRecordsMap =
+      std::unordered_map<const Instruction*, InstRecords>;
+
+  // Links |use| into |list|, after the last use whose user has a smaller
+  // unique id.  This is constant time when the user is newer than the other
+  // users, which is the case while a module is analyzed in order.
+  // Otherwise, the position is searched from the use linked last, so that
+  // linking users in increasing order, as ReplaceAllUsesWith does, takes
+  // time linear in the length of |list| overall, not for each user.
+  // Returns false, and leaves |use| unlinked, if |list| already has a use by
+  // the same user.
+  static bool LinkUse(UseList* list, Use* use);
+
+  // Unlinks |use| from the list of the users of its definition.
+  static void UnlinkUse(Use* use);
+
+  // Returns the list of the users of |def|, or null if it has none.
+  const UseList* GetUsers(const Instruction* def) const;
+
+  // Unlinks and clears the records of the uses in |records|.
+  void EraseUses(InstRecords* records);
 
   // Analyzes the defs and uses in the given |module| and populates data
   // structures in this class. Does nothing if |module| is nullptr.
   void AnalyzeDefUse(Module* module);
 
-  IdToDefMap id_to_def_;      // Mapping from ids to their definitions
-  IdToUsersMap id_to_users_;  // Mapping from ids to their users
-  // Mapping from instructions to the ids used in the instruction.
-  InstToUsedIdsMap inst_to_used_ids_;
+  IdToDefMap id_to_def_;  // Mapping from ids to their definitions
+  // Mapping from instructions to their def-use records.
+  InstToRecordsMap inst_to_records_;
 };
 
 }  // namespace analysis
@@ -223,8 +223,8 @@ bool IsValidTypeForComponentWiseOperation(const analysis::Type* type) {
 // the given target type.
 //
 // Note: type |type| argument must be either Integer or Bool.
-utils::SmallVector<uint32_t, 2> EncodeIntegerAsWords(const analysis::Type& type,
-                                                     uint32_t value) {
+Operand::OperandData EncodeIntegerAsWords(const analysis::Type& type,
+                                          uint32_t value) {
   const uint32_t all_ones = ~0;
   uint32_t bit_width = 0;
   uint32_t pad_value = 0;
@@ -250,7 +250,7 @@ utils::SmallVector<uint32_t, 2> EncodeIntegerAsWords(const analysis::Type& type,
     first_word = utils::SignExtendValue(first_word, bit_width);
   }
 
-  utils::SmallVector<uint32_t, 2> words = {first_word};
+  Operand::OperandData words = {first_word};
   for (uint32_t current_bit = bits_per_word; current_bit < bit_width;
        current_bit += bits_per_word) {
     words.push_back(pad_value);
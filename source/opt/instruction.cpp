@@ -52,6 +52,7 @@ Instruction::Instruction(IRContext* c)
       has_type_id_(false),
       has_result_id_(false),
       unique_id_(c->TakeNextUniqueId()),
+      operands_(OperandStorage::allocator_type(c->slab_allocator())),
       dbg_scope_(kNoDebugScope, kNoInlinedAt) {}
 
 Instruction::Instruction(IRContext* c, spv::Op op)
@@ -61,6 +62,7 @@ Instruction::Instruction(IRContext* c, spv::Op op)
       has_type_id_(false),
       has_result_id_(false),
       unique_id_(c->TakeNextUniqueId()),
+      operands_(OperandStorage::allocator_type(c->slab_allocator())),
       dbg_scope_(kNoDebugScope, kNoInlinedAt) {}
 
 Instruction::Instruction(IRContext* c, const spv_parsed_instruction_t& inst,
@@ -71,6 +73,7 @@ Instruction::Instruction(IRContext* c, const spv_parsed_instruction_t& inst,
       has_type_id_(inst.type_id != 0),
       has_result_id_(inst.result_id != 0),
       unique_id_(c->TakeNextUniqueId()),
+      operands_(OperandStorage::allocator_type(c->slab_allocator())),
       dbg_line_insts_(std::move(dbg_line)),
       dbg_scope_(kNoDebugScope, kNoInlinedAt) {
   operands_.reserve(inst.num_operands);
@@ -92,6 +95,7 @@ Instruction::Instruction(IRContext* c, const spv_parsed_instruction_t& inst,
       has_type_id_(inst.type_id != 0),
       has_result_id_(inst.result_id != 0),
       unique_id_(c->TakeNextUniqueId()),
+      operands_(OperandStorage::allocator_type(c->slab_allocator())),
       dbg_scope_(dbg_scope) {
   operands_.reserve(inst.num_operands);
   for (uint32_t i = 0; i < inst.num_operands; ++i) {
@@ -110,7 +114,7 @@ Instruction::Instruction(IRContext* c, spv::Op op, uint32_t ty_id,
       has_type_id_(ty_id != 0),
       has_result_id_(res_id != 0),
       unique_id_(c->TakeNextUniqueId()),
-      operands_(),
+      operands_(OperandStorage::allocator_type(c->slab_allocator())),
       dbg_scope_(kNoDebugScope, kNoInlinedAt) {
   size_t operands_size = in_operands.size();
   if (has_type_id_) {
@@ -158,8 +162,13 @@ Instruction& Instruction::operator=(Instruction&& that) {
   return *this;
 }
 
+void* Instruction::operator new(size_t size, IRContext* context) {
+  return utils::SlabAllocator::Allocate(
+      context ? context->slab_allocator() : nullptr, size);
+}
+
 Instruction* Instruction::Clone(IRContext* c) const {
-  Instruction* clone = new Instruction(c);
+  Instruction* clone = new (c) Instruction(c);
   clone->opcode_ = opcode_;
   clone->has_type_id_ = has_type_id_;
   clone->has_result_id_ = has_result_id_;
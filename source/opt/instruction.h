@@ -32,6 +32,7 @@
 #include "source/operand.h"
 #include "source/opt/reflect.h"
 #include "source/util/ilist_node.h"
+#include "source/util/slab_allocator.h"
 #include "source/util/small_vector.h"
 #include "source/util/string_utils.h"
 #include "spirv-tools/libspirv.h"
@@ -77,8 +78,15 @@ class InstructionList;
 
 // A *logical* operand to a SPIR-V instruction. It can be the type id, result
 // id, or other additional operands carried in an instruction.
+//
+// The words that do not fit in the operand itself come from the slabs of the
+// allocator the operand is constructed with.  The operands of an instruction
+// are constructed with the allocator of its context (see std::uses_allocator).
 struct Operand {
-  using OperandData = utils::SmallVector<uint32_t, 2>;
+  using OperandData =
+      utils::SmallVector<uint32_t, 2, utils::SlabStlAllocator<uint32_t>>;
+  using allocator_type = OperandData::allocator_type;
+
   Operand(spv_operand_type_t t, OperandData&& w)
       : type(t), words(std::move(w)) {}
 
@@ -89,6 +97,26 @@ struct Operand {
           InputIt lastOperandData)
       : type(t), words(firstOperandData, lastOperandData) {}
 
+  // The constructors above, with the allocator of the words.
+  Operand(std::allocator_arg_t, const allocator_type& a, spv_operand_type_t t,
+          OperandData&& w)
+      : type(t), words(std::move(w), a) {}
+
+  Operand(std::allocator_arg_t, const allocator_type& a, spv_operand_type_t t,
+          const OperandData& w)
+      : type(t), words(w, a) {}
+
+  template <class InputIt>
+  Operand(std::allocator_arg_t, const allocator_type& a, spv_operand_type_t t,
+          InputIt firstOperandData, InputIt lastOperandData)
+      : type(t), words(firstOperandData, lastOperandData, a) {}
+
+  Operand(std::allocator_arg_t, const allocator_type& a, const Operand& that)
+      : type(that.type), words(that.words, a) {}
+
+  Operand(std::allocator_arg_t, const allocator_type& a, Operand&& that)
+      : type(that.type), words(std::move(that.words), a) {}
+
   spv_operand_type_t type;  // Type of this logical operand.
   OperandData words;        // Binary segments of this logical operand.
 
@@ -182,8 +210,10 @@ class DebugScope {
 class Instruction : public utils::IntrusiveNodeBase<Instruction> {
  public:
   using OperandList = std::vector<Operand>;
-  using iterator = OperandList::iterator;
-  using const_iterator = OperandList::const_iterator;
+  // The operands of an instruction, allocated from the slabs of its context.
+  using OperandStorage = std::vector<Operand, utils::SlabStlAllocator<Operand>>;
+  using iterator = OperandStorage::iterator;
+  using const_iterator = OperandStorage::const_iterator;
 
   // Creates a default OpNop instruction.
   // This exists solely for containers that can't do without. Should be removed.
@@ -226,6 +256,19 @@ class Instruction : public utils::IntrusiveNodeBase<Instruction> {
 
   ~Instruction() override = default;
 
+  // Instructions are allocated by utils::SlabAllocator.  "new (context)
+  // Instruction(...)" allocates the instruction out of the slabs of
+  // |context|, while a plain "new" allocates it from the heap.  Either way,
+  // "delete" frees it.
+  static void* operator new(size_t size) {
+    return utils::SlabAllocator::Allocate(nullptr, size);
+  }
+  static void* operator new(size_t size, IRContext* context);
+  static void operator delete(void* inst) { utils::SlabAllocator::Free(inst); }
+  static void operator delete(void* inst, IRContext*) {
+    utils::SlabAllocator::Free(inst);
+  }
+
   // Returns a newly allocated instruction that has the same operands, result,
   // and type as |this|.  The new instruction is not linked into any list.
   // It is the responsibility of the caller to make sure that the storage is
@@ -636,7 +679,7 @@ class Instruction : public utils::IntrusiveNodeBase<Instruction> {
   bool has_result_id_;  // True if the instruction has a result id
   uint32_t unique_id_;  // Unique instruction id
   // All logical operands, including result type id and result id.
-  OperandList operands_;
+  OperandStorage operands_;
   // Op[No]Line or Debug[No]Line instructions preceding this instruction. Note
   // that for Instructions representing Op[No]Line or Debug[No]Line themselves,
   // this field should be empty.
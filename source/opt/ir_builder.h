@@ -66,8 +66,8 @@ class InstructionBuilder {
         return nullptr;
       }
     }
-    std::unique_ptr<Instruction> new_inst(
-        new Instruction(GetContext(), opcode, type_id, result_id, {}));
+    std::unique_ptr<Instruction> new_inst(new (GetContext()) Instruction(
+        GetContext(), opcode, type_id, result_id, {}));
     return AddInstruction(std::move(new_inst));
   }
 
@@ -79,7 +79,7 @@ class InstructionBuilder {
         return nullptr;
       }
     }
-    std::unique_ptr<Instruction> newUnOp(new Instruction(
+    std::unique_ptr<Instruction> newUnOp(new (GetContext()) Instruction(
         GetContext(), opcode, type_id, result_id,
         {{spv_operand_type_t::SPV_OPERAND_TYPE_ID, {operand1}}}));
     return AddInstruction(std::move(newUnOp));
@@ -94,7 +94,7 @@ class InstructionBuilder {
         return nullptr;
       }
     }
-    std::unique_ptr<Instruction> newBinOp(new Instruction(
+    std::unique_ptr<Instruction> newBinOp(new (GetContext()) Instruction(
         GetContext(), opcode, type_id,
         opcode == spv::Op::OpStore ? 0 : result_id,
         {{spv_operand_type_t::SPV_OPERAND_TYPE_ID, {operand1}},
@@ -111,7 +111,7 @@ class InstructionBuilder {
         return nullptr;
       }
     }
-    std::unique_ptr<Instruction> newTernOp(new Instruction(
+    std::unique_ptr<Instruction> newTernOp(new (GetContext()) Instruction(
         GetContext(), opcode, type_id, result_id,
         {{spv_operand_type_t::SPV_OPERAND_TYPE_ID, {operand1}},
          {spv_operand_type_t::SPV_OPERAND_TYPE_ID, {operand2}},
@@ -129,7 +129,7 @@ class InstructionBuilder {
         return nullptr;
       }
     }
-    std::unique_ptr<Instruction> newQuadOp(new Instruction(
+    std::unique_ptr<Instruction> newQuadOp(new (GetContext()) Instruction(
         GetContext(), opcode, type_id, result_id,
         {{spv_operand_type_t::SPV_OPERAND_TYPE_ID, {operand1}},
          {spv_operand_type_t::SPV_OPERAND_TYPE_ID, {operand2}},
@@ -147,7 +147,7 @@ class InstructionBuilder {
         return nullptr;
       }
     }
-    std::unique_ptr<Instruction> newBinOp(new Instruction(
+    std::unique_ptr<Instruction> newBinOp(new (GetContext()) Instruction(
         GetContext(), opcode, type_id, result_id,
         {{spv_operand_type_t::SPV_OPERAND_TYPE_ID, {id}},
          {spv_operand_type_t::SPV_OPERAND_TYPE_LITERAL_INTEGER, {uliteral}}}));
@@ -166,7 +166,7 @@ class InstructionBuilder {
       ops.push_back({SPV_OPERAND_TYPE_ID, {operands[i]}});
     }
     // TODO(1841): Handle id overflow.
-    std::unique_ptr<Instruction> new_inst(new Instruction(
+    std::unique_ptr<Instruction> new_inst(new (GetContext()) Instruction(
         GetContext(), opcode, type_id,
         result != 0 ? result : GetContext()->TakeNextId(), ops));
     return AddInstruction(std::move(new_inst));
@@ -177,11 +177,12 @@ class InstructionBuilder {
   Instruction* AddSelectionMerge(
       uint32_t merge_id, uint32_t selection_control = static_cast<uint32_t>(
                              spv::SelectionControlMask::MaskNone)) {
-    std::unique_ptr<Instruction> new_branch_merge(new Instruction(
-        GetContext(), spv::Op::OpSelectionMerge, 0, 0,
-        {{spv_operand_type_t::SPV_OPERAND_TYPE_ID, {merge_id}},
-         {spv_operand_type_t::SPV_OPERAND_TYPE_SELECTION_CONTROL,
-          {selection_control}}}));
+    std::unique_ptr<Instruction> new_branch_merge(
+        new (GetContext()) Instruction(
+            GetContext(), spv::Op::OpSelectionMerge, 0, 0,
+            {{spv_operand_type_t::SPV_OPERAND_TYPE_ID, {merge_id}},
+             {spv_operand_type_t::SPV_OPERAND_TYPE_SELECTION_CONTROL,
+              {selection_control}}}));
     return AddInstruction(std::move(new_branch_merge));
   }
 
@@ -192,11 +193,13 @@ class InstructionBuilder {
   Instruction* AddLoopMerge(uint32_t merge_id, uint32_t continue_id,
                             uint32_t loop_control = static_cast<uint32_t>(
                                 spv::LoopControlMask::MaskNone)) {
-    std::unique_ptr<Instruction> new_branch_merge(new Instruction(
-        GetContext(), spv::Op::OpLoopMerge, 0, 0,
-        {{spv_operand_type_t::SPV_OPERAND_TYPE_ID, {merge_id}},
-         {spv_operand_type_t::SPV_OPERAND_TYPE_ID, {continue_id}},
-         {spv_operand_type_t::SPV_OPERAND_TYPE_LOOP_CONTROL, {loop_control}}}));
+    std::unique_ptr<Instruction> new_branch_merge(
+        new (GetContext()) Instruction(
+            GetContext(), spv::Op::OpLoopMerge, 0, 0,
+            {{spv_operand_type_t::SPV_OPERAND_TYPE_ID, {merge_id}},
+             {spv_operand_type_t::SPV_OPERAND_TYPE_ID, {continue_id}},
+             {spv_operand_type_t::SPV_OPERAND_TYPE_LOOP_CONTROL,
+              {loop_control}}}));
     return AddInstruction(std::move(new_branch_merge));
   }
 
@@ -204,7 +207,7 @@ class InstructionBuilder {
   // Note that the user must make sure the final basic block is
   // well formed.
   Instruction* AddBranch(uint32_t label_id) {
-    std::unique_ptr<Instruction> new_branch(new Instruction(
+    std::unique_ptr<Instruction> new_branch(new (GetContext()) Instruction(
         GetContext(), spv::Op::OpBranch, 0, 0,
         {{spv_operand_type_t::SPV_OPERAND_TYPE_ID, {label_id}}}));
     return AddInstruction(std::move(new_branch));
@@ -233,7 +236,7 @@ class InstructionBuilder {
     if (merge_id != kInvalidId) {
       AddSelectionMerge(merge_id, selection_control);
     }
-    std::unique_ptr<Instruction> new_branch(new Instruction(
+    std::unique_ptr<Instruction> new_branch(new (GetContext()) Instruction(
         GetContext(), spv::Op::OpBranchConditional, 0, 0,
         {{spv_operand_type_t::SPV_OPERAND_TYPE_ID, {cond_id}},
          {spv_operand_type_t::SPV_OPERAND_TYPE_ID, {true_id}},
@@ -275,8 +278,8 @@ class InstructionBuilder {
       operands.emplace_back(
           Operand{spv_operand_type_t::SPV_OPERAND_TYPE_ID, {target.second}});
     }
-    std::unique_ptr<Instruction> new_switch(
-        new Instruction(GetContext(), spv::Op::OpSwitch, 0, 0, operands));
+    std::unique_ptr<Instruction> new_switch(new (GetContext()) Instruction(
+        GetContext(), spv::Op::OpSwitch, 0, 0, operands));
     return AddInstruction(std::move(new_switch));
   }
 
@@ -297,7 +300,7 @@ class InstructionBuilder {
   // The id |op2| is the right hand side of the operation.
   Instruction* AddIAdd(uint32_t type, uint32_t op1, uint32_t op2) {
     // TODO(1841): Handle id overflow.
-    std::unique_ptr<Instruction> inst(new Instruction(
+    std::unique_ptr<Instruction> inst(new (GetContext()) Instruction(
         GetContext(), spv::Op::OpIAdd, type, GetContext()->TakeNextId(),
         {{SPV_OPERAND_TYPE_ID, {op1}}, {SPV_OPERAND_TYPE_ID, {op2}}}));
     return AddInstruction(std::move(inst));
@@ -311,7 +314,7 @@ class InstructionBuilder {
     analysis::Bool bool_type;
     uint32_t type = GetContext()->get_type_mgr()->GetId(&bool_type);
     // TODO(1841): Handle id overflow.
-    std::unique_ptr<Instruction> inst(new Instruction(
+    std::unique_ptr<Instruction> inst(new (GetContext()) Instruction(
         GetContext(), spv::Op::OpULessThan, type, GetContext()->TakeNextId(),
         {{SPV_OPERAND_TYPE_ID, {op1}}, {SPV_OPERAND_TYPE_ID, {op2}}}));
     return AddInstruction(std::move(inst));
@@ -325,7 +328,7 @@ class InstructionBuilder {
     analysis::Bool bool_type;
     uint32_t type = GetContext()->get_type_mgr()->GetId(&bool_type);
     // TODO(1841): Handle id overflow.
-    std::unique_ptr<Instruction> inst(new Instruction(
+    std::unique_ptr<Instruction> inst(new (GetContext()) Instruction(
         GetContext(), spv::Op::OpSLessThan, type, GetContext()->TakeNextId(),
         {{SPV_OPERAND_TYPE_ID, {op1}}, {SPV_OPERAND_TYPE_ID, {op2}}}));
     return AddInstruction(std::move(inst));
@@ -355,7 +358,7 @@ class InstructionBuilder {
   Instruction* AddSelect(uint32_t type, uint32_t cond, uint32_t true_value,
                          uint32_t false_value) {
     // TODO(1841): Handle id overflow.
-    std::unique_ptr<Instruction> select(new Instruction(
+    std::unique_ptr<Instruction> select(new (GetContext()) Instruction(
         GetContext(), spv::Op::OpSelect, type, GetContext()->TakeNextId(),
         std::initializer_list<Operand>{{SPV_OPERAND_TYPE_ID, {cond}},
                                        {SPV_OPERAND_TYPE_ID, {true_value}},
@@ -381,9 +384,9 @@ class InstructionBuilder {
                        std::initializer_list<uint32_t>{id});
     }
     // TODO(1841): Handle id overflow.
-    std::unique_ptr<Instruction> construct(
-        new Instruction(GetContext(), spv::Op::OpCompositeConstruct, type,
-                        GetContext()->TakeNextId(), ops));
+    std::unique_ptr<Instruction> construct(new (GetContext()) Instruction(
+        GetContext(), spv::Op::OpCompositeConstruct, type,
+        GetContext()->TakeNextId(), ops));
     return AddInstruction(std::move(construct));
   }
 
@@ -466,17 +469,17 @@ class InstructionBuilder {
     }
 
     // TODO(1841): Handle id overflow.
-    std::unique_ptr<Instruction> new_inst(
-        new Instruction(GetContext(), spv::Op::OpCompositeExtract, type,
-                        GetContext()->TakeNextId(), operands));
+    std::unique_ptr<Instruction> new_inst(new (GetContext()) Instruction(
+        GetContext(), spv::Op::OpCompositeExtract, type,
+        GetContext()->TakeNextId(), operands));
     return AddInstruction(std::move(new_inst));
   }
 
   // Creates an unreachable instruction.
   Instruction* AddUnreachable() {
-    std::unique_ptr<Instruction> select(
-        new Instruction(GetContext(), spv::Op::OpUnreachable, 0, 0,
-                        std::initializer_list<Operand>{}));
+    std::unique_ptr<Instruction> select(new (GetContext()) Instruction(
+        GetContext(), spv::Op::OpUnreachable, 0, 0,
+        std::initializer_list<Operand>{}));
     return AddInstruction(std::move(select));
   }
 
@@ -490,9 +493,9 @@ class InstructionBuilder {
     }
 
     // TODO(1841): Handle id overflow.
-    std::unique_ptr<Instruction> new_inst(
-        new Instruction(GetContext(), spv::Op::OpAccessChain, type_id,
-                        GetContext()->TakeNextId(), operands));
+    std::unique_ptr<Instruction> new_inst(new (GetContext()) Instruction(
+        GetContext(), spv::Op::OpAccessChain, type_id,
+        GetContext()->TakeNextId(), operands));
     return AddInstruction(std::move(new_inst));
   }
 
@@ -508,18 +511,18 @@ class InstructionBuilder {
     }
 
     // TODO(1841): Handle id overflow.
-    std::unique_ptr<Instruction> new_inst(
-        new Instruction(GetContext(), spv::Op::OpLoad, type_id,
-                        GetContext()->TakeNextId(), operands));
+    std::unique_ptr<Instruction> new_inst(new (GetContext()) Instruction(
+        GetContext(), spv::Op::OpLoad, type_id,
+        GetContext()->TakeNextId(), operands));
     return AddInstruction(std::move(new_inst));
   }
 
   Instruction* AddVariable(uint32_t type_id, uint32_t storage_class) {
     std::vector<Operand> operands;
     operands.push_back({SPV_OPERAND_TYPE_ID, {storage_class}});
-    std::unique_ptr<Instruction> new_inst(
-        new Instruction(GetContext(), spv::Op::OpVariable, type_id,
-                        GetContext()->TakeNextId(), operands));
+    std::unique_ptr<Instruction> new_inst(new (GetContext()) Instruction(
+        GetContext(), spv::Op::OpVariable, type_id,
+        GetContext()->TakeNextId(), operands));
     return AddInstruction(std::move(new_inst));
   }
 
@@ -528,8 +531,8 @@ class InstructionBuilder {
     operands.push_back({SPV_OPERAND_TYPE_ID, {ptr_id}});
     operands.push_back({SPV_OPERAND_TYPE_ID, {obj_id}});
 
-    std::unique_ptr<Instruction> new_inst(
-        new Instruction(GetContext(), spv::Op::OpStore, 0, 0, operands));
+    std::unique_ptr<Instruction> new_inst(new (GetContext()) Instruction(
+        GetContext(), spv::Op::OpStore, 0, 0, operands));
     return AddInstruction(std::move(new_inst));
   }
 
@@ -545,9 +548,9 @@ class InstructionBuilder {
     if (result_id == 0) {
       return nullptr;
     }
-    std::unique_ptr<Instruction> new_inst(
-        new Instruction(GetContext(), spv::Op::OpFunctionCall, result_type,
-                        result_id, operands));
+    std::unique_ptr<Instruction> new_inst(new (GetContext()) Instruction(
+        GetContext(), spv::Op::OpFunctionCall, result_type, result_id,
+        operands));
     return AddInstruction(std::move(new_inst));
   }
 
@@ -566,9 +569,9 @@ class InstructionBuilder {
       return nullptr;
     }
 
-    std::unique_ptr<Instruction> new_inst(
-        new Instruction(GetContext(), spv::Op::OpVectorShuffle, result_type,
-                        result_id, operands));
+    std::unique_ptr<Instruction> new_inst(new (GetContext()) Instruction(
+        GetContext(), spv::Op::OpVectorShuffle, result_type, result_id,
+        operands));
     return AddInstruction(std::move(new_inst));
   }
 
@@ -588,7 +591,7 @@ class InstructionBuilder {
       return nullptr;
     }
 
-    std::unique_ptr<Instruction> new_inst(new Instruction(
+    std::unique_ptr<Instruction> new_inst(new (GetContext()) Instruction(
         GetContext(), spv::Op::OpExtInst, result_type, result_id, operands));
     return AddInstruction(std::move(new_inst));
   }
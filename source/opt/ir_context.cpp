@@ -99,7 +99,62 @@ void IRContext::InvalidateAnalysesExceptFor(
   InvalidateAnalyses(static_cast<IRContext::Analysis>(analyses_to_invalidate));
 }
 
+void IRContext::InvalidateAnalysesExceptFor(
+    IRContext::Analysis preserved_analyses,
+    const std::unordered_set<const Function*>& modified_functions) {
+  for (const Function* f : modified_functions) {
+    InvalidateFunctionAnalyses(f);
+  }
+  ForgetRemovedFunctions();
+
+  // The per-function analyses of the other functions are still valid, even if
+  // the CFG is not: it is rebuilt in place.
+  uint32_t analyses_to_invalidate =
+      valid_analyses_ &
+      ~(preserved_analyses | kAnalysisDominatorAnalysis |
+        kAnalysisLoopAnalysis | kAnalysisStructuredCFG);
+  ResetAnalyses(static_cast<IRContext::Analysis>(analyses_to_invalidate));
+}
+
 void IRContext::InvalidateAnalyses(IRContext::Analysis analyses_to_invalidate) {
+  // If the CFG change the dominators many changed as well, so the dominator
+  // analysis should be invalidated as well.
+  if (analyses_to_invalidate & kAnalysisCFG) {
+    analyses_to_invalidate |= kAnalysisDominatorAnalysis;
+  }
+  ResetAnalyses(analyses_to_invalidate);
+}
+
+void IRContext::InvalidateFunctionAnalyses(const Function* f) {
+  dominator_trees_.erase(f);
+  post_dominator_trees_.erase(f);
+  loop_descriptors_.erase(f);
+  if (struct_cfg_analysis_) {
+    struct_cfg_analysis_->InvalidateFunction(f);
+  }
+}
+
+void IRContext::ForgetRemovedFunctions() {
+  std::unordered_set<const Function*> functions;
+  for (const Function& f : *module()) {
+    functions.insert(&f);
+  }
+
+  auto forget_removed = [&functions](auto* cache) {
+    for (auto it = cache->begin(); it != cache->end();) {
+      if (functions.count(it->first)) {
+        ++it;
+      } else {
+        it = cache->erase(it);
+      }
+    }
+  };
+  forget_removed(&dominator_trees_);
+  forget_removed(&post_dominator_trees_);
+  forget_removed(&loop_descriptors_);
+}
+
+void IRContext::ResetAnalyses(IRContext::Analysis analyses_to_invalidate) {
   // The ConstantManager and DebugInfoManager contain Type pointers. If the
   // TypeManager goes away, the ConstantManager and DebugInfoManager have to
   // go away.
@@ -108,13 +163,6 @@ void IRContext::InvalidateAnalyses(IRContext::Analysis analyses_to_invalidate) {
     analyses_to_invalidate |= kAnalysisDebugInfo;
   }
 
-  // The dominator analysis hold the pseudo entry and exit nodes from the CFG.
-  // Also if the CFG change the dominators many changed as well, so the
-  // dominator analysis should be invalidated as well.
-  if (analyses_to_invalidate & kAnalysisCFG) {
-    analyses_to_invalidate |= kAnalysisDominatorAnalysis;
-  }
-
   if (analyses_to_invalidate & kAnalysisDefUse) {
     def_use_mgr_.reset(nullptr);
   }
@@ -130,9 +178,6 @@ void IRContext::InvalidateAnalyses(IRContext::Analysis analyses_to_invalidate) {
   if (analyses_to_invalidate & kAnalysisBuiltinVarId) {
     builtin_var_id_map_.clear();
   }
-  if (analyses_to_invalidate & kAnalysisCFG) {
-    cfg_.reset(nullptr);
-  }
   if (analyses_to_invalidate & kAnalysisDominatorAnalysis) {
     dominator_trees_.clear();
     post_dominator_trees_.clear();
@@ -181,7 +226,7 @@ Instruction* IRContext::KillInst(Instruction* inst) {
     for (auto& l_inst : inst->dbg_line_insts()) def_use_mgr->ClearInst(&l_inst);
   }
   if (AreAnalysesValid(kAnalysisInstrToBlockMapping)) {
-    instr_to_block_.erase(inst);
+    instr_to_block_.erase(inst->unique_id());
   }
   if (AreAnalysesValid(kAnalysisDecorations)) {
     if (inst->IsDecoration()) {
@@ -44,7 +44,9 @@
 #include "source/opt/struct_cfg_analysis.h"
 #include "source/opt/type_manager.h"
 #include "source/opt/value_number_table.h"
+#include "source/util/id_map.h"
 #include "source/util/make_unique.h"
+#include "source/util/slab_allocator.h"
 #include "source/util/string_utils.h"
 
 namespace spvtools {
@@ -99,6 +101,7 @@ class IRContext {
       : syntax_context_(spvContextCreate(env)),
         grammar_(syntax_context_),
         unique_id_(0),
+        slab_allocator_(utils::SlabAllocator::Create()),
         module_(new Module()),
         consumer_(std::move(c)),
         def_use_mgr_(nullptr),
@@ -118,6 +121,7 @@ class IRContext {
       : syntax_context_(spvContextCreate(env)),
         grammar_(syntax_context_),
         unique_id_(0),
+        slab_allocator_(utils::SlabAllocator::Create()),
         module_(std::move(m)),
         consumer_(std::move(c)),
         def_use_mgr_(nullptr),
@@ -133,10 +137,18 @@ class IRContext {
     InitializeCombinators();
   }
 
-  ~IRContext() { spvContextDestroy(syntax_context_); }
+  ~IRContext() {
+    spvContextDestroy(syntax_context_);
+    // The allocator lives on until the instructions of |module_| are freed.
+    slab_allocator_->Release();
+  }
 
   Module* module() const { return module_.get(); }
 
+  // Returns the allocator of the instructions and basic blocks allocated in
+  // this context.
+  utils::SlabAllocator* slab_allocator() const { return slab_allocator_; }
+
   // Returns a vector of pointers to constant-creation instructions in this
   // context.
   inline std::vector<Instruction*> GetConstants();
@@ -292,6 +304,8 @@ class IRContext {
   StructuredCFGAnalysis* GetStructuredCFGAnalysis() {
     if (!AreAnalysesValid(kAnalysisStructuredCFG)) {
       BuildStructuredCFGAnalysis();
+    } else if (struct_cfg_analysis_->NeedsUpdate()) {
+      struct_cfg_analysis_->Update();
     }
     return struct_cfg_analysis_.get();
   }
@@ -311,7 +325,8 @@ class IRContext {
     if (!AreAnalysesValid(kAnalysisInstrToBlockMapping)) {
       BuildInstrToBlockMapping();
     }
-    auto entry = instr_to_block_.find(instr);
+    if (instr == nullptr) return nullptr;
+    auto entry = instr_to_block_.find(instr->unique_id());
     return (entry != instr_to_block_.end()) ? entry->second : nullptr;
   }
 
@@ -328,7 +343,7 @@ class IRContext {
   // invalid.
   void set_instr_block(Instruction* inst, BasicBlock* block) {
     if (AreAnalysesValid(kAnalysisInstrToBlockMapping)) {
-      instr_to_block_[inst] = block;
+      instr_to_block_[inst->unique_id()] = block;
     }
   }
 
@@ -415,9 +430,25 @@ class IRContext {
   // Invalidates all of the analyses except for those in |preserved_analyses|.
   void InvalidateAnalysesExceptFor(Analysis preserved_analyses);
 
+  // Invalidates all of the analyses except for those in |preserved_analyses|,
+  // when only the functions in |modified_functions| were changed.  The
+  // analyses kept per function, the dominator and post-dominator trees, the
+  // loop descriptors and the structured CFG analysis, are then invalidated
+  // only for those functions, and are rebuilt for them on demand.  The
+  // functions added to or removed from the module must be in
+  // |modified_functions|.
+  void InvalidateAnalysesExceptFor(
+      Analysis preserved_analyses,
+      const std::unordered_set<const Function*>& modified_functions);
+
   // Invalidates the analyses marked in |analyses_to_invalidate|.
   void InvalidateAnalyses(Analysis analyses_to_invalidate);
 
+  // Invalidates the analyses kept for the function |f| alone: its dominator
+  // and post-dominator trees, its loop descriptor and its part of the
+  // structured CFG analysis.  |f| may have been removed from the module.
+  void InvalidateFunctionAnalyses(const Function* f);
+
   // Deletes the instruction defining the given |id|. Returns true on
   // success, false if the given |id| is not defined at all. This method also
   // erases the name, decorations, and definition of |id|.
@@ -703,7 +734,7 @@ class IRContext {
     for (auto& fn : *module_) {
       for (auto& block : fn) {
         block.ForEachInst([this, &block](Instruction* inst) {
-          instr_to_block_[inst] = &block;
+          instr_to_block_[inst->unique_id()] = &block;
         });
       }
     }
@@ -724,8 +755,14 @@ class IRContext {
     valid_analyses_ = valid_analyses_ | kAnalysisDecorations;
   }
 
+  // Builds the CFG.  An existing CFG is rebuilt in place, so that the
+  // dominator trees that are kept still refer to its pseudo blocks.
   void BuildCFG() {
-    cfg_ = MakeUnique<CFG>(module());
+    if (cfg_) {
+      cfg_->Rebuild();
+    } else {
+      cfg_ = MakeUnique<CFG>(module());
+    }
     valid_analyses_ = valid_analyses_ | kAnalysisCFG;
   }
 
@@ -791,6 +828,14 @@ class IRContext {
     valid_analyses_ = valid_analyses_ | kAnalysisLoopAnalysis;
   }
 
+  // Resets the analyses in |analyses_to_reset|, without invalidating the
+  // analyses that depend on them.
+  void ResetAnalyses(Analysis analyses_to_reset);
+
+  // Forgets the per-function analyses of the functions that are no longer in
+  // the module.
+  void ForgetRemovedFunctions();
+
   // Removes all computed loop descriptors.
   void ResetBuiltinAnalysis() {
     // Clear the cache.
@@ -843,6 +888,10 @@ class IRContext {
   // Therefore, 0 is not a valid unique id for an instruction.
   uint32_t unique_id_;
 
+  // The allocator of the instructions and basic blocks allocated in this
+  // context.  It is released, rather than deleted, with the context.
+  utils::SlabAllocator* slab_allocator_;
+
   // The module being processed within this IR context.
   std::unique_ptr<Module> module_;
 
@@ -858,12 +907,12 @@ class IRContext {
   // The feature manager for |module_|.
   std::unique_ptr<FeatureManager> feature_mgr_;
 
-  // A map from instructions to the basic block they belong to. This mapping is
-  // built on-demand when get_instr_block() is called.
+  // A map from the unique ids of instructions to the basic block they belong
+  // to. This mapping is built on-demand when get_instr_block() is called.
   //
   // NOTE: Do not traverse this map. Ever. Use the function and basic block
   // iterators to traverse instructions.
-  std::unordered_map<Instruction*, BasicBlock*> instr_to_block_;
+  utils::IdMap<BasicBlock*> instr_to_block_;
 
   // A map from ids to the function they define. This mapping is
   // built on-demand when GetFunction() is called.
@@ -883,7 +932,8 @@ class IRContext {
   // without side-effect.
   std::unordered_map<uint32_t, uint32_t> builtin_var_id_map_;
 
-  // The CFG for all the functions in |module_|.
+  // The CFG for all the functions in |module_|.  It is kept when it is
+  // invalidated, and rebuilt in place.
   std::unique_ptr<CFG> cfg_;
 
   // Each function in the module will create its own dominator tree. We cache
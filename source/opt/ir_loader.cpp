@@ -107,8 +107,8 @@ bool IrLoader::AddInstruction(const spv_parsed_instruction_t* inst) {
     }
   }
 
-  std::unique_ptr<Instruction> spv_inst(
-      new Instruction(module()->context(), *inst, std::move(dbg_line_info_)));
+  std::unique_ptr<Instruction> spv_inst(new (module()->context()) Instruction(
+      module()->context(), *inst, std::move(dbg_line_info_)));
   if (!spv_inst->dbg_line_insts().empty()) {
     if (extra_line_tracking_ &&
         (!spv_inst->dbg_line_insts().back().IsNoLine())) {
@@ -160,7 +160,7 @@ bool IrLoader::AddInstruction(const spv_parsed_instruction_t* inst) {
       Error(consumer_, src, loc, "OpLabel inside basic block");
       return false;
     }
-    block_ = MakeUnique<BasicBlock>(std::move(spv_inst));
+    block_.reset(new (module()->context()) BasicBlock(std::move(spv_inst)));
   } else if (spvOpcodeIsBlockTerminator(opcode)) {
     if (function_ == nullptr) {
       Error(consumer_, src, loc, "terminator instruction outside function");
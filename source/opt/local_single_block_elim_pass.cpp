@@ -26,51 +26,79 @@ namespace {
 constexpr uint32_t kStoreValIdInIdx = 1;
 }  // namespace
 
-bool LocalSingleBlockLoadStoreElimPass::HasOnlySupportedRefs(uint32_t ptrId) {
-  if (supported_ref_ptrs_.find(ptrId) != supported_ref_ptrs_.end()) return true;
-  if (get_def_use_mgr()->WhileEachUser(ptrId, [this](Instruction* user) {
-        auto dbg_op = user->GetCommonDebugOpcode();
-        if (dbg_op == CommonDebugInfoDebugDeclare ||
-            dbg_op == CommonDebugInfoDebugValue) {
-          return true;
-        }
-        spv::Op op = user->opcode();
-        if (IsNonPtrAccessChain(op) || op == spv::Op::OpCopyObject) {
-          if (!HasOnlySupportedRefs(user->result_id())) {
-            return false;
-          }
-        } else if (op != spv::Op::OpStore && op != spv::Op::OpLoad &&
-                   op != spv::Op::OpName && !IsNonTypeDecorate(op)) {
-          return false;
-        }
-        return true;
-      })) {
-    supported_ref_ptrs_.insert(ptrId);
+bool LocalSingleBlockLoadStoreElimPass::HasOnlySupportedRefs(
+    uint32_t ptrId, std::unordered_set<uint32_t>* supported_ref_ptrs) {
+  if (supported_ref_ptrs->find(ptrId) != supported_ref_ptrs->end())
+    return true;
+  if (get_def_use_mgr()->WhileEachUser(
+          ptrId, [this, supported_ref_ptrs](Instruction* user) {
+            auto dbg_op = user->GetCommonDebugOpcode();
+            if (dbg_op == CommonDebugInfoDebugDeclare ||
+                dbg_op == CommonDebugInfoDebugValue) {
+              return true;
+            }
+            spv::Op op = user->opcode();
+            if (IsNonPtrAccessChain(op) || op == spv::Op::OpCopyObject) {
+              if (!HasOnlySupportedRefs(user->result_id(),
+                                        supported_ref_ptrs)) {
+                return false;
+              }
+            } else if (op != spv::Op::OpStore && op != spv::Op::OpLoad &&
+                       op != spv::Op::OpName && !IsNonTypeDecorate(op)) {
+              return false;
+            }
+            return true;
+          })) {
+    supported_ref_ptrs->insert(ptrId);
     return true;
   }
   return false;
 }
 
-bool LocalSingleBlockLoadStoreElimPass::LocalSingleBlockLoadStoreElim(
-    Function* func) {
+LocalSingleBlockLoadStoreElimPass::FunctionChanges
+LocalSingleBlockLoadStoreElimPass::FindChanges(Function* func,
+                                               bool replace_loads) {
   // Perform local store/load, load/load and store/store elimination
   // on each block
-  bool modified = false;
-  std::vector<Instruction*> instructions_to_kill;
+  FunctionChanges changes;
   std::unordered_set<Instruction*> instructions_to_save;
+  std::unordered_set<uint32_t> supported_ref_ptrs;
+
+  // The ids that replace the loads found so far.  Unless |replace_loads| is
+  // true, the loads are only replaced by ApplyChanges(), so the values read
+  // from the instructions are mapped through this.  The pointers are not,
+  // which is why the search stops at a replaceable load of a pointer.
+  std::unordered_map<uint32_t, uint32_t> replacements;
+  auto current_id = [&replacements](uint32_t id) {
+    auto it = replacements.find(id);
+    return it == replacements.end() ? id : it->second;
+  };
+
+  // Map from function scope variable to a store of that variable in the
+  // current block whose value is currently valid. This map is cleared
+  // at the start of each block and incrementally updated as the block
+  // is scanned. The stores are candidates for elimination. The map is
+  // conservatively cleared when a function call is encountered.
+  std::unordered_map<uint32_t, Instruction*> var2store;
+
+  // Map from function scope variable to a load of that variable in the
+  // current block whose value is currently valid. This map is cleared
+  // at the start of each block and incrementally updated as the block
+  // is scanned. The stores are candidates for elimination. The map is
+  // conservatively cleared when a function call is encountered.
+  std::unordered_map<uint32_t, Instruction*> var2load;
+
   for (auto bi = func->begin(); bi != func->end(); ++bi) {
-    var2store_.clear();
-    var2load_.clear();
-    auto next = bi->begin();
-    for (auto ii = next; ii != bi->end(); ii = next) {
-      ++next;
+    var2store.clear();
+    var2load.clear();
+    for (auto ii = bi->begin(); ii != bi->end(); ++ii) {
       switch (ii->opcode()) {
         case spv::Op::OpStore: {
           // Verify store variable is target type
           uint32_t varId;
           Instruction* ptrInst = GetPtr(&*ii, &varId);
           if (!IsTargetVar(varId)) continue;
-          if (!HasOnlySupportedRefs(varId)) continue;
+          if (!HasOnlySupportedRefs(varId, &supported_ref_ptrs)) continue;
           // If a store to the whole variable, remember it for succeeding
           // loads and stores. Otherwise forget any previous store to that
           // variable.
@@ -78,19 +106,18 @@ bool LocalSingleBlockLoadStoreElimPass::LocalSingleBlockLoadStoreElim(
             // If a previous store to same variable, mark the store
             // for deletion if not still used. Don't delete store
             // if debugging; let ssa-rewrite and DCE handle it
-            auto prev_store = var2store_.find(varId);
-            if (prev_store != var2store_.end() &&
+            auto prev_store = var2store.find(varId);
+            if (prev_store != var2store.end() &&
                 instructions_to_save.count(prev_store->second) == 0 &&
                 !context()->get_debug_info_mgr()->IsVariableDebugDeclared(
                     varId)) {
-              instructions_to_kill.push_back(prev_store->second);
-              modified = true;
+              changes.instructions_to_kill.push_back(prev_store->second);
             }
 
             bool kill_store = false;
-            auto li = var2load_.find(varId);
-            if (li != var2load_.end()) {
-              if (ii->GetSingleWordInOperand(kStoreValIdInIdx) ==
+            auto li = var2load.find(varId);
+            if (li != var2load.end()) {
+              if (current_id(ii->GetSingleWordInOperand(kStoreValIdInIdx)) ==
                   li->second->result_id()) {
                 // We are storing the same value that already exists in the
                 // memory location.  The store does nothing.
@@ -99,16 +126,15 @@ bool LocalSingleBlockLoadStoreElimPass::LocalSingleBlockLoadStoreElim(
             }
 
             if (!kill_store) {
-              var2store_[varId] = &*ii;
-              var2load_.erase(varId);
+              var2store[varId] = &*ii;
+              var2load.erase(varId);
             } else {
-              instructions_to_kill.push_back(&*ii);
-              modified = true;
+              changes.instructions_to_kill.push_back(&*ii);
             }
           } else {
             assert(IsNonPtrAccessChain(ptrInst->opcode()));
-            var2store_.erase(varId);
-            var2load_.erase(varId);
+            var2store.erase(varId);
+            var2load.erase(varId);
           }
         } break;
         case spv::Op::OpLoad: {
@@ -116,54 +142,94 @@ bool LocalSingleBlockLoadStoreElimPass::LocalSingleBlockLoadStoreElim(
           uint32_t varId;
           Instruction* ptrInst = GetPtr(&*ii, &varId);
           if (!IsTargetVar(varId)) continue;
-          if (!HasOnlySupportedRefs(varId)) continue;
+          if (!HasOnlySupportedRefs(varId, &supported_ref_ptrs)) continue;
           uint32_t replId = 0;
           if (ptrInst->opcode() == spv::Op::OpVariable) {
             // If a load from a variable, look for a previous store or
             // load from that variable and use its value.
-            auto si = var2store_.find(varId);
-            if (si != var2store_.end()) {
-              replId = si->second->GetSingleWordInOperand(kStoreValIdInIdx);
+            auto si = var2store.find(varId);
+            if (si != var2store.end()) {
+              replId = current_id(
+                  si->second->GetSingleWordInOperand(kStoreValIdInIdx));
             } else {
-              auto li = var2load_.find(varId);
-              if (li != var2load_.end()) {
+              auto li = var2load.find(varId);
+              if (li != var2load.end()) {
                 replId = li->second->result_id();
               }
             }
           } else {
             // If a partial load of a previously seen store, remember
             // not to delete the store.
-            auto si = var2store_.find(varId);
-            if (si != var2store_.end()) instructions_to_save.insert(si->second);
+            auto si = var2store.find(varId);
+            if (si != var2store.end()) instructions_to_save.insert(si->second);
           }
           if (replId != 0) {
             // replace load's result id and delete load
-            context()->KillNamesAndDecorates(&*ii);
-            context()->ReplaceAllUsesWith(ii->result_id(), replId);
-            instructions_to_kill.push_back(&*ii);
-            modified = true;
+            if (replace_loads) {
+              context()->KillNamesAndDecorates(&*ii);
+              context()->ReplaceAllUsesWith(ii->result_id(), replId);
+            } else {
+              const spv::Op type_op =
+                  get_def_use_mgr()->GetDef(ii->type_id())->opcode();
+              if (type_op == spv::Op::OpTypePointer ||
+                  type_op == spv::Op::OpTypeUntypedPointerKHR) {
+                FunctionChanges later;
+                later.find_when_applied = true;
+                return later;
+              }
+              replacements[ii->result_id()] = replId;
+              changes.replaced_loads.emplace_back(&*ii, replId);
+            }
+            changes.instructions_to_kill.push_back(&*ii);
           } else {
             if (ptrInst->opcode() == spv::Op::OpVariable)
-              var2load_[varId] = &*ii;  // register load
+              var2load[varId] = &*ii;  // register load
           }
         } break;
         case spv::Op::OpFunctionCall: {
           // Conservatively assume all locals are redefined for now.
           // TODO(): Handle more optimally
-          var2store_.clear();
-          var2load_.clear();
+          var2store.clear();
+          var2load.clear();
         } break;
         default:
           break;
       }
     }
   }
+  return changes;
+}
+
+bool LocalSingleBlockLoadStoreElimPass::ApplyChanges(
+    Function* func, FunctionChanges* changes) {
+  if (changes->find_when_applied) {
+    *changes = FindChanges(func, /* replace_loads = */ true);
+  }
 
-  for (Instruction* inst : instructions_to_kill) {
+  for (const auto& load_and_id : changes->replaced_loads) {
+    Instruction* load = load_and_id.first;
+    context()->KillNamesAndDecorates(load);
+    context()->ReplaceAllUsesWith(load->result_id(), load_and_id.second);
+  }
+
+  for (Instruction* inst : changes->instructions_to_kill) {
     context()->KillInst(inst);
   }
 
-  return modified;
+  return !changes->instructions_to_kill.empty();
+}
+
+void LocalSingleBlockLoadStoreElimPass::FindTargetVars(
+    const std::vector<Function*>& functions) {
+  for (auto& inst : get_module()->types_values()) {
+    if (inst.opcode() == spv::Op::OpVariable) IsTargetVar(inst.result_id());
+  }
+  for (Function* func : functions) {
+    if (func->begin() == func->end()) continue;
+    for (auto& inst : *func->begin()) {
+      if (inst.opcode() == spv::Op::OpVariable) IsTargetVar(inst.result_id());
+    }
+  }
 }
 
 void LocalSingleBlockLoadStoreElimPass::Initialize() {
@@ -171,9 +237,6 @@ void LocalSingleBlockLoadStoreElimPass::Initialize() {
   seen_target_vars_.clear();
   seen_non_target_vars_.clear();
 
-  // Clear collections
-  supported_ref_ptrs_.clear();
-
   // Initialize extensions allowlist
   InitExtensions();
 }
@@ -214,12 +277,20 @@ Pass::Status LocalSingleBlockLoadStoreElimPass::ProcessImpl() {
   // If any extensions in the module are not explicitly supported,
   // return unmodified.
   if (!AllExtensionsSupported()) return Status::SuccessWithoutChange;
-  // Process all entry point functions
-  ProcessFunction pfn = [this](Function* fp) {
-    return LocalSingleBlockLoadStoreElim(fp);
-  };
-
-  bool modified = context()->ProcessReachableCallTree(pfn);
+  // Process all entry point functions.  The functions are analyzed once the
+  // analyses they read are built.
+  std::vector<Function*> functions = GetReachableFunctions();
+  context()->BuildInvalidAnalyses(IRContext::kAnalysisDefUse |
+                                  IRContext::kAnalysisDebugInfo);
+  FindTargetVars(functions);
+  bool modified = AnalyzeThenApply(
+      functions,
+      [this](Function* fp) {
+        return FindChanges(fp, /* replace_loads = */ false);
+      },
+      [this](Function* fp, FunctionChanges* changes) {
+        return ApplyChanges(fp, changes);
+      });
   return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
 }
 
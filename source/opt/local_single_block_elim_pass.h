@@ -24,6 +24,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "source/opt/basic_block.h"
 #include "source/opt/def_use_manager.h"
@@ -47,21 +48,49 @@ class LocalSingleBlockLoadStoreElimPass : public MemPass {
            IRContext::kAnalysisConstants | IRContext::kAnalysisTypes;
   }
 
+  bool ReportsModifiedFunctions() const override { return true; }
+
  private:
+  // The loads and stores of a function that can be eliminated.
+  struct FunctionChanges {
+    // The loads to replace, in order, each with the id that replaces it.
+    std::vector<std::pair<Instruction*, uint32_t>> replaced_loads;
+    // The instructions to kill once the loads are replaced.
+    std::vector<Instruction*> instructions_to_kill;
+    // Whether a load of a pointer is replaced.  Its uses may be the pointer
+    // operands of later loads and stores, which are only resolved once it is
+    // replaced, so the changes are then found again by ApplyChanges().
+    bool find_when_applied = false;
+  };
+
   // Return true if all uses of |varId| are only through supported reference
-  // operations ie. loads and store. Also cache in supported_ref_ptrs_.
+  // operations ie. loads and store. Also cache in |supported_ref_ptrs|.
   // TODO(dnovillo): This function is replicated in other passes and it's
   // slightly different in every pass. Is it possible to make one common
   // implementation?
-  bool HasOnlySupportedRefs(uint32_t varId);
-
-  // On all entry point functions, within each basic block, eliminate
-  // loads and stores to function variables where possible. For
-  // loads, if previous load or store to same variable, replace
-  // load id with previous id and delete load. Finally, check if
-  // remaining stores are useless, and delete store and variable
-  // where possible. Assumes logical addressing.
-  bool LocalSingleBlockLoadStoreElim(Function* func);
+  bool HasOnlySupportedRefs(uint32_t varId,
+                            std::unordered_set<uint32_t>* supported_ref_ptrs);
+
+  // Within each basic block of |func|, finds the loads and stores to
+  // function variables that can be eliminated. For loads, if previous load
+  // or store to same variable, the load id is replaced with previous id and
+  // the load deleted. Stores that are overwritten in the same block, or that
+  // store the value just loaded, are deleted. Assumes logical addressing.
+  //
+  // If |replace_loads| is false, only reads the module and the analyses, so
+  // that several functions can be analyzed at once, once the target
+  // variables are known.  The loads are left to ApplyChanges(), and the
+  // search stops at the first load of a pointer that can be replaced.  If
+  // |replace_loads| is true, each load is replaced as soon as it is found.
+  FunctionChanges FindChanges(Function* func, bool replace_loads);
+
+  // Makes the |changes| found by FindChanges() in |func|.  Returns true if
+  // there are any.
+  bool ApplyChanges(Function* func, FunctionChanges* changes);
+
+  // Caches whether each variable of the module and of |functions| is a
+  // target variable, so that IsTargetVar() no longer modifies the pass.
+  void FindTargetVars(const std::vector<Function*>& functions);
 
   // Initialize extensions allowlist
   void InitExtensions();
@@ -72,20 +101,6 @@ class LocalSingleBlockLoadStoreElimPass : public MemPass {
   void Initialize();
   Pass::Status ProcessImpl();
 
-  // Map from function scope variable to a store of that variable in the
-  // current block whose value is currently valid. This map is cleared
-  // at the start of each block and incrementally updated as the block
-  // is scanned. The stores are candidates for elimination. The map is
-  // conservatively cleared when a function call is encountered.
-  std::unordered_map<uint32_t, Instruction*> var2store_;
-
-  // Map from function scope variable to a load of that variable in the
-  // current block whose value is currently valid. This map is cleared
-  // at the start of each block and incrementally updated as the block
-  // is scanned. The stores are candidates for elimination. The map is
-  // conservatively cleared when a function call is encountered.
-  std::unordered_map<uint32_t, Instruction*> var2load_;
-
   // Set of variables whose most recent store in the current block cannot be
   // deleted, for example, if there is a load of the variable which is
   // dependent on the store and is not replaced and deleted by this pass,
@@ -95,10 +110,6 @@ class LocalSingleBlockLoadStoreElimPass : public MemPass {
 
   // Extensions supported by this pass.
   std::unordered_set<std::string> extensions_allowlist_;
-
-  // Variables that are only referenced by supported operations for this
-  // pass ie. loads and stores.
-  std::unordered_set<uint32_t> supported_ref_ptrs_;
 };
 
 }  // namespace opt
@@ -38,13 +38,38 @@ Pass::Status Pass::Run(IRContext* ctx) {
   context_ = nullptr;
 
   if (status == Status::SuccessWithChange) {
-    ctx->InvalidateAnalysesExceptFor(GetPreservedAnalyses());
+    if (ReportsModifiedFunctions()) {
+      ctx->InvalidateAnalysesExceptFor(GetPreservedAnalyses(),
+                                       modified_functions_);
+    } else {
+      ctx->InvalidateAnalysesExceptFor(GetPreservedAnalyses());
+    }
   }
+  modified_functions_.clear();
   if (!(status == Status::Failure || ctx->IsConsistent()))
     assert(false && "An analysis in the context is out of date.");
   return status;
 }
 
+bool Pass::ProcessReachableCallTree(ProcessFunction& pfn) {
+  ProcessFunction mark_modified = [this, &pfn](Function* fp) {
+    if (!pfn(fp)) return false;
+    MarkFunctionModified(fp);
+    return true;
+  };
+  return context()->ProcessReachableCallTree(mark_modified);
+}
+
+std::vector<Function*> Pass::GetReachableFunctions() {
+  std::vector<Function*> functions;
+  ProcessFunction collect = [&functions](Function* fp) {
+    functions.push_back(fp);
+    return false;
+  };
+  context()->ProcessReachableCallTree(collect);
+  return functions;
+}
+
 uint32_t Pass::GetPointeeTypeId(const Instruction* ptrInst) const {
   const uint32_t ptrTypeId = ptrInst->type_id();
   const Instruction* ptrTypeInst = get_def_use_mgr()->GetDef(ptrTypeId);
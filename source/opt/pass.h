@@ -17,14 +17,17 @@
 
 #include <algorithm>
 #include <map>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "source/opt/basic_block.h"
 #include "source/opt/def_use_manager.h"
 #include "source/opt/ir_context.h"
 #include "source/opt/module.h"
+#include "source/util/parallel.h"
 #include "spirv-tools/libspirv.hpp"
 #include "types.h"
 
@@ -113,6 +116,18 @@ class Pass {
     return IRContext::kAnalysisNone;
   }
 
+  // Returns true if the pass reports, through MarkFunctionModified(), every
+  // function it changes, adds or removes.  The dominator trees, loop
+  // descriptors and structured CFG analysis of the other functions are then
+  // kept when the pass makes a change, even if they are not preserved.
+  virtual bool ReportsModifiedFunctions() const { return false; }
+
+  // Sets whether the pass may spread its work over several threads.  This is
+  // an experiment, which only eliminate-local-single-block supports.  Its
+  // tests check that the result matches a serial run on the modules they
+  // cover; nothing more is promised.
+  void SetParallel(bool parallel) { parallel_ = parallel; }
+
   // Return type id for |ptrInst|'s pointee
   uint32_t GetPointeeTypeId(const Instruction* ptrInst) const;
 
@@ -143,6 +158,39 @@ class Pass {
   // TODO(1841): Handle id overflow.
   uint32_t TakeNextId() { return context_->TakeNextId(); }
 
+  // Records that the pass changed, added or removed |func|.
+  void MarkFunctionModified(const Function* func) {
+    modified_functions_.insert(func);
+  }
+
+  // Calls |pfn| on every function reachable from an entry point or an
+  // exported function, like IRContext::ProcessReachableCallTree, and marks
+  // the functions for which it returns true as modified.  Returns true if any
+  // call to |pfn| returns true.
+  bool ProcessReachableCallTree(ProcessFunction& pfn);
+
+  // Returns the functions reachable from an entry point or an exported
+  // function, in the order in which ProcessReachableCallTree() visits them.
+  std::vector<Function*> GetReachableFunctions();
+
+  // Calls |analyze| on each function of |functions|, then calls |apply| on
+  // each of them in order, with the result of its analysis, and marks the
+  // functions for which |apply| returns true as modified.  Returns true if
+  // any call to |apply| returns true.
+  //
+  // |analyze| is called as analyze(func), and returns a default
+  // constructible result.  |apply| is called as apply(func, &result).  When
+  // the pass runs in parallel, the calls to |analyze| are spread over
+  // several threads.  They must then not modify the module, the analyses or
+  // the state shared by the pass, and every analysis they use must be built
+  // beforehand.  The calls to |apply| are always made in order on the calling
+  // thread, so that ids, types and constants are created in the order of a
+  // serial run.  Whether the output matches a serial run still depends on
+  // how the pass splits its work, which its tests must check.
+  template <typename Analyze, typename Apply>
+  bool AnalyzeThenApply(const std::vector<Function*>& functions,
+                        const Analyze& analyze, const Apply& apply);
+
   // Returns the id whose value is the same as |object_to_copy| except its type
   // is |new_type_id|.  Any instructions needed to generate this value will be
   // inserted before |insertion_position|.
@@ -159,8 +207,36 @@ class Pass {
   // enforce proper resetting of internal state for each instance.  This member
   // is used to check that we do not run the same instance twice.
   bool already_run_;
+
+  // The functions the pass changed, added or removed.
+  std::unordered_set<const Function*> modified_functions_;
+
+  // Whether the pass may spread its work over several threads.
+  bool parallel_ = false;
 };
 
+template <typename Analyze, typename Apply>
+bool Pass::AnalyzeThenApply(const std::vector<Function*>& functions,
+                            const Analyze& analyze, const Apply& apply) {
+  using Result = typename std::decay<decltype(analyze(
+      std::declval<Function*>()))>::type;
+  std::vector<Result> results(functions.size());
+  utils::ParallelFor(functions.size(),
+                     parallel_ ? utils::HardwareThreadCount() : 1u,
+                     [&functions, &analyze, &results](size_t i) {
+                       results[i] = analyze(functions[i]);
+                     });
+
+  bool modified = false;
+  for (size_t i = 0; i < functions.size(); ++i) {
+    if (apply(functions[i], &results[i])) {
+      MarkFunctionModified(functions[i]);
+      modified = true;
+    }
+  }
+  return modified;
+}
+
 inline Pass::Status CombineStatus(Pass::Status a, Pass::Status b) {
   return std::min(a, b);
 }
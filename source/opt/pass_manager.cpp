@@ -15,11 +15,13 @@
 #include "source/opt/pass_manager.h"
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "source/opt/ir_context.h"
 #include "source/util/timer.h"
+#include "source/val/validate.h"
 #include "spirv-tools/libspirv.hpp"
 
 namespace spvtools {
@@ -51,20 +53,27 @@ Pass::Status PassManager::Run(IRContext* context) {
     }
   };
 
+  // Most passes change few functions, so the validation after each pass
+  // skips the function-local checks of the functions that did not change.
+  std::unique_ptr<val::IncrementalValidator> validator;
+  if (validate_after_all_) {
+    validator.reset(new val::IncrementalValidator(target_env_, val_options_));
+    validator->SetMessageConsumer(consumer());
+  }
+
   SPIRV_TIMER_DESCRIPTION(time_report_stream_, /* measure_mem_usage = */ true);
   for (auto& pass : passes_) {
     print_disassembly("; IR before pass ", pass.get());
     SPIRV_TIMER_SCOPED(time_report_stream_, (pass ? pass->name() : ""), true);
+    pass->SetParallel(parallel_);
     const auto one_status = pass->Run(context);
     if (one_status == Pass::Status::Failure) return one_status;
     if (one_status == Pass::Status::SuccessWithChange) status = one_status;
 
-    if (validate_after_all_) {
-      spvtools::SpirvTools tools(target_env_);
-      tools.SetMessageConsumer(consumer());
+    if (validator) {
       std::vector<uint32_t> binary;
       context->module()->ToBinary(&binary, true);
-      if (!tools.Validate(binary.data(), binary.size(), val_options_)) {
+      if (!validator->Validate(binary)) {
         std::string msg = "Validation failed after pass ";
         msg += pass->name();
         spv_position_t null_pos{0, 0, 0};
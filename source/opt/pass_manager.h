@@ -46,7 +46,8 @@ class PassManager {
         time_report_stream_(nullptr),
         target_env_(SPV_ENV_UNIVERSAL_1_2),
         val_options_(nullptr),
-        validate_after_all_(false) {}
+        validate_after_all_(false),
+        parallel_(false) {}
 
   // Sets the message consumer to the given |consumer|.
   void SetMessageConsumer(MessageConsumer c) { consumer_ = std::move(c); }
@@ -110,6 +111,13 @@ class PassManager {
     return *this;
   }
 
+  // Sets the option to let the passes spread their work over several threads.
+  // See Pass::SetParallel().
+  PassManager& SetParallel(bool parallel) {
+    parallel_ = parallel;
+    return *this;
+  }
+
  private:
   // Consumer for messages.
   MessageConsumer consumer_;
@@ -127,6 +135,9 @@ class PassManager {
   spv_validator_options val_options_;
   // Controls whether validation occurs after every pass.
   bool validate_after_all_;
+
+  // Controls whether the passes may run on several threads.
+  bool parallel_;
 };
 
 inline void PassManager::AddPass(std::unique_ptr<Pass> pass) {
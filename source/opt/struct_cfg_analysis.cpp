@@ -35,7 +35,44 @@ StructuredCFGAnalysis::StructuredCFGAnalysis(IRContext* ctx) : context_(ctx) {
   }
 }
 
+void StructuredCFGAnalysis::Update() {
+  std::unordered_set<const Function*> functions;
+  for (auto& func : *context_->module()) {
+    functions.insert(&func);
+  }
+
+  for (auto it = function_info_.begin(); it != function_info_.end();) {
+    if (invalid_functions_.count(it->first) || !functions.count(it->first)) {
+      RemoveBlocks(it->second);
+      it = function_info_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  invalid_functions_.clear();
+
+  if (!context_->get_feature_mgr()->HasCapability(spv::Capability::Shader)) {
+    return;
+  }
+
+  for (auto& func : *context_->module()) {
+    if (!function_info_.count(&func)) {
+      AddBlocksInFunction(&func);
+    }
+  }
+}
+
+void StructuredCFGAnalysis::RemoveBlocks(const FunctionInfo& info) {
+  for (uint32_t id : info.blocks) {
+    bb_to_construct_.erase(id);
+  }
+  for (uint32_t id : info.merge_blocks) {
+    merge_blocks_.Clear(id);
+  }
+}
+
 void StructuredCFGAnalysis::AddBlocksInFunction(Function* func) {
+  FunctionInfo& info = function_info_[func];
   if (func->begin() == func->end()) return;
 
   std::list<BasicBlock*> order;
@@ -74,6 +111,7 @@ void StructuredCFGAnalysis::AddBlocksInFunction(Function* func) {
     }
 
     bb_to_construct_.emplace(std::make_pair(block->id(), state.back().cinfo));
+    info.blocks.push_back(block->id());
 
     if (Instruction* merge_inst = block->GetMergeInst()) {
       TraversalInfo new_state;
@@ -107,6 +145,7 @@ void StructuredCFGAnalysis::AddBlocksInFunction(Function* func) {
 
       state.emplace_back(new_state);
       merge_blocks_.Set(new_state.merge_node);
+      info.merge_blocks.push_back(new_state.merge_node);
     }
   }
 }
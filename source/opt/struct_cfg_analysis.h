@@ -17,6 +17,7 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "source/opt/function.h"
 #include "source/util/bit_vector.h"
@@ -119,6 +120,20 @@ class StructuredCFGAnalysis {
   // a continue construct.
   std::unordered_set<uint32_t> FindFuncsCalledFromContinue();
 
+  // Marks the blocks of |func| as out of date.  They are analyzed again by
+  // the next call to Update().  |func| may have been removed from the module.
+  void InvalidateFunction(const Function* func) {
+    invalid_functions_.insert(func);
+  }
+
+  // Returns true if a function was invalidated since the last Update().
+  bool NeedsUpdate() const { return !invalid_functions_.empty(); }
+
+  // Forgets the blocks of the invalidated functions and of the functions no
+  // longer in the module, and analyzes the functions of the module that are
+  // not analyzed.
+  void Update();
+
  private:
   // Struct used to hold the information for a basic block.
   // |containing_construct| is the header for the innermost containing
@@ -143,16 +158,31 @@ class StructuredCFGAnalysis {
     bool in_continue;
   };
 
+  // The blocks and merge blocks that were added for a function.
+  struct FunctionInfo {
+    std::vector<uint32_t> blocks;
+    std::vector<uint32_t> merge_blocks;
+  };
+
   // Populates |bb_to_construct_| with the innermost containing merge and loop
   // constructs for each basic block in |func|.
   void AddBlocksInFunction(Function* func);
 
+  // Removes the blocks in |info| from |bb_to_construct_| and |merge_blocks_|.
+  void RemoveBlocks(const FunctionInfo& info);
+
   IRContext* context_;
 
   // A map from a basic block to the headers of its inner most containing
   // constructs.
   std::unordered_map<uint32_t, ConstructInfo> bb_to_construct_;
   utils::BitVector merge_blocks_;
+
+  // The blocks added for each analyzed function.
+  std::unordered_map<const Function*, FunctionInfo> function_info_;
+
+  // The functions whose blocks are out of date.
+  std::unordered_set<const Function*> invalid_functions_;
 };
 
 }  // namespace opt
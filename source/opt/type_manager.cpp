@@ -153,7 +153,7 @@ void TypeManager::AnalyzeTypes(const Module& module) {
 
   // Add a mapping for any ids that whose original type was replaced by an
   // equivalent type.
-  for (auto& type : id_to_incomplete_type_) {
+  for (const auto& type : id_to_incomplete_type_) {
     id_to_type_[type.first] = type.second;
   }
 
@@ -184,7 +184,7 @@ void TypeManager::RemoveId(uint32_t id) {
       // |type| currently maps to |id|.
       // Search for an equivalent type to re-map.
       bool found = false;
-      for (auto& pair : id_to_type_) {
+      for (const auto& pair : id_to_type_) {
         if (pair.first != id && *pair.second == *type) {
           // Equivalent ambiguous type, re-map type.
           type_to_id_.erase(type);
@@ -23,6 +23,7 @@
 
 #include "source/opt/module.h"
 #include "source/opt/types.h"
+#include "source/util/id_map.h"
 #include "spirv-tools/libspirv.hpp"
 
 namespace spvtools {
@@ -70,7 +71,7 @@ struct CompareTypeUniquePointers {
 // A class for managing the SPIR-V type hierarchy.
 class TypeManager {
  public:
-  using IdToTypeMap = std::unordered_map<uint32_t, Type*>;
+  using IdToTypeMap = utils::IdMap<Type*>;
 
   // Constructs a type manager from the given |module|. All internal messages
   // will be communicated to the outside via the given message |consumer|.
@@ -284,7 +285,7 @@ class TypeManager {
   IdToTypeMap id_to_incomplete_type_;  // Maps ids to their type representations
                                        // for incomplete types.
 
-  std::unordered_map<uint32_t, const Instruction*> id_to_constant_inst_;
+  utils::IdMap<const Instruction*> id_to_constant_inst_;
 };
 
 }  // namespace analysis
@@ -16,6 +16,18 @@
 
 #include <cstring>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SPIRV_ENDIAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPIRV_ENDIAN_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SPIRV_ENDIAN_NEON
+#endif
+
 enum {
   I32_ENDIAN_LITTLE = 0x03020100ul,
   I32_ENDIAN_BIG = 0x00010203ul,
@@ -46,6 +58,42 @@ uint64_t spvFixDoubleWord(const uint32_t low, const uint32_t high,
   return (uint64_t(spvFixWord(high, endian)) << 32) | spvFixWord(low, endian);
 }
 
+void spvFixWords(const uint32_t* words, size_t num_words,
+                 const spv_endianness_t endian, uint32_t* out) {
+  if (spvIsHostEndian(endian)) {
+    if (words != out) memcpy(out, words, num_words * sizeof(uint32_t));
+    return;
+  }
+
+  size_t i = 0;
+#if defined(SPIRV_ENDIAN_AVX2)
+  const __m256i reverse_bytes_in_words = _mm256_setr_epi8(
+      3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,  //
+      3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+  for (; i + 8 <= num_words; i += 8) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                        _mm256_shuffle_epi8(v, reverse_bytes_in_words));
+  }
+#elif defined(SPIRV_ENDIAN_SSE2)
+  for (; i + 4 <= num_words; i += 4) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i));
+    // Swap the bytes in each 16-bit half, then swap the halves.
+    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), v);
+  }
+#elif defined(SPIRV_ENDIAN_NEON)
+  for (; i + 4 <= num_words; i += 4) {
+    const uint8x16_t v = vreinterpretq_u8_u32(vld1q_u32(words + i));
+    vst1q_u32(out + i, vreinterpretq_u32_u8(vrev32q_u8(v)));
+  }
+#endif
+  for (; i < num_words; ++i) out[i] = spvFixWord(words[i], endian);
+}
+
 spv_result_t spvBinaryEndianness(spv_const_binary binary,
                                  spv_endianness_t* pEndian) {
   if (!binary->code || !binary->wordCount) return SPV_ERROR_INVALID_BINARY;
@@ -75,3 +123,8 @@ bool spvIsHostEndian(spv_endianness_t endian) {
          ((SPV_ENDIANNESS_BIG == endian) &&
           (I32_ENDIAN_BIG == I32_ENDIAN_HOST));
 }
+
+spv_endianness_t spvHostEndianness() {
+  return I32_ENDIAN_HOST == I32_ENDIAN_BIG ? SPV_ENDIANNESS_BIG
+                                           : SPV_ENDIANNESS_LITTLE;
+}
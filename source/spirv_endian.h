@@ -25,6 +25,14 @@ uint32_t spvFixWord(const uint32_t word, const spv_endianness_t endianness);
 uint64_t spvFixDoubleWord(const uint32_t low, const uint32_t high,
                           const spv_endianness_t endianness);
 
+// Converts num_words words in the specified endianness to the host native
+// endianness, writing them to out.  The input and output may be the same
+// array, but must not otherwise overlap.  Swaps several words at a time where
+// the target supports it, so it is much faster than calling spvFixWord on
+// each word.
+void spvFixWords(const uint32_t* words, size_t num_words,
+                 const spv_endianness_t endianness, uint32_t* out);
+
 // Gets the endianness of the SPIR-V module given in the binary parameter.
 // Returns SPV_ENDIANNESS_UNKNOWN if the SPIR-V magic number is invalid,
 // otherwise writes the determined endianness into *endian.
@@ -34,4 +42,7 @@ spv_result_t spvBinaryEndianness(const spv_const_binary binary,
 // Returns true if the given endianness matches the host's native endianness.
 bool spvIsHostEndian(spv_endianness_t endian);
 
+// Returns the host's native endianness.
+spv_endianness_t spvHostEndianness();
+
 #endif  // SOURCE_SPIRV_ENDIAN_H_
@@ -48,6 +48,20 @@ bool spvParseUniversalLimitsOptions(const char* s, spv_validator_limit* type) {
   return true;
 }
 
+bool spvParseValidatorTier(const char* s, spv_validator_tier* tier) {
+  if (!s) return false;
+  if (0 == strcmp(s, "structural")) {
+    *tier = spv_validator_tier_structural;
+  } else if (0 == strcmp(s, "standard")) {
+    *tier = spv_validator_tier_standard;
+  } else if (0 == strcmp(s, "exhaustive")) {
+    *tier = spv_validator_tier_exhaustive;
+  } else {
+    return false;
+  }
+  return true;
+}
+
 spv_validator_options spvValidatorOptionsCreate(void) {
   return new spv_validator_options_t;
 }
@@ -130,3 +144,12 @@ void spvValidatorOptionsSetFriendlyNames(spv_validator_options options,
                                          bool val) {
   options->use_friendly_names = val;
 }
+
+void spvValidatorOptionsSetParallel(spv_validator_options options, bool val) {
+  options->parallel = val;
+}
+
+void spvValidatorOptionsSetTier(spv_validator_options options,
+                                spv_validator_tier tier) {
+  options->tier = tier;
+}
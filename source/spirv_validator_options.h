@@ -21,6 +21,10 @@
 // returns the Enum for option in this case). Returns false otherwise.
 bool spvParseUniversalLimitsOptions(const char* s, spv_validator_limit* limit);
 
+// Parses the name of a validator tier, one of "structural", "standard" and
+// "exhaustive", into |tier|.  Returns false if |s| is not such a name.
+bool spvParseValidatorTier(const char* s, spv_validator_tier* tier);
+
 // Default initialization of this structure is to the default Universal Limits
 // described in the SPIR-V Spec.
 struct validator_universal_limits_t {
@@ -49,7 +53,9 @@ struct spv_validator_options_t {
         skip_block_layout(false),
         allow_localsizeid(false),
         before_hlsl_legalization(false),
-        use_friendly_names(true) {}
+        use_friendly_names(true),
+        parallel(false),
+        tier(spv_validator_tier_standard) {}
 
   validator_universal_limits_t universal_limits_;
   bool relax_struct_store;
@@ -62,6 +68,8 @@ struct spv_validator_options_t {
   bool allow_localsizeid;
   bool before_hlsl_legalization;
   bool use_friendly_names;
+  bool parallel;
+  spv_validator_tier tier;
 };
 
 #endif  // SOURCE_SPIRV_VALIDATOR_OPTIONS_H_
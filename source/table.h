@@ -19,6 +19,82 @@
 #include "source/latest_version_spirv_header.h"
 #include "spirv-tools/libspirv.hpp"
 
+// Sentinel for a missing entry in a spv_table_index_t.
+static const uint16_t kNoTableIndex = 0xFFFF;
+// The log2 of the number of consecutive keys covered by a page of a
+// spv_table_index_t.
+static const uint32_t kTableIndexPageBits = 6;
+
+// A two-level index from a key to the position of the first entry with that
+// key in one of the generated info tables.  Keys are grouped into pages of
+// 1 << kTableIndexPageBits consecutive keys, and only pages holding at least
+// one key have slots, so the index stays small for sparse keys.
+// An index with no pages is empty, and its table must be searched instead.
+typedef struct spv_table_index_t {
+  const uint32_t num_pages;
+  // The start of the slots for each page, or kNoTableIndex if no key in that
+  // page has an entry.
+  const uint16_t* pages;
+  // The position of the first entry for each key, or kNoTableIndex.
+  const uint16_t* slots;
+} spv_table_index_t;
+
+// Returns the position of the first entry with the given key, according to
+// the given index.  Returns kNoTableIndex if there is no such entry.
+inline uint16_t spvTableIndexLookup(const spv_table_index_t& index,
+                                    uint32_t key) {
+  const uint32_t page = key >> kTableIndexPageBits;
+  if (page >= index.num_pages) return kNoTableIndex;
+  const uint16_t start = index.pages[page];
+  if (start == kNoTableIndex) return kNoTableIndex;
+  return index.slots[start + (key & ((1u << kTableIndexPageBits) - 1))];
+}
+
+// A minimal perfect hash from the names of the entries of one of the
+// generated info tables to their positions.  Names are first hashed into one
+// of the buckets, whose displacement either gives the slot of its only name
+// directly, as -(slot + 1), or is the seed to hash its names with to find
+// their slots.  There are as many slots as buckets.
+// A hash with no buckets is empty, and its table must be searched instead.
+typedef struct spv_name_hash_t {
+  const uint32_t num_buckets;
+  const int32_t* displacements;
+  // The position of the entry for each slot.
+  const uint16_t* positions;
+} spv_name_hash_t;
+
+// Returns the hash of the first |length| characters of |name| under the
+// given seed.  This must match name_hash in utils/generate_grammar_tables.py.
+inline uint32_t spvNameHash(uint32_t seed, const char* name, size_t length) {
+  uint32_t h = 0x811c9dc5u ^ seed;
+  for (size_t i = 0; i < length; ++i) {
+    h = (h ^ static_cast<unsigned char>(name[i])) * 0x01000193u;
+  }
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
+
+// Returns the position of the only entry that may have the name given by the
+// first |length| characters of |name|, according to the given hash.  The
+// caller must still compare the name of that entry.  Returns kNoTableIndex if
+// the hash is empty.
+inline uint16_t spvNameHashLookup(const spv_name_hash_t& hash, const char* name,
+                                  size_t length) {
+  if (hash.num_buckets == 0) return kNoTableIndex;
+  const int32_t displacement =
+      hash.displacements[spvNameHash(0, name, length) % hash.num_buckets];
+  const uint32_t slot =
+      displacement < 0
+          ? static_cast<uint32_t>(-(displacement + 1))
+          : spvNameHash(static_cast<uint32_t>(displacement), name, length) %
+                hash.num_buckets;
+  return hash.positions[slot];
+}
+
 typedef struct spv_opcode_desc_t {
   const char* name;
   const spv::Op opcode;
@@ -67,6 +143,12 @@ typedef struct spv_operand_desc_group_t {
   const spv_operand_type_t type;
   const uint32_t count;
   const spv_operand_desc_t* entries;
+  // Is this a mask operand kind?  If so, the index is keyed by the position
+  // of the single set bit plus one, or 0 for the value 0.  Otherwise it is
+  // keyed by value.
+  const bool is_bit_enum;
+  const spv_table_index_t index;
+  const spv_name_hash_t name_hash;
 } spv_operand_desc_group_t;
 
 typedef struct spv_ext_inst_desc_t {
@@ -81,11 +163,17 @@ typedef struct spv_ext_inst_group_t {
   const spv_ext_inst_type_t type;
   const uint32_t count;
   const spv_ext_inst_desc_t* entries;
+  // Hash of the entries by name, or null.
+  const spv_name_hash_t* name_hash;
 } spv_ext_inst_group_t;
 
 typedef struct spv_opcode_table_t {
   const uint32_t count;
   const spv_opcode_desc_t* entries;
+  // Index of the entries by opcode, or null.
+  const spv_table_index_t* index;
+  // Hash of the entries by name, or null.
+  const spv_name_hash_t* name_hash;
 } spv_opcode_table_t;
 
 typedef struct spv_operand_table_t {
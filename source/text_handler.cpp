@@ -88,12 +88,13 @@ spv_result_t advance(spv_text text, spv_position position) {
 }
 
 // Fetches the next word from the given text stream starting from the given
-// *position. On success, writes the decoded word into *word and updates
+// *position. On success, points *word at the word in the text and updates
 // *position to the location past the returned word.
 //
 // A word ends at the next comment or whitespace.  However, double-quoted
 // strings remain intact, and a backslash always escapes the next character.
-spv_result_t getWord(spv_text text, spv_position position, std::string* word) {
+spv_result_t getWord(spv_text text, spv_position position,
+                     std::string_view* word) {
   if (!text->str || !text->length) return SPV_ERROR_INVALID_TEXT;
   if (!position) return SPV_ERROR_INVALID_POINTER;
 
@@ -105,7 +106,8 @@ spv_result_t getWord(spv_text text, spv_position position, std::string* word) {
   // NOTE: Assumes first character is not white space!
   while (true) {
     if (position->index >= text->length) {
-      word->assign(text->str + start_index, text->str + position->index);
+      *word = std::string_view(text->str + start_index,
+                               position->index - start_index);
       return SPV_SUCCESS;
     }
     const char ch = text->str[position->index];
@@ -122,10 +124,12 @@ spv_result_t getWord(spv_text text, spv_position position, std::string* word) {
         case '\n':
         case '\r':
           if (escaping || quoting) break;
-          word->assign(text->str + start_index, text->str + position->index);
+          *word = std::string_view(text->str + start_index,
+                               position->index - start_index);
           return SPV_SUCCESS;
         case '\0': {  // NOTE: End of word found!
-          word->assign(text->str + start_index, text->str + position->index);
+          *word = std::string_view(text->str + start_index,
+                               position->index - start_index);
           return SPV_SUCCESS;
         }
         default:
@@ -153,6 +157,13 @@ bool startsWithOp(spv_text text, spv_position position) {
 
 const IdType kUnknownType = {0, false, IdTypeClass::kBottom};
 
+namespace {
+
+// The size of the blocks holding interned id names.
+constexpr size_t kNameBlockSize = 4096;
+
+}  // namespace
+
 // TODO(dneto): Reorder AssemblyContext definitions to match declaration order.
 
 // This represents all of the data that is only valid for the duration of
@@ -168,7 +179,8 @@ uint32_t AssemblyContext::spvNamedIdAssignOrGet(const char* textValue) {
     }
   }
 
-  const auto it = named_ids_.find(textValue);
+  const std::string_view name(textValue);
+  const auto it = named_ids_.find(name);
   if (it == named_ids_.end()) {
     uint32_t id = next_id_++;
     if (!ids_to_preserve_.empty()) {
@@ -177,7 +189,7 @@ uint32_t AssemblyContext::spvNamedIdAssignOrGet(const char* textValue) {
       }
     }
 
-    named_ids_.emplace(textValue, id);
+    named_ids_.emplace(internName(name), id);
     bound_ = std::max(bound_, id + 1);
     return id;
   }
@@ -191,12 +203,34 @@ spv_result_t AssemblyContext::advance() {
   return spvtools::advance(text_, &current_position_);
 }
 
-spv_result_t AssemblyContext::getWord(std::string* word,
+spv_result_t AssemblyContext::getWord(std::string_view* word,
                                       spv_position next_position) {
   *next_position = current_position_;
   return spvtools::getWord(text_, next_position, word);
 }
 
+const char* AssemblyContext::terminateWord(std::string_view word) {
+  word_buffer_.assign(word.data(), word.size());
+  return word_buffer_.c_str();
+}
+
+std::string_view AssemblyContext::internName(std::string_view name) {
+  const size_t size = name.size() + 1;
+  if (size > name_block_free_size_) {
+    // Start a new block.  The unused tail of the previous one is abandoned.
+    const size_t block_size = std::max(size, kNameBlockSize);
+    name_blocks_.emplace_back(new char[block_size]);
+    name_block_free_ = name_blocks_.back().get();
+    name_block_free_size_ = block_size;
+  }
+  char* copy = name_block_free_;
+  memcpy(copy, name.data(), name.size());
+  copy[name.size()] = '\0';
+  name_block_free_ += size;
+  name_block_free_size_ -= size;
+  return std::string_view(copy, name.size());
+}
+
 bool AssemblyContext::startsWithOp() {
   return spvtools::startsWithOp(text_, &current_position_);
 }
@@ -206,7 +240,7 @@ bool AssemblyContext::isStartOfNewInst() {
   if (spvtools::advance(text_, &pos)) return false;
   if (spvtools::startsWithOp(text_, &pos)) return true;
 
-  std::string word;
+  std::string_view word;
   pos = current_position_;
   if (spvtools::getWord(text_, &pos, &word)) return false;
   if ('%' != word.front()) return false;
@@ -387,7 +421,8 @@ std::set<uint32_t> AssemblyContext::GetNumericIds() const {
   std::set<uint32_t> ids;
   for (const auto& kv : named_ids_) {
     uint32_t id;
-    if (spvtools::utils::ParseNumber(kv.first.c_str(), &id)) ids.insert(id);
+    // Interned names are null-terminated.
+    if (spvtools::utils::ParseNumber(kv.first.data(), &id)) ids.insert(id);
   }
   return ids;
 }
@@ -16,12 +16,15 @@
 #define SOURCE_TEXT_HANDLER_H_
 
 #include <iomanip>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "source/diagnostic.h"
 #include "source/instruction.h"
@@ -141,8 +144,13 @@ class AssemblyContext {
   spv_result_t advance();
 
   // Sets word to the next word in the input text. Fills next_position with
-  // the next location past the end of the word.
-  spv_result_t getWord(std::string* word, spv_position next_position);
+  // the next location past the end of the word.  The word refers to the
+  // input text, and so is valid for the lifetime of the context.
+  spv_result_t getWord(std::string_view* word, spv_position next_position);
+
+  // Returns a null-terminated copy of the given word.  The copy is held in a
+  // buffer owned by the context, and is only valid until the next call.
+  const char* terminateWord(std::string_view word);
 
   // Returns true if the next word in the input is the start of a new Opcode.
   bool startsWithOp();
@@ -239,14 +247,27 @@ class AssemblyContext {
   std::set<uint32_t> GetNumericIds() const;
 
  private:
-  // Maps ID names to their corresponding numerical ids.
-  using spv_named_id_table = std::unordered_map<std::string, uint32_t>;
+  // Returns a copy of the given name in storage owned by the context.  The
+  // copy is null-terminated, and does not move while the context is alive.
+  std::string_view internName(std::string_view name);
+
+  // Maps ID names to their corresponding numerical ids.  The names are
+  // interned with internName.
+  using spv_named_id_table = std::unordered_map<std::string_view, uint32_t>;
   // Maps type-defining IDs to their IdType.
   using spv_id_to_type_map = std::unordered_map<uint32_t, IdType>;
   // Maps Ids to the id of their type.
   using spv_id_to_type_id = std::unordered_map<uint32_t, uint32_t>;
 
   spv_named_id_table named_ids_;
+  // Storage for the interned names.  Names are packed into fixed-size
+  // blocks, so that assembling a module does not allocate once per name.
+  std::vector<std::unique_ptr<char[]>> name_blocks_;
+  // The unused part of the last block of name_blocks_.
+  char* name_block_free_ = nullptr;
+  size_t name_block_free_size_ = 0;
+  // Holds the last word returned by terminateWord.
+  std::string word_buffer_;
   spv_id_to_type_map types_;
   spv_id_to_type_id value_types_;
   // Maps an extended instruction import Id to the extended instruction type.
@@ -105,6 +105,22 @@ size_t CountSetBits(T word) {
   return count;
 }
 
+// Returns the number of '0' bits below the least significant '1' bit in
+// |word|, which must not be zero.
+inline size_t CountTrailingZeros(uint32_t word) {
+  assert(word != 0 && "CountTrailingZeros requires a non-zero word");
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<size_t>(__builtin_ctz(word));
+#else
+  size_t count = 0;
+  while (!(word & 1)) {
+    word >>= 1;
+    ++count;
+  }
+  return count;
+#endif
+}
+
 // Checks if the bit at the |position| is set to '1'.
 // Bits zero-indexed starting at the least significant bit.
 // |position| must be within the bit width of |T|.
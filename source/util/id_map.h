@@ -0,0 +1,281 @@
+// Copyright (c) 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_ID_MAP_H_
+#define SOURCE_UTIL_ID_MAP_H_
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace spvtools {
+namespace utils {
+
+// A map from SPIR-V ids to values of type |T|, with an interface like the
+// one of std::map.
+//
+// The ids of a module are dense below its id bound, so the values are
+// stored in fixed-size pages indexed by id, instead of nodes or buckets.  A
+// look up is two array accesses, and the iteration is in increasing id
+// order.  A page is only allocated once an id in it is mapped, so a sparse
+// map only pays one pointer per page below its largest id.  The map grows as
+// larger ids are mapped.
+//
+// Every slot of an allocated page holds a value, so |T| must be default
+// constructible, and should be cheap to construct.  Erasing an id resets its
+// value to a default-constructed one.
+//
+// Mapping or unmapping an id does not move the other values, nor invalidate
+// the iterators to them, but mapping an id may change end().
+template <typename T>
+class IdMap {
+  enum : uint32_t { kPageBits = 8, kPageSize = 1u << kPageBits };
+
+  struct Page {
+    T values[kPageSize];
+    std::bitset<kPageSize> mapped;
+  };
+
+ public:
+  // The element an iterator refers to: a mapped id and its value.
+  template <typename Value>
+  struct Entry {
+    const uint32_t first;
+    Value& second;
+  };
+
+  template <typename Map, typename Value>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Entry<Value>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = Entry<Value>;
+
+    // Holds an entry, so that it->second works.
+    struct Arrow {
+      Entry<Value> entry;
+      Entry<Value>* operator->() { return &entry; }
+    };
+
+    Iterator() : map_(nullptr), position_(0) {}
+
+    // Converts an iterator to a const iterator.
+    template <typename OtherMap, typename OtherValue>
+    Iterator(const Iterator<OtherMap, OtherValue>& other)
+        : map_(other.map_), position_(other.position_) {}
+
+    Entry<Value> operator*() const {
+      const uint32_t id = static_cast<uint32_t>(position_);
+      return {id, map_->pages_[id >> kPageBits]->values[id & (kPageSize - 1)]};
+    }
+
+    Arrow operator->() const { return {**this}; }
+
+    Iterator& operator++() {
+      position_ = map_->NextMapped(position_ + 1);
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator result = *this;
+      ++*this;
+      return result;
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+      return lhs.position_ == rhs.position_;
+    }
+
+    friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    template <typename>
+    friend class IdMap;
+    template <typename, typename>
+    friend class Iterator;
+
+    Iterator(Map* map, size_t position) : map_(map), position_(position) {}
+
+    Map* map_;
+    // The mapped id, or the end of the pages.
+    size_t position_;
+  };
+
+  using key_type = uint32_t;
+  using mapped_type = T;
+  using iterator = Iterator<IdMap, T>;
+  using const_iterator = Iterator<const IdMap, const T>;
+
+  IdMap() : size_(0) {}
+
+  IdMap(IdMap&&) = default;
+  IdMap& operator=(IdMap&&) = default;
+
+  IdMap(const IdMap& that) : size_(that.size_) { *this = that; }
+  IdMap& operator=(const IdMap& that) {
+    if (this == &that) return *this;
+    pages_.clear();
+    pages_.reserve(that.pages_.size());
+    for (const auto& page : that.pages_) {
+      pages_.emplace_back(page ? new Page(*page) : nullptr);
+    }
+    size_ = that.size_;
+    return *this;
+  }
+
+  // Returns the number of mapped ids.
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Unmaps every id, and frees the pages.
+  void clear() {
+    pages_.clear();
+    size_ = 0;
+  }
+
+  // Returns 1 if |id| is mapped, and 0 otherwise.
+  size_t count(uint32_t id) const { return IsMapped(id) ? 1 : 0; }
+
+  iterator find(uint32_t id) {
+    return iterator(this, IsMapped(id) ? id : EndPosition());
+  }
+  const_iterator find(uint32_t id) const {
+    return const_iterator(this, IsMapped(id) ? id : EndPosition());
+  }
+
+  // Returns the value of |id|, mapping it to a default-constructed value
+  // first if it is not mapped.
+  T& operator[](uint32_t id) { return Map(id).first; }
+
+  // Returns the value of |id|, which must be mapped.  Like std::map::at, the
+  // check is not compiled out of release builds; since exceptions are
+  // disabled, an unmapped |id| aborts the process instead of throwing.
+  T& at(uint32_t id) {
+    if (!IsMapped(id)) AbortUnmapped(id);
+    return pages_[id >> kPageBits]->values[id & (kPageSize - 1)];
+  }
+  const T& at(uint32_t id) const {
+    if (!IsMapped(id)) AbortUnmapped(id);
+    return pages_[id >> kPageBits]->values[id & (kPageSize - 1)];
+  }
+
+  // Maps |id| to |value|, unless |id| is already mapped.  Returns the
+  // iterator to |id|, and whether it was mapped by this call.
+  std::pair<iterator, bool> emplace(uint32_t id, T value) {
+    auto slot = Map(id);
+    if (slot.second) slot.first = std::move(value);
+    return {iterator(this, id), slot.second};
+  }
+  std::pair<iterator, bool> insert(std::pair<uint32_t, T> entry) {
+    return emplace(entry.first, std::move(entry.second));
+  }
+
+  // Unmaps |id|.  Returns the number of ids unmapped.
+  size_t erase(uint32_t id) {
+    if (!IsMapped(id)) return 0;
+    Page& page = *pages_[id >> kPageBits];
+    page.mapped.reset(id & (kPageSize - 1));
+    page.values[id & (kPageSize - 1)] = T();
+    --size_;
+    return 1;
+  }
+  iterator erase(const_iterator where) {
+    const size_t next = NextMapped(where.position_ + 1);
+    erase(static_cast<uint32_t>(where.position_));
+    return iterator(this, next);
+  }
+
+  iterator begin() { return iterator(this, NextMapped(0)); }
+  iterator end() { return iterator(this, EndPosition()); }
+  const_iterator begin() const { return const_iterator(this, NextMapped(0)); }
+  const_iterator end() const { return const_iterator(this, EndPosition()); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  // Returns true if both maps map the same ids to equal values.
+  friend bool operator==(const IdMap& lhs, const IdMap& rhs) {
+    if (lhs.size() != rhs.size()) return false;
+    for (const auto& entry : lhs) {
+      const auto iter = rhs.find(entry.first);
+      if (iter == rhs.end() || !(iter->second == entry.second)) return false;
+    }
+    return true;
+  }
+  friend bool operator!=(const IdMap& lhs, const IdMap& rhs) {
+    return !(lhs == rhs);
+  }
+
+ private:
+  [[noreturn]] static void AbortUnmapped(uint32_t id) {
+    std::fprintf(stderr, "IdMap::at: id %u is not mapped.\n", id);
+    std::abort();
+  }
+
+  bool IsMapped(uint32_t id) const {
+    const size_t page = id >> kPageBits;
+    return page < pages_.size() && pages_[page] &&
+           pages_[page]->mapped.test(id & (kPageSize - 1));
+  }
+
+  // Returns the slot of |id|, allocating its page if needed, and whether
+  // |id| was unmapped.  Maps |id|.
+  std::pair<T&, bool> Map(uint32_t id) {
+    const size_t page_index = id >> kPageBits;
+    if (page_index >= pages_.size()) pages_.resize(page_index + 1);
+    auto& page = pages_[page_index];
+    if (!page) page.reset(new Page());
+    const size_t slot = id & (kPageSize - 1);
+    const bool was_unmapped = !page->mapped.test(slot);
+    if (was_unmapped) {
+      page->mapped.set(slot);
+      ++size_;
+    }
+    return {page->values[slot], was_unmapped};
+  }
+
+  size_t EndPosition() const { return pages_.size() * kPageSize; }
+
+  // Returns the first mapped id at or after |position|, or the end.
+  size_t NextMapped(size_t position) const {
+    const size_t end = EndPosition();
+    while (position < end) {
+      const auto& page = pages_[position >> kPageBits];
+      if (!page || page->mapped.none()) {
+        position = ((position >> kPageBits) + 1) << kPageBits;
+        continue;
+      }
+      if (page->mapped.test(position & (kPageSize - 1))) return position;
+      ++position;
+    }
+    return end;
+  }
+
+  std::vector<std::unique_ptr<Page>> pages_;
+  size_t size_;
+};
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_ID_MAP_H_
@@ -0,0 +1,74 @@
+// Copyright (c) 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_PARALLEL_H_
+#define SOURCE_UTIL_PARALLEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace spvtools {
+namespace utils {
+
+// Returns the number of threads that can usefully run at once on this
+// machine.  Always at least 1.
+inline uint32_t HardwareThreadCount() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Calls |task| with each index in [0, |count|), spreading the calls over at
+// most |num_threads| threads.  The calling thread is one of them.  The
+// indices are handed out in increasing order, but the calls may finish in
+// any order.  Returns once every call has returned.  |task| is called as
+// task(thread_index, index), where |thread_index| in [0, |num_threads|)
+// identifies the thread making the call.  Calls with the same thread index
+// never run concurrently, so they can share state that is not thread safe.
+template <typename Task>
+void ParallelForWithThreadIndex(size_t count, uint32_t num_threads,
+                                const Task& task) {
+  const size_t num_workers = std::min<size_t>(num_threads, count);
+  if (num_workers <= 1) {
+    for (size_t i = 0; i < count; ++i) task(0u, i);
+    return;
+  }
+
+  std::atomic<size_t> next(0);
+  auto work = [&next, count, &task](uint32_t thread_index) {
+    for (size_t i = next++; i < count; i = next++) task(thread_index, i);
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(num_workers - 1);
+  for (size_t i = 1; i < num_workers; ++i) {
+    threads.emplace_back(work, static_cast<uint32_t>(i));
+  }
+  work(0u);
+  for (auto& thread : threads) thread.join();
+}
+
+// Like ParallelForWithThreadIndex, but calls |task| as task(index).  |task|
+// must be safe to call concurrently with itself.
+template <typename Task>
+void ParallelFor(size_t count, uint32_t num_threads, const Task& task) {
+  ParallelForWithThreadIndex(
+      count, num_threads, [&task](uint32_t, size_t i) { task(i); });
+}
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_PARALLEL_H_
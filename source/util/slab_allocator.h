@@ -0,0 +1,222 @@
+// Copyright (c) 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_SLAB_ALLOCATOR_H_
+#define SOURCE_UTIL_SLAB_ALLOCATOR_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace spvtools {
+namespace utils {
+
+// Allocates small blocks of memory out of large slabs, and recycles the
+// freed blocks through one free list per block size.  Allocating and freeing
+// a block is a few pointer operations, instead of a call to the heap, and
+// the slabs are returned to the heap all at once.
+//
+// Every block starts with a header naming the allocator it came from, so
+// that Free() does not need to be told.  The blocks that are too large for
+// the slabs, or that are allocated without an allocator, come from the heap
+// and are freed to it.
+//
+// The owner of an allocator calls Release() instead of deleting it.  The
+// allocator is then destroyed once its last block is freed, so blocks may
+// outlive their owner.
+//
+// An allocator is not thread safe: its blocks must be allocated and freed by
+// one thread at a time.
+class SlabAllocator {
+ public:
+  // The largest block, header included, that comes from the slabs.
+  static constexpr size_t kMaxBlockSize = 512;
+  // The size of a slab.
+  static constexpr size_t kSlabSize = 64 * 1024;
+
+  SlabAllocator(const SlabAllocator&) = delete;
+  SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+  // Returns a new allocator, which the caller must release.
+  static SlabAllocator* Create() { return new SlabAllocator(); }
+
+  // Gives up the ownership of this allocator.  It is destroyed now if none
+  // of its blocks are in use, and otherwise once they are all freed.
+  void Release() {
+    released_ = true;
+    if (num_allocated_ == 0) delete this;
+  }
+
+  // Returns a block of |size| bytes, aligned like std::max_align_t.  The
+  // block comes from |allocator| if it is not null and the block is small
+  // enough, and from the heap otherwise.
+  static void* Allocate(SlabAllocator* allocator, size_t size) {
+    const size_t total = sizeof(Header) + size;
+    Header* header = nullptr;
+    if (allocator && total <= kMaxBlockSize) {
+      const size_t size_class = (total - 1) / kGranularity;
+      header = static_cast<Header*>(allocator->Take(size_class));
+      header->owner = allocator;
+      header->size_class = size_class;
+    } else {
+      header = static_cast<Header*>(::operator new(total));
+      header->owner = nullptr;
+      header->size_class = 0;
+    }
+    return header + 1;
+  }
+
+  // Frees |block|, which must have been returned by Allocate().
+  static void Free(void* block) {
+    if (!block) return;
+    Header* header = static_cast<Header*>(block) - 1;
+    SlabAllocator* owner = header->owner;
+    if (owner) {
+      owner->Give(header, header->size_class);
+    } else {
+      ::operator delete(header);
+    }
+  }
+
+  // Returns the number of blocks from the slabs that are not freed.
+  size_t num_allocated() const { return num_allocated_; }
+
+  // Returns the number of slabs.
+  size_t num_slabs() const { return slabs_.size(); }
+
+ private:
+  // The granularity of the block sizes, which keeps the blocks aligned.
+  static constexpr size_t kGranularity = alignof(std::max_align_t);
+  static constexpr size_t kNumSizeClasses = kMaxBlockSize / kGranularity;
+
+  struct alignas(std::max_align_t) Header {
+    // The allocator of the block, or null if the block is from the heap.
+    SlabAllocator* owner;
+    // The size of the block is (size_class + 1) * kGranularity bytes.
+    size_t size_class;
+  };
+
+  SlabAllocator() : next_(nullptr), end_(nullptr), free_lists_() {}
+
+  ~SlabAllocator() {
+    for (void* slab : slabs_) ::operator delete(slab);
+  }
+
+  // Returns a block of the given size class.
+  void* Take(size_t size_class) {
+    ++num_allocated_;
+    void*& free_list = free_lists_[size_class];
+    if (free_list) {
+      void* block = free_list;
+      free_list = *static_cast<void**>(block);
+      return block;
+    }
+    const size_t block_size = (size_class + 1) * kGranularity;
+    if (static_cast<size_t>(end_ - next_) < block_size) {
+      next_ = static_cast<char*>(::operator new(kSlabSize));
+      end_ = next_ + kSlabSize;
+      slabs_.push_back(next_);
+    }
+    void* block = next_;
+    next_ += block_size;
+    return block;
+  }
+
+  // Puts |block| of the given size class back on its free list.
+  void Give(void* block, size_t size_class) {
+    *static_cast<void**>(block) = free_lists_[size_class];
+    free_lists_[size_class] = block;
+    if (--num_allocated_ == 0 && released_) delete this;
+  }
+
+  // The unused part of the last slab.
+  char* next_;
+  char* end_;
+  std::vector<void*> slabs_;
+  // The first free block of each size class.  Each free block starts with a
+  // pointer to the next one.
+  void* free_lists_[kNumSizeClasses];
+  size_t num_allocated_ = 0;
+  bool released_ = false;
+};
+
+// A standard allocator that allocates from a SlabAllocator, or from the heap
+// if it has none.  Since every block records where it came from, any
+// instance frees any block, and all instances compare equal.
+//
+// The elements that accept this allocator (see std::uses_allocator) are
+// constructed with it, so that their own storage comes from the same slabs.
+// A copy of a container uses the heap rather than the slabs of the original:
+// copies may be made on threads that must not touch those slabs.
+template <class T>
+class SlabStlAllocator {
+ public:
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+                "The blocks are only aligned like std::max_align_t.");
+
+  using value_type = T;
+  using is_always_equal = std::true_type;
+
+  // Returns an allocator that allocates from the heap.
+  SlabStlAllocator() : slabs_(nullptr) {}
+  // Returns an allocator that allocates from |slabs|, or from the heap if it
+  // is null.
+  explicit SlabStlAllocator(SlabAllocator* slabs) : slabs_(slabs) {}
+  template <class U>
+  SlabStlAllocator(const SlabStlAllocator<U>& that) : slabs_(that.slabs()) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(SlabAllocator::Allocate(slabs_, n * sizeof(T)));
+  }
+  void deallocate(T* p, size_t) { SlabAllocator::Free(p); }
+
+  template <class U, class... Args>
+  void construct(U* p, Args&&... args) {
+    if constexpr (!std::uses_allocator<U, SlabStlAllocator>::value) {
+      ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    } else if constexpr (std::is_constructible<U, std::allocator_arg_t,
+                                               const SlabStlAllocator&,
+                                               Args...>::value) {
+      ::new (static_cast<void*>(p))
+          U(std::allocator_arg, *this, std::forward<Args>(args)...);
+    } else {
+      ::new (static_cast<void*>(p)) U(std::forward<Args>(args)..., *this);
+    }
+  }
+
+  SlabStlAllocator select_on_container_copy_construction() const {
+    return SlabStlAllocator();
+  }
+
+  // Returns the slabs this allocator allocates from, or null for the heap.
+  SlabAllocator* slabs() const { return slabs_; }
+
+  friend bool operator==(const SlabStlAllocator&, const SlabStlAllocator&) {
+    return true;
+  }
+  friend bool operator!=(const SlabStlAllocator&, const SlabStlAllocator&) {
+    return false;
+  }
+
+ private:
+  SlabAllocator* slabs_;
+};
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_SLAB_ALLOCATOR_H_
@@ -20,6 +20,7 @@
 #include <cstddef>
 #include <iostream>
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -37,27 +38,59 @@ namespace utils {
 // should experiment with different values for |small_size| and compare to
 // using and |std::vector|.
 //
+// The elements that do not fit in the vector itself, and the std::vector
+// holding them, are allocated with |Allocator|.  Any instance of |Allocator|
+// must be able to free what another one allocated.  Like a std::vector, a copy
+// gets the allocator given by select_on_container_copy_construction(), and
+// an assignment keeps the allocator of the vector assigned to.
+//
 // TODO: I have implemented the public member functions from |std::vector| that
 // I needed.  If others are needed they should be implemented. Do not implement
 // public member functions that are not defined by std::vector.
-template <class T, size_t small_size>
+template <class T, size_t small_size, class Allocator = std::allocator<T>>
 class SmallVector {
+  static_assert(std::allocator_traits<Allocator>::is_always_equal::value,
+                "The allocators must be interchangeable.");
+
+  using LargeVector = std::vector<T, Allocator>;
+
  public:
   using iterator = T*;
   using const_iterator = const T*;
+  using allocator_type = Allocator;
 
-  SmallVector()
+  SmallVector() : SmallVector(Allocator()) {}
+
+  explicit SmallVector(const Allocator& allocator)
       : size_(0),
         small_data_(reinterpret_cast<T*>(buffer)),
+        allocator_(allocator),
         large_data_(nullptr) {}
 
-  SmallVector(const SmallVector& that) : SmallVector() { *this = that; }
+  SmallVector(const SmallVector& that)
+      : SmallVector(std::allocator_traits<Allocator>::
+                        select_on_container_copy_construction(
+                            that.allocator_)) {
+    *this = that;
+  }
+
+  SmallVector(const SmallVector& that, const Allocator& allocator)
+      : SmallVector(allocator) {
+    *this = that;
+  }
+
+  SmallVector(SmallVector&& that) : SmallVector(that.allocator_) {
+    *this = std::move(that);
+  }
 
-  SmallVector(SmallVector&& that) : SmallVector() { *this = std::move(that); }
+  SmallVector(SmallVector&& that, const Allocator& allocator)
+      : SmallVector(allocator) {
+    *this = std::move(that);
+  }
 
   SmallVector(const std::vector<T>& vec) : SmallVector() {
     if (vec.size() > small_size) {
-      large_data_ = MakeUnique<std::vector<T>>(vec);
+      MakeLargeData(vec.begin(), vec.end());
     } else {
       size_ = vec.size();
       for (uint32_t i = 0; i < size_; i++) {
@@ -71,9 +104,20 @@ class SmallVector {
     insert(end(), first, last);
   }
 
+  template <class InputIt>
+  SmallVector(InputIt first, InputIt last, const Allocator& allocator)
+      : SmallVector(allocator) {
+    insert(end(), first, last);
+  }
+
   SmallVector(std::vector<T>&& vec) : SmallVector() {
     if (vec.size() > small_size) {
-      large_data_ = MakeUnique<std::vector<T>>(std::move(vec));
+      if constexpr (std::is_same<LargeVector, std::vector<T>>::value) {
+        MakeLargeData(std::move(vec));
+      } else {
+        MakeLargeData(std::make_move_iterator(vec.begin()),
+                      std::make_move_iterator(vec.end()));
+      }
     } else {
       size_ = vec.size();
       for (uint32_t i = 0; i < size_; i++) {
@@ -89,7 +133,7 @@ class SmallVector {
         new (small_data_ + (size_++)) T(std::move(*it));
       }
     } else {
-      large_data_ = MakeUnique<std::vector<T>>(std::move(init_list));
+      MakeLargeData(init_list);
     }
   }
 
@@ -107,7 +151,7 @@ class SmallVector {
       if (large_data_) {
         *large_data_ = *that.large_data_;
       } else {
-        large_data_ = MakeUnique<std::vector<T>>(*that.large_data_);
+        MakeLargeData(*that.large_data_);
       }
     } else {
       large_data_.reset(nullptr);
@@ -354,7 +398,7 @@ class SmallVector {
     }
 
     if (large_data_) {
-      typename std::vector<T>::iterator new_pos =
+      typename LargeVector::iterator new_pos =
           large_data_->begin() + element_idx;
       large_data_->insert(new_pos, first, last);
       return begin() + element_idx;
@@ -440,12 +484,39 @@ class SmallVector {
     size_ = new_size;
   }
 
+  allocator_type get_allocator() const { return allocator_; }
+
  private:
+  using LargeAllocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<LargeVector>;
+
+  // Destroys and frees a vector made by MakeLargeData().
+  struct LargeDataDeleter {
+    void operator()(LargeVector* large) const {
+      // Any allocator frees what another one allocated.
+      LargeAllocator large_allocator;
+      large->~LargeVector();
+      std::allocator_traits<LargeAllocator>::deallocate(large_allocator, large,
+                                                        1);
+    }
+  };
+
+  // Makes |large_data_| a new vector constructed from |args| and
+  // |allocator_|, allocated with |allocator_| too.
+  template <class... Args>
+  void MakeLargeData(Args&&... args) {
+    LargeAllocator large_allocator(allocator_);
+    LargeVector* large =
+        std::allocator_traits<LargeAllocator>::allocate(large_allocator, 1);
+    new (large) LargeVector(std::forward<Args>(args)..., allocator_);
+    large_data_.reset(large);
+  }
+
   // Moves all of the element from |small_data_| into a new std::vector that can
   // be access through |large_data|.
   void MoveToLargeData() {
     assert(!large_data_);
-    large_data_ = MakeUnique<std::vector<T>>();
+    MakeLargeData();
     for (size_t i = 0; i < size_; ++i) {
       large_data_->emplace_back(std::move(small_data_[i]));
     }
@@ -476,11 +547,14 @@ class SmallVector {
   // elements is small.
   T* small_data_;
 
+  // The allocator of |large_data_|.
+  Allocator allocator_;
+
   // A pointer to a vector that is used to store the elements of the vector when
   // this size exceeds |small_size|.  If |large_data_| is nullptr, then the data
   // is stored in |small_data_|.  Otherwise, the data is stored in
   // |large_data_|.
-  std::unique_ptr<std::vector<T>> large_data_;
+  std::unique_ptr<LargeVector, LargeDataDeleter> large_data_;
 };  // namespace utils
 
 }  // namespace utils
@@ -25,6 +25,8 @@ BasicBlock::BasicBlock(uint32_t label_id)
       immediate_dominator_(nullptr),
       immediate_structural_dominator_(nullptr),
       immediate_structural_post_dominator_(nullptr),
+      tree_enter_(),
+      tree_leave_(),
       predecessors_(),
       successors_(),
       type_(0),
@@ -77,19 +79,50 @@ void BasicBlock::RegisterSuccessors(
   }
 }
 
+void BasicBlock::SetDominatorTreeInterval(DominatorTree tree, uint32_t enter,
+                                          uint32_t leave) {
+  tree_enter_[static_cast<size_t>(tree)] = enter;
+  tree_leave_[static_cast<size_t>(tree)] = leave;
+}
+
+bool BasicBlock::HasDominatorTreeIntervals(DominatorTree tree,
+                                           const BasicBlock& other) const {
+  const auto index = static_cast<size_t>(tree);
+  return tree_enter_[index] != 0 && other.tree_enter_[index] != 0;
+}
+
+bool BasicBlock::DominatorTreeIntervalContains(DominatorTree tree,
+                                               const BasicBlock& other) const {
+  const auto index = static_cast<size_t>(tree);
+  return tree_enter_[index] <= other.tree_enter_[index] &&
+         other.tree_leave_[index] <= tree_leave_[index];
+}
+
 bool BasicBlock::dominates(const BasicBlock& other) const {
+  if (HasDominatorTreeIntervals(DominatorTree::kDominator, other)) {
+    return DominatorTreeIntervalContains(DominatorTree::kDominator, other);
+  }
   return (this == &other) ||
          !(other.dom_end() ==
            std::find(other.dom_begin(), other.dom_end(), this));
 }
 
 bool BasicBlock::structurally_dominates(const BasicBlock& other) const {
+  if (HasDominatorTreeIntervals(DominatorTree::kStructuralDominator, other)) {
+    return DominatorTreeIntervalContains(DominatorTree::kStructuralDominator,
+                                         other);
+  }
   return (this == &other) || !(other.structural_dom_end() ==
                                std::find(other.structural_dom_begin(),
                                          other.structural_dom_end(), this));
 }
 
 bool BasicBlock::structurally_postdominates(const BasicBlock& other) const {
+  if (HasDominatorTreeIntervals(DominatorTree::kStructuralPostDominator,
+                                other)) {
+    return DominatorTreeIntervalContains(
+        DominatorTree::kStructuralPostDominator, other);
+  }
   return (this == &other) || !(other.structural_pdom_end() ==
                                std::find(other.structural_pdom_begin(),
                                          other.structural_pdom_end(), this));
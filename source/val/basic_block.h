@@ -37,6 +37,14 @@ enum BlockType : uint32_t {
   kBlockTypeCOUNT  ///< Total number of block types. (must be the last element)
 };
 
+/// The dominator trees computed for the blocks of a function.
+enum class DominatorTree : uint32_t {
+  kDominator,
+  kStructuralDominator,
+  kStructuralPostDominator,
+  kCount  ///< Total number of trees. (must be the last element)
+};
+
 class Instruction;
 
 // This class represents a basic block in a SPIR-V module
@@ -179,6 +187,16 @@ class BasicBlock {
   /// Assumes structural dominators have been computed.
   bool structurally_postdominates(const BasicBlock& other) const;
 
+  /// Sets the interval of this block in a depth-first traversal of the given
+  /// dominator tree: the traversal enters the block at step @p enter and
+  /// leaves it at step @p leave.  Zero clears the interval.
+  ///
+  /// A block dominates another in the tree if and only if its interval
+  /// contains the interval of the other block, which takes constant time to
+  /// check.  Without the intervals, the dominance queries walk up the tree.
+  void SetDominatorTreeInterval(DominatorTree tree, uint32_t enter,
+                                uint32_t leave);
+
   void RegisterStructuralSuccessor(BasicBlock* block) {
     block->structural_predecessors_.push_back(this);
     structural_successors_.push_back(block);
@@ -267,6 +285,16 @@ class BasicBlock {
   DominatorIterator structural_pdom_end();
 
  private:
+  /// Returns true if this block and @p other have an interval in the given
+  /// dominator tree.
+  bool HasDominatorTreeIntervals(DominatorTree tree,
+                                 const BasicBlock& other) const;
+
+  /// Returns true if the interval of this block in the given dominator tree
+  /// contains the interval of @p other.
+  bool DominatorTreeIntervalContains(DominatorTree tree,
+                                     const BasicBlock& other) const;
+
   /// Id of the BasicBlock
   const uint32_t id_;
 
@@ -279,6 +307,11 @@ class BasicBlock {
   /// Pointer to the immediate structural post dominator of the BasicBlock
   BasicBlock* immediate_structural_post_dominator_;
 
+  /// The steps at which a depth-first traversal of each dominator tree enters
+  /// and leaves the BasicBlock, or zero if the tree is not numbered.
+  uint32_t tree_enter_[static_cast<size_t>(DominatorTree::kCount)];
+  uint32_t tree_leave_[static_cast<size_t>(DominatorTree::kCount)];
+
   /// The set of predecessors of the BasicBlock
   std::vector<BasicBlock*> predecessors_;
 
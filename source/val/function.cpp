@@ -296,6 +296,66 @@ void Function::ComputeAugmentedCFG() {
       pred_func);
 }
 
+void Function::NumberDominatorTree(DominatorTree tree) {
+  auto dominator = [tree](const BasicBlock* block) -> const BasicBlock* {
+    switch (tree) {
+      case DominatorTree::kDominator:
+        return block->immediate_dominator();
+      case DominatorTree::kStructuralDominator:
+        return block->immediate_structural_dominator();
+      case DominatorTree::kStructuralPostDominator:
+        return block->immediate_structural_post_dominator();
+      case DominatorTree::kCount:
+        break;
+    }
+    return nullptr;
+  };
+
+  std::vector<BasicBlock*> blocks = {&pseudo_entry_block_,
+                                     &pseudo_exit_block_};
+  for (auto& block : blocks_) blocks.push_back(&block.second);
+
+  // Build the tree from the immediate dominators.  The root of the tree is
+  // its own immediate dominator, or has none.
+  std::unordered_map<const BasicBlock*, std::vector<BasicBlock*>> children;
+  for (auto block : blocks) {
+    block->SetDominatorTreeInterval(tree, 0, 0);
+    children[block];
+  }
+  std::vector<BasicBlock*> roots;
+  for (auto block : blocks) {
+    const BasicBlock* parent = dominator(block);
+    auto where = parent == block ? children.end() : children.find(parent);
+    if (where == children.end()) {
+      roots.push_back(block);
+    } else {
+      where->second.push_back(block);
+    }
+  }
+
+  struct Visit {
+    BasicBlock* block;
+    uint32_t enter;
+    size_t next_child;
+  };
+  std::vector<Visit> stack;
+  uint32_t step = 0;
+  for (auto root : roots) {
+    stack.push_back({root, ++step, 0});
+    while (!stack.empty()) {
+      Visit& visit = stack.back();
+      const auto& block_children = children[visit.block];
+      if (visit.next_child < block_children.size()) {
+        BasicBlock* child = block_children[visit.next_child++];
+        stack.push_back({child, ++step, 0});
+      } else {
+        visit.block->SetDominatorTreeInterval(tree, visit.enter, ++step);
+        stack.pop_back();
+      }
+    }
+  }
+}
+
 Construct& Function::AddConstruct(const Construct& new_construct) {
   cfg_constructs_.push_back(new_construct);
   auto& result = cfg_constructs_.back();
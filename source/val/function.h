@@ -193,6 +193,12 @@ class Function {
   /// Returns the block structural predecessors function for the augmented CFG.
   GetBlocksFunction AugmentedStructuralCFGPredecessorsFunction() const;
 
+  /// Numbers the blocks of the function in a depth-first traversal of the
+  /// given dominator tree, so that dominance queries in that tree take
+  /// constant time.  Must be called once the immediate dominators of the tree
+  /// are set, and again whenever they change.
+  void NumberDominatorTree(DominatorTree tree);
+
   /// Returns the control flow nesting depth of the given basic block.
   /// This function only works when you have structured control flow.
   /// This function should only be called after the control flow constructs have
@@ -24,6 +24,7 @@
 #include "source/ext_inst.h"
 #include "source/opcode.h"
 #include "source/table.h"
+#include "source/util/span.h"
 #include "spirv-tools/libspirv.h"
 
 namespace spvtools {
@@ -34,8 +35,15 @@ class Function;
 
 /// Wraps the spv_parsed_instruction struct along with use and definition of the
 /// instruction's result id
+///
+/// The words and the operand descriptors of the instruction are not copied.
+/// The validation state keeps the words in the module binary and the operand
+/// descriptors in a table shared by the whole module, both of which outlive
+/// its instructions.
 class Instruction {
  public:
+  /// Wraps |inst|.  The words and operands |inst| points to must outlive the
+  /// Instruction.
   explicit Instruction(const spv_parsed_instruction_t* inst);
 
   /// Registers the use of the Instruction in instruction \p inst at \p index
@@ -64,19 +72,26 @@ class Instruction {
   }
 
   /// The word used to define the Instruction
-  uint32_t word(size_t index) const { return words_[index]; }
+  uint32_t word(size_t index) const {
+    assert(index < inst_.num_words);
+    return inst_.words[index];
+  }
 
   /// The words used to define the Instruction
-  const std::vector<uint32_t>& words() const { return words_; }
+  utils::Span<uint32_t> words() const {
+    return utils::Span<uint32_t>(inst_.words, inst_.num_words);
+  }
 
   /// Returns the operand at |idx|.
   const spv_parsed_operand_t& operand(size_t idx) const {
-    return operands_[idx];
+    assert(idx < inst_.num_operands);
+    return inst_.operands[idx];
   }
 
   /// The operands of the Instruction
-  const std::vector<spv_parsed_operand_t>& operands() const {
-    return operands_;
+  utils::Span<spv_parsed_operand_t> operands() const {
+    return utils::Span<spv_parsed_operand_t>(inst_.operands,
+                                             inst_.num_operands);
   }
 
   /// Provides direct access to the stored C instruction object.
@@ -101,18 +116,26 @@ class Instruction {
   // Casts the words belonging to the operand under |index| to |T| and returns.
   template <typename T>
   T GetOperandAs(size_t index) const {
-    const spv_parsed_operand_t& o = operands_.at(index);
+    const spv_parsed_operand_t& o = CheckedOperand(index);
     assert(o.num_words * 4 >= sizeof(T));
     assert(o.offset + o.num_words <= inst_.num_words);
-    return *reinterpret_cast<const T*>(&words_[o.offset]);
+    return *reinterpret_cast<const T*>(&inst_.words[o.offset]);
   }
 
   size_t LineNum() const { return line_num_; }
   void SetLineNum(size_t pos) { line_num_ = pos; }
 
  private:
-  const std::vector<uint32_t> words_;
-  const std::vector<spv_parsed_operand_t> operands_;
+  /// Returns the operand at |index|, or aborts if there is no such operand.
+  /// Unlike operand(), this is checked in release builds too, since the
+  /// checks ask for optional operands that may be missing.
+  const spv_parsed_operand_t& CheckedOperand(size_t index) const {
+    if (index >= inst_.num_operands) AbortMissingOperand(index);
+    return inst_.operands[index];
+  }
+
+  [[noreturn]] void AbortMissingOperand(size_t index) const;
+
   spv_parsed_instruction_t inst_;
   size_t line_num_ = 0;
 
@@ -14,10 +14,14 @@
 
 #include "source/val/validate.h"
 
+#include <algorithm>
 #include <functional>
 #include <iterator>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "source/binary.h"
@@ -28,6 +32,7 @@
 #include "source/spirv_constant.h"
 #include "source/spirv_endian.h"
 #include "source/spirv_target_env.h"
+#include "source/spirv_validator_options.h"
 #include "source/val/construct.h"
 #include "source/val/instruction.h"
 #include "source/val/validation_state.h"
@@ -151,9 +156,169 @@ spv_result_t ValidateEntryPoints(ValidationState_t& _) {
   return SPV_SUCCESS;
 }
 
+using OpcodePass = spv_result_t (*)(ValidationState_t&, const Instruction*);
+
+// A per-instruction pass, and the opcodes it checks.
+struct OpcodePassEntry {
+  bool (*handles)(spv::Op opcode);
+  OpcodePass pass;
+  // True if, for an instruction in a function, the pass records nothing, and
+  // only looks at that function, the instructions before the functions, and
+  // the OpFunction instructions.  Such a pass can skip verified functions.
+  bool function_local;
+  // True if the pass is part of the structural tier of validation.
+  bool structural;
+};
+
+// Keep these passes in the order they appear in the SPIR-V specification
+// sections to maintain test consistency.
+const OpcodePassEntry kOpcodePasses[] = {
+    {MiscPassHandles, MiscPass, false, false},
+    {DebugPassHandles, DebugPass, true, false},
+    {AnnotationPassHandles, AnnotationPass, false, false},
+    {ExtensionPassHandles, ExtensionPass, false, false},
+    {ModeSettingPassHandles, ModeSettingPass, false, false},
+    {TypePassHandles, TypePass, false, false},
+    {ConstantPassHandles, ConstantPass, true, false},
+    {MemoryPassHandles, MemoryPass, false, false},
+    // Checks the uses of each function, wherever they are.
+    {FunctionPassHandles, FunctionPass, false, false},
+    {ImagePassHandles, ImagePass, false, false},
+    {ConversionPassHandles, ConversionPass, true, false},
+    {CompositesPassHandles, CompositesPass, true, false},
+    {ArithmeticsPassHandles, ArithmeticsPass, true, false},
+    {BitwisePassHandles, BitwisePass, true, false},
+    {LogicalsPassHandles, LogicalsPass, true, false},
+    {ControlFlowPassHandles, ControlFlowPass, true, true},
+    {DerivativesPassHandles, DerivativesPass, false, false},
+    {AtomicsPassHandles, AtomicsPass, false, false},
+    {PrimitivesPassHandles, PrimitivesPass, false, false},
+    {BarriersPassHandles, BarriersPass, false, false},
+    // Group
+    // Device-Side Enqueue
+    // Pipe
+    {NonUniformPassHandles, NonUniformPass, false, false},
+
+    {LiteralsPassHandles, LiteralsPass, true, false},
+    {RayQueryPassHandles, RayQueryPass, true, false},
+    {RayTracingPassHandles, RayTracingPass, false, false},
+    {RayReorderNVPassHandles, RayReorderNVPass, false, false},
+    {MeshShadingPassHandles, MeshShadingPass, false, false},
+};
+
+// The passes of kOpcodePasses that check each opcode, in their order there.
+// Covers the opcodes up to the largest one in the grammar.  Any larger opcode
+// gets all the passes of the tier.
+class OpcodeDispatchTable {
+ public:
+  OpcodeDispatchTable() {
+    spv_opcode_table grammar = nullptr;
+    spvOpcodeTableGet(&grammar, SPV_ENV_UNIVERSAL_1_0);
+    uint32_t num_opcodes = 0;
+    for (uint32_t i = 0; i < grammar->count; ++i) {
+      num_opcodes = std::max(
+          num_opcodes, static_cast<uint32_t>(grammar->entries[i].opcode) + 1);
+    }
+
+    for (bool structural : {false, true}) {
+      for (bool verified : {false, true}) {
+        auto& list = lists_[structural][verified];
+        list.starts.reserve(num_opcodes + 1);
+        for (uint32_t opcode = 0; opcode < num_opcodes; ++opcode) {
+          list.starts.push_back(static_cast<uint32_t>(list.passes.size()));
+          for (const auto& entry : kOpcodePasses) {
+            if (structural && !entry.structural) continue;
+            if (verified && entry.function_local) continue;
+            if (entry.handles(static_cast<spv::Op>(opcode))) {
+              list.passes.push_back(entry.pass);
+            }
+          }
+        }
+        list.starts.push_back(static_cast<uint32_t>(list.passes.size()));
+      }
+
+      for (const auto& entry : kOpcodePasses) {
+        if (structural && !entry.structural) continue;
+        all_passes_[structural].push_back(entry.pass);
+      }
+    }
+  }
+
+  // Returns the table, which is built on first use.
+  static const OpcodeDispatchTable& Get() {
+    static const OpcodeDispatchTable table;
+    return table;
+  }
+
+  // Returns the passes that check |opcode|, as the range [*first, *last).
+  // If |structural|, leaves out the passes that are not structural.  If
+  // |verified|, leaves out the function-local passes.
+  void PassesFor(spv::Op opcode, bool structural, bool verified,
+                 const OpcodePass** first, const OpcodePass** last) const {
+    const auto& list = lists_[structural][verified];
+    const auto index = static_cast<size_t>(opcode);
+    if (index + 1 >= list.starts.size()) {
+      const auto& all_passes = all_passes_[structural];
+      *first = all_passes.data();
+      *last = all_passes.data() + all_passes.size();
+      return;
+    }
+    *first = list.passes.data() + list.starts[index];
+    *last = list.passes.data() + list.starts[index + 1];
+  }
+
+ private:
+  // The passes for opcode i are passes[starts[i]] to passes[starts[i + 1]].
+  struct PassList {
+    std::vector<uint32_t> starts;
+    std::vector<OpcodePass> passes;
+  };
+
+  // The lists for the standard and the structural tiers, and in each, for
+  // instructions in functions that are not verified, and for those in
+  // verified functions.
+  PassList lists_[2][2];
+  // All the passes, and the structural passes.
+  std::vector<OpcodePass> all_passes_[2];
+};
+
+// Checks the rules of the opcode of the given instruction.  If |verified|,
+// the instruction is in a verified function.
+spv_result_t ValidateOpcodes(ValidationState_t& _, const Instruction* inst,
+                             bool verified) {
+  const OpcodePass* first = nullptr;
+  const OpcodePass* last = nullptr;
+  const bool structural =
+      _.options()->tier == spv_validator_tier_structural;
+  OpcodeDispatchTable::Get().PassesFor(inst->opcode(), structural, verified,
+                                       &first, &last);
+  for (const OpcodePass* pass = first; pass != last; ++pass) {
+    if (auto error = (*pass)(_, inst)) return error;
+  }
+  return SPV_SUCCESS;
+}
+
+// Checks the rules of the opcodes of the instructions in [begin, end) of the
+// ordered instructions.  If |verified|, they are in a verified function.
+spv_result_t ValidateOpcodes(ValidationState_t& _, size_t begin, size_t end,
+                             bool verified) {
+  for (size_t i = begin; i < end; ++i) {
+    if (auto error =
+            ValidateOpcodes(_, &_.ordered_instructions()[i], verified)) {
+      return error;
+    }
+  }
+  return SPV_SUCCESS;
+}
+
+// Validates the given module.  If |find_verified_functions| is given, it is
+// called once the module is parsed, before the checks of the functions, to
+// set the verified functions of |vstate|.
 spv_result_t ValidateBinaryUsingContextAndValidationState(
     const spv_context_t& context, const uint32_t* words, const size_t num_words,
-    spv_diagnostic* pDiagnostic, ValidationState_t* vstate) {
+    spv_diagnostic* pDiagnostic, ValidationState_t* vstate,
+    const std::function<void(ValidationState_t*)>& find_verified_functions =
+        nullptr) {
   auto binary = std::unique_ptr<spv_const_binary_t>(
       new spv_const_binary_t{words, num_words});
 
@@ -201,8 +366,11 @@ spv_result_t ValidateBinaryUsingContextAndValidationState(
                  /* diagnostic = */ nullptr);
 
   // Parse the module and perform inline validation checks. These checks do
-  // not require the knowledge of the whole module.
-  if (auto error = spvBinaryParse(&context, vstate, words, num_words,
+  // not require the knowledge of the whole module.  The instructions keep
+  // pointers into the parsed words, so parse the validation state's copy of
+  // the module, which is in host endianness.
+  if (auto error = spvBinaryParse(&context, vstate, vstate->words(),
+                                  vstate->num_words(),
                                   /*parsed_header =*/nullptr,
                                   ProcessInstruction, pDiagnostic)) {
     return error;
@@ -330,42 +498,31 @@ spv_result_t ValidateBinaryUsingContextAndValidationState(
     if (auto error = UpdateIdUse(*vstate, &instruction)) return error;
   }
 
-  // Validate individual opcodes.
-  for (size_t i = 0; i < vstate->ordered_instructions().size(); ++i) {
-    auto& instruction = vstate->ordered_instructions()[i];
-
-    // Keep these passes in the order they appear in the SPIR-V specification
-    // sections to maintain test consistency.
-    if (auto error = MiscPass(*vstate, &instruction)) return error;
-    if (auto error = DebugPass(*vstate, &instruction)) return error;
-    if (auto error = AnnotationPass(*vstate, &instruction)) return error;
-    if (auto error = ExtensionPass(*vstate, &instruction)) return error;
-    if (auto error = ModeSettingPass(*vstate, &instruction)) return error;
-    if (auto error = TypePass(*vstate, &instruction)) return error;
-    if (auto error = ConstantPass(*vstate, &instruction)) return error;
-    if (auto error = MemoryPass(*vstate, &instruction)) return error;
-    if (auto error = FunctionPass(*vstate, &instruction)) return error;
-    if (auto error = ImagePass(*vstate, &instruction)) return error;
-    if (auto error = ConversionPass(*vstate, &instruction)) return error;
-    if (auto error = CompositesPass(*vstate, &instruction)) return error;
-    if (auto error = ArithmeticsPass(*vstate, &instruction)) return error;
-    if (auto error = BitwisePass(*vstate, &instruction)) return error;
-    if (auto error = LogicalsPass(*vstate, &instruction)) return error;
-    if (auto error = ControlFlowPass(*vstate, &instruction)) return error;
-    if (auto error = DerivativesPass(*vstate, &instruction)) return error;
-    if (auto error = AtomicsPass(*vstate, &instruction)) return error;
-    if (auto error = PrimitivesPass(*vstate, &instruction)) return error;
-    if (auto error = BarriersPass(*vstate, &instruction)) return error;
-    // Group
-    // Device-Side Enqueue
-    // Pipe
-    if (auto error = NonUniformPass(*vstate, &instruction)) return error;
-
-    if (auto error = LiteralsPass(*vstate, &instruction)) return error;
-    if (auto error = RayQueryPass(*vstate, &instruction)) return error;
-    if (auto error = RayTracingPass(*vstate, &instruction)) return error;
-    if (auto error = RayReorderNVPass(*vstate, &instruction)) return error;
-    if (auto error = MeshShadingPass(*vstate, &instruction)) return error;
+  if (find_verified_functions) find_verified_functions(vstate);
+
+  // Validate individual opcodes.  The checks of the instructions in a
+  // function only update the state of that function, so the functions can be
+  // checked concurrently once the rest of the module has been checked.
+  const auto& instructions = vstate->ordered_instructions();
+  const std::vector<size_t> function_begins =
+      vstate->function_instruction_begins();
+  const size_t functions_begin =
+      function_begins.empty() ? instructions.size() : function_begins[0];
+  if (auto error = ValidateOpcodes(*vstate, 0, functions_begin, false)) {
+    return error;
+  }
+  if (auto error = vstate->CheckEach(
+          function_begins.size(),
+          [vstate, &instructions, &function_begins](size_t function_index) {
+            const size_t begin = function_begins[function_index];
+            const size_t end = function_index + 1 < function_begins.size()
+                                   ? function_begins[function_index + 1]
+                                   : instructions.size();
+            return ValidateOpcodes(
+                *vstate, begin, end,
+                vstate->IsVerifiedFunction(instructions[begin].id()));
+          })) {
+    return error;
   }
 
   // Validate the preconditions involving adjacent instructions. e.g.
@@ -373,15 +530,24 @@ spv_result_t ValidateBinaryUsingContextAndValidationState(
   // or spv::Op::OpLine.
   if (auto error = ValidateAdjacency(*vstate)) return error;
 
-  if (auto error = ValidateEntryPoints(*vstate)) return error;
+  // The structural tier stops after the checks of the control flow and of
+  // the dominance of the ids.
+  const bool structural =
+      vstate->options()->tier == spv_validator_tier_structural;
+
+  if (!structural) {
+    if (auto error = ValidateEntryPoints(*vstate)) return error;
+  }
   // CFG checks are performed after the binary has been parsed
   // and the CFGPass has collected information about the control flow
   if (auto error = PerformCfgChecks(*vstate)) return error;
   if (auto error = CheckIdDefinitionDominateUse(*vstate)) return error;
+  if (structural) return SPV_SUCCESS;
+
   if (auto error = ValidateDecorations(*vstate)) return error;
   if (auto error = ValidateInterfaces(*vstate)) return error;
-  // TODO(dsinclair): Restructure ValidateBuiltins so we can move into the
-  // for() above as it loops over all ordered_instructions internally.
+  // The built-ins are checked at the instructions that reference them, which
+  // are found from the uses recorded above rather than by another sweep.
   if (auto error = ValidateBuiltIns(*vstate)) return error;
   // These checks must be performed after individual opcode checks because
   // those checks register the limitation checked here.
@@ -467,3 +633,185 @@ spv_result_t spvValidateWithOptions(const spv_const_context context,
   return spvtools::val::ValidateBinaryUsingContextAndValidationState(
       hijack_context, binary->code, binary->wordCount, pDiagnostic, &vstate);
 }
+
+namespace {
+
+// Where a function lies in a module, as word offsets.
+struct FunctionRange {
+  size_t begin;
+  // The end of its OpFunction instruction.
+  size_t header_end;
+  size_t end;
+};
+
+// The functions of a module, by id, and where they start.
+struct FunctionLayout {
+  size_t functions_begin = 0;
+  std::unordered_map<uint32_t, FunctionRange> functions;
+};
+
+// Finds the functions of the given module, which has been parsed.  Returns
+// false if two functions have the same id, which the validation reports.
+bool FindFunctions(const spvtools::val::ValidationState_t& vstate,
+                   FunctionLayout* layout) {
+  const auto& instructions = vstate.ordered_instructions();
+  // Returns the word offset of the instruction at the given index.
+  const auto offset = [&vstate, &instructions](size_t index) {
+    if (index == instructions.size()) return vstate.num_words();
+    return static_cast<size_t>(instructions[index].words().data() -
+                               vstate.words());
+  };
+
+  const std::vector<size_t> function_begins =
+      vstate.function_instruction_begins();
+  layout->functions_begin =
+      offset(function_begins.empty() ? instructions.size()
+                                     : function_begins[0]);
+  for (size_t i = 0; i < function_begins.size(); ++i) {
+    const auto& function = instructions[function_begins[i]];
+    FunctionRange range = {};
+    range.begin = offset(function_begins[i]);
+    range.header_end = range.begin + function.words().size();
+    range.end = offset(i + 1 < function_begins.size() ? function_begins[i + 1]
+                                                      : instructions.size());
+    if (!layout->functions.insert({function.id(), range}).second) return false;
+  }
+  return true;
+}
+
+// Returns true if the words in [begin, begin + count) are the same in both
+// modules.
+bool SameWords(const uint32_t* words, size_t begin,
+               const std::vector<uint32_t>& other_words, size_t other_begin,
+               size_t count) {
+  return std::equal(words + begin, words + begin + count,
+                    other_words.begin() + other_begin);
+}
+
+}  // namespace
+
+namespace spvtools {
+namespace val {
+
+struct IncrementalValidator::LastModule {
+  // Returns the ids of the functions of the given module, laid out as
+  // |module_layout| says, that are verified with respect to this module.
+  std::unordered_set<uint32_t> FindVerifiedFunctions(
+      const uint32_t* module, const FunctionLayout& module_layout) const;
+
+  spv_target_env env = SPV_ENV_UNIVERSAL_1_0;
+  std::vector<uint32_t> words;
+  FunctionLayout layout;
+};
+
+std::unordered_set<uint32_t>
+IncrementalValidator::LastModule::FindVerifiedFunctions(
+    const uint32_t* module, const FunctionLayout& module_layout) const {
+  std::unordered_set<uint32_t> verified;
+
+  // Everything before the functions must be the same, except the id bound.
+  const size_t functions_begin = module_layout.functions_begin;
+  if (functions_begin != layout.functions_begin ||
+      !SameWords(module, 0, words, 0, SPV_INDEX_BOUND) ||
+      !SameWords(module, SPV_INDEX_BOUND + 1, words, SPV_INDEX_BOUND + 1,
+                 functions_begin - SPV_INDEX_BOUND - 1)) {
+    return verified;
+  }
+
+  for (const auto& function : module_layout.functions) {
+    const auto last = layout.functions.find(function.first);
+    if (last == layout.functions.end()) continue;
+    const FunctionRange& range = function.second;
+    const FunctionRange& last_range = last->second;
+    // The first word holds the length of the OpFunction.
+    if (!SameWords(module, range.begin, words, last_range.begin,
+                   range.header_end - range.begin)) {
+      // The calls to the function may have become invalid anywhere.
+      return {};
+    }
+    if (range.end - range.begin == last_range.end - last_range.begin &&
+        SameWords(module, range.begin, words, last_range.begin,
+                  range.end - range.begin)) {
+      verified.insert(function.first);
+    }
+  }
+  return verified;
+}
+
+IncrementalValidator::IncrementalValidator(spv_target_env env,
+                                           spv_const_validator_options options)
+    : context_(spvContextCreate(env)), options_(spvValidatorOptionsCreate()) {
+  if (options) *options_ = *options;
+}
+
+IncrementalValidator::~IncrementalValidator() {
+  spvValidatorOptionsDestroy(options_);
+  spvContextDestroy(context_);
+}
+
+void IncrementalValidator::SetMessageConsumer(MessageConsumer consumer) {
+  SetContextMessageConsumer(context_, std::move(consumer));
+}
+
+bool IncrementalValidator::Validate(const std::vector<uint32_t>& binary) {
+  spv_context_t hijack_context = *context_;
+  spv_diagnostic diagnostic = nullptr;
+  UseDiagnosticAsMessageConsumer(&hijack_context, &diagnostic);
+  // Only a module that passes without any message can be relied on later,
+  // since skipping a check must not skip a warning either.
+  bool quiet = true;
+  hijack_context.consumer = [&quiet, consumer = hijack_context.consumer](
+                                spv_message_level_t level, const char* source,
+                                const spv_position_t& position,
+                                const char* message) {
+    quiet = false;
+    consumer(level, source, position, message);
+  };
+
+  // The functions are found from the instructions parsed by the validation,
+  // rather than by parsing the module again.
+  std::unique_ptr<LastModule> module(new LastModule());
+  module->env = context_->target_env;
+  bool laid_out = false;
+  num_checked_functions_ = 0;
+  const auto find_verified_functions = [this, &binary, &module,
+                                        &laid_out](ValidationState_t* vstate) {
+    laid_out = FindFunctions(*vstate, &module->layout);
+    // The exhaustive tier checks every function again.
+    if (laid_out && last_ && last_->env == module->env &&
+        options_->tier != spv_validator_tier_exhaustive) {
+      vstate->set_verified_functions(
+          last_->FindVerifiedFunctions(binary.data(), module->layout));
+    }
+    for (const auto& function : module->layout.functions) {
+      if (!vstate->IsVerifiedFunction(function.first)) {
+        ++num_checked_functions_;
+      }
+    }
+  };
+  ValidationState_t vstate(&hijack_context, options_, binary.data(),
+                           binary.size(), kDefaultMaxNumOfWarnings);
+  const bool valid =
+      ValidateBinaryUsingContextAndValidationState(
+          hijack_context, binary.data(), binary.size(), &diagnostic, &vstate,
+          find_verified_functions) == SPV_SUCCESS;
+
+  if (valid && quiet && laid_out) {
+    // Reuse the storage of the words of the last module.
+    if (last_) module->words.swap(last_->words);
+    module->words.assign(binary.begin(), binary.end());
+    last_ = std::move(module);
+  } else {
+    last_.reset();
+  }
+
+  if (!valid && context_->consumer) {
+    context_->consumer(SPV_MSG_ERROR, nullptr, diagnostic->position,
+                       diagnostic->error);
+  }
+  spvDiagnosticDestroy(diagnostic);
+  return valid;
+}
+
+}  // namespace val
+}  // namespace spvtools
@@ -22,7 +22,7 @@
 
 #include "source/instruction.h"
 #include "source/table.h"
-#include "spirv-tools/libspirv.h"
+#include "spirv-tools/libspirv.hpp"
 
 namespace spvtools {
 namespace val {
@@ -223,6 +223,38 @@ spv_result_t RayReorderNVPass(ValidationState_t& _, const Instruction* inst);
 /// Validates correctness of mesh shading instructions.
 spv_result_t MeshShadingPass(ValidationState_t& _, const Instruction* inst);
 
+/// Each per-instruction pass above declares the opcodes it checks, so that
+/// the validator only calls it for instructions with those opcodes.  These
+/// return true if the pass may report an error for, or record something
+/// about, an instruction with the given opcode.  A pass must do nothing for
+/// the other opcodes.
+bool MiscPassHandles(spv::Op opcode);
+bool DebugPassHandles(spv::Op opcode);
+bool AnnotationPassHandles(spv::Op opcode);
+bool ExtensionPassHandles(spv::Op opcode);
+bool ModeSettingPassHandles(spv::Op opcode);
+bool TypePassHandles(spv::Op opcode);
+bool ConstantPassHandles(spv::Op opcode);
+bool MemoryPassHandles(spv::Op opcode);
+bool FunctionPassHandles(spv::Op opcode);
+bool ImagePassHandles(spv::Op opcode);
+bool ConversionPassHandles(spv::Op opcode);
+bool CompositesPassHandles(spv::Op opcode);
+bool ArithmeticsPassHandles(spv::Op opcode);
+bool BitwisePassHandles(spv::Op opcode);
+bool LogicalsPassHandles(spv::Op opcode);
+bool ControlFlowPassHandles(spv::Op opcode);
+bool DerivativesPassHandles(spv::Op opcode);
+bool AtomicsPassHandles(spv::Op opcode);
+bool PrimitivesPassHandles(spv::Op opcode);
+bool BarriersPassHandles(spv::Op opcode);
+bool NonUniformPassHandles(spv::Op opcode);
+bool LiteralsPassHandles(spv::Op opcode);
+bool RayQueryPassHandles(spv::Op opcode);
+bool RayTracingPassHandles(spv::Op opcode);
+bool RayReorderNVPassHandles(spv::Op opcode);
+bool MeshShadingPassHandles(spv::Op opcode);
+
 /// Calculates the reachability of basic blocks.
 void ReachabilityPass(ValidationState_t& _);
 
@@ -270,6 +302,49 @@ spv_result_t ValidateBinaryAndKeepValidationState(
     const uint32_t* words, const size_t num_words, spv_diagnostic* pDiagnostic,
     std::unique_ptr<ValidationState_t>* vstate);
 
+// Validates the successive states of a module being transformed, such as the
+// module after each pass of the optimizer or the fuzzer.
+//
+// Each call is a full validation, with the same verdict and messages as
+// spvValidateWithOptions: the module is parsed, and every check that records
+// state or spans functions runs again.  Only the checks that depend on
+// nothing but a function are skipped, for the functions that are word for
+// word the same as in the last module.  That module must have passed without
+// any message, for the same environment, with the same instructions before
+// its functions and the same OpFunction for each function in common.  A call
+// thus still costs time linear in the size of the module.
+class IncrementalValidator {
+ public:
+  // Creates a validator for the given environment, using a copy of the given
+  // options, or the default options if |options| is null.
+  IncrementalValidator(spv_target_env env, spv_const_validator_options options);
+  ~IncrementalValidator();
+
+  IncrementalValidator(const IncrementalValidator&) = delete;
+  IncrementalValidator& operator=(const IncrementalValidator&) = delete;
+
+  // Sets the consumer of the messages of the validation.
+  void SetMessageConsumer(MessageConsumer consumer);
+
+  // Validates the given module.  Returns true if it is valid.  Otherwise,
+  // returns false and reports the error to the message consumer.
+  bool Validate(const std::vector<uint32_t>& binary);
+
+  // Returns the number of functions whose checks the last call of Validate
+  // performed in full.
+  size_t num_checked_functions() const { return num_checked_functions_; }
+
+ private:
+  // A module that passed validation without any message, and where its
+  // functions lie.
+  struct LastModule;
+
+  spv_context context_;
+  spv_validator_options options_;
+  std::unique_ptr<LastModule> last_;
+  size_t num_checked_functions_ = 0;
+};
+
 }  // namespace val
 }  // namespace spvtools
 
@@ -130,5 +130,18 @@ spv_result_t BarriersPass(ValidationState_t& _, const Instruction* inst) {
   return SPV_SUCCESS;
 }
 
+bool BarriersPassHandles(spv::Op opcode) {
+  switch (opcode) {
+    case spv::Op::OpControlBarrier:
+    case spv::Op::OpMemoryBarrier:
+    case spv::Op::OpNamedBarrierInitialize:
+    case spv::Op::OpMemoryNamedBarrier:
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
+
 }  // namespace val
 }  // namespace spvtools
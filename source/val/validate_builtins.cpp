@@ -20,10 +20,12 @@
 #include <functional>
 #include <list>
 #include <map>
+#include <queue>
 #include <set>
 #include <sstream>
 #include <stack>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "source/opcode.h"
@@ -667,9 +669,16 @@ class BuiltInsValidator {
   // UniformConstant".
   std::string GetStorageClassDesc(const Instruction& inst) const;
 
-  // Updates inner working of the class. Is called sequentially for every
-  // instruction.
-  void Update(const Instruction& inst);
+  // Sets the function we are currently inside to the one of |inst|, along
+  // with its entry points and execution models.
+  void EnterFunctionOf(const Instruction& inst);
+
+  // Runs the checks of the ids |inst| references on |inst|.
+  spv_result_t CheckReferences(const Instruction& inst);
+
+  // Schedules the instructions after |position| in the ordered instructions
+  // which reference the id defined by |inst|, if there are checks for it.
+  void ScheduleUsers(const Instruction& inst, size_t position);
 
   ValidationState_t& _;
 
@@ -689,34 +698,54 @@ class BuiltInsValidator {
   const std::vector<uint32_t> no_entry_points;
   const std::vector<uint32_t>* entry_points_ = &no_entry_points;
 
-  // Execution models with which the current function can be called.
-  std::set<spv::ExecutionModel> execution_models_;
+  // Execution models with which the current function can be called.  Points
+  // into function_execution_models_ or to no_execution_models_, and is never
+  // null.
+  const std::set<spv::ExecutionModel> no_execution_models_;
+  const std::set<spv::ExecutionModel>* execution_models_ =
+      &no_execution_models_;
+
+  // Execution models with which each function can be called, computed the
+  // first time the function references an id with checks.
+  std::unordered_map<uint32_t, std::set<spv::ExecutionModel>>
+      function_execution_models_;
+
+  // Positions in the ordered instructions of the instructions that may
+  // reference an id with checks, smallest first.
+  std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>>
+      scheduled_;
 };
 
-void BuiltInsValidator::Update(const Instruction& inst) {
-  const spv::Op opcode = inst.opcode();
-  if (opcode == spv::Op::OpFunction) {
-    // Entering a function.
-    assert(function_id_ == 0);
-    function_id_ = inst.id();
-    execution_models_.clear();
-    entry_points_ = &_.FunctionEntryPoints(function_id_);
+void BuiltInsValidator::EnterFunctionOf(const Instruction& inst) {
+  // An OpFunction is part of its function, but an OpFunctionEnd is not.
+  uint32_t function_id = 0;
+  if (inst.opcode() == spv::Op::OpFunction) {
+    function_id = inst.id();
+  } else if (inst.function() && inst.opcode() != spv::Op::OpFunctionEnd) {
+    function_id = inst.function()->id();
+  }
+  if (function_id == function_id_) return;
+
+  function_id_ = function_id;
+  if (function_id_ == 0) {
+    entry_points_ = &no_entry_points;
+    execution_models_ = &no_execution_models_;
+    return;
+  }
+
+  entry_points_ = &_.FunctionEntryPoints(function_id_);
+  auto inserted = function_execution_models_.emplace(
+      function_id_, std::set<spv::ExecutionModel>());
+  if (inserted.second) {
     // Collect execution models from all entry points from which the current
     // function can be called.
     for (const uint32_t entry_point : *entry_points_) {
       if (const auto* models = _.GetExecutionModels(entry_point)) {
-        execution_models_.insert(models->begin(), models->end());
+        inserted.first->second.insert(models->begin(), models->end());
       }
     }
   }
-
-  if (opcode == spv::Op::OpFunctionEnd) {
-    // Exiting a function.
-    assert(function_id_ != 0);
-    function_id_ = 0;
-    entry_points_ = &no_entry_points;
-    execution_models_.clear();
-  }
+  execution_models_ = &inserted.first->second;
 }
 
 std::string BuiltInsValidator::GetDefinitionDesc(
@@ -1170,7 +1199,7 @@ spv_result_t BuiltInsValidator::ValidateNotCalledWithExecutionModel(
     const Instruction& referenced_inst,
     const Instruction& referenced_from_inst) {
   if (function_id_) {
-    if (execution_models_.count(execution_model)) {
+    if (execution_models_->count(execution_model)) {
       const char* execution_model_str = _.grammar().lookupOperandName(
           SPV_OPERAND_TYPE_EXECUTION_MODEL, uint32_t(execution_model));
       const char* built_in_str = _.grammar().lookupOperandName(
@@ -1264,7 +1293,7 @@ spv_result_t BuiltInsValidator::ValidateClipOrCullDistanceAtReference(
           referenced_from_inst, std::placeholders::_1));
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       switch (execution_model) {
         case spv::ExecutionModel::Fragment:
         case spv::ExecutionModel::Vertex: {
@@ -1409,7 +1438,7 @@ spv_result_t BuiltInsValidator::ValidateFragCoordAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Fragment) {
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
                << _.VkErrorID(4210)
@@ -1470,7 +1499,7 @@ spv_result_t BuiltInsValidator::ValidateFragDepthAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Fragment) {
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
                << _.VkErrorID(4213)
@@ -1546,7 +1575,7 @@ spv_result_t BuiltInsValidator::ValidateFrontFacingAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Fragment) {
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
                << _.VkErrorID(4229)
@@ -1606,7 +1635,7 @@ spv_result_t BuiltInsValidator::ValidateHelperInvocationAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Fragment) {
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
                << _.VkErrorID(4239)
@@ -1666,7 +1695,7 @@ spv_result_t BuiltInsValidator::ValidateInvocationIdAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::TessellationControl &&
           execution_model != spv::ExecutionModel::Geometry) {
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
@@ -1727,7 +1756,7 @@ spv_result_t BuiltInsValidator::ValidateInstanceIndexAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Vertex) {
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
                << _.VkErrorID(4263)
@@ -1787,7 +1816,7 @@ spv_result_t BuiltInsValidator::ValidatePatchVerticesAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::TessellationControl &&
           execution_model != spv::ExecutionModel::TessellationEvaluation) {
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
@@ -1849,7 +1878,7 @@ spv_result_t BuiltInsValidator::ValidatePointCoordAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Fragment) {
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
                << _.VkErrorID(4311)
@@ -1906,7 +1935,7 @@ spv_result_t BuiltInsValidator::ValidatePointSizeAtReference(
           referenced_from_inst, std::placeholders::_1));
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       switch (execution_model) {
         case spv::ExecutionModel::Vertex: {
           if (spv_result_t error = ValidateF32(
@@ -2037,7 +2066,7 @@ spv_result_t BuiltInsValidator::ValidatePositionAtReference(
           referenced_from_inst, std::placeholders::_1));
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       switch (execution_model) {
         case spv::ExecutionModel::Vertex: {
           if (spv_result_t error = ValidateF32Vec(
@@ -2223,7 +2252,7 @@ spv_result_t BuiltInsValidator::ValidatePrimitiveIdAtReference(
           referenced_from_inst, std::placeholders::_1));
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       switch (execution_model) {
         case spv::ExecutionModel::Fragment:
         case spv::ExecutionModel::TessellationControl:
@@ -2299,7 +2328,7 @@ spv_result_t BuiltInsValidator::ValidateSampleIdAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Fragment) {
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
                << _.VkErrorID(4354)
@@ -2359,7 +2388,7 @@ spv_result_t BuiltInsValidator::ValidateSampleMaskAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Fragment) {
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
                << _.VkErrorID(4357)
@@ -2421,7 +2450,7 @@ spv_result_t BuiltInsValidator::ValidateSamplePositionAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Fragment) {
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
                << _.VkErrorID(4360)
@@ -2482,7 +2511,7 @@ spv_result_t BuiltInsValidator::ValidateTessCoordAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::TessellationEvaluation) {
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
                << _.VkErrorID(4387)
@@ -2595,7 +2624,7 @@ spv_result_t BuiltInsValidator::ValidateTessLevelAtReference(
           referenced_from_inst, std::placeholders::_1));
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       switch (execution_model) {
         case spv::ExecutionModel::TessellationControl:
         case spv::ExecutionModel::TessellationEvaluation: {
@@ -2699,7 +2728,7 @@ spv_result_t BuiltInsValidator::ValidateVertexIndexAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Vertex) {
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
                << _.VkErrorID(4398)
@@ -2825,7 +2854,7 @@ spv_result_t BuiltInsValidator::ValidateLayerOrViewportIndexAtReference(
                     referenced_from_inst, std::placeholders::_1));
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       switch (execution_model) {
         case spv::ExecutionModel::Geometry:
         case spv::ExecutionModel::Fragment:
@@ -2934,7 +2963,7 @@ spv_result_t BuiltInsValidator::ValidateFragmentShaderF32Vec3InputAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Fragment) {
         uint32_t vuid = GetVUIDForBuiltin(builtin, VUIDErrorExecutionModel);
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
@@ -3007,7 +3036,7 @@ spv_result_t BuiltInsValidator::ValidateComputeShaderI32Vec3InputAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       bool has_vulkan_model = execution_model == spv::ExecutionModel::GLCompute ||
                               execution_model == spv::ExecutionModel::TaskNV ||
                               execution_model == spv::ExecutionModel::MeshNV ||
@@ -3093,7 +3122,7 @@ spv_result_t BuiltInsValidator::ValidateComputeI32InputAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       bool has_vulkan_model = execution_model == spv::ExecutionModel::GLCompute ||
                               execution_model == spv::ExecutionModel::TaskNV ||
                               execution_model == spv::ExecutionModel::MeshNV ||
@@ -3248,7 +3277,7 @@ spv_result_t BuiltInsValidator::ValidateWorkgroupSizeAtReference(
     const Instruction& referenced_inst,
     const Instruction& referenced_from_inst) {
   if (spvIsVulkanEnv(_.context()->target_env)) {
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::GLCompute &&
           execution_model != spv::ExecutionModel::TaskNV &&
           execution_model != spv::ExecutionModel::MeshNV &&
@@ -3324,7 +3353,7 @@ spv_result_t BuiltInsValidator::ValidateBaseInstanceOrVertexAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Vertex) {
         uint32_t vuid = (spv::BuiltIn(operand) == spv::BuiltIn::BaseInstance) ? 4181 : 4184;
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
@@ -3391,7 +3420,7 @@ spv_result_t BuiltInsValidator::ValidateDrawIndexAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Vertex &&
           execution_model != spv::ExecutionModel::MeshNV &&
           execution_model != spv::ExecutionModel::TaskNV &&
@@ -3462,7 +3491,7 @@ spv_result_t BuiltInsValidator::ValidateViewIndexAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model == spv::ExecutionModel::GLCompute) {
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
                << _.VkErrorID(4401) << "Vulkan spec allows BuiltIn "
@@ -3584,7 +3613,7 @@ spv_result_t BuiltInsValidator::ValidateFragInvocationCountAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Fragment) {
         uint32_t vuid = GetVUIDForBuiltin(builtin, VUIDErrorExecutionModel);
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
@@ -3654,7 +3683,7 @@ spv_result_t BuiltInsValidator::ValidateFragSizeAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Fragment) {
         uint32_t vuid = GetVUIDForBuiltin(builtin, VUIDErrorExecutionModel);
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
@@ -3724,7 +3753,7 @@ spv_result_t BuiltInsValidator::ValidateFragStencilRefAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Fragment) {
         uint32_t vuid = GetVUIDForBuiltin(builtin, VUIDErrorExecutionModel);
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
@@ -3794,7 +3823,7 @@ spv_result_t BuiltInsValidator::ValidateFullyCoveredAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Fragment) {
         uint32_t vuid = GetVUIDForBuiltin(builtin, VUIDErrorExecutionModel);
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
@@ -3917,7 +3946,7 @@ spv_result_t BuiltInsValidator::ValidatePrimitiveShadingRateAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       switch (execution_model) {
         case spv::ExecutionModel::Vertex:
         case spv::ExecutionModel::Geometry:
@@ -3992,7 +4021,7 @@ spv_result_t BuiltInsValidator::ValidateShadingRateAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::Fragment) {
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
                << _.VkErrorID(4490) << "Vulkan spec allows BuiltIn "
@@ -4156,7 +4185,7 @@ spv_result_t BuiltInsValidator::ValidateRayTracingBuiltinsAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (!IsExecutionModelValidForRtBuiltIn(builtin, execution_model)) {
         uint32_t vuid = GetVUIDForBuiltin(builtin, VUIDErrorExecutionModel);
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
@@ -4274,7 +4303,7 @@ spv_result_t BuiltInsValidator::ValidateMeshShadingEXTBuiltinsAtReference(
              << " " << GetStorageClassDesc(referenced_from_inst);
     }
 
-    for (const spv::ExecutionModel execution_model : execution_models_) {
+    for (const spv::ExecutionModel execution_model : *execution_models_) {
       if (execution_model != spv::ExecutionModel::MeshEXT) {
         uint32_t vuid = GetVUIDForBuiltin(builtin, VUIDErrorExecutionModel);
         return _.diag(SPV_ERROR_INVALID_DATA, &referenced_from_inst)
@@ -4495,17 +4524,11 @@ spv_result_t BuiltInsValidator::ValidateSingleBuiltInAtDefinition(
 }
 
 spv_result_t BuiltInsValidator::ValidateBuiltInsAtDefinition() {
-  for (const auto& kv : _.id_decorations()) {
-    const uint32_t id = kv.first;
-    const auto& decorations = kv.second;
-    if (decorations.empty()) {
-      continue;
-    }
-
+  for (const uint32_t id : _.builtin_decorated_ids()) {
     const Instruction* inst = _.FindDef(id);
     assert(inst);
 
-    for (const auto& decoration : kv.second) {
+    for (const auto& decoration : _.id_decorations(id)) {
       if (decoration.dec_type() != spv::Decoration::BuiltIn) {
         continue;
       }
@@ -4532,47 +4555,87 @@ spv_result_t BuiltInsValidator::Run() {
     return SPV_SUCCESS;
   }
 
-  // Second pass: validate every id reference in the module using
-  // rules in id_to_at_reference_checks_.
-  for (const Instruction& inst : _.ordered_instructions()) {
-    Update(inst);
+  // Second pass: validate the id references in the module using rules in
+  // id_to_at_reference_checks_.  The instructions are checked in module
+  // order, as a sweep over the whole module would, but only those which
+  // reference an id with checks are visited.  The checks of an instruction
+  // may add checks for the id it defines, which then apply to the later
+  // instructions using that id.
+  // The seeded checks also apply to the uses before the decorated
+  // definition, such as the interface of an OpEntryPoint.
+  const auto& instructions = _.ordered_instructions();
+  for (const auto& kv : id_to_at_reference_checks_) {
+    if (const Instruction* inst = _.FindDef(kv.first)) {
+      ScheduleUsers(*inst, 0);
+    }
+  }
+  bool any_checked = false;
+  size_t last_checked = 0;
+  while (!scheduled_.empty()) {
+    const size_t position = scheduled_.top();
+    scheduled_.pop();
+    if (any_checked && position == last_checked) continue;
+    any_checked = true;
+    last_checked = position;
 
-    std::set<uint32_t> already_checked;
+    const Instruction& inst = instructions[position];
+    EnterFunctionOf(inst);
+    if (auto error = CheckReferences(inst)) return error;
+    ScheduleUsers(inst, position + 1);
+  }
 
-    for (const auto& operand : inst.operands()) {
-      if (!spvIsIdType(operand.type)) {
-        // Not id.
-        continue;
-      }
+  return SPV_SUCCESS;
+}
 
-      const uint32_t id = inst.word(operand.offset);
-      if (id == inst.id()) {
-        // No need to check result id.
-        continue;
-      }
+spv_result_t BuiltInsValidator::CheckReferences(const Instruction& inst) {
+  const auto operands = inst.operands();
+  for (size_t i = 0; i < operands.size(); ++i) {
+    if (!spvIsIdType(operands[i].type)) {
+      // Not id.
+      continue;
+    }
 
-      if (!already_checked.insert(id).second) {
-        // The instruction has already referenced this id.
-        continue;
-      }
+    const uint32_t id = inst.word(operands[i].offset);
+    if (id == inst.id()) {
+      // No need to check result id.
+      continue;
+    }
 
-      // Instruction references the id. Run all checks associated with the id
-      // on the instruction. id_to_at_reference_checks_ can be modified in the
-      // process, iterators are safe because it's a tree-based map.
-      const auto it = id_to_at_reference_checks_.find(id);
-      if (it != id_to_at_reference_checks_.end()) {
-        for (const auto& check : it->second) {
-          if (spv_result_t error = check(inst)) {
-            return error;
-          }
+    bool already_checked = false;
+    for (size_t j = 0; j < i && !already_checked; ++j) {
+      already_checked = spvIsIdType(operands[j].type) &&
+                        inst.word(operands[j].offset) == id;
+    }
+    if (already_checked) {
+      // The instruction has already referenced this id.
+      continue;
+    }
+
+    // Instruction references the id. Run all checks associated with the id
+    // on the instruction. id_to_at_reference_checks_ can be modified in the
+    // process, iterators are safe because it's a tree-based map.
+    const auto it = id_to_at_reference_checks_.find(id);
+    if (it != id_to_at_reference_checks_.end()) {
+      for (const auto& check : it->second) {
+        if (spv_result_t error = check(inst)) {
+          return error;
         }
       }
     }
   }
-
   return SPV_SUCCESS;
 }
 
+void BuiltInsValidator::ScheduleUsers(const Instruction& inst,
+                                      size_t position) {
+  if (inst.id() == 0 || !id_to_at_reference_checks_.count(inst.id())) return;
+  const Instruction* first = _.ordered_instructions().data();
+  for (const auto& use : inst.uses()) {
+    const size_t user_position = static_cast<size_t>(use.first - first);
+    if (user_position >= position) scheduled_.push(user_position);
+  }
+}
+
 }  // namespace
 
 // Validates correctness of built-in variables.
@@ -967,129 +967,147 @@ spv_result_t MaximalReconvergenceChecks(ValidationState_t& _) {
   return SPV_SUCCESS;
 }
 
-spv_result_t PerformCfgChecks(ValidationState_t& _) {
-  for (auto& function : _.functions()) {
-    // Check all referenced blocks are defined within a function
-    if (function.undefined_block_count() != 0) {
-      std::string undef_blocks("{");
-      bool first = true;
-      for (auto undefined_block : function.undefined_blocks()) {
-        undef_blocks += _.getIdName(undefined_block);
-        if (!first) {
-          undef_blocks += " ";
+// Performs the control flow checks that only concern the given function.
+spv_result_t PerformFunctionCfgChecks(ValidationState_t& _,
+                                      Function& function) {
+  // Check all referenced blocks are defined within a function
+  if (function.undefined_block_count() != 0) {
+    std::string undef_blocks("{");
+    bool first = true;
+    for (auto undefined_block : function.undefined_blocks()) {
+      undef_blocks += _.getIdName(undefined_block);
+      if (!first) {
+        undef_blocks += " ";
+      }
+      first = false;
+    }
+    return _.diag(SPV_ERROR_INVALID_CFG, _.FindDef(function.id()))
+           << "Block(s) " << undef_blocks << "}"
+           << " are referenced but not defined in function "
+           << _.getIdName(function.id());
+  }
+
+  // Set each block's immediate dominator.
+  //
+  // We want to analyze all the blocks in the function, even in degenerate
+  // control flow cases including unreachable blocks.  So use the augmented
+  // CFG to ensure we cover all the blocks.
+  std::vector<const BasicBlock*> postorder;
+  auto ignore_block = [](const BasicBlock*) {};
+  auto no_terminal_blocks = [](const BasicBlock*) { return false; };
+  if (!function.ordered_blocks().empty()) {
+    /// calculate dominators
+    CFA<BasicBlock>::DepthFirstTraversal(
+        function.first_block(), function.AugmentedCFGSuccessorsFunction(),
+        ignore_block, [&](const BasicBlock* b) { postorder.push_back(b); },
+        no_terminal_blocks);
+    auto edges = CFA<BasicBlock>::CalculateDominators(
+        postorder, function.AugmentedCFGPredecessorsFunction());
+    for (auto edge : edges) {
+      if (edge.first != edge.second)
+        edge.first->SetImmediateDominator(edge.second);
+    }
+    function.NumberDominatorTree(DominatorTree::kDominator);
+  }
+
+  // The remaining checks of a verified function are known to pass, but the
+  // dominance information still has to be computed for the later checks.
+  const bool verified = _.IsVerifiedFunction(function.id());
+
+  auto& blocks = function.ordered_blocks();
+  if (!blocks.empty() && !verified) {
+    // Check if the order of blocks in the binary appear before the blocks
+    // they dominate
+    for (auto block = begin(blocks) + 1; block != end(blocks); ++block) {
+      if (auto idom = (*block)->immediate_dominator()) {
+        if (idom != function.pseudo_entry_block() &&
+            block == std::find(begin(blocks), block, idom)) {
+          return _.diag(SPV_ERROR_INVALID_CFG, _.FindDef(idom->id()))
+                 << "Block " << _.getIdName((*block)->id())
+                 << " appears in the binary before its dominator "
+                 << _.getIdName(idom->id());
+        }
+      }
+    }
+    // If we have structured control flow, check that no block has a control
+    // flow nesting depth larger than the limit.
+    if (_.HasCapability(spv::Capability::Shader)) {
+      const int control_flow_nesting_depth_limit =
+          _.options()->universal_limits_.max_control_flow_nesting_depth;
+      for (auto block = begin(blocks); block != end(blocks); ++block) {
+        if (function.GetBlockDepth(*block) > control_flow_nesting_depth_limit) {
+          return _.diag(SPV_ERROR_INVALID_CFG, _.FindDef((*block)->id()))
+                 << "Maximum Control Flow nesting depth exceeded.";
         }
-        first = false;
       }
-      return _.diag(SPV_ERROR_INVALID_CFG, _.FindDef(function.id()))
-             << "Block(s) " << undef_blocks << "}"
-             << " are referenced but not defined in function "
-             << _.getIdName(function.id());
     }
+  }
 
-    // Set each block's immediate dominator.
-    //
-    // We want to analyze all the blocks in the function, even in degenerate
-    // control flow cases including unreachable blocks.  So use the augmented
-    // CFG to ensure we cover all the blocks.
-    std::vector<const BasicBlock*> postorder;
-    auto ignore_block = [](const BasicBlock*) {};
-    auto no_terminal_blocks = [](const BasicBlock*) { return false; };
+  /// Structured control flow checks are only required for shader capabilities
+  if (_.HasCapability(spv::Capability::Shader)) {
+    // Calculate structural dominance.
+    postorder.clear();
+    std::vector<const BasicBlock*> postdom_postorder;
+    std::vector<std::pair<uint32_t, uint32_t>> back_edges;
     if (!function.ordered_blocks().empty()) {
       /// calculate dominators
       CFA<BasicBlock>::DepthFirstTraversal(
-          function.first_block(), function.AugmentedCFGSuccessorsFunction(),
-          ignore_block, [&](const BasicBlock* b) { postorder.push_back(b); },
+          function.first_block(),
+          function.AugmentedStructuralCFGSuccessorsFunction(), ignore_block,
+          [&](const BasicBlock* b) { postorder.push_back(b); },
           no_terminal_blocks);
       auto edges = CFA<BasicBlock>::CalculateDominators(
-          postorder, function.AugmentedCFGPredecessorsFunction());
+          postorder, function.AugmentedStructuralCFGPredecessorsFunction());
       for (auto edge : edges) {
         if (edge.first != edge.second)
-          edge.first->SetImmediateDominator(edge.second);
+          edge.first->SetImmediateStructuralDominator(edge.second);
       }
-    }
+      function.NumberDominatorTree(DominatorTree::kStructuralDominator);
 
-    auto& blocks = function.ordered_blocks();
-    if (!blocks.empty()) {
-      // Check if the order of blocks in the binary appear before the blocks
-      // they dominate
-      for (auto block = begin(blocks) + 1; block != end(blocks); ++block) {
-        if (auto idom = (*block)->immediate_dominator()) {
-          if (idom != function.pseudo_entry_block() &&
-              block == std::find(begin(blocks), block, idom)) {
-            return _.diag(SPV_ERROR_INVALID_CFG, _.FindDef(idom->id()))
-                   << "Block " << _.getIdName((*block)->id())
-                   << " appears in the binary before its dominator "
-                   << _.getIdName(idom->id());
-          }
-        }
-      }
-      // If we have structured control flow, check that no block has a control
-      // flow nesting depth larger than the limit.
-      if (_.HasCapability(spv::Capability::Shader)) {
-        const int control_flow_nesting_depth_limit =
-            _.options()->universal_limits_.max_control_flow_nesting_depth;
-        for (auto block = begin(blocks); block != end(blocks); ++block) {
-          if (function.GetBlockDepth(*block) >
-              control_flow_nesting_depth_limit) {
-            return _.diag(SPV_ERROR_INVALID_CFG, _.FindDef((*block)->id()))
-                   << "Maximum Control Flow nesting depth exceeded.";
-          }
-        }
+      /// calculate post dominators
+      CFA<BasicBlock>::DepthFirstTraversal(
+          function.pseudo_exit_block(),
+          function.AugmentedStructuralCFGPredecessorsFunction(), ignore_block,
+          [&](const BasicBlock* b) { postdom_postorder.push_back(b); },
+          no_terminal_blocks);
+      auto postdom_edges = CFA<BasicBlock>::CalculateDominators(
+          postdom_postorder,
+          function.AugmentedStructuralCFGSuccessorsFunction());
+      for (auto edge : postdom_edges) {
+        edge.first->SetImmediateStructuralPostDominator(edge.second);
       }
+      function.NumberDominatorTree(DominatorTree::kStructuralPostDominator);
+      /// calculate back edges.
+      CFA<BasicBlock>::DepthFirstTraversal(
+          function.pseudo_entry_block(),
+          function.AugmentedStructuralCFGSuccessorsFunction(), ignore_block,
+          ignore_block,
+          [&](const BasicBlock* from, const BasicBlock* to) {
+            // A back edge must be a real edge. Since the augmented successors
+            // contain structural edges, filter those from consideration.
+            for (const auto* succ : *(from->successors())) {
+              if (succ == to) back_edges.emplace_back(from->id(), to->id());
+            }
+          },
+          no_terminal_blocks);
     }
+    UpdateContinueConstructExitBlocks(function, back_edges);
 
-    /// Structured control flow checks are only required for shader capabilities
-    if (_.HasCapability(spv::Capability::Shader)) {
-      // Calculate structural dominance.
-      postorder.clear();
-      std::vector<const BasicBlock*> postdom_postorder;
-      std::vector<std::pair<uint32_t, uint32_t>> back_edges;
-      if (!function.ordered_blocks().empty()) {
-        /// calculate dominators
-        CFA<BasicBlock>::DepthFirstTraversal(
-            function.first_block(),
-            function.AugmentedStructuralCFGSuccessorsFunction(), ignore_block,
-            [&](const BasicBlock* b) { postorder.push_back(b); },
-            no_terminal_blocks);
-        auto edges = CFA<BasicBlock>::CalculateDominators(
-            postorder, function.AugmentedStructuralCFGPredecessorsFunction());
-        for (auto edge : edges) {
-          if (edge.first != edge.second)
-            edge.first->SetImmediateStructuralDominator(edge.second);
-        }
+    if (verified) return SPV_SUCCESS;
+    if (auto error =
+            StructuredControlFlowChecks(_, &function, back_edges, postorder))
+      return error;
+  }
 
-        /// calculate post dominators
-        CFA<BasicBlock>::DepthFirstTraversal(
-            function.pseudo_exit_block(),
-            function.AugmentedStructuralCFGPredecessorsFunction(), ignore_block,
-            [&](const BasicBlock* b) { postdom_postorder.push_back(b); },
-            no_terminal_blocks);
-        auto postdom_edges = CFA<BasicBlock>::CalculateDominators(
-            postdom_postorder,
-            function.AugmentedStructuralCFGSuccessorsFunction());
-        for (auto edge : postdom_edges) {
-          edge.first->SetImmediateStructuralPostDominator(edge.second);
-        }
-        /// calculate back edges.
-        CFA<BasicBlock>::DepthFirstTraversal(
-            function.pseudo_entry_block(),
-            function.AugmentedStructuralCFGSuccessorsFunction(), ignore_block,
-            ignore_block,
-            [&](const BasicBlock* from, const BasicBlock* to) {
-              // A back edge must be a real edge. Since the augmented successors
-              // contain structural edges, filter those from consideration.
-              for (const auto* succ : *(from->successors())) {
-                if (succ == to) back_edges.emplace_back(from->id(), to->id());
-              }
-            },
-            no_terminal_blocks);
-      }
-      UpdateContinueConstructExitBlocks(function, back_edges);
+  return SPV_SUCCESS;
+}
 
-      if (auto error =
-              StructuredControlFlowChecks(_, &function, back_edges, postorder))
-        return error;
-    }
+spv_result_t PerformCfgChecks(ValidationState_t& _) {
+  auto& functions = _.functions();
+  if (auto error = _.CheckEach(functions.size(), [&_, &functions](size_t i) {
+        return PerformFunctionCfgChecks(_, functions[i]);
+      })) {
+    return error;
   }
 
   if (auto error = MaximalReconvergenceChecks(_)) {
@@ -1267,5 +1285,20 @@ spv_result_t ControlFlowPass(ValidationState_t& _, const Instruction* inst) {
   return SPV_SUCCESS;
 }
 
+bool ControlFlowPassHandles(spv::Op opcode) {
+  switch (opcode) {
+    case spv::Op::OpPhi:
+    case spv::Op::OpBranch:
+    case spv::Op::OpBranchConditional:
+    case spv::Op::OpReturnValue:
+    case spv::Op::OpSwitch:
+    case spv::Op::OpLoopMerge:
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
+
 }  // namespace val
 }  // namespace spvtools
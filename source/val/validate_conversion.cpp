@@ -594,5 +594,31 @@ spv_result_t ConversionPass(ValidationState_t& _, const Instruction* inst) {
   return SPV_SUCCESS;
 }
 
+bool ConversionPassHandles(spv::Op opcode) {
+  switch (opcode) {
+    case spv::Op::OpConvertFToU:
+    case spv::Op::OpConvertFToS:
+    case spv::Op::OpConvertSToF:
+    case spv::Op::OpConvertUToF:
+    case spv::Op::OpUConvert:
+    case spv::Op::OpSConvert:
+    case spv::Op::OpFConvert:
+    case spv::Op::OpQuantizeToF16:
+    case spv::Op::OpConvertPtrToU:
+    case spv::Op::OpSatConvertSToU:
+    case spv::Op::OpSatConvertUToS:
+    case spv::Op::OpConvertUToPtr:
+    case spv::Op::OpPtrCastToGeneric:
+    case spv::Op::OpGenericCastToPtr:
+    case spv::Op::OpGenericCastToPtrExplicit:
+    case spv::Op::OpBitcast:
+    case spv::Op::OpConvertUToAccelerationStructureKHR:
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
+
 }  // namespace val
 }  // namespace spvtools
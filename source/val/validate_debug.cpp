@@ -68,5 +68,16 @@ spv_result_t DebugPass(ValidationState_t& _, const Instruction* inst) {
   return SPV_SUCCESS;
 }
 
+bool DebugPassHandles(spv::Op opcode) {
+  switch (opcode) {
+    case spv::Op::OpMemberName:
+    case spv::Op::OpLine:
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
+
 }  // namespace val
 }  // namespace spvtools
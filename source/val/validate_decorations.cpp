@@ -57,10 +57,6 @@ struct LayoutConstraints {
   uint32_t matrix_stride;
 };
 
-// A type for mapping (struct id, member id) to layout constraints.
-using MemberConstraints = std::unordered_map<std::pair<uint32_t, uint32_t>,
-                                             LayoutConstraints, PairHash>;
-
 // Returns the array stride of the given array type.
 uint32_t GetArrayStride(uint32_t array_id, ValidationState_t& vstate) {
   for (auto& decoration : vstate.id_decorations(array_id)) {
@@ -147,6 +143,129 @@ bool isMissingOffsetInStruct(uint32_t struct_id, ValidationState_t& vstate) {
                       [](const bool b) { return b; });
 }
 
+// The layout rules an alignment is computed under.
+enum LayoutRule {
+  // The base alignment.
+  kBaseLayout,
+  // The extended alignment, for uniform buffers.
+  kExtendedLayout,
+  // The scalar alignment.
+  kScalarLayout,
+  kNumLayoutRules
+};
+
+// The layout of a struct type.  It only depends on the type and its
+// decorations, not on where the struct is used.
+struct StructLayout {
+  // The member types.
+  std::vector<uint32_t> members;
+  // The Offset decoration of each member, or 0xffffffff if it has none.
+  std::vector<uint32_t> offsets;
+  // The largest of |offsets|.
+  uint32_t max_offset = 0;
+  // The member indices, in increasing offset order.
+  std::vector<uint32_t> offset_order;
+  // The majorness and matrix stride of each member.
+  std::vector<LayoutConstraints> constraints;
+  // The size, if |has_size|.
+  bool has_size = false;
+  uint32_t size = 0;
+  // The alignment under each layout rule, or 0 if it is not computed yet.
+  uint32_t alignments[kNumLayoutRules] = {};
+};
+
+// Memoizes the layouts of the struct types reached by the block layout
+// checks, and the layout checks that passed.  A module usually declares a
+// handful of struct types and uses them in many blocks, so each of them is
+// laid out once and shared by all the checks.
+class LayoutCache {
+ public:
+  // Flags for the rules a layout is checked under.
+  enum LayoutChecks : uint32_t { kBlockRules = 1, kScalarBlockLayout = 2 };
+
+  explicit LayoutCache(ValidationState_t& vstate) : vstate_(vstate) {}
+
+  // Returns the layout of the struct type |struct_id|.  The reference stays
+  // valid as other layouts are added.
+  StructLayout& GetStruct(uint32_t struct_id) {
+    auto where = structs_.find(struct_id);
+    if (where != structs_.end()) return where->second;
+
+    StructLayout& layout = structs_[struct_id];
+    layout.members = getStructMembers(struct_id, vstate_);
+    const auto num_members = uint32_t(layout.members.size());
+    layout.offsets.assign(num_members, 0xffffffff);
+    layout.constraints.assign(num_members, LayoutConstraints());
+    for (uint32_t memberIdx = 0; memberIdx < num_members; ++memberIdx) {
+      LayoutConstraints& constraint = layout.constraints[memberIdx];
+      auto member_decorations =
+          vstate_.id_member_decorations(struct_id, memberIdx);
+      for (auto decoration = member_decorations.begin;
+           decoration != member_decorations.end; ++decoration) {
+        assert(decoration->struct_member_index() == (int)memberIdx);
+        switch (decoration->dec_type()) {
+          case spv::Decoration::Offset:
+            layout.offsets[memberIdx] = decoration->params()[0];
+            break;
+          case spv::Decoration::RowMajor:
+            constraint.majorness = kRowMajor;
+            break;
+          case spv::Decoration::ColMajor:
+            constraint.majorness = kColumnMajor;
+            break;
+          case spv::Decoration::MatrixStride:
+            constraint.matrix_stride = decoration->params()[0];
+            break;
+          default:
+            break;
+        }
+      }
+      layout.max_offset =
+          std::max(layout.max_offset, layout.offsets[memberIdx]);
+      layout.offset_order.push_back(memberIdx);
+    }
+    std::stable_sort(layout.offset_order.begin(), layout.offset_order.end(),
+                     [&layout](uint32_t lhs, uint32_t rhs) {
+                       return layout.offsets[lhs] < layout.offsets[rhs];
+                     });
+    return layout;
+  }
+
+  // Returns the layout constraints of member |member_index| of |type_id|.
+  // They are the default ones unless |type_id| is a struct type with such a
+  // member.
+  const LayoutConstraints& GetMemberConstraints(uint32_t type_id,
+                                                uint32_t member_index) {
+    const auto type_inst = vstate_.FindDef(type_id);
+    if (type_inst && type_inst->opcode() == spv::Op::OpTypeStruct) {
+      const auto& constraints = GetStruct(type_id).constraints;
+      if (member_index < constraints.size()) return constraints[member_index];
+    }
+    return default_constraints_;
+  }
+
+  // Returns true if the layout of |type_id| at |offset| was checked
+  // successfully under |rules|, a combination of the flags of LayoutChecks.
+  bool IsChecked(uint32_t type_id, uint32_t offset, uint32_t rules) const {
+    auto where = checked_.find(std::make_pair(type_id, offset));
+    return where != checked_.end() && (where->second & (1u << rules));
+  }
+
+  // Records that the layout of |type_id| at |offset| was checked
+  // successfully under |rules|.
+  void SetChecked(uint32_t type_id, uint32_t offset, uint32_t rules) {
+    checked_[std::make_pair(type_id, offset)] |= 1u << rules;
+  }
+
+ private:
+  ValidationState_t& vstate_;
+  std::unordered_map<uint32_t, StructLayout> structs_;
+  const LayoutConstraints default_constraints_;
+  // Maps (type id, offset) to the set of rules it was checked under.
+  std::unordered_map<std::pair<uint32_t, uint32_t>, uint32_t, PairHash>
+      checked_;
+};
+
 // Rounds x up to the next alignment. Assumes alignment is a power of two.
 uint32_t align(uint32_t x, uint32_t alignment) {
   return (x + alignment - 1) & ~(alignment - 1);
@@ -158,8 +277,7 @@ uint32_t align(uint32_t x, uint32_t alignment) {
 // returns the *extended* alignment as it's called by the Vulkan spec.)
 uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
                           const LayoutConstraints& inherited,
-                          MemberConstraints& constraints,
-                          ValidationState_t& vstate) {
+                          LayoutCache& layouts, ValidationState_t& vstate) {
   const auto inst = vstate.FindDef(member_id);
   const auto& words = inst->words();
   // Minimal alignment is byte-aligned.
@@ -180,7 +298,7 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
       const auto componentId = words[2];
       const auto numComponents = words[3];
       const auto componentAlignment = getBaseAlignment(
-          componentId, roundUp, inherited, constraints, vstate);
+          componentId, roundUp, inherited, layouts, vstate);
       baseAlignment =
           componentAlignment * (numComponents == 3 ? 4 : numComponents);
       break;
@@ -189,7 +307,7 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
       const auto column_type = words[2];
       if (inherited.majorness == kColumnMajor) {
         baseAlignment = getBaseAlignment(column_type, roundUp, inherited,
-                                         constraints, vstate);
+                                         layouts, vstate);
       } else {
         // A row-major matrix of C columns has a base alignment equal to the
         // base alignment of a vector of C matrix components.
@@ -197,7 +315,7 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
         const auto component_inst = vstate.FindDef(column_type);
         const auto component_id = component_inst->words()[2];
         const auto componentAlignment = getBaseAlignment(
-            component_id, roundUp, inherited, constraints, vstate);
+            component_id, roundUp, inherited, layouts, vstate);
         baseAlignment =
             componentAlignment * (num_columns == 3 ? 4 : num_columns);
       }
@@ -206,21 +324,24 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
     case spv::Op::OpTypeArray:
     case spv::Op::OpTypeRuntimeArray:
       baseAlignment =
-          getBaseAlignment(words[2], roundUp, inherited, constraints, vstate);
+          getBaseAlignment(words[2], roundUp, inherited, layouts, vstate);
       if (roundUp) baseAlignment = align(baseAlignment, 16u);
       break;
     case spv::Op::OpTypeStruct: {
-      const auto members = getStructMembers(member_id, vstate);
-      for (uint32_t memberIdx = 0, numMembers = uint32_t(members.size());
+      StructLayout& layout = layouts.GetStruct(member_id);
+      uint32_t& alignment =
+          layout.alignments[roundUp ? kExtendedLayout : kBaseLayout];
+      if (alignment != 0) return alignment;
+      for (uint32_t memberIdx = 0, numMembers = uint32_t(layout.members.size());
            memberIdx < numMembers; ++memberIdx) {
-        const auto id = members[memberIdx];
-        const auto& constraint =
-            constraints[std::make_pair(member_id, memberIdx)];
+        const auto id = layout.members[memberIdx];
+        const auto& constraint = layout.constraints[memberIdx];
         baseAlignment = std::max(
             baseAlignment,
-            getBaseAlignment(id, roundUp, constraint, constraints, vstate));
+            getBaseAlignment(id, roundUp, constraint, layouts, vstate));
       }
       if (roundUp) baseAlignment = align(baseAlignment, 16u);
+      alignment = baseAlignment;
       break;
     }
     case spv::Op::OpTypePointer:
@@ -236,7 +357,8 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
 }
 
 // Returns scalar alignment of a type.
-uint32_t getScalarAlignment(uint32_t type_id, ValidationState_t& vstate) {
+uint32_t getScalarAlignment(uint32_t type_id, LayoutCache& layouts,
+                            ValidationState_t& vstate) {
   const auto inst = vstate.FindDef(type_id);
   const auto& words = inst->words();
   switch (inst->opcode()) {
@@ -255,19 +377,20 @@ uint32_t getScalarAlignment(uint32_t type_id, ValidationState_t& vstate) {
     case spv::Op::OpTypeArray:
     case spv::Op::OpTypeRuntimeArray: {
       const auto compositeMemberTypeId = words[2];
-      return getScalarAlignment(compositeMemberTypeId, vstate);
+      return getScalarAlignment(compositeMemberTypeId, layouts, vstate);
     }
     case spv::Op::OpTypeStruct: {
-      const auto members = getStructMembers(type_id, vstate);
+      StructLayout& layout = layouts.GetStruct(type_id);
+      uint32_t& alignment = layout.alignments[kScalarLayout];
+      if (alignment != 0) return alignment;
       uint32_t max_member_alignment = 1;
-      for (uint32_t memberIdx = 0, numMembers = uint32_t(members.size());
-           memberIdx < numMembers; ++memberIdx) {
-        const auto id = members[memberIdx];
-        uint32_t member_alignment = getScalarAlignment(id, vstate);
+      for (const auto id : layout.members) {
+        uint32_t member_alignment = getScalarAlignment(id, layouts, vstate);
         if (member_alignment > max_member_alignment) {
           max_member_alignment = member_alignment;
         }
       }
+      alignment = max_member_alignment;
       return max_member_alignment;
     } break;
     case spv::Op::OpTypePointer:
@@ -284,7 +407,7 @@ uint32_t getScalarAlignment(uint32_t type_id, ValidationState_t& vstate) {
 // Returns size of a struct member. Doesn't include padding at the end of struct
 // or array.  Assumes that in the struct case, all members have offsets.
 uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
-                 MemberConstraints& constraints, ValidationState_t& vstate) {
+                 LayoutCache& layouts, ValidationState_t& vstate) {
   const auto inst = vstate.FindDef(member_id);
   const auto& words = inst->words();
   switch (inst->opcode()) {
@@ -302,7 +425,7 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
       const auto componentId = words[2];
       const auto numComponents = words[3];
       const auto componentSize =
-          getSize(componentId, inherited, constraints, vstate);
+          getSize(componentId, inherited, layouts, vstate);
       const auto size = componentSize * numComponents;
       return size;
     }
@@ -313,7 +436,7 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
       const uint32_t num_elem = sizeInst->words()[3];
       const uint32_t elem_type = words[2];
       const uint32_t elem_size =
-          getSize(elem_type, inherited, constraints, vstate);
+          getSize(elem_type, inherited, layouts, vstate);
       // Account for gaps due to alignments in the first N-1 elements,
       // then add the size of the last element.
       const auto size =
@@ -333,32 +456,30 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
         const auto num_rows = component_inst->words()[3];
         const auto scalar_elem_type = component_inst->words()[2];
         const uint32_t scalar_elem_size =
-            getSize(scalar_elem_type, inherited, constraints, vstate);
+            getSize(scalar_elem_type, inherited, layouts, vstate);
         return (num_rows - 1) * inherited.matrix_stride +
                num_columns * scalar_elem_size;
       }
     }
     case spv::Op::OpTypeStruct: {
-      const auto& members = getStructMembers(member_id, vstate);
-      if (members.empty()) return 0;
-      const auto lastIdx = uint32_t(members.size() - 1);
-      const auto& lastMember = members.back();
-      uint32_t offset = 0xffffffff;
-      // Find the offset of the last element and add the size.
-      auto member_decorations =
-          vstate.id_member_decorations(member_id, lastIdx);
-      for (auto decoration = member_decorations.begin;
-           decoration != member_decorations.end; ++decoration) {
-        assert(decoration->struct_member_index() == (int)lastIdx);
-        if (spv::Decoration::Offset == decoration->dec_type()) {
-          offset = decoration->params()[0];
-        }
+      StructLayout& layout = layouts.GetStruct(member_id);
+      if (layout.has_size) return layout.size;
+      uint32_t size = 0;
+      if (!layout.members.empty()) {
+        const auto lastIdx = uint32_t(layout.members.size() - 1);
+        const auto lastMember = layout.members.back();
+        // Find the offset of the last element and add the size.
+        const uint32_t offset = layout.offsets.back();
+        // This check depends on the fact that all members have offsets.  This
+        // has been checked earlier in the flow.
+        assert(offset != 0xffffffff);
+        const auto& constraint =
+            layouts.GetMemberConstraints(lastMember, lastIdx);
+        size = offset + getSize(lastMember, constraint, layouts, vstate);
       }
-      // This check depends on the fact that all members have offsets.  This
-      // has been checked earlier in the flow.
-      assert(offset != 0xffffffff);
-      const auto& constraint = constraints[std::make_pair(lastMember, lastIdx)];
-      return offset + getSize(lastMember, constraint, constraints, vstate);
+      layout.size = size;
+      layout.has_size = true;
+      return size;
     }
     case spv::Op::OpTypePointer:
     case spv::Op::OpTypeUntypedPointerKHR:
@@ -378,9 +499,8 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
 // decorations placing its first byte at a non-integer multiple of 16.
 bool hasImproperStraddle(uint32_t id, uint32_t offset,
                          const LayoutConstraints& inherited,
-                         MemberConstraints& constraints,
-                         ValidationState_t& vstate) {
-  const auto size = getSize(id, inherited, constraints, vstate);
+                         LayoutCache& layouts, ValidationState_t& vstate) {
+  const auto size = getSize(id, inherited, layouts, vstate);
   const auto F = offset;
   const auto L = offset + size - 1;
   if (size <= 16) {
@@ -405,8 +525,7 @@ bool IsAlignedTo(uint32_t offset, uint32_t alignment) {
 spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
                          const char* decoration_str, bool blockRules,
                          bool scalar_block_layout,
-                         uint32_t incoming_offset,
-                         MemberConstraints& constraints,
+                         uint32_t incoming_offset, LayoutCache& layouts,
                          ValidationState_t& vstate) {
   if (vstate.options()->skip_block_layout) return SPV_SUCCESS;
 
@@ -414,6 +533,13 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
   // standard layout extension is being used.
   if (vstate.options()->uniform_buffer_standard_layout) blockRules = false;
 
+  // The outcome only depends on the type, the offset and the rules, so a
+  // layout shared by many blocks is only checked once.
+  const uint32_t rules =
+      (blockRules ? LayoutCache::kBlockRules : 0u) |
+      (scalar_block_layout ? LayoutCache::kScalarBlockLayout : 0u);
+  if (layouts.IsChecked(struct_id, incoming_offset, rules)) return SPV_SUCCESS;
+
   // Relaxed layout and scalar layout can both be in effect at the same time.
   // For example, relaxed layout is implied by Vulkan 1.1.  But scalar layout
   // is more permissive than relaxed layout.
@@ -439,9 +565,10 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
   // buffer pointers, we may not actually have a struct here. Instead, pretend
   // we have a struct with a single member at offset 0.
   const auto& struct_type = vstate.FindDef(struct_id);
+  const StructLayout* layout = nullptr;
   std::vector<uint32_t> members;
   if (struct_type->opcode() == spv::Op::OpTypeStruct) {
-    members = getStructMembers(struct_id, vstate);
+    layout = &layouts.GetStruct(struct_id);
   } else {
     members.push_back(struct_id);
   }
@@ -456,32 +583,20 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
 
   // With untyped pointers or physical storage buffers, we might be checking
   // layouts that do not originate from a structure.
-  if (struct_type->opcode() == spv::Op::OpTypeStruct) {
-    member_offsets.reserve(members.size());
-    for (uint32_t memberIdx = 0, numMembers = uint32_t(members.size());
-         memberIdx < numMembers; memberIdx++) {
-      uint32_t offset = 0xffffffff;
-      auto member_decorations =
-          vstate.id_member_decorations(struct_id, memberIdx);
-      for (auto decoration = member_decorations.begin;
-           decoration != member_decorations.end; ++decoration) {
-        assert(decoration->struct_member_index() == (int)memberIdx);
-        switch (decoration->dec_type()) {
-          case spv::Decoration::Offset:
-            offset = decoration->params()[0];
-            break;
-          default:
-            break;
-        }
-      }
-      member_offsets.push_back(
-          MemberOffsetPair{memberIdx, incoming_offset + offset});
+  if (layout) {
+    member_offsets.reserve(layout->members.size());
+    for (const auto memberIdx : layout->offset_order) {
+      member_offsets.push_back(MemberOffsetPair{
+          memberIdx, incoming_offset + layout->offsets[memberIdx]});
+    }
+    // The offsets are already in order, unless some of them wrapped around.
+    if (incoming_offset > 0xffffffff - layout->max_offset) {
+      std::sort(member_offsets.begin(), member_offsets.end(),
+                [](const MemberOffsetPair& lhs, const MemberOffsetPair& rhs) {
+                  return lhs.offset < rhs.offset ||
+                         (lhs.offset == rhs.offset && lhs.member < rhs.member);
+                });
     }
-    std::stable_sort(
-        member_offsets.begin(), member_offsets.end(),
-        [](const MemberOffsetPair& lhs, const MemberOffsetPair& rhs) {
-          return lhs.offset < rhs.offset;
-        });
   } else {
     member_offsets.push_back({0, 0});
   }
@@ -493,19 +608,19 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
     const auto& member_offset = member_offsets[ordered_member_idx];
     const auto memberIdx = member_offset.member;
     const auto offset = member_offset.offset;
-    auto id = members[member_offset.member];
+    auto id = layout ? layout->members[memberIdx] : members[memberIdx];
     const LayoutConstraints& constraint =
-        constraints[std::make_pair(struct_id, uint32_t(memberIdx))];
+        layouts.GetMemberConstraints(struct_id, memberIdx);
     // Scalar layout takes precedence because it's more permissive, and implying
     // an alignment that divides evenly into the alignment that would otherwise
     // be used.
     const auto alignment =
         scalar_block_layout
-            ? getScalarAlignment(id, vstate)
-            : getBaseAlignment(id, blockRules, constraint, constraints, vstate);
+            ? getScalarAlignment(id, layouts, vstate)
+            : getBaseAlignment(id, blockRules, constraint, layouts, vstate);
     const auto inst = vstate.FindDef(id);
     const auto opcode = inst->opcode();
-    const auto size = getSize(id, constraint, constraints, vstate);
+    const auto size = getSize(id, constraint, layouts, vstate);
     // Check offset.
     if (offset == 0xffffffff)
       return fail(memberIdx) << "is missing an Offset decoration";
@@ -514,7 +629,8 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
       // In relaxed block layout, the vector offset must be aligned to the
       // vector's scalar element type.
       const auto componentId = inst->words()[2];
-      const auto scalar_alignment = getScalarAlignment(componentId, vstate);
+      const auto scalar_alignment =
+          getScalarAlignment(componentId, layouts, vstate);
       if (!IsAlignedTo(offset, scalar_alignment)) {
         return fail(memberIdx)
                << "at offset " << offset
@@ -535,7 +651,7 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
     if (!scalar_block_layout && relaxed_block_layout) {
       // Check improper straddle of vectors.
       if (spv::Op::OpTypeVector == opcode &&
-          hasImproperStraddle(id, offset, constraint, constraints, vstate))
+          hasImproperStraddle(id, offset, constraint, layouts, vstate))
         return fail(memberIdx)
                << "is an improperly straddling vector at offset " << offset;
     }
@@ -544,7 +660,7 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
     if (spv::Op::OpTypeStruct == opcode &&
         SPV_SUCCESS != (recursive_status = checkLayout(
                             id, storage_class_str, decoration_str, blockRules,
-                            scalar_block_layout, offset, constraints, vstate)))
+                            scalar_block_layout, offset, layouts, vstate)))
       return recursive_status;
     // Check matrix stride.
     if (spv::Op::OpTypeMatrix == opcode) {
@@ -601,7 +717,7 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
           if (SPV_SUCCESS !=
               (recursive_status = checkLayout(
                    typeId, storage_class_str, decoration_str, blockRules,
-                   scalar_block_layout, next_offset, constraints, vstate)))
+                   scalar_block_layout, next_offset, layouts, vstate)))
             return recursive_status;
 
           seen[next_offset % 16] = true;
@@ -618,13 +734,14 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
 
       // Proceed to the element in case it is an array.
       array_inst = element_inst;
-      array_alignment = scalar_block_layout
-                            ? getScalarAlignment(array_inst->id(), vstate)
-                            : getBaseAlignment(array_inst->id(), blockRules,
-                                               constraint, constraints, vstate);
+      array_alignment =
+          scalar_block_layout
+              ? getScalarAlignment(array_inst->id(), layouts, vstate)
+              : getBaseAlignment(array_inst->id(), blockRules, constraint,
+                                 layouts, vstate);
 
       const auto element_size =
-          getSize(element_inst->id(), constraint, constraints, vstate);
+          getSize(element_inst->id(), constraint, layouts, vstate);
       if (element_size > array_stride) {
         return fail(memberIdx)
                << "contains an array with stride " << array_stride
@@ -639,6 +756,7 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
       nextValidOffset = align(nextValidOffset, alignment);
     }
   }
+  layouts.SetChecked(struct_id, incoming_offset, rules);
   return SPV_SUCCESS;
 }
 
@@ -1024,98 +1142,16 @@ spv_result_t CheckDecorationsOfEntryPoints(ValidationState_t& vstate) {
   return SPV_SUCCESS;
 }
 
-// Load |constraints| with all the member constraints for structs contained
-// within the given array type.
-void ComputeMemberConstraintsForArray(MemberConstraints* constraints,
-                                      uint32_t array_id,
-                                      const LayoutConstraints& inherited,
-                                      ValidationState_t& vstate);
-
-// Load |constraints| with all the member constraints for the given struct,
-// and all its contained structs.
-void ComputeMemberConstraintsForStruct(MemberConstraints* constraints,
-                                       uint32_t struct_id,
-                                       const LayoutConstraints& inherited,
-                                       ValidationState_t& vstate) {
-  assert(constraints);
-  const auto& members = getStructMembers(struct_id, vstate);
-  for (uint32_t memberIdx = 0, numMembers = uint32_t(members.size());
-       memberIdx < numMembers; memberIdx++) {
-    LayoutConstraints& constraint =
-        (*constraints)[std::make_pair(struct_id, memberIdx)];
-    constraint = inherited;
-    auto member_decorations =
-        vstate.id_member_decorations(struct_id, memberIdx);
-    for (auto decoration = member_decorations.begin;
-         decoration != member_decorations.end; ++decoration) {
-      assert(decoration->struct_member_index() == (int)memberIdx);
-      switch (decoration->dec_type()) {
-        case spv::Decoration::RowMajor:
-          constraint.majorness = kRowMajor;
-          break;
-        case spv::Decoration::ColMajor:
-          constraint.majorness = kColumnMajor;
-          break;
-        case spv::Decoration::MatrixStride:
-          constraint.matrix_stride = decoration->params()[0];
-          break;
-        default:
-          break;
-      }
-    }
-
-    // Now recurse
-    auto member_type_id = members[memberIdx];
-    const auto member_type_inst = vstate.FindDef(member_type_id);
-    const auto opcode = member_type_inst->opcode();
-    switch (opcode) {
-      case spv::Op::OpTypeArray:
-      case spv::Op::OpTypeRuntimeArray:
-        ComputeMemberConstraintsForArray(constraints, member_type_id, inherited,
-                                         vstate);
-        break;
-      case spv::Op::OpTypeStruct:
-        ComputeMemberConstraintsForStruct(constraints, member_type_id,
-                                          inherited, vstate);
-        break;
-      default:
-        break;
-    }
-  }
-}
-
-void ComputeMemberConstraintsForArray(MemberConstraints* constraints,
-                                      uint32_t array_id,
-                                      const LayoutConstraints& inherited,
-                                      ValidationState_t& vstate) {
-  assert(constraints);
-  auto elem_type_id = vstate.FindDef(array_id)->words()[2];
-  const auto elem_type_inst = vstate.FindDef(elem_type_id);
-  const auto opcode = elem_type_inst->opcode();
-  switch (opcode) {
-    case spv::Op::OpTypeArray:
-    case spv::Op::OpTypeRuntimeArray:
-      ComputeMemberConstraintsForArray(constraints, elem_type_id, inherited,
-                                       vstate);
-      break;
-    case spv::Op::OpTypeStruct:
-      ComputeMemberConstraintsForStruct(constraints, elem_type_id, inherited,
-                                        vstate);
-      break;
-    default:
-      break;
-  }
-}
-
 spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
   // Set of entry points that are known to use a push constant.
   std::unordered_set<uint32_t> uses_push_constant;
+  // The struct layouts, shared by all the blocks.
+  LayoutCache layouts(vstate);
   for (const auto& inst : vstate.ordered_instructions()) {
     const auto& words = inst.words();
     auto type_id = inst.type_id();
     const Instruction* type_inst = vstate.FindDef(type_id);
     bool scalar_block_layout = false;
-    MemberConstraints constraints;
     if (spv::Op::OpVariable == inst.opcode() ||
         spv::Op::OpUntypedVariableKHR == inst.opcode()) {
       const bool untyped_pointer =
@@ -1218,8 +1254,6 @@ spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
           }
           // Struct requirement is checked on variables so just move on here.
           if (spv::Op::OpTypeStruct != id_inst->opcode()) continue;
-          ComputeMemberConstraintsForStruct(&constraints, id,
-                                            LayoutConstraints(), vstate);
         }
         // Prepare for messages
         const char* sc_str =
@@ -1366,13 +1400,13 @@ spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
                     (SPV_SUCCESS !=
                      (recursive_status = checkLayout(id, sc_str, deco_str, true,
                                                      scalar_block_layout, 0,
-                                                     constraints, vstate)))) {
+                                                     layouts, vstate)))) {
                   return recursive_status;
                 } else if (bufferRules &&
                            (SPV_SUCCESS != (recursive_status = checkLayout(
                                                 id, sc_str, deco_str, false,
                                                 scalar_block_layout, 0,
-                                                constraints, vstate)))) {
+                                                layouts, vstate)))) {
                   return recursive_status;
                 }
               }
@@ -1385,15 +1419,10 @@ spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
                    spv::StorageClass::PhysicalStorageBuffer) {
       const bool buffer = true;
       const auto pointee_type_id = type_inst->GetOperandAs<uint32_t>(2u);
-      const auto* data_type_inst = vstate.FindDef(pointee_type_id);
       scalar_block_layout = vstate.options()->scalar_block_layout;
-      if (data_type_inst->opcode() == spv::Op::OpTypeStruct) {
-        ComputeMemberConstraintsForStruct(&constraints, pointee_type_id,
-                                          LayoutConstraints(), vstate);
-      }
       if (auto res = checkLayout(pointee_type_id, "PhysicalStorageBuffer",
                                  "Block", !buffer, scalar_block_layout, 0,
-                                 constraints, vstate)) {
+                                 layouts, vstate)) {
         return res;
       }
     } else if (vstate.HasCapability(spv::Capability::UntypedPointersKHR) &&
@@ -1458,13 +1487,10 @@ spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
       // Assume uniform storage class uses block rules unless we see a
       // BufferBlock decorated struct in the data type.
       bool bufferRules = sc == spv::StorageClass::Uniform ? false : true;
-      if (data_type->opcode() == spv::Op::OpTypeStruct) {
-        if (sc == spv::StorageClass::Uniform) {
-          bufferRules =
-              vstate.HasDecoration(data_type_id, spv::Decoration::BufferBlock);
-        }
-        ComputeMemberConstraintsForStruct(&constraints, data_type_id,
-                                          LayoutConstraints(), vstate);
+      if (data_type->opcode() == spv::Op::OpTypeStruct &&
+          sc == spv::StorageClass::Uniform) {
+        bufferRules =
+            vstate.HasDecoration(data_type_id, spv::Decoration::BufferBlock);
       }
       const char* deco_str =
           bufferRules
@@ -1472,7 +1498,7 @@ spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
               : "Block";
       if (auto result =
               checkLayout(data_type_id, sc_str, deco_str, !bufferRules,
-                          scalar_block_layout, 0, constraints, vstate)) {
+                          scalar_block_layout, 0, layouts, vstate)) {
         return result;
       }
     }
@@ -3737,5 +3737,10 @@ spv_result_t ExtensionPass(ValidationState_t& _, const Instruction* inst) {
   return SPV_SUCCESS;
 }
 
+bool ExtensionPassHandles(spv::Op opcode) {
+  return opcode == spv::Op::OpExtension ||
+         opcode == spv::Op::OpExtInstImport || spvIsExtendedInstruction(opcode);
+}
+
 }  // namespace val
 }  // namespace spvtools
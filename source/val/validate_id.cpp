@@ -39,6 +39,69 @@ spv_result_t UpdateIdUse(ValidationState_t& _, const Instruction* inst) {
   return SPV_SUCCESS;
 }
 
+namespace {
+
+// Checks that the ids defined in the blocks of the function whose
+// instructions are in [begin, end) of the ordered instructions dominate their
+// uses, and that its other ids are only used in the function.  Appends the
+// OpPhi instructions using its ids to |phi_instructions|, in order of first
+// use.
+spv_result_t CheckFunctionIdDefinitionsDominateUse(
+    ValidationState_t& _, size_t begin, size_t end,
+    std::vector<const Instruction*>* phi_instructions) {
+  std::unordered_set<uint32_t> phi_ids;
+  for (size_t i = begin; i < end; ++i) {
+    const Instruction& inst = _.ordered_instructions()[i];
+    if (inst.id() == 0) continue;
+    const Function* func = inst.function();
+    if (!func) continue;
+    // The uses within a verified function are known to be dominated by their
+    // definitions, but the uses in other functions still have to be checked.
+    const bool verified = _.IsVerifiedFunction(func->id());
+    if (const BasicBlock* block = inst.block()) {
+      // If the Id is defined within a block then make sure all references to
+      // that Id appear in a blocks that are dominated by the defining block
+      for (auto& use_index_pair : inst.uses()) {
+        const Instruction* use = use_index_pair.first;
+        if (const BasicBlock* use_block = use->block()) {
+          if (use_block->reachable() == false) continue;
+          if (use->opcode() == spv::Op::OpPhi) {
+            if (phi_ids.insert(use->id()).second) {
+              phi_instructions->push_back(use);
+            }
+          } else if (verified && use->function() == func) {
+            continue;
+          } else if (!block->dominates(*use->block())) {
+            return _.diag(SPV_ERROR_INVALID_ID, use_block->label())
+                   << "ID " << _.getIdName(inst.id()) << " defined in block "
+                   << _.getIdName(block->id())
+                   << " does not dominate its use in block "
+                   << _.getIdName(use_block->id());
+          }
+        }
+      }
+    } else {
+      // If the Ids defined within a function but not in a block(i.e. function
+      // parameters, block ids), then make sure all references to that Id
+      // appear within the same function
+      for (auto use : inst.uses()) {
+        const Instruction* user = use.first;
+        if (user->function() && user->function() != func) {
+          return _.diag(SPV_ERROR_INVALID_ID, _.FindDef(func->id()))
+                 << "ID " << _.getIdName(inst.id()) << " used in function "
+                 << _.getIdName(user->function()->id())
+                 << " is used outside of it's defining function "
+                 << _.getIdName(func->id());
+        }
+      }
+    }
+  }
+
+  return SPV_SUCCESS;
+}
+
+}  // namespace
+
 /// This function checks all ID definitions dominate their use in the CFG.
 ///
 /// This function will iterate over all ID definitions that are defined in the
@@ -48,49 +111,30 @@ spv_result_t UpdateIdUse(ValidationState_t& _, const Instruction* inst) {
 /// NOTE: This function does NOT check module scoped functions which are
 /// checked during the initial binary parse in the IdPass below
 spv_result_t CheckIdDefinitionDominateUse(ValidationState_t& _) {
+  // Each function is checked on its own, so that the functions can be checked
+  // concurrently.
+  const std::vector<size_t> function_begins = _.function_instruction_begins();
+  std::vector<std::vector<const Instruction*>> function_phis(
+      function_begins.size());
+  if (auto error = _.CheckEach(
+          function_begins.size(),
+          [&_, &function_begins, &function_phis](size_t function_index) {
+            const size_t end = function_index + 1 < function_begins.size()
+                                   ? function_begins[function_index + 1]
+                                   : _.ordered_instructions().size();
+            return CheckFunctionIdDefinitionsDominateUse(
+                _, function_begins[function_index], end,
+                &function_phis[function_index]);
+          })) {
+    return error;
+  }
+
   std::vector<const Instruction*> phi_instructions;
   std::unordered_set<uint32_t> phi_ids;
-  for (const auto& inst : _.ordered_instructions()) {
-    if (inst.id() == 0) continue;
-    if (const Function* func = inst.function()) {
-      if (const BasicBlock* block = inst.block()) {
-        // If the Id is defined within a block then make sure all references to
-        // that Id appear in a blocks that are dominated by the defining block
-        for (auto& use_index_pair : inst.uses()) {
-          const Instruction* use = use_index_pair.first;
-          if (const BasicBlock* use_block = use->block()) {
-            if (use_block->reachable() == false) continue;
-            if (use->opcode() == spv::Op::OpPhi) {
-              if (phi_ids.insert(use->id()).second) {
-                phi_instructions.push_back(use);
-              }
-            } else if (!block->dominates(*use->block())) {
-              return _.diag(SPV_ERROR_INVALID_ID, use_block->label())
-                     << "ID " << _.getIdName(inst.id()) << " defined in block "
-                     << _.getIdName(block->id())
-                     << " does not dominate its use in block "
-                     << _.getIdName(use_block->id());
-            }
-          }
-        }
-      } else {
-        // If the Ids defined within a function but not in a block(i.e. function
-        // parameters, block ids), then make sure all references to that Id
-        // appear within the same function
-        for (auto use : inst.uses()) {
-          const Instruction* user = use.first;
-          if (user->function() && user->function() != func) {
-            return _.diag(SPV_ERROR_INVALID_ID, _.FindDef(func->id()))
-                   << "ID " << _.getIdName(inst.id()) << " used in function "
-                   << _.getIdName(user->function()->id())
-                   << " is used outside of it's defining function "
-                   << _.getIdName(func->id());
-          }
-        }
-      }
+  for (const auto& phis : function_phis) {
+    for (const Instruction* phi : phis) {
+      if (phi_ids.insert(phi->id()).second) phi_instructions.push_back(phi);
     }
-    // NOTE: Ids defined outside of functions must appear before they are used
-    // This check is being performed in the IdPass function
   }
 
   // Check all OpPhi parent blocks are dominated by the variable's defining
@@ -92,5 +92,19 @@ spv_result_t LiteralsPass(ValidationState_t& _, const Instruction* inst) {
   return SPV_SUCCESS;
 }
 
+bool LiteralsPassHandles(spv::Op opcode) {
+  // Only the literals whose width comes from a type can be narrower than a
+  // word.
+  switch (opcode) {
+    case spv::Op::OpConstant:
+    case spv::Op::OpSpecConstant:
+    case spv::Op::OpSwitch:
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
+
 }  // namespace val
 }  // namespace spvtools
@@ -119,5 +119,17 @@ spv_result_t MeshShadingPass(ValidationState_t& _, const Instruction* inst) {
   return SPV_SUCCESS;
 }
 
+bool MeshShadingPassHandles(spv::Op opcode) {
+  switch (opcode) {
+    case spv::Op::OpEmitMeshTasksEXT:
+    case spv::Op::OpSetMeshOutputsEXT:
+    case spv::Op::OpWritePackedPrimitiveIndices4x8NV:
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
+
 }  // namespace val
 }  // namespace spvtools
@@ -210,5 +210,22 @@ spv_result_t MiscPass(ValidationState_t& _, const Instruction* inst) {
   return SPV_SUCCESS;
 }
 
+bool MiscPassHandles(spv::Op opcode) {
+  switch (opcode) {
+    case spv::Op::OpUndef:
+    case spv::Op::OpBeginInvocationInterlockEXT:
+    case spv::Op::OpEndInvocationInterlockEXT:
+    case spv::Op::OpDemoteToHelperInvocationEXT:
+    case spv::Op::OpIsHelperInvocationEXT:
+    case spv::Op::OpReadClockKHR:
+    case spv::Op::OpAssumeTrueKHR:
+    case spv::Op::OpExpectKHR:
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
+
 }  // namespace val
 }  // namespace spvtools
@@ -827,6 +827,19 @@ spv_result_t ModeSettingPass(ValidationState_t& _, const Instruction* inst) {
   return SPV_SUCCESS;
 }
 
+bool ModeSettingPassHandles(spv::Op opcode) {
+  switch (opcode) {
+    case spv::Op::OpEntryPoint:
+    case spv::Op::OpExecutionMode:
+    case spv::Op::OpExecutionModeId:
+    case spv::Op::OpMemoryModel:
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
+
 spv_result_t ValidateDuplicateExecutionModes(ValidationState_t& _) {
   using PerEntryKey = std::tuple<spv::ExecutionMode, uint32_t>;
   using PerOperandKey = std::tuple<spv::ExecutionMode, uint32_t, uint32_t>;
@@ -205,5 +205,17 @@ spv_result_t RayTracingPass(ValidationState_t& _, const Instruction* inst) {
 
   return SPV_SUCCESS;
 }
+
+bool RayTracingPassHandles(spv::Op opcode) {
+  switch (opcode) {
+    case spv::Op::OpTraceRayKHR:
+    case spv::Op::OpReportIntersectionKHR:
+    case spv::Op::OpExecuteCallableKHR:
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
 }  // namespace val
 }  // namespace spvtools
@@ -621,5 +621,43 @@ spv_result_t RayReorderNVPass(ValidationState_t& _, const Instruction* inst) {
   }
   return SPV_SUCCESS;
 }
+
+bool RayReorderNVPassHandles(spv::Op opcode) {
+  switch (opcode) {
+    case spv::Op::OpHitObjectIsMissNV:
+    case spv::Op::OpHitObjectIsHitNV:
+    case spv::Op::OpHitObjectIsEmptyNV:
+    case spv::Op::OpHitObjectGetShaderRecordBufferHandleNV:
+    case spv::Op::OpHitObjectGetHitKindNV:
+    case spv::Op::OpHitObjectGetPrimitiveIndexNV:
+    case spv::Op::OpHitObjectGetGeometryIndexNV:
+    case spv::Op::OpHitObjectGetInstanceIdNV:
+    case spv::Op::OpHitObjectGetInstanceCustomIndexNV:
+    case spv::Op::OpHitObjectGetShaderBindingTableRecordIndexNV:
+    case spv::Op::OpHitObjectGetCurrentTimeNV:
+    case spv::Op::OpHitObjectGetRayTMaxNV:
+    case spv::Op::OpHitObjectGetRayTMinNV:
+    case spv::Op::OpHitObjectGetObjectToWorldNV:
+    case spv::Op::OpHitObjectGetWorldToObjectNV:
+    case spv::Op::OpHitObjectGetObjectRayOriginNV:
+    case spv::Op::OpHitObjectGetObjectRayDirectionNV:
+    case spv::Op::OpHitObjectGetWorldRayDirectionNV:
+    case spv::Op::OpHitObjectGetWorldRayOriginNV:
+    case spv::Op::OpHitObjectGetAttributesNV:
+    case spv::Op::OpHitObjectExecuteShaderNV:
+    case spv::Op::OpHitObjectRecordEmptyNV:
+    case spv::Op::OpHitObjectRecordMissNV:
+    case spv::Op::OpHitObjectRecordHitWithIndexNV:
+    case spv::Op::OpHitObjectRecordHitNV:
+    case spv::Op::OpHitObjectTraceRayMotionNV:
+    case spv::Op::OpHitObjectTraceRayNV:
+    case spv::Op::OpReorderThreadWithHitObjectNV:
+    case spv::Op::OpReorderThreadWithHintNV:
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
 }  // namespace val
 }  // namespace spvtools
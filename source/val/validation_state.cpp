@@ -14,13 +14,16 @@
 
 #include "source/val/validation_state.h"
 
+#include <algorithm>
 #include <cassert>
 #include <stack>
 #include <utility>
 
 #include "source/opcode.h"
 #include "source/spirv_constant.h"
+#include "source/spirv_endian.h"
 #include "source/spirv_target_env.h"
+#include "source/util/hash_combine.h"
 #include "source/util/make_unique.h"
 #include "source/val/basic_block.h"
 #include "source/val/construct.h"
@@ -141,6 +144,10 @@ void UpdateFeaturesBasedOnSpirvVersion(ValidationState_t::Feature* features,
   }
 }
 
+// Where the diagnostics emitted on this thread are held back, if anywhere.
+thread_local std::vector<ValidationState_t::HeldDiagnostic>*
+    held_diagnostics = nullptr;
+
 }  // namespace
 
 ValidationState_t::ValidationState_t(const spv_const_context ctx,
@@ -174,6 +181,17 @@ ValidationState_t::ValidationState_t(const spv_const_context ctx,
       max_num_of_warnings_(max_warnings) {
   assert(opt && "Validator options may not be Null.");
 
+  // The instructions reference their words in the module, so byte swap a
+  // module in the other endianness once, up front, and validate the copy.
+  spv_const_binary_t binary = {words, num_words};
+  spv_endianness_t endian;
+  if (num_words > 0 && spvBinaryEndianness(&binary, &endian) == SPV_SUCCESS &&
+      endian != spvHostEndianness()) {
+    native_words_.resize(num_words);
+    spvFixWords(words, num_words, endian, native_words_.data());
+    words_ = native_words_.data();
+  }
+
   const auto env = context_->target_env;
 
   if (spvIsVulkanEnv(env)) {
@@ -206,7 +224,7 @@ ValidationState_t::ValidationState_t(const spv_const_context ctx,
     spv_context_t hijacked_context = *ctx;
     hijacked_context.consumer = [](spv_message_level_t, const char*,
                                    const spv_position_t&, const char*) {};
-    spvBinaryParse(&hijacked_context, this, words, num_words, setHeader,
+    spvBinaryParse(&hijacked_context, this, words_, num_words_, setHeader,
                    CountInstructions,
                    /* diagnostic = */ nullptr);
     preallocateStorage();
@@ -305,30 +323,72 @@ bool ValidationState_t::IsOpcodeInCurrentLayoutSection(spv::Op op) {
   return IsInstructionInLayoutSection(current_layout_section_, op);
 }
 
+bool ValidationState_t::CountWarning() {
+  if (num_of_warnings_ == max_num_of_warnings_) {
+    DiagnosticStream({0, 0, 0}, context_->consumer, "", SPV_WARNING)
+        << "Other warnings have been suppressed.\n";
+  }
+  if (num_of_warnings_ >= max_num_of_warnings_) return false;
+  ++num_of_warnings_;
+  return true;
+}
+
 DiagnosticStream ValidationState_t::diag(spv_result_t error_code,
                                          const Instruction* inst) {
-  if (error_code == SPV_WARNING) {
-    if (num_of_warnings_ == max_num_of_warnings_) {
-      DiagnosticStream({0, 0, 0}, context_->consumer, "", error_code)
-          << "Other warnings have been suppressed.\n";
-    }
-    if (num_of_warnings_ >= max_num_of_warnings_) {
-      return DiagnosticStream({0, 0, 0}, nullptr, "", error_code);
-    }
-    ++num_of_warnings_;
+  std::string disassembly;
+  if (held_diagnostics) {
+    // Warnings are counted once the held diagnostics are emitted.
+    if (inst) disassembly = Disassemble(*inst);
+    auto held = held_diagnostics;
+    return DiagnosticStream(
+        {0, 0, inst ? inst->LineNum() : 0},
+        [held](spv_message_level_t level, const char* source,
+               const spv_position_t& position, const char* message) {
+          held->push_back({level, source, position, message});
+        },
+        disassembly, error_code);
+  }
+
+  if (error_code == SPV_WARNING && !CountWarning()) {
+    return DiagnosticStream({0, 0, 0}, nullptr, "", error_code);
   }
 
-  std::string disassembly;
   if (inst) disassembly = Disassemble(*inst);
 
   return DiagnosticStream({0, 0, inst ? inst->LineNum() : 0},
                           context_->consumer, disassembly, error_code);
 }
 
+void ValidationState_t::HoldDiagnostics(std::vector<HeldDiagnostic>* held) {
+  held_diagnostics = held;
+}
+
+void ValidationState_t::EmitHeldDiagnostics(
+    const std::vector<HeldDiagnostic>& held) {
+  for (const auto& diagnostic : held) {
+    if (diagnostic.level == SPV_MSG_WARNING && !CountWarning()) continue;
+    if (context_->consumer) {
+      context_->consumer(diagnostic.level, diagnostic.source.c_str(),
+                         diagnostic.position, diagnostic.message.c_str());
+    }
+  }
+}
+
 std::vector<Function>& ValidationState_t::functions() {
   return module_functions_;
 }
 
+std::vector<size_t> ValidationState_t::function_instruction_begins() const {
+  std::vector<size_t> begins;
+  begins.reserve(module_functions_.size());
+  for (size_t i = 0; i < ordered_instructions_.size(); ++i) {
+    if (ordered_instructions_[i].opcode() == spv::Op::OpFunction) {
+      begins.push_back(i);
+    }
+  }
+  return begins;
+}
+
 Function& ValidationState_t::current_function() {
   assert(in_function_body());
   return module_functions_.back();
@@ -527,11 +587,66 @@ spv_result_t ValidationState_t::RegisterFunctionEnd() {
 
 Instruction* ValidationState_t::AddOrderedInstruction(
     const spv_parsed_instruction_t* inst) {
-  ordered_instructions_.emplace_back(inst);
+  assert(inst->words >= words_ &&
+         inst->words + inst->num_words <= words_ + num_words_ &&
+         "The instruction must be in the module being validated.");
+  spv_parsed_instruction_t shared = *inst;
+  shared.operands = ShareOperands(inst->operands, inst->num_operands);
+  ordered_instructions_.emplace_back(&shared);
   ordered_instructions_.back().SetLineNum(ordered_instructions_.size());
   return &ordered_instructions_.back();
 }
 
+size_t ValidationState_t::OperandsKeyHash::operator()(
+    const OperandsKey& key) const {
+  size_t hash = key.count;
+  for (uint16_t i = 0; i < key.count; ++i) {
+    const spv_parsed_operand_t& operand = key.operands[i];
+    hash = utils::hash_combine(hash, operand.offset, operand.num_words,
+                               static_cast<uint32_t>(operand.type),
+                               static_cast<uint32_t>(operand.number_kind),
+                               operand.number_bit_width);
+  }
+  return hash;
+}
+
+bool ValidationState_t::OperandsKeyEqual::operator()(
+    const OperandsKey& lhs, const OperandsKey& rhs) const {
+  return lhs.count == rhs.count &&
+         std::equal(lhs.operands, lhs.operands + lhs.count, rhs.operands,
+                    [](const spv_parsed_operand_t& a,
+                       const spv_parsed_operand_t& b) {
+                      return a.offset == b.offset &&
+                             a.num_words == b.num_words && a.type == b.type &&
+                             a.number_kind == b.number_kind &&
+                             a.number_bit_width == b.number_bit_width;
+                    });
+}
+
+const spv_parsed_operand_t* ValidationState_t::ShareOperands(
+    const spv_parsed_operand_t* operands, uint16_t count) {
+  if (count == 0) return nullptr;
+
+  auto shared = shared_operands_.find(OperandsKey{operands, count});
+  if (shared != shared_operands_.end()) return shared->operands;
+
+  // Most instructions have a handful of operands, so the descriptors are
+  // copied into large chunks.  A run longer than a chunk gets its own.
+  const size_t kChunkSize = 1024;
+  if (operand_chunk_free_ < count) {
+    const size_t chunk_size = std::max<size_t>(kChunkSize, count);
+    operand_chunks_.emplace_back(new spv_parsed_operand_t[chunk_size]);
+    operand_chunk_next_ = operand_chunks_.back().get();
+    operand_chunk_free_ = chunk_size;
+  }
+  spv_parsed_operand_t* copy = operand_chunk_next_;
+  std::copy(operands, operands + count, copy);
+  operand_chunk_next_ += count;
+  operand_chunk_free_ -= count;
+  shared_operands_.insert(OperandsKey{copy, count});
+  return copy;
+}
+
 // Improves diagnostic messages by collecting names of IDs
 void ValidationState_t::RegisterDebugInstruction(const Instruction* inst) {
   switch (inst->opcode()) {
@@ -619,6 +734,7 @@ void ValidationState_t::RegisterQCOMImageProcessingTextureConsumer(
   if (HasDecoration(texture_id, spv::Decoration::WeightTextureQCOM) ||
       HasDecoration(texture_id, spv::Decoration::BlockMatchTextureQCOM) ||
       HasDecoration(texture_id, spv::Decoration::BlockMatchSamplerQCOM)) {
+    std::lock_guard<std::mutex> lock(concurrent_update_mutex_);
     qcom_image_processing_consumers_.insert(consumer0->id());
     if (consumer1) {
       qcom_image_processing_consumers_.insert(consumer1->id());
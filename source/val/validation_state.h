@@ -16,12 +16,16 @@
 #define SOURCE_VAL_VALIDATION_STATE_H_
 
 #include <algorithm>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "source/assembly_grammar.h"
@@ -32,6 +36,8 @@
 #include "source/name_mapper.h"
 #include "source/spirv_definition.h"
 #include "source/spirv_validator_options.h"
+#include "source/util/id_map.h"
+#include "source/util/parallel.h"
 #include "source/val/decoration.h"
 #include "source/val/function.h"
 #include "source/val/instruction.h"
@@ -192,6 +198,33 @@ class ValidationState_t {
 
   DiagnosticStream diag(spv_result_t error_code, const Instruction* inst);
 
+  /// A diagnostic that was held back instead of being passed to the message
+  /// consumer.
+  struct HeldDiagnostic {
+    spv_message_level_t level;
+    std::string source;
+    spv_position_t position;
+    std::string message;
+  };
+
+  /// Makes the diagnostics emitted on the calling thread be appended to
+  /// |held| instead of being passed to the message consumer, or stops doing
+  /// so if |held| is null.
+  static void HoldDiagnostics(std::vector<HeldDiagnostic>* held);
+
+  /// Passes the given held diagnostics to the message consumer, counting the
+  /// warnings among them as if they had just been emitted.
+  void EmitHeldDiagnostics(const std::vector<HeldDiagnostic>& held);
+
+  /// Calls |check| with each index in [0, |count|), in order, until a call
+  /// returns something other than SPV_SUCCESS, and returns that status.
+  /// When parallel validation is enabled, the calls are spread over several
+  /// threads, and their diagnostics are held back and emitted in index order,
+  /// so that the result and the diagnostics are the same either way.  A call
+  /// must only modify the state belonging to its index.
+  template <typename Check>
+  spv_result_t CheckEach(size_t count, const Check& check);
+
   /// Returns the function states
   std::vector<Function>& functions();
 
@@ -379,8 +412,14 @@ class ValidationState_t {
   const AssemblyGrammar& grammar() const { return grammar_; }
 
   /// Inserts the instruction into the list of ordered instructions in the file.
+  /// The words of |inst| must be in the module returned by words().
   Instruction* AddOrderedInstruction(const spv_parsed_instruction_t* inst);
 
+  /// Returns the words of the module, in host endianness.  They are the words
+  /// the validation state was created with, unless those are byte swapped.
+  const uint32_t* words() const { return words_; }
+  size_t num_words() const { return num_words_; }
+
   /// Registers the instruction. This will add the instruction to the list of
   /// definitions and register sampled image consumers.
   void RegisterInstruction(Instruction* inst);
@@ -388,17 +427,21 @@ class ValidationState_t {
   /// Registers the debug instruction information.
   void RegisterDebugInstruction(const Instruction* inst);
 
+  /// The decorations of an <id>, sorted and without duplicates.
+  using Decorations = std::vector<Decoration>;
+
   /// Registers the decoration for the given <id>
   void RegisterDecorationForId(uint32_t id, const Decoration& dec) {
-    auto& dec_list = id_decorations_[id];
-    dec_list.insert(dec);
+    InsertDecoration(id, &id_decorations_[id], dec);
   }
 
   /// Registers the list of decorations for the given <id>
   template <class InputIt>
   void RegisterDecorationsForId(uint32_t id, InputIt begin, InputIt end) {
-    std::set<Decoration>& cur_decs = id_decorations_[id];
-    cur_decs.insert(begin, end);
+    Decorations& cur_decs = id_decorations_[id];
+    for (InputIt iter = begin; iter != end; ++iter) {
+      InsertDecoration(id, &cur_decs, *iter);
+    }
   }
 
   /// Registers the list of decorations for the given member of the given
@@ -407,29 +450,38 @@ class ValidationState_t {
   void RegisterDecorationsForStructMember(uint32_t struct_id,
                                           uint32_t member_index, InputIt begin,
                                           InputIt end) {
-    std::set<Decoration>& cur_decs = id_decorations_[struct_id];
-    for (InputIt iter = begin; iter != end; ++iter) {
-      Decoration dec = *iter;
+    // Copy the decorations first, in case they are those of the structure.
+    Decorations member_decs(begin, end);
+    Decorations& cur_decs = id_decorations_[struct_id];
+    for (Decoration& dec : member_decs) {
       dec.set_struct_member_index(member_index);
-      cur_decs.insert(dec);
+      InsertDecoration(struct_id, &cur_decs, dec);
     }
   }
 
-  /// Returns all the decorations for the given <id>. If no decorations exist
-  /// for the <id>, it registers an empty set for it in the map and
-  /// returns the empty set.
-  std::set<Decoration>& id_decorations(uint32_t id) {
-    return id_decorations_[id];
+  /// Returns the ids with a BuiltIn decoration, on themselves or on one of
+  /// their members, in increasing order.
+  const std::set<uint32_t>& builtin_decorated_ids() const {
+    return builtin_decorated_ids_;
+  }
+
+  /// Returns all the decorations for the given <id>, or an empty set if
+  /// there are none.
+  const Decorations& id_decorations(uint32_t id) const {
+    static const Decorations no_decorations;
+    const auto decorations = id_decorations_.find(id);
+    if (decorations == id_decorations_.end()) return no_decorations;
+    return decorations->second;
   }
 
   /// Returns the range of decorations for the given field of the given <id>.
   struct FieldDecorationsIter {
-    std::set<Decoration>::const_iterator begin;
-    std::set<Decoration>::const_iterator end;
+    Decorations::const_iterator begin;
+    Decorations::const_iterator end;
   };
   FieldDecorationsIter id_member_decorations(uint32_t id,
-                                             uint32_t member_index) {
-    const auto& decorations = id_decorations_[id];
+                                             uint32_t member_index) const {
+    const auto& decorations = id_decorations(id);
 
     // The decorations are sorted by member_index, so this look up will give the
     // exact range of decorations for this member index.
@@ -437,14 +489,16 @@ class ValidationState_t {
     Decoration max_decoration(spv::Decoration::Max, {}, member_index);
 
     FieldDecorationsIter result;
-    result.begin = decorations.lower_bound(min_decoration);
-    result.end = decorations.upper_bound(max_decoration);
+    result.begin = std::lower_bound(decorations.begin(), decorations.end(),
+                                    min_decoration);
+    result.end =
+        std::upper_bound(result.begin, decorations.end(), max_decoration);
 
     return result;
   }
 
   // Returns const pointer to the internal decoration container.
-  const std::map<uint32_t, std::set<Decoration>>& id_decorations() const {
+  const utils::IdMap<Decorations>& id_decorations() const {
     return id_decorations_;
   }
 
@@ -472,8 +526,27 @@ class ValidationState_t {
     return ordered_instructions_;
   }
 
+  /// Returns the index in ordered_instructions() of the OpFunction of each
+  /// function, in the order of functions().  The instructions of a function
+  /// extend up to the OpFunction of the next one.
+  std::vector<size_t> function_instruction_begins() const;
+
+  /// Sets the ids of the verified functions.  A function is verified if it is
+  /// word for word the same as in an earlier module that passed validation,
+  /// and that module had the same instructions before its functions and the
+  /// same OpFunction instruction for each function they have in common.  The
+  /// checks that only depend on those parts may skip a verified function.
+  void set_verified_functions(std::unordered_set<uint32_t> ids) {
+    verified_functions_ = std::move(ids);
+  }
+
+  /// Returns true if the function with the given id is verified.
+  bool IsVerifiedFunction(uint32_t id) const {
+    return verified_functions_.count(id) != 0;
+  }
+
   /// Returns a map of instructions mapped by their result id
-  const std::unordered_map<uint32_t, Instruction*>& all_definitions() const {
+  const utils::IdMap<Instruction*>& all_definitions() const {
     return all_definitions_;
   }
 
@@ -532,8 +605,9 @@ class ValidationState_t {
   }
 
   /// Returns the nesting depth of a given structure ID
-  uint32_t struct_nesting_depth(uint32_t id) {
-    return struct_nesting_depth_[id];
+  uint32_t struct_nesting_depth(uint32_t id) const {
+    const auto depth = struct_nesting_depth_.find(id);
+    return depth == struct_nesting_depth_.end() ? 0 : depth->second;
   }
 
   /// Records the has a nested block/bufferblock decorated struct for a given
@@ -544,8 +618,10 @@ class ValidationState_t {
 
   /// For a given struct ID returns true if it has a nested block/bufferblock
   /// decorated struct
-  bool GetHasNestedBlockOrBufferBlockStruct(uint32_t id) {
-    return struct_has_nested_blockorbufferblock_struct_[id];
+  bool GetHasNestedBlockOrBufferBlockStruct(uint32_t id) const {
+    const auto has = struct_has_nested_blockorbufferblock_struct_.find(id);
+    return has != struct_has_nested_blockorbufferblock_struct_.end() &&
+           has->second;
   }
 
   /// Records that the structure type has a member decorated with a built-in.
@@ -818,6 +894,23 @@ class ValidationState_t {
  private:
   ValidationState_t(const ValidationState_t&);
 
+  /// Adds |dec| to |decorations|, the decorations of |id|, unless it is
+  /// already there.
+  void InsertDecoration(uint32_t id, Decorations* decorations,
+                        const Decoration& dec) {
+    if (dec.dec_type() == spv::Decoration::BuiltIn) {
+      builtin_decorated_ids_.insert(id);
+    }
+    // Decorations are mostly registered in order, so check the end first.
+    if (decorations->empty() || decorations->back() < dec) {
+      decorations->push_back(dec);
+      return;
+    }
+    auto where =
+        std::lower_bound(decorations->begin(), decorations->end(), dec);
+    if (!(*where == dec)) decorations->insert(where, dec);
+  }
+
   const spv_const_context context_;
 
   /// Stores the Validator command line options. Must be a valid options object.
@@ -827,6 +920,36 @@ class ValidationState_t {
   const uint32_t* words_;
   const size_t num_words_;
 
+  /// The module in host endianness, if the module we were given is not.
+  std::vector<uint32_t> native_words_;
+
+  /// A run of operand descriptors, hashed and compared by content.
+  struct OperandsKey {
+    const spv_parsed_operand_t* operands;
+    uint16_t count;
+  };
+  struct OperandsKeyHash {
+    size_t operator()(const OperandsKey& key) const;
+  };
+  struct OperandsKeyEqual {
+    bool operator()(const OperandsKey& lhs, const OperandsKey& rhs) const;
+  };
+
+  /// Returns a copy of the |count| operand descriptors at |operands| which
+  /// lives as long as the validation state.  Instructions with the same
+  /// operand layout share one copy.
+  const spv_parsed_operand_t* ShareOperands(
+      const spv_parsed_operand_t* operands, uint16_t count);
+
+  /// The operand descriptors of the instructions, in chunks that never move.
+  std::vector<std::unique_ptr<spv_parsed_operand_t[]>> operand_chunks_;
+  /// The first unused descriptor of the last chunk, and how many are left.
+  spv_parsed_operand_t* operand_chunk_next_ = nullptr;
+  size_t operand_chunk_free_ = 0;
+  /// The runs of descriptors in |operand_chunks_|.
+  std::unordered_set<OperandsKey, OperandsKeyHash, OperandsKeyEqual>
+      shared_operands_;
+
   /// The generator of the SPIR-V.
   uint32_t generator_ = 0;
 
@@ -874,7 +997,7 @@ class ValidationState_t {
   std::vector<Instruction> ordered_instructions_;
 
   /// Instructions that can be referenced by Ids
-  std::unordered_map<uint32_t, Instruction*> all_definitions_;
+  utils::IdMap<Instruction*> all_definitions_;
 
   /// IDs that are entry points, ie, arguments to OpEntryPoint.
   std::vector<uint32_t> entry_points_;
@@ -903,14 +1026,16 @@ class ValidationState_t {
   std::unordered_set<uint32_t> builtin_structs_;
 
   /// Structure Nesting Depth
-  std::unordered_map<uint32_t, uint32_t> struct_nesting_depth_;
+  utils::IdMap<uint32_t> struct_nesting_depth_;
 
   /// Structure has nested blockorbufferblock struct
-  std::unordered_map<uint32_t, bool>
-      struct_has_nested_blockorbufferblock_struct_;
+  utils::IdMap<bool> struct_has_nested_blockorbufferblock_struct_;
 
   /// Stores the list of decorations for a given <id>
-  std::map<uint32_t, std::set<Decoration>> id_decorations_;
+  utils::IdMap<Decorations> id_decorations_;
+
+  /// The ids with a BuiltIn decoration, or with a member that has one.
+  std::set<uint32_t> builtin_decorated_ids_;
 
   /// Stores type declarations which need to be unique (i.e. non-aggregates),
   /// in the form [opcode, operand words], result_id is not stored.
@@ -937,7 +1062,7 @@ class ValidationState_t {
   Feature features_;
 
   /// Maps function ids to function stat objects.
-  std::unordered_map<uint32_t, Function*> id_to_function_;
+  utils::IdMap<Function*> id_to_function_;
 
   /// Mapping entry point -> execution models. It is presumed that the same
   /// function could theoretically be used as 'main' by multiple OpEntryPoint
@@ -978,8 +1103,53 @@ class ValidationState_t {
   /// Variables used to reduce the number of diagnostic messages.
   uint32_t num_of_warnings_;
   uint32_t max_num_of_warnings_;
+
+  /// The ids of the verified functions.
+  std::unordered_set<uint32_t> verified_functions_;
+
+  /// Guards the state that may be updated while functions are checked
+  /// concurrently.
+  std::mutex concurrent_update_mutex_;
+
+  /// Counts a warning that is about to be emitted.  Returns false if the
+  /// warning should be suppressed instead.
+  bool CountWarning();
 };
 
+template <typename Check>
+spv_result_t ValidationState_t::CheckEach(size_t count, const Check& check) {
+  if (!options()->parallel || count < 2) {
+    for (size_t i = 0; i < count; ++i) {
+      if (auto error = check(i)) return error;
+    }
+    return SPV_SUCCESS;
+  }
+
+  std::vector<spv_result_t> results(count, SPV_SUCCESS);
+  std::vector<std::vector<HeldDiagnostic>> held(count);
+  std::atomic<size_t> first_failure(count);
+  utils::ParallelFor(
+      count, utils::HardwareThreadCount(),
+      [&check, &results, &held, &first_failure](size_t i) {
+        // Nothing past a failure is reported.
+        if (i > first_failure) return;
+        HoldDiagnostics(&held[i]);
+        results[i] = check(i);
+        HoldDiagnostics(nullptr);
+        if (results[i] == SPV_SUCCESS) return;
+        size_t failure = first_failure;
+        while (i < failure &&
+               !first_failure.compare_exchange_weak(failure, i)) {
+        }
+      });
+
+  for (size_t i = 0; i < count; ++i) {
+    EmitHeldDiagnostics(held[i]);
+    if (results[i] != SPV_SUCCESS) return results[i];
+  }
+  return SPV_SUCCESS;
+}
+
 }  // namespace val
 }  // namespace spvtools
 
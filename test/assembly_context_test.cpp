@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -73,5 +75,38 @@ INSTANTIATE_TEST_SUITE_P(
     }));
 // clang-format on
 
+TEST(AssemblyContextNamedIds, NamesKeepTheirIds) {
+  AssemblyContext context(AutoText(""), nullptr);
+  // Use enough names, and a long enough name, to need several blocks of
+  // interned name storage.
+  const std::string long_name(10000, 'x');
+  EXPECT_EQ(1u, context.spvNamedIdAssignOrGet("first"));
+  for (uint32_t i = 0; i < 2000; ++i) {
+    const std::string name = "name_" + std::to_string(i);
+    EXPECT_EQ(i + 2, context.spvNamedIdAssignOrGet(name.c_str()));
+  }
+  EXPECT_EQ(2002u, context.spvNamedIdAssignOrGet(long_name.c_str()));
+  EXPECT_EQ(2003u, context.spvNamedIdAssignOrGet("42"));
+
+  // The ids of earlier names are found again, whatever block holds them.
+  EXPECT_EQ(1u, context.spvNamedIdAssignOrGet("first"));
+  for (uint32_t i = 0; i < 2000; ++i) {
+    const std::string name = "name_" + std::to_string(i);
+    EXPECT_EQ(i + 2, context.spvNamedIdAssignOrGet(name.c_str()));
+  }
+  EXPECT_EQ(2002u, context.spvNamedIdAssignOrGet(long_name.c_str()));
+  EXPECT_EQ(2004u, context.getBound());
+  EXPECT_THAT(context.GetNumericIds(), Eq(std::set<uint32_t>{42}));
+}
+
+TEST(AssemblyContextTerminateWord, CopiesTheWord) {
+  AssemblyContext context(AutoText(""), nullptr);
+  const std::string text = "OpIAdd %int";
+  EXPECT_STREQ("OpIAdd",
+               context.terminateWord(std::string_view(text).substr(0, 6)));
+  EXPECT_STREQ("%int", context.terminateWord(std::string_view(text).substr(7)));
+  EXPECT_STREQ("", context.terminateWord(std::string_view()));
+}
+
 }  // namespace
 }  // namespace spvtools
@@ -20,6 +20,7 @@
 
 #include "gmock/gmock.h"
 #include "source/latest_version_opencl_std_header.h"
+#include "source/spirv_constant.h"
 #include "source/table.h"
 #include "source/util/string_utils.h"
 #include "test/test_fixture.h"
@@ -834,6 +835,194 @@ TEST_F(CxxBinaryParseTest, ExtendedInstruction) {
   EXPECT_EQ(nullptr, diagnostic_);
 }
 
+TEST_F(BinaryParseTest, ExtendedInstructionImportWithEndianSwap) {
+  const auto words = CompileSuccessfully(
+      "%extcl = OpExtInstImport \"OpenCL.std\" "
+      "%result = OpExtInst %float %extcl sqrt %x");
+  EXPECT_HEADER(5).WillOnce(Return(SPV_SUCCESS));
+  EXPECT_CALL(client_, Instruction(_))
+      .Times(2)
+      .WillRepeatedly(Return(SPV_SUCCESS));
+  Parse(words, SPV_SUCCESS, true);
+  EXPECT_EQ(nullptr, diagnostic_);
+}
+
+// Appends the words pointer of each parsed instruction to the vector of
+// pointers passed as user_data.
+spv_result_t RecordWordsPointer(void* user_data,
+                                const spv_parsed_instruction_t* inst) {
+  static_cast<std::vector<const uint32_t*>*>(user_data)->push_back(
+      inst->words);
+  return SPV_SUCCESS;
+}
+
+TEST_F(BinaryParseTest, HostEndianInstructionWordsPointIntoInput) {
+  const auto words = CompileSuccessfully(
+      "OpName %1 \"a long enough name\" %1 = OpTypeInt 32 1");
+  std::vector<const uint32_t*> pointers;
+  EXPECT_EQ(SPV_SUCCESS,
+            spvBinaryParse(ScopedContext().context, &pointers, words.data(),
+                           words.size(), nullptr, RecordWordsPointer,
+                           &diagnostic_));
+  ASSERT_EQ(2u, pointers.size());
+  EXPECT_EQ(words.data() + SPV_INDEX_INSTRUCTION, pointers[0]);
+  EXPECT_EQ(words.data() + words.size() - 4, pointers[1]);
+}
+
+// Appends a copy of each parsed instruction to the vector of
+// ParsedInstruction objects passed as user_data.
+spv_result_t RecordInstruction(void* user_data,
+                               const spv_parsed_instruction_t* inst) {
+  static_cast<std::vector<ParsedInstruction>*>(user_data)->emplace_back(*inst);
+  return SPV_SUCCESS;
+}
+
+class IncrementalBinaryParseTest
+    : public spvtest::TextToBinaryTestBase<::testing::Test> {
+ protected:
+  // Parses the given words as a whole module, and returns the instructions.
+  std::vector<ParsedInstruction> ParseWhole(const SpirvVector& words) {
+    std::vector<ParsedInstruction> result;
+    EXPECT_EQ(SPV_SUCCESS,
+              spvBinaryParse(ScopedContext().context, &result, words.data(),
+                             words.size(), nullptr, RecordInstruction,
+                             nullptr));
+    return result;
+  }
+
+  const std::string kAssembly =
+      "OpCapability Shader "
+      "OpMemoryModel Logical GLSL450 "
+      "OpName %main \"main_function_with_a_long_name\" "
+      "%void = OpTypeVoid "
+      "%uint = OpTypeInt 32 0 "
+      "%uint_7 = OpConstant %uint 7 "
+      "%fn = OpTypeFunction %void "
+      "%main = OpFunction %void None %fn "
+      "%entry = OpLabel "
+      "OpSwitch %uint_7 %entry 1 %entry 2 %entry "
+      "OpFunctionEnd";
+};
+
+TEST_F(IncrementalBinaryParseTest, WordChunksMatchWholeModule) {
+  const auto words = CompileSuccessfully(kAssembly);
+  const auto expected = ParseWhole(words);
+  for (size_t chunk = 1; chunk <= words.size(); ++chunk) {
+    std::vector<ParsedInstruction> actual;
+    spv_binary_parser parser =
+        spvBinaryParserCreate(ScopedContext().context, &actual, nullptr,
+                              RecordInstruction, &diagnostic);
+    for (size_t i = 0; i < words.size(); i += chunk) {
+      const size_t n = std::min(chunk, words.size() - i);
+      EXPECT_EQ(SPV_SUCCESS,
+                spvBinaryParserFeedWords(parser, words.data() + i, n));
+    }
+    EXPECT_EQ(SPV_SUCCESS, spvBinaryParserFinish(parser));
+    spvBinaryParserDestroy(parser);
+    EXPECT_EQ(nullptr, diagnostic);
+    EXPECT_EQ(expected, actual) << "chunk size " << chunk;
+  }
+}
+
+TEST_F(IncrementalBinaryParseTest, ByteChunksMatchWholeModule) {
+  for (bool endian_swap : kSwapEndians) {
+    auto words = CompileSuccessfully(kAssembly);
+    MaybeFlipWords(endian_swap, words.begin(), words.end());
+    const auto expected = ParseWhole(words);
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(words.data());
+    const size_t num_bytes = words.size() * sizeof(uint32_t);
+    for (size_t chunk : {1, 3, 5, 7, 64}) {
+      std::vector<ParsedInstruction> actual;
+      spv_binary_parser parser =
+          spvBinaryParserCreate(ScopedContext().context, &actual, nullptr,
+                                RecordInstruction, &diagnostic);
+      for (size_t i = 0; i < num_bytes; i += chunk) {
+        const size_t n = std::min(chunk, num_bytes - i);
+        EXPECT_EQ(SPV_SUCCESS, spvBinaryParserFeedBytes(parser, bytes + i, n));
+      }
+      EXPECT_EQ(SPV_SUCCESS, spvBinaryParserFinish(parser));
+      spvBinaryParserDestroy(parser);
+      EXPECT_EQ(nullptr, diagnostic);
+      EXPECT_EQ(expected, actual) << "chunk size " << chunk;
+    }
+  }
+}
+
+TEST_F(IncrementalBinaryParseTest, InstructionsArriveBeforeFinish) {
+  const auto words = CompileSuccessfully("%1 = OpTypeVoid %2 = OpTypeBool");
+  std::vector<ParsedInstruction> actual;
+  spv_binary_parser parser =
+      spvBinaryParserCreate(ScopedContext().context, &actual, nullptr,
+                            RecordInstruction, &diagnostic);
+  // The header and the first word of OpTypeVoid.
+  EXPECT_EQ(SPV_SUCCESS, spvBinaryParserFeedWords(parser, words.data(), 6));
+  EXPECT_EQ(0u, actual.size());
+  EXPECT_EQ(SPV_SUCCESS, spvBinaryParserFeedWords(parser, words.data() + 6, 1));
+  EXPECT_EQ(1u, actual.size());
+  EXPECT_EQ(SPV_SUCCESS, spvBinaryParserFeedWords(parser, words.data() + 7, 2));
+  EXPECT_EQ(2u, actual.size());
+  EXPECT_EQ(SPV_SUCCESS, spvBinaryParserFinish(parser));
+  spvBinaryParserDestroy(parser);
+}
+
+TEST_F(IncrementalBinaryParseTest, TruncatedModuleIsDiagnosedAtFinish) {
+  const auto words = CompileSuccessfully("%1 = OpTypeInt 32 0");
+  spv_binary_parser parser = spvBinaryParserCreate(
+      ScopedContext().context, nullptr, nullptr, nullptr, &diagnostic);
+  EXPECT_EQ(SPV_SUCCESS,
+            spvBinaryParserFeedWords(parser, words.data(), words.size() - 1));
+  EXPECT_EQ(SPV_ERROR_INVALID_BINARY, spvBinaryParserFinish(parser));
+  spvBinaryParserDestroy(parser);
+  ASSERT_NE(nullptr, diagnostic);
+  EXPECT_THAT(diagnostic->error,
+              Eq("End of input reached while decoding OpTypeInt starting at "
+                 "word 5: missing literal number operand at word offset 3."));
+}
+
+TEST_F(IncrementalBinaryParseTest, IncompleteHeaderIsDiagnosedAtFinish) {
+  spv_binary_parser parser = spvBinaryParserCreate(
+      ScopedContext().context, nullptr, nullptr, nullptr, &diagnostic);
+  EXPECT_EQ(SPV_SUCCESS, spvBinaryParserFeedWords(parser, kHeaderForBound1, 3));
+  EXPECT_EQ(SPV_ERROR_INVALID_BINARY, spvBinaryParserFinish(parser));
+  spvBinaryParserDestroy(parser);
+  ASSERT_NE(nullptr, diagnostic);
+  EXPECT_THAT(diagnostic->error,
+              Eq("Module has incomplete header: only 3 words instead of 5"));
+}
+
+TEST_F(IncrementalBinaryParseTest, TrailingBytesAreDiagnosedAtFinish) {
+  const auto words = CompileSuccessfully("%1 = OpTypeVoid");
+  spv_binary_parser parser = spvBinaryParserCreate(
+      ScopedContext().context, nullptr, nullptr, nullptr, &diagnostic);
+  EXPECT_EQ(SPV_SUCCESS,
+            spvBinaryParserFeedBytes(parser, words.data(),
+                                     words.size() * sizeof(uint32_t) - 2));
+  EXPECT_EQ(SPV_ERROR_INVALID_BINARY, spvBinaryParserFinish(parser));
+  spvBinaryParserDestroy(parser);
+  ASSERT_NE(nullptr, diagnostic);
+  EXPECT_THAT(diagnostic->error,
+              Eq("Module size is not a multiple of 4 bytes: 2 trailing bytes"));
+}
+
+TEST_F(IncrementalBinaryParseTest, ErrorStopsFurtherParsing) {
+  const auto words = Concatenate(
+      {ExpectedHeaderForBound(1), {spvOpcodeMake(0, spv::Op::OpNop)}});
+  std::vector<ParsedInstruction> actual;
+  spv_binary_parser parser =
+      spvBinaryParserCreate(ScopedContext().context, &actual, nullptr,
+                            RecordInstruction, &diagnostic);
+  EXPECT_EQ(SPV_ERROR_INVALID_BINARY,
+            spvBinaryParserFeedWords(parser, words.data(), words.size()));
+  const uint32_t nop = spvOpcodeMake(1, spv::Op::OpNop);
+  EXPECT_EQ(SPV_ERROR_INVALID_BINARY,
+            spvBinaryParserFeedWords(parser, &nop, 1));
+  EXPECT_EQ(SPV_ERROR_INVALID_BINARY, spvBinaryParserFinish(parser));
+  spvBinaryParserDestroy(parser);
+  EXPECT_EQ(0u, actual.size());
+  ASSERT_NE(nullptr, diagnostic);
+  EXPECT_THAT(diagnostic->error, Eq("Invalid instruction word count: 0"));
+}
+
 // A binary parser diagnostic test case where we provide the words array
 // pointer and word count explicitly.
 struct WordsAndCountDiagnosticCase {
@@ -12,12 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <limits>
 #include <sstream>
 #include <string>
 #include <tuple>
 #include <vector>
 
 #include "gmock/gmock.h"
+#include "source/disassemble.h"
 #include "source/spirv_constant.h"
 #include "test/test_fixture.h"
 #include "test/unit_spirv.h"
@@ -2650,6 +2652,185 @@ INSTANTIATE_TEST_SUITE_P(GeneratorStrings, GeneratorStringTest,
                              {65535, 32767, "Unknown(65535); 32767"},
                          }));
 
+// Returns a module with many functions, each with structured control flow.
+std::string MakeModuleWithManyFunctions(int num_functions) {
+  std::ostringstream module;
+  module << R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+OpSource GLSL 450
+OpName %main "main"
+OpName %counter "counter"
+OpDecorate %counter RelaxedPrecision
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%bool = OpTypeBool
+%uint = OpTypeInt 32 0
+%uint_0 = OpConstant %uint 0
+%uint_1 = OpConstant %uint 1
+%ptr = OpTypePointer Private %uint
+%counter = OpVariable %ptr Private
+%main = OpFunction %void None %fn
+%main_entry = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+  for (int i = 0; i < num_functions; ++i) {
+    module << "%f" << i << " = OpFunction %void None %fn\n"
+           << "%entry" << i << " = OpLabel\n"
+           << "%value" << i << " = OpLoad %uint %counter\n"
+           << "%cond" << i << " = OpULessThan %bool %value" << i
+           << " %uint_1\n"
+           << "OpSelectionMerge %merge" << i << " None\n"
+           << "OpBranchConditional %cond" << i << " %then" << i << " %merge"
+           << i << "\n"
+           << "%then" << i << " = OpLabel\n"
+           << "OpStore %counter %uint_0\n"
+           << "OpBranch %merge" << i << "\n"
+           << "%merge" << i << " = OpLabel\n"
+           << "OpReturn\n"
+           << "OpFunctionEnd\n";
+  }
+  return module.str();
+}
+
+// The number of threads the parallel disassembly tests use, so that the
+// function definitions are split even on a machine with a single core.
+constexpr uint32_t kDisassemblyThreads = 4;
+
+using ParallelDisassemblyTest = spvtest::TextToBinaryTestBase<
+    ::testing::TestWithParam<uint32_t>>;
+
+TEST_P(ParallelDisassemblyTest, SameTextAsSerial) {
+  const auto words = CompileSuccessfully(MakeModuleWithManyFunctions(100));
+  ScopedContext context;
+  spv_text serial = nullptr;
+  ASSERT_EQ(SPV_SUCCESS,
+            spvBinaryToText(context.context, words.data(), words.size(),
+                            GetParam(), &serial, &diagnostic));
+  spv_text parallel = nullptr;
+  ASSERT_EQ(SPV_SUCCESS,
+            spvBinaryToTextWithThreads(
+                context.context, words.data(), words.size(),
+                GetParam() | SPV_BINARY_TO_TEXT_OPTION_PARALLEL,
+                kDisassemblyThreads, &parallel, &diagnostic));
+  EXPECT_EQ(std::string(serial->str, serial->length),
+            std::string(parallel->str, parallel->length));
+  spvTextDestroy(serial);
+  spvTextDestroy(parallel);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    DisassemblyOptions, ParallelDisassemblyTest,
+    ::testing::ValuesIn(std::vector<uint32_t>{
+        SPV_BINARY_TO_TEXT_OPTION_NONE,
+        SPV_BINARY_TO_TEXT_OPTION_INDENT |
+            SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES,
+        SPV_BINARY_TO_TEXT_OPTION_COMMENT |
+            SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES,
+        SPV_BINARY_TO_TEXT_OPTION_COMMENT | SPV_BINARY_TO_TEXT_OPTION_INDENT |
+            SPV_BINARY_TO_TEXT_OPTION_NESTED_INDENT |
+            SPV_BINARY_TO_TEXT_OPTION_REORDER_BLOCKS,
+        SPV_BINARY_TO_TEXT_OPTION_SHOW_BYTE_OFFSET |
+            SPV_BINARY_TO_TEXT_OPTION_COLOR,
+    }));
+
+TEST_F(TextToBinaryTest, ParallelDisassemblyReportsErrorsLikeSerial) {
+  auto words = CompileSuccessfully(MakeModuleWithManyFunctions(100));
+  // Cut the module in the middle of the last OpLabel.
+  words.resize(words.size() - 3);
+  ScopedContext context;
+  spv_text text = nullptr;
+  EXPECT_EQ(SPV_ERROR_INVALID_BINARY,
+            spvBinaryToText(context.context, words.data(), words.size(),
+                            SPV_BINARY_TO_TEXT_OPTION_NONE, &text, &diagnostic));
+  ASSERT_NE(nullptr, diagnostic);
+  const std::string serial_error = diagnostic->error;
+  const spv_position_t serial_position = diagnostic->position;
+  spvDiagnosticDestroy(diagnostic);
+  diagnostic = nullptr;
+
+  EXPECT_EQ(SPV_ERROR_INVALID_BINARY,
+            spvBinaryToTextWithThreads(
+                context.context, words.data(), words.size(),
+                SPV_BINARY_TO_TEXT_OPTION_PARALLEL, kDisassemblyThreads, &text,
+                &diagnostic));
+  ASSERT_NE(nullptr, diagnostic);
+  EXPECT_EQ(serial_error, diagnostic->error);
+  EXPECT_EQ(serial_position.index, diagnostic->position.index);
+}
+
+// Collects the pieces of text passed to a text sink.
+struct TextPieces {
+  std::vector<std::string> pieces;
+  // The sink fails when it is passed more pieces than this.
+  size_t max_pieces = std::numeric_limits<size_t>::max();
+};
+
+spv_result_t CollectTextPiece(void* user_data, const char* text,
+                              size_t length) {
+  auto collected = static_cast<TextPieces*>(user_data);
+  if (collected->pieces.size() == collected->max_pieces) {
+    return SPV_REQUESTED_TERMINATION;
+  }
+  collected->pieces.emplace_back(text, length);
+  return SPV_SUCCESS;
+}
+
+using StreamedDisassemblyTest = spvtest::TextToBinaryTestBase<
+    ::testing::TestWithParam<uint32_t>>;
+
+TEST_P(StreamedDisassemblyTest, SameTextAsBinaryToText) {
+  // The text of this module is several times the size of a piece.
+  const auto words = CompileSuccessfully(MakeModuleWithManyFunctions(2000));
+  ScopedContext context;
+  spv_text serial = nullptr;
+  ASSERT_EQ(SPV_SUCCESS,
+            spvBinaryToText(context.context, words.data(), words.size(),
+                            GetParam(), &serial, &diagnostic));
+  const std::string expected(serial->str, serial->length);
+  spvTextDestroy(serial);
+
+  TextPieces streamed;
+  ASSERT_EQ(SPV_SUCCESS,
+            spvBinaryToTextStream(context.context, words.data(), words.size(),
+                                  GetParam() | SPV_BINARY_TO_TEXT_OPTION_PRINT,
+                                  &streamed, CollectTextPiece, &diagnostic));
+  EXPECT_GT(streamed.pieces.size(), 1u);
+  std::string concatenated;
+  for (const auto& piece : streamed.pieces) {
+    EXPECT_LE(piece.size(), 64u * 1024u);
+    concatenated += piece;
+  }
+  EXPECT_EQ(expected, concatenated);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    DisassemblyOptions, StreamedDisassemblyTest,
+    ::testing::ValuesIn(std::vector<uint32_t>{
+        SPV_BINARY_TO_TEXT_OPTION_NONE,
+        SPV_BINARY_TO_TEXT_OPTION_INDENT |
+            SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES |
+            SPV_BINARY_TO_TEXT_OPTION_NESTED_INDENT |
+            SPV_BINARY_TO_TEXT_OPTION_REORDER_BLOCKS,
+        SPV_BINARY_TO_TEXT_OPTION_PARALLEL |
+            SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES,
+    }));
+
+TEST_F(TextToBinaryTest, StreamedDisassemblyStopsWhenSinkFails) {
+  const auto words = CompileSuccessfully(MakeModuleWithManyFunctions(2000));
+  ScopedContext context;
+  TextPieces streamed;
+  streamed.max_pieces = 1;
+  EXPECT_EQ(SPV_REQUESTED_TERMINATION,
+            spvBinaryToTextStream(context.context, words.data(), words.size(),
+                                  SPV_BINARY_TO_TEXT_OPTION_NONE, &streamed,
+                                  CollectTextPiece, &diagnostic));
+  EXPECT_EQ(1u, streamed.pieces.size());
+  EXPECT_EQ(nullptr, diagnostic);
+}
+
 // TODO(dneto): Test new instructions and enums in SPIR-V 1.3
 
 }  // namespace
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -141,6 +142,21 @@ TEST(CppInterface, DisassembleOverloads) {
     EXPECT_TRUE(t.Disassemble(binary.data(), binary.size(), &output_text));
     EXPECT_EQ(input_text, output_text);
   }
+  {
+    std::ostringstream output_stream;
+    EXPECT_TRUE(t.Disassemble(binary.data(), binary.size(), &output_stream));
+    EXPECT_EQ(input_text, output_stream.str());
+  }
+}
+
+TEST(CppInterface, DisassembleToFailedStream) {
+  SpirvTools t(SPV_ENV_UNIVERSAL_1_1);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(t.Assemble("%2 = OpSizeOf %1 %3\n", &binary));
+
+  std::ostringstream output_stream;
+  output_stream.setstate(std::ios::badbit);
+  EXPECT_FALSE(t.Disassemble(binary.data(), binary.size(), &output_stream));
 }
 
 TEST(CppInterface, SuccessfulValidation) {
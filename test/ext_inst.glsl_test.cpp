@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 
+#include "source/ext_inst.h"
 #include "source/latest_version_glsl_std_450_header.h"
 #include "test/unit_spirv.h"
 
@@ -37,6 +38,27 @@ struct ExtInstContext {
   std::vector<uint32_t> extInstOperandIds;  ///< Ids for operands.
 };
 
+TEST(ExtInstTableNameLookup, FindsEveryInstructionByName) {
+  spv_ext_inst_table table;
+  ASSERT_EQ(SPV_SUCCESS, spvExtInstTableGet(&table, SPV_ENV_UNIVERSAL_1_0));
+  for (uint32_t i = 0; i < table->count; ++i) {
+    const auto& group = table->groups[i];
+    for (uint32_t j = 0; j < group.count; ++j) {
+      const auto& entry = group.entries[j];
+      spv_ext_inst_desc found = nullptr;
+      ASSERT_EQ(SPV_SUCCESS,
+                spvExtInstTableNameLookup(table, group.type, entry.name,
+                                          &found))
+          << entry.name;
+      EXPECT_EQ(&entry, found);
+    }
+  }
+  spv_ext_inst_desc found = nullptr;
+  EXPECT_EQ(SPV_ERROR_INVALID_LOOKUP,
+            spvExtInstTableNameLookup(table, SPV_EXT_INST_TYPE_GLSL_STD_450,
+                                      "Sqrtt", &found));
+}
+
 using ExtInstGLSLstd450RoundTripTest = ::testing::TestWithParam<ExtInstContext>;
 
 TEST_P(ExtInstGLSLstd450RoundTripTest, ParameterizedExtInst) {
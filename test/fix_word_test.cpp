@@ -60,5 +60,31 @@ TEST(FixDoubleWord, Reorder) {
   ASSERT_EQ(result, spvFixDoubleWord(low, high, endian));
 }
 
+TEST(FixWords, MatchesFixWordForAllLengths) {
+  for (spv_endianness_t endian : {SPV_ENDIANNESS_LITTLE, SPV_ENDIANNESS_BIG}) {
+    // Cover lengths that do and do not fill whole vector registers.
+    for (size_t num_words = 0; num_words < 40; ++num_words) {
+      std::vector<uint32_t> words(num_words);
+      for (size_t i = 0; i < num_words; ++i) {
+        words[i] = 0x53780921u * static_cast<uint32_t>(i + 1);
+      }
+      std::vector<uint32_t> fixed(num_words);
+      spvFixWords(words.data(), num_words, endian, fixed.data());
+      for (size_t i = 0; i < num_words; ++i) {
+        EXPECT_EQ(spvFixWord(words[i], endian), fixed[i]) << i;
+      }
+    }
+  }
+}
+
+TEST(FixWords, InPlace) {
+  spv_endianness_t endian =
+      (I32_ENDIAN_HOST == I32_ENDIAN_LITTLE ? SPV_ENDIANNESS_BIG
+                                            : SPV_ENDIANNESS_LITTLE);
+  std::vector<uint32_t> words(11, 0x53780921);
+  spvFixWords(words.data(), words.size(), endian, words.data());
+  EXPECT_EQ(std::vector<uint32_t>(11, 0x21097853), words);
+}
+
 }  // namespace
 }  // namespace spvtools
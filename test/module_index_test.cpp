@@ -0,0 +1,273 @@
+// Copyright (c) 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "test/test_fixture.h"
+#include "test/unit_spirv.h"
+
+namespace spvtools {
+namespace {
+
+using spvtest::ScopedContext;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+const char kModule[] = R"(
+               OpCapability Shader
+               OpCapability Int64
+       %glsl = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint GLCompute %main "main"
+               OpExecutionMode %main LocalSize 1 1 1
+               OpName %main "main"
+               OpName %helper "helper"
+               OpDecorate %float_2 RelaxedPrecision
+       %void = OpTypeVoid
+         %fn = OpTypeFunction %void
+       %long = OpTypeInt 64 0
+      %float = OpTypeFloat 32
+     %long_1 = OpConstant %long 1
+    %float_2 = OpConstant %float 2
+     %helper = OpFunction %void None %fn
+    %h_entry = OpLabel
+       %sqrt = OpExtInst %float %glsl Sqrt %float_2
+               OpReturn
+               OpFunctionEnd
+       %main = OpFunction %void None %fn
+      %entry = OpLabel
+               OpSelectionMerge %merge None
+               OpSwitch %long_1 %merge 5000000000 %merge
+      %merge = OpLabel
+               OpReturn
+               OpFunctionEnd
+)";
+
+// Records the opcode of each parsed instruction, and the number of words of
+// the last operand of each OpSwitch.
+struct ParsedRange {
+  std::vector<spv::Op> opcodes;
+  std::vector<uint16_t> switch_literal_words;
+};
+
+spv_result_t RecordInstruction(void* user_data,
+                               const spv_parsed_instruction_t* inst) {
+  auto parsed = static_cast<ParsedRange*>(user_data);
+  parsed->opcodes.push_back(static_cast<spv::Op>(inst->opcode));
+  if (static_cast<spv::Op>(inst->opcode) == spv::Op::OpSwitch) {
+    parsed->switch_literal_words.push_back(
+        inst->operands[inst->num_operands - 2].num_words);
+  }
+  return SPV_SUCCESS;
+}
+
+using ModuleIndexTest = spvtest::TextToBinaryTestBase<::testing::Test>;
+
+class ModuleIndexFixture : public ModuleIndexTest {
+ protected:
+  // Assembles kModule, optionally flips its endianness, and indexes it.
+  void BuildIndex(bool flip_words) {
+    words_ = CompileSuccessfully(kModule);
+    MaybeFlipWords(flip_words, words_.begin(), words_.end());
+    ASSERT_EQ(SPV_SUCCESS,
+              spvModuleIndexCreate(context_.context, words_.data(),
+                                   words_.size(), &index_, &diagnostic));
+  }
+
+  ~ModuleIndexFixture() override { spvModuleIndexDestroy(index_); }
+
+  ScopedContext context_;
+  std::vector<uint32_t> words_;
+  spv_module_index index_ = nullptr;
+};
+
+TEST_F(ModuleIndexFixture, Sections) {
+  BuildIndex(false);
+  size_t begin = 0;
+  size_t end = 0;
+  ASSERT_TRUE(spvModuleIndexGetSection(index_, SPV_MODULE_SECTION_CAPABILITY,
+                                       &begin, &end));
+  EXPECT_EQ(kFirstInstruction, begin);
+  // The sections present in the module follow each other.
+  size_t previous_end = end;
+  for (const auto section :
+       {SPV_MODULE_SECTION_EXT_INST_IMPORT, SPV_MODULE_SECTION_MEMORY_MODEL,
+        SPV_MODULE_SECTION_ENTRY_POINT, SPV_MODULE_SECTION_EXECUTION_MODE,
+        SPV_MODULE_SECTION_DEBUG, SPV_MODULE_SECTION_ANNOTATION,
+        SPV_MODULE_SECTION_TYPES_VALUES, SPV_MODULE_SECTION_FUNCTIONS}) {
+    ASSERT_TRUE(spvModuleIndexGetSection(index_, section, &begin, &end))
+        << section;
+    EXPECT_EQ(previous_end, begin) << section;
+    EXPECT_LT(begin, end) << section;
+    previous_end = end;
+  }
+  EXPECT_EQ(words_.size(), previous_end);
+  EXPECT_FALSE(spvModuleIndexGetSection(index_, SPV_MODULE_SECTION_EXTENSION,
+                                        &begin, &end));
+  EXPECT_FALSE(spvModuleIndexGetSection(index_, SPV_MODULE_SECTION_COUNT,
+                                        &begin, &end));
+}
+
+TEST_F(ModuleIndexFixture, FunctionsAndIds) {
+  BuildIndex(false);
+  ASSERT_EQ(2u, spvModuleIndexGetFunctionCount(index_));
+  uint32_t helper_id = 0;
+  size_t helper_begin = 0;
+  size_t helper_end = 0;
+  ASSERT_TRUE(spvModuleIndexGetFunction(index_, 0, &helper_id, &helper_begin,
+                                        &helper_end));
+  uint32_t main_id = 0;
+  size_t main_begin = 0;
+  size_t main_end = 0;
+  ASSERT_TRUE(spvModuleIndexGetFunction(index_, 1, &main_id, &main_begin,
+                                        &main_end));
+  EXPECT_FALSE(spvModuleIndexGetFunction(index_, 2, nullptr, nullptr, nullptr));
+  EXPECT_EQ(helper_end, main_begin);
+  EXPECT_EQ(words_.size(), main_end);
+  // %main is the first id used in the module.
+  EXPECT_EQ(1u, main_id);
+
+  size_t begin = 0;
+  size_t end = 0;
+  ASSERT_TRUE(spvModuleIndexGetIdDefinition(index_, main_id, &begin, &end));
+  EXPECT_EQ(main_begin, begin);
+  EXPECT_EQ(spv::Op::OpFunction, static_cast<spv::Op>(words_[begin] & 0xffff));
+  EXPECT_EQ(words_[begin] >> 16, end - begin);
+  EXPECT_FALSE(spvModuleIndexGetIdDefinition(index_, 0, &begin, &end));
+  EXPECT_FALSE(spvModuleIndexGetIdDefinition(index_, 1000, &begin, &end));
+}
+
+class ModuleIndexParseTest
+    : public spvtest::TextToBinaryTestBase<::testing::TestWithParam<bool>> {};
+
+TEST_P(ModuleIndexParseTest, ParseOneFunction) {
+  auto words = CompileSuccessfully(kModule);
+  MaybeFlipWords(GetParam(), words.begin(), words.end());
+  ScopedContext context;
+  spv_module_index index = nullptr;
+  ASSERT_EQ(SPV_SUCCESS, spvModuleIndexCreate(context.context, words.data(),
+                                              words.size(), &index,
+                                              &diagnostic));
+  size_t begin = 0;
+  size_t end = 0;
+  ASSERT_TRUE(spvModuleIndexGetFunction(index, 1, nullptr, &begin, &end));
+
+  ParsedRange parsed;
+  EXPECT_EQ(SPV_SUCCESS,
+            spvModuleIndexParseRange(context.context, index, begin, end,
+                                     &parsed, nullptr, RecordInstruction,
+                                     &diagnostic));
+  EXPECT_THAT(parsed.opcodes,
+              ElementsAre(spv::Op::OpFunction, spv::Op::OpLabel,
+                          spv::Op::OpSelectionMerge, spv::Op::OpSwitch,
+                          spv::Op::OpLabel, spv::Op::OpReturn,
+                          spv::Op::OpFunctionEnd));
+  // The 64-bit selector type was learned from the types section.
+  EXPECT_THAT(parsed.switch_literal_words, ElementsAre(2));
+  spvModuleIndexDestroy(index);
+}
+
+INSTANTIATE_TEST_SUITE_P(Endianness, ModuleIndexParseTest,
+                         ::testing::Bool());
+
+TEST_F(ModuleIndexFixture, DisassembleOneFunction) {
+  BuildIndex(false);
+  size_t begin = 0;
+  size_t end = 0;
+  ASSERT_TRUE(spvModuleIndexGetFunction(index_, 0, nullptr, &begin, &end));
+  spv_text text = nullptr;
+  ASSERT_EQ(SPV_SUCCESS,
+            spvModuleIndexRangeToText(
+                context_.context, index_, begin, end,
+                SPV_BINARY_TO_TEXT_OPTION_NO_HEADER |
+                    SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES,
+                &text, &diagnostic));
+  const std::string disassembly(text->str, text->length);
+  spvTextDestroy(text);
+  EXPECT_THAT(disassembly, HasSubstr("%helper = OpFunction %void None"));
+  EXPECT_THAT(disassembly, HasSubstr("Sqrt %float_2"));
+  EXPECT_THAT(disassembly, Not(HasSubstr("OpCapability")));
+  EXPECT_THAT(disassembly, Not(HasSubstr("OpSwitch")));
+}
+
+TEST_F(ModuleIndexFixture, ParseSingleDefinition) {
+  BuildIndex(true);
+  size_t begin = 0;
+  size_t end = 0;
+  // Parse each type, constant and function instruction on its own.
+  size_t types_begin = 0;
+  ASSERT_TRUE(spvModuleIndexGetSection(
+      index_, SPV_MODULE_SECTION_TYPES_VALUES, &types_begin, nullptr));
+  ParsedRange parsed;
+  for (uint32_t id = 1; id < 100; ++id) {
+    if (!spvModuleIndexGetIdDefinition(index_, id, &begin, &end)) continue;
+    if (begin < types_begin) continue;
+    EXPECT_EQ(SPV_SUCCESS,
+              spvModuleIndexParseRange(context_.context, index_, begin, end,
+                                       &parsed, nullptr, RecordInstruction,
+                                       &diagnostic));
+  }
+  EXPECT_EQ(2, std::count(parsed.opcodes.begin(), parsed.opcodes.end(),
+                         spv::Op::OpConstant));
+}
+
+TEST_F(ModuleIndexFixture, RejectsRangesNotAtInstructionBoundaries) {
+  BuildIndex(false);
+  size_t begin = 0;
+  size_t end = 0;
+  ASSERT_TRUE(spvModuleIndexGetFunction(index_, 1, nullptr, &begin, &end));
+  EXPECT_EQ(SPV_ERROR_INVALID_VALUE,
+            spvModuleIndexParseRange(context_.context, index_, begin + 1, end,
+                                     nullptr, nullptr, nullptr, &diagnostic));
+  spvDiagnosticDestroy(diagnostic);
+  diagnostic = nullptr;
+  EXPECT_EQ(SPV_ERROR_INVALID_VALUE,
+            spvModuleIndexParseRange(context_.context, index_, begin, end + 1,
+                                     nullptr, nullptr, nullptr, &diagnostic));
+}
+
+TEST_F(ModuleIndexTest, RejectsMalformedModules) {
+  ScopedContext context;
+  auto words = CompileSuccessfully(kModule);
+  spv_module_index index = nullptr;
+
+  EXPECT_EQ(SPV_ERROR_INVALID_BINARY,
+            spvModuleIndexCreate(context.context, words.data(), 3, &index,
+                                 &diagnostic));
+  EXPECT_THAT(diagnostic->error, HasSubstr("incomplete header"));
+  spvDiagnosticDestroy(diagnostic);
+  diagnostic = nullptr;
+
+  // Cut the module in the middle of the last OpLabel.
+  EXPECT_EQ(SPV_ERROR_INVALID_BINARY,
+            spvModuleIndexCreate(context.context, words.data(),
+                                 words.size() - 3, &index, &diagnostic));
+  EXPECT_THAT(diagnostic->error, HasSubstr("End of input reached"));
+  spvDiagnosticDestroy(diagnostic);
+  diagnostic = nullptr;
+
+  words[0] = 0;
+  EXPECT_EQ(SPV_ERROR_INVALID_BINARY,
+            spvModuleIndexCreate(context.context, words.data(), words.size(),
+                                 &index, &diagnostic));
+  EXPECT_THAT(diagnostic->error, HasSubstr("Invalid SPIR-V magic number"));
+  EXPECT_EQ(nullptr, index);
+}
+
+}  // namespace
+}  // namespace spvtools
@@ -35,5 +35,34 @@ TEST_P(GetTargetOpcodeTableGetTest, InvalidPointerTable) {
 INSTANTIATE_TEST_SUITE_P(OpcodeTableGet, GetTargetOpcodeTableGetTest,
                          ValuesIn(spvtest::AllTargetEnvironments()));
 
+TEST(OpcodeTableNameLookup, FindsEveryOpcodeByName) {
+  spv_opcode_table table;
+  ASSERT_EQ(SPV_SUCCESS, spvOpcodeTableGet(&table, SPV_ENV_UNIVERSAL_1_6));
+  for (uint32_t i = 0; i < table->count; ++i) {
+    const auto& entry = table->entries[i];
+    spv_opcode_desc found = nullptr;
+    if (spvOpcodeTableNameLookup(SPV_ENV_UNIVERSAL_1_6, table, entry.name,
+                                 &found) == SPV_SUCCESS) {
+      EXPECT_EQ(&entry, found) << entry.name;
+    }
+  }
+  spv_opcode_desc found = nullptr;
+  EXPECT_EQ(SPV_SUCCESS, spvOpcodeTableNameLookup(SPV_ENV_UNIVERSAL_1_6, table,
+                                                  "IAdd", &found));
+  EXPECT_EQ(spv::Op::OpIAdd, found->opcode);
+}
+
+TEST(OpcodeTableNameLookup, RejectsUnknownNames) {
+  spv_opcode_table table;
+  ASSERT_EQ(SPV_SUCCESS, spvOpcodeTableGet(&table, SPV_ENV_UNIVERSAL_1_6));
+  spv_opcode_desc found = nullptr;
+  for (const char* name : {"", "I", "IAd", "IAddd", "iadd", "OpIAdd"}) {
+    EXPECT_EQ(SPV_ERROR_INVALID_LOOKUP,
+              spvOpcodeTableNameLookup(SPV_ENV_UNIVERSAL_1_6, table, name,
+                                       &found))
+        << name;
+  }
+}
+
 }  // namespace
 }  // namespace spvtools
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstring>
 #include <vector>
 
 #include "test/unit_spirv.h"
@@ -55,6 +56,82 @@ TEST(OperandString, AllAreDefinedExceptVariable) {
   }
 }
 
+TEST(OperandTableValueLookup, FindsEveryEnumerant) {
+  spv_operand_table table;
+  ASSERT_EQ(SPV_SUCCESS, spvOperandTableGet(&table, SPV_ENV_UNIVERSAL_1_0));
+  for (uint64_t i = 0; i < table->count; ++i) {
+    const auto& group = table->types[i];
+    for (uint32_t j = 0; j < group.count; ++j) {
+      const auto& entry = group.entries[j];
+      spv_operand_desc found = nullptr;
+      ASSERT_EQ(SPV_SUCCESS,
+                spvOperandTableValueLookup(SPV_ENV_UNIVERSAL_1_0, table,
+                                           group.type, entry.value, &found))
+          << spvOperandTypeStr(group.type) << " " << entry.name;
+      // Aliases share a value; the lookup yields the first of them.
+      EXPECT_EQ(entry.value, found->value);
+      EXPECT_LE(found, &entry);
+    }
+  }
+}
+
+TEST(OperandTableValueLookup, RejectsUnknownValues) {
+  spv_operand_table table;
+  ASSERT_EQ(SPV_SUCCESS, spvOperandTableGet(&table, SPV_ENV_UNIVERSAL_1_0));
+  spv_operand_desc found = nullptr;
+  EXPECT_EQ(SPV_ERROR_INVALID_LOOKUP,
+            spvOperandTableValueLookup(SPV_ENV_UNIVERSAL_1_0, table,
+                                       SPV_OPERAND_TYPE_CAPABILITY,
+                                       0x7fffffffu, &found));
+  // Several bits at once are never a single mask enumerant.
+  EXPECT_EQ(SPV_ERROR_INVALID_LOOKUP,
+            spvOperandTableValueLookup(SPV_ENV_UNIVERSAL_1_0, table,
+                                       SPV_OPERAND_TYPE_MEMORY_ACCESS,
+                                       0x3u, &found));
+  EXPECT_EQ(SPV_ERROR_INVALID_LOOKUP,
+            spvOperandTableValueLookup(SPV_ENV_UNIVERSAL_1_0, table,
+                                       SPV_OPERAND_TYPE_NONE, 0, &found));
+}
+
+TEST(OperandTableNameLookup, FindsEveryEnumerant) {
+  spv_operand_table table;
+  ASSERT_EQ(SPV_SUCCESS, spvOperandTableGet(&table, SPV_ENV_UNIVERSAL_1_0));
+  for (uint64_t i = 0; i < table->count; ++i) {
+    const auto& group = table->types[i];
+    for (uint32_t j = 0; j < group.count; ++j) {
+      const auto& entry = group.entries[j];
+      spv_operand_desc found = nullptr;
+      ASSERT_EQ(SPV_SUCCESS,
+                spvOperandTableNameLookup(SPV_ENV_UNIVERSAL_1_0, table,
+                                          group.type, entry.name,
+                                          strlen(entry.name), &found))
+          << spvOperandTypeStr(group.type) << " " << entry.name;
+      EXPECT_EQ(&entry, found);
+    }
+  }
+}
+
+TEST(OperandTableNameLookup, ComparesOnlyTheGivenLength) {
+  spv_operand_table table;
+  ASSERT_EQ(SPV_SUCCESS, spvOperandTableGet(&table, SPV_ENV_UNIVERSAL_1_0));
+  spv_operand_desc found = nullptr;
+  // The assembler looks up each part of a mask like "Volatile|Aligned".
+  const char* text = "Volatile|Aligned";
+  ASSERT_EQ(SPV_SUCCESS,
+            spvOperandTableNameLookup(SPV_ENV_UNIVERSAL_1_0, table,
+                                      SPV_OPERAND_TYPE_MEMORY_ACCESS, text, 8,
+                                      &found));
+  EXPECT_STREQ("Volatile", found->name);
+  EXPECT_EQ(SPV_ERROR_INVALID_LOOKUP,
+            spvOperandTableNameLookup(SPV_ENV_UNIVERSAL_1_0, table,
+                                      SPV_OPERAND_TYPE_MEMORY_ACCESS, text, 7,
+                                      &found));
+  EXPECT_EQ(SPV_ERROR_INVALID_LOOKUP,
+            spvOperandTableNameLookup(SPV_ENV_UNIVERSAL_1_0, table,
+                                      SPV_OPERAND_TYPE_MEMORY_ACCESS, text,
+                                      strlen(text), &found));
+}
+
 TEST(OperandIsConcreteMask, Sample) {
   // Check a few operand types preceding the concrete mask types.
   EXPECT_FALSE(spvOperandIsConcreteMask(SPV_OPERAND_TYPE_NONE));
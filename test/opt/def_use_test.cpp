@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <memory>
+#include <sstream>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -1430,6 +1431,30 @@ TEST(AnalyzeInstDefUse, AddNewInstruction) {
   CheckUse(expected, &manager, context->module()->IdBound());
 }
 
+TEST(AnalyzeInstDefUse, DefsAboveTheIdBound) {
+  const std::string input = "%1 = OpTypeBool";
+
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, input);
+  ASSERT_NE(nullptr, context);
+  DefUseManager* manager = context->get_def_use_mgr();
+
+  // Ids taken after the analysis was built grow the tables as they are
+  // registered.
+  std::vector<std::unique_ptr<Instruction>> insts;
+  for (int i = 0; i < 1000; ++i) {
+    const uint32_t id = context->TakeNextId();
+    EXPECT_EQ(nullptr, manager->GetDef(id));
+    insts.emplace_back(
+        new Instruction(context.get(), spv::Op::OpConstantTrue, 1, id, {}));
+    manager->AnalyzeInstDefUse(insts.back().get());
+  }
+  EXPECT_EQ(1001u, manager->id_to_defs().size());
+  EXPECT_EQ(insts.back().get(), manager->GetDef(insts.back()->result_id()));
+  EXPECT_EQ(1000u, manager->NumUsers(1));
+  EXPECT_EQ(nullptr, manager->GetDef(context->module()->IdBound()));
+}
+
 struct KillInstTestCase {
   const char* before;
   std::unordered_set<uint32_t> indices_for_inst_to_kill;
@@ -1714,6 +1739,118 @@ TEST_F(UpdateUsesTest, KeepOldUses) {
 
   EXPECT_TRUE(userFound);
 }
+
+TEST_F(UpdateUsesTest, UsersInUniqueIdOrder) {
+  const std::vector<const char*> text = {
+      // clang-format off
+      "OpCapability Shader",
+      "OpMemoryModel Logical GLSL450",
+      "OpEntryPoint Vertex %main \"main\"",
+      "%void = OpTypeVoid",
+      "%4 = OpTypeFunction %void",
+      "%uint = OpTypeInt 32 0",
+      "%7 = OpConstant %uint 5",
+      "%main = OpFunction %void None %4",
+      "%8 = OpLabel",
+      "%9 = OpIMul %uint %7 %7",
+      "%10 = OpIAdd %uint %9 %7",
+      "%11 = OpISub %uint %7 %10",
+      "OpReturn",
+      "OpFunctionEnd"
+      // clang-format on
+  };
+
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, JoinAllInsts(text),
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(nullptr, context);
+
+  DefUseManager* def_use_mgr = context->get_def_use_mgr();
+  Instruction* uint_5 = def_use_mgr->GetDef(7);
+  Instruction* inst_9 = def_use_mgr->GetDef(9);
+  Instruction* inst_10 = def_use_mgr->GetDef(10);
+  Instruction* inst_11 = def_use_mgr->GetDef(11);
+  auto users_of = [def_use_mgr](Instruction* def) {
+    std::vector<Instruction*> users;
+    def_use_mgr->ForEachUser(
+        def, [&users](Instruction* user) { users.push_back(user); });
+    return users;
+  };
+
+  // %9 uses %7 twice, but is a single user.
+  EXPECT_EQ(3u, def_use_mgr->NumUsers(uint_5));
+  EXPECT_EQ(4u, def_use_mgr->NumUses(uint_5));
+
+  // Analyzing a user again keeps the users in order.
+  def_use_mgr->AnalyzeInstUse(inst_10);
+  def_use_mgr->AnalyzeInstUse(inst_9);
+  EXPECT_THAT(users_of(uint_5),
+              ::testing::ElementsAre(inst_9, inst_10, inst_11));
+
+  // Clearing an instruction drops its uses, and the uses of its result id.
+  def_use_mgr->ClearInst(inst_10);
+  EXPECT_THAT(users_of(uint_5), ::testing::ElementsAre(inst_9, inst_11));
+  EXPECT_EQ(0u, def_use_mgr->NumUsers(inst_9));
+  EXPECT_EQ(nullptr, def_use_mgr->GetDef(10));
+
+  // A new user comes after the existing ones.
+  inst_11->SetInOperand(1, {7});
+  def_use_mgr->AnalyzeInstUse(inst_11);
+  EXPECT_THAT(users_of(uint_5), ::testing::ElementsAre(inst_9, inst_11));
+  EXPECT_EQ(4u, def_use_mgr->NumUses(uint_5));
+  def_use_mgr->AnalyzeInstDefUse(inst_10);
+  EXPECT_THAT(users_of(uint_5),
+              ::testing::ElementsAre(inst_9, inst_10, inst_11));
+  EXPECT_THAT(users_of(inst_9), ::testing::ElementsAre(inst_10));
+}
+
+TEST_F(UpdateUsesTest, ReplaceManyValuesWithWidelyUsedConstant) {
+  // Each %x is used by one %y, and %uint_0 is used by every %z.  Replacing
+  // the %x with %uint_0 in order links each %y between two of its users.
+  // Searching for each position from the end of the list would take time
+  // quadratic in the number of values.
+  const uint32_t kNumValues = 20000;
+  std::ostringstream text;
+  text << "OpCapability Shader\n"
+       << "OpMemoryModel Logical GLSL450\n"
+       << "OpEntryPoint Vertex %1 \"main\"\n"
+       << "%2 = OpTypeVoid\n"
+       << "%3 = OpTypeFunction %2\n"
+       << "%4 = OpTypeInt 32 0\n"
+       << "%5 = OpConstant %4 0\n"
+       << "%6 = OpConstant %4 1\n"
+       << "%1 = OpFunction %2 None %3\n"
+       << "%7 = OpLabel\n";
+  for (uint32_t i = 0; i < kNumValues; ++i) {
+    const uint32_t x = 10 + 3 * i;
+    text << "%" << x << " = OpIAdd %4 %6 %6\n"
+         << "%" << x + 1 << " = OpIMul %4 %" << x << " %" << x << "\n"
+         << "%" << x + 2 << " = OpISub %4 %5 %6\n";
+  }
+  text << "OpReturn\n"
+       << "OpFunctionEnd\n";
+
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, text.str(),
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(nullptr, context);
+
+  DefUseManager* def_use_mgr = context->get_def_use_mgr();
+  for (uint32_t i = 0; i < kNumValues; ++i) {
+    EXPECT_TRUE(context->ReplaceAllUsesWith(10 + 3 * i, 5));
+  }
+
+  // Every %y and %z now uses %uint_0, and they are still visited in order.
+  EXPECT_EQ(2 * kNumValues, def_use_mgr->NumUsers(5));
+  uint32_t expected_id = 11;
+  bool in_order = true;
+  def_use_mgr->ForEachUser(5, [&expected_id, &in_order](Instruction* user) {
+    in_order &= user->result_id() == expected_id;
+    expected_id += expected_id % 3 == 2 ? 2 : 1;
+  });
+  EXPECT_TRUE(in_order);
+  EXPECT_EQ(10 + 3 * kNumValues + 1, expected_id);
+}
 // clang-format on
 
 }  // namespace
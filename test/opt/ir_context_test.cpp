@@ -75,6 +75,34 @@ class NoopPassPreservesFirst : public Pass {
   Status status_to_return_;
 };
 
+// Turns the selection construct headed by |header| into a branch to |target|.
+void RemoveSelection(IRContext* context, BasicBlock* header, uint32_t target) {
+  context->KillInst(header->GetMergeInst());
+  Instruction* branch = header->terminator();
+  branch->SetOpcode(spv::Op::OpBranch);
+  branch->SetInOperands({{SPV_OPERAND_TYPE_ID, {target}}});
+}
+
+// Removes the selection construct at the start of the first function, and
+// reports that function as modified.
+class StraightenFirstFunctionPass : public Pass {
+ public:
+  const char* name() const override { return "straighten-first-function"; }
+  bool ReportsModifiedFunctions() const override { return true; }
+
+  Status Process() override {
+    Function* first = &*get_module()->begin();
+    ProcessFunction pfn = [this, first](Function* fp) {
+      if (fp != first) return false;
+      BasicBlock* header = &*fp->begin();
+      RemoveSelection(context(), header, fp->begin()[1].id());
+      return true;
+    };
+    return ProcessReachableCallTree(pfn) ? Status::SuccessWithChange
+                                         : Status::SuccessWithoutChange;
+  }
+};
+
 using IRContextTest = PassTest<::testing::Test>;
 
 TEST_F(IRContextTest, IndividualValidAfterBuild) {
@@ -1148,6 +1176,162 @@ OpFunctionEnd)";
             20);
 }
 
+TEST_F(IRContextTest, InstructionsComeFromTheSlabs) {
+  const std::string text = R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%uint_1 = OpConstant %uint 1
+%main = OpFunction %void None %fn
+%entry = OpLabel
+%sum = OpIAdd %uint %uint_1 %uint_1
+OpReturn
+OpFunctionEnd
+)";
+  std::unique_ptr<IRContext> ctx =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+  ASSERT_NE(nullptr, ctx);
+  utils::SlabAllocator* allocator = ctx->slab_allocator();
+  // The 13 instructions, the operands of the 11 that have some, and the basic
+  // block were loaded into the slabs.
+  const size_t num_loaded = allocator->num_allocated();
+  EXPECT_EQ(25u, num_loaded);
+
+  Instruction* sum = &*ctx->module()->begin()->begin()->begin();
+  ASSERT_EQ(spv::Op::OpIAdd, sum->opcode());
+  std::unique_ptr<Instruction> clone(sum->Clone(ctx.get()));
+  EXPECT_EQ(num_loaded + 2, allocator->num_allocated());
+  clone.reset();
+  ctx->KillInst(sum);
+  EXPECT_EQ(num_loaded - 2, allocator->num_allocated());
+
+  // A copy of an instruction comes from the heap, operands included.
+  Instruction* one = ctx->get_def_use_mgr()->GetDef(5);
+  ASSERT_EQ(spv::Op::OpConstant, one->opcode());
+  Instruction copy(*one);
+  EXPECT_EQ(num_loaded - 2, allocator->num_allocated());
+
+  // Instructions created without a context come from the heap.
+  std::unique_ptr<Instruction> heap_inst(new Instruction(ctx.get()));
+  EXPECT_EQ(num_loaded - 2, allocator->num_allocated());
+}
+
+TEST_F(IRContextTest, LongOperandsComeFromTheSlabs) {
+  auto num_allocated = [](const std::string& name) {
+    const std::string text = R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpName %uint ")" + name + R"("
+%uint = OpTypeInt 32 0
+)";
+    std::unique_ptr<IRContext> ctx =
+        BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+    return ctx->slab_allocator()->num_allocated();
+  };
+  // The words of a name that does not fit in its operand come from the slabs,
+  // along with the vector holding them.
+  EXPECT_EQ(num_allocated("uint") + 2,
+            num_allocated("an_unsigned_integer_type"));
+}
+
+const std::string kTwoFunctionsWithSelections = R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%bool = OpTypeBool
+%true = OpConstantTrue %bool
+%main = OpFunction %void None %fn
+%main_header = OpLabel
+OpSelectionMerge %main_merge None
+OpBranchConditional %true %main_then %main_merge
+%main_then = OpLabel
+OpBranch %main_merge
+%main_merge = OpLabel
+%call = OpFunctionCall %void %other
+OpReturn
+OpFunctionEnd
+%other = OpFunction %void None %fn
+%other_header = OpLabel
+OpSelectionMerge %other_merge None
+OpBranchConditional %true %other_then %other_merge
+%other_then = OpLabel
+OpBranch %other_merge
+%other_merge = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+TEST_F(IRContextTest, InvalidateAnalysesOfModifiedFunctions) {
+  std::unique_ptr<IRContext> ctx = BuildModule(
+      SPV_ENV_UNIVERSAL_1_2, nullptr, kTwoFunctionsWithSelections);
+  ASSERT_NE(nullptr, ctx);
+  Function* main = &*ctx->module()->begin();
+  Function* other = &ctx->module()->begin()[1];
+  BasicBlock* header = &*main->begin();
+  BasicBlock* then = &main->begin()[1];
+  BasicBlock* merge = &main->begin()[2];
+
+  CFG* cfg = ctx->cfg();
+  DominatorAnalysis* other_dom = ctx->GetDominatorAnalysis(other);
+  LoopDescriptor* other_loops = ctx->GetLoopDescriptor(other);
+  StructuredCFGAnalysis* struct_cfg = ctx->GetStructuredCFGAnalysis();
+  EXPECT_FALSE(ctx->GetDominatorAnalysis(main)->Dominates(then, merge));
+  EXPECT_EQ(header->id(), struct_cfg->ContainingConstruct(then->id()));
+  EXPECT_TRUE(struct_cfg->IsMergeBlock(merge->id()));
+
+  RemoveSelection(ctx.get(), header, then->id());
+  ctx->InvalidateAnalysesExceptFor(IRContext::kAnalysisNone, {main});
+
+  // The CFG is rebuilt in place, and the analyses of |other| are kept.
+  EXPECT_EQ(cfg, ctx->cfg());
+  EXPECT_EQ(other_dom, ctx->GetDominatorAnalysis(other));
+  EXPECT_EQ(other_loops, ctx->GetLoopDescriptor(other));
+  EXPECT_EQ(struct_cfg, ctx->GetStructuredCFGAnalysis());
+
+  // Those of |main| are rebuilt.
+  EXPECT_TRUE(ctx->GetDominatorAnalysis(main)->Dominates(then, merge));
+  EXPECT_EQ(0u, struct_cfg->ContainingConstruct(then->id()));
+  EXPECT_FALSE(struct_cfg->IsMergeBlock(merge->id()));
+
+  BasicBlock* other_then = &other->begin()[1];
+  EXPECT_EQ(other->begin()->id(),
+            struct_cfg->ContainingConstruct(other_then->id()));
+  EXPECT_TRUE(other_dom->Dominates(&*other->begin(), other_then));
+}
+
+TEST_F(IRContextTest, PassesReportTheFunctionsTheyModify) {
+  std::unique_ptr<IRContext> ctx = BuildModule(
+      SPV_ENV_UNIVERSAL_1_2, nullptr, kTwoFunctionsWithSelections);
+  ASSERT_NE(nullptr, ctx);
+  Function* main = &*ctx->module()->begin();
+  Function* other = &ctx->module()->begin()[1];
+  BasicBlock* then = &main->begin()[1];
+  BasicBlock* merge = &main->begin()[2];
+
+  DominatorAnalysis* other_dom = ctx->GetDominatorAnalysis(other);
+  EXPECT_FALSE(ctx->GetDominatorAnalysis(main)->Dominates(then, merge));
+
+  StraightenFirstFunctionPass pass;
+  EXPECT_EQ(Pass::Status::SuccessWithChange, pass.Run(ctx.get()));
+  EXPECT_TRUE(ctx->AreAnalysesValid(IRContext::kAnalysisDominatorAnalysis));
+  EXPECT_FALSE(ctx->AreAnalysesValid(IRContext::kAnalysisCFG));
+  EXPECT_EQ(other_dom, ctx->GetDominatorAnalysis(other));
+  EXPECT_TRUE(ctx->GetDominatorAnalysis(main)->Dominates(then, merge));
+
+  // A pass that does not report the functions it modifies invalidates the
+  // analyses of all of them.
+  NoopPassPreservesNothing noop(Pass::Status::SuccessWithChange);
+  noop.Run(ctx.get());
+  EXPECT_FALSE(ctx->AreAnalysesValid(IRContext::kAnalysisDominatorAnalysis));
+}
+
 struct TargetEnvCompareTestData {
   spv_target_env later_env, earlier_env;
 };
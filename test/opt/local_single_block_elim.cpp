@@ -14,6 +14,7 @@
 // limitations under the License.
 
 #include <string>
+#include <vector>
 
 #include "test/opt/pass_fixture.h"
 #include "test/opt/pass_utils.h"
@@ -1545,6 +1546,134 @@ TEST_F(LocalSingleBlockLoadStoreElimTest, VkMemoryModelTest) {
   SinglePassRunAndMatch<LocalSingleBlockLoadStoreElimPass>(text, false);
 }
 
+TEST_F(LocalSingleBlockLoadStoreElimTest, ParallelMatchesSerial) {
+  const std::string text = R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%float = OpTypeFloat 32
+%_ptr_Function_float = OpTypePointer Function %float
+%float_1 = OpConstant %float 1
+%float_2 = OpConstant %float 2
+%main = OpFunction %void None %fn
+%main_entry = OpLabel
+%a = OpVariable %_ptr_Function_float Function
+OpStore %a %float_1
+%a1 = OpLoad %float %a
+%a2 = OpFAdd %float %a1 %float_2
+OpStore %a %a2
+%a3 = OpLoad %float %a
+%call1 = OpFunctionCall %void %f1
+%call2 = OpFunctionCall %void %f2
+OpReturn
+OpFunctionEnd
+%f1 = OpFunction %void None %fn
+%f1_entry = OpLabel
+%b = OpVariable %_ptr_Function_float Function
+OpStore %b %float_2
+%b1 = OpLoad %float %b
+%b2 = OpFMul %float %b1 %b1
+OpStore %b %b2
+%b3 = OpLoad %float %b
+%b4 = OpFAdd %float %b3 %b1
+OpReturn
+OpFunctionEnd
+%f2 = OpFunction %void None %fn
+%f2_entry = OpLabel
+%c = OpVariable %_ptr_Function_float Function
+%c1 = OpLoad %float %c
+OpStore %c %c1
+%c2 = OpLoad %float %c
+%c3 = OpFAdd %float %c2 %float_1
+OpReturn
+OpFunctionEnd
+)";
+
+  std::vector<uint32_t> binaries[2];
+  for (bool parallel : {false, true}) {
+    std::unique_ptr<IRContext> context =
+        BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+    ASSERT_NE(nullptr, context);
+    LocalSingleBlockLoadStoreElimPass pass;
+    pass.SetParallel(parallel);
+    EXPECT_EQ(Pass::Status::SuccessWithChange, pass.Run(context.get()));
+    context->module()->ToBinary(&binaries[parallel], true);
+
+    // Only the load of the uninitialized variable is left.
+    uint32_t num_loads = 0;
+    context->module()->ForEachInst([&num_loads](Instruction* inst) {
+      if (inst->opcode() == spv::Op::OpLoad) ++num_loads;
+    });
+    EXPECT_EQ(1u, num_loads);
+  }
+  EXPECT_EQ(binaries[0], binaries[1]);
+}
+
+TEST_F(LocalSingleBlockLoadStoreElimTest, ParallelReplacesLoadedPointers) {
+  // The load of %px is replaced by %x, which makes the load and the store
+  // through %p a load and a store of %x.
+  const std::string predefs =
+      R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+OpName %main "main"
+OpName %x "x"
+OpName %px "px"
+%void = OpTypeVoid
+%4 = OpTypeFunction %void
+%int = OpTypeInt 32 1
+%int_1 = OpConstant %int 1
+%int_2 = OpConstant %int 2
+%_ptr_Function_int = OpTypePointer Function %int
+%_ptr_Function__ptr_Function_int = OpTypePointer Function %_ptr_Function_int
+)";
+
+  const std::string before =
+      R"(%main = OpFunction %void None %4
+%10 = OpLabel
+%x = OpVariable %_ptr_Function_int Function
+%px = OpVariable %_ptr_Function__ptr_Function_int Function
+OpStore %x %int_1
+OpStore %px %x
+%p = OpLoad %_ptr_Function_int %px
+%v = OpLoad %int %p
+OpStore %p %int_2
+%w = OpLoad %int %x
+OpReturn
+OpFunctionEnd
+)";
+
+  const std::string after =
+      R"(%main = OpFunction %void None %4
+%10 = OpLabel
+%x = OpVariable %_ptr_Function_int Function
+%px = OpVariable %_ptr_Function__ptr_Function_int Function
+OpStore %px %x
+OpStore %x %int_2
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndCheck<LocalSingleBlockLoadStoreElimPass>(
+      predefs + before, predefs + after, true);
+
+  std::vector<uint32_t> binaries[2];
+  for (bool parallel : {false, true}) {
+    std::unique_ptr<IRContext> context =
+        BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, predefs + before);
+    ASSERT_NE(nullptr, context);
+    LocalSingleBlockLoadStoreElimPass pass;
+    pass.SetParallel(parallel);
+    EXPECT_EQ(Pass::Status::SuccessWithChange, pass.Run(context.get()));
+    context->module()->ToBinary(&binaries[parallel], true);
+  }
+  EXPECT_EQ(binaries[0], binaries[1]);
+}
+
 // TODO(greg-lunarg): Add tests to verify handling of these cases:
 //
 //    Other target variable types
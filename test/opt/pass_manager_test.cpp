@@ -186,6 +186,72 @@ TEST(PassManager, RecomputeIdBoundAutomatically) {
   EXPECT_THAT(GetIdBound(*context.module()), Eq(201u));
 }
 
+// A pass that counts the instructions of each reachable function, and records
+// the counts in the order of the functions.
+class CountInstructionsPass : public Pass {
+ public:
+  explicit CountInstructionsPass(std::vector<size_t>* counts)
+      : counts_(counts) {}
+
+  const char* name() const override { return "count-instructions"; }
+  Status Process() override {
+    AnalyzeThenApply(
+        GetReachableFunctions(),
+        [](Function* func) {
+          size_t count = 0;
+          func->ForEachInst([&count](Instruction*) { ++count; });
+          return count;
+        },
+        [this](Function*, size_t* count) {
+          counts_->push_back(*count);
+          return false;
+        });
+    return Status::SuccessWithoutChange;
+  }
+
+ private:
+  std::vector<size_t>* counts_;
+};
+
+TEST(PassManager, ParallelPassesApplyInOrder) {
+  const std::string text = R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%main = OpFunction %void None %fn
+%main_entry = OpLabel
+%call1 = OpFunctionCall %void %small
+%call2 = OpFunctionCall %void %large
+OpReturn
+OpFunctionEnd
+%large = OpFunction %void None %fn
+%large_entry = OpLabel
+OpBranch %large_exit
+%large_exit = OpLabel
+OpReturn
+OpFunctionEnd
+%small = OpFunction %void None %fn
+%small_entry = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  for (bool parallel : {false, true}) {
+    std::unique_ptr<IRContext> context =
+        BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+    ASSERT_NE(nullptr, context);
+    std::vector<size_t> counts;
+    PassManager manager;
+    manager.SetParallel(parallel);
+    manager.AddPass<CountInstructionsPass>(&counts);
+    EXPECT_EQ(Pass::Status::SuccessWithoutChange, manager.Run(context.get()));
+    EXPECT_THAT(counts, ::testing::ElementsAre(6u, 4u, 6u)) << parallel;
+  }
+}
+
 }  // anonymous namespace
 }  // namespace opt
 }  // namespace spvtools
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <string>
+#include <string_view>
 
 #include "test/unit_spirv.h"
 
@@ -27,56 +28,57 @@ using spvtest::AutoText;
 #define QUOTE R"(")"
 
 TEST(TextWordGet, NullTerminator) {
-  std::string word;
+  AutoText input("Word");
+  std::string_view word;
   spv_position_t endPosition = {};
-  ASSERT_EQ(
-      SPV_SUCCESS,
-      AssemblyContext(AutoText("Word"), nullptr).getWord(&word, &endPosition));
+  ASSERT_EQ(SPV_SUCCESS,
+            AssemblyContext(input, nullptr).getWord(&word, &endPosition));
   ASSERT_EQ(4u, endPosition.column);
   ASSERT_EQ(0u, endPosition.line);
   ASSERT_EQ(4u, endPosition.index);
-  ASSERT_STREQ("Word", word.c_str());
+  ASSERT_EQ("Word", word);
 }
 
 TEST(TextWordGet, TabTerminator) {
-  std::string word;
+  AutoText input("Word\t");
+  std::string_view word;
   spv_position_t endPosition = {};
-  ASSERT_EQ(SPV_SUCCESS, AssemblyContext(AutoText("Word\t"), nullptr)
-                             .getWord(&word, &endPosition));
+  ASSERT_EQ(SPV_SUCCESS,
+            AssemblyContext(input, nullptr).getWord(&word, &endPosition));
   ASSERT_EQ(4u, endPosition.column);
   ASSERT_EQ(0u, endPosition.line);
   ASSERT_EQ(4u, endPosition.index);
-  ASSERT_STREQ("Word", word.c_str());
+  ASSERT_EQ("Word", word);
 }
 
 TEST(TextWordGet, SpaceTerminator) {
-  std::string word;
+  AutoText input("Word ");
+  std::string_view word;
   spv_position_t endPosition = {};
-  ASSERT_EQ(
-      SPV_SUCCESS,
-      AssemblyContext(AutoText("Word "), nullptr).getWord(&word, &endPosition));
+  ASSERT_EQ(SPV_SUCCESS,
+            AssemblyContext(input, nullptr).getWord(&word, &endPosition));
   ASSERT_EQ(4u, endPosition.column);
   ASSERT_EQ(0u, endPosition.line);
   ASSERT_EQ(4u, endPosition.index);
-  ASSERT_STREQ("Word", word.c_str());
+  ASSERT_EQ("Word", word);
 }
 
 TEST(TextWordGet, SemicolonTerminator) {
-  std::string word;
+  AutoText input("Wo;rd");
+  std::string_view word;
   spv_position_t endPosition = {};
-  ASSERT_EQ(
-      SPV_SUCCESS,
-      AssemblyContext(AutoText("Wo;rd"), nullptr).getWord(&word, &endPosition));
+  ASSERT_EQ(SPV_SUCCESS,
+            AssemblyContext(input, nullptr).getWord(&word, &endPosition));
   ASSERT_EQ(2u, endPosition.column);
   ASSERT_EQ(0u, endPosition.line);
   ASSERT_EQ(2u, endPosition.index);
-  ASSERT_STREQ("Wo", word.c_str());
+  ASSERT_EQ("Wo", word);
 }
 
 TEST(TextWordGet, NoTerminator) {
   const std::string full_text = "abcdefghijklmn";
   for (size_t len = 1; len <= full_text.size(); ++len) {
-    std::string word;
+    std::string_view word;
     spv_text_t text = {full_text.data(), len};
     spv_position_t endPosition = {};
     ASSERT_EQ(SPV_SUCCESS,
@@ -95,7 +97,7 @@ TEST(TextWordGet, MultipleWords) {
   spv_position_t endPosition = {};
   const char* words[] = {"Words", "in", "a", "sentence"};
 
-  std::string word;
+  std::string_view word;
   for (uint32_t wordIndex = 0; wordIndex < 4; ++wordIndex) {
     ASSERT_EQ(SPV_SUCCESS, data.getWord(&word, &endPosition));
     ASSERT_EQ(strlen(words[wordIndex]),
@@ -103,7 +105,7 @@ TEST(TextWordGet, MultipleWords) {
     ASSERT_EQ(0u, endPosition.line);
     ASSERT_EQ(strlen(words[wordIndex]),
               endPosition.index - data.position().index);
-    ASSERT_STREQ(words[wordIndex], word.c_str());
+    ASSERT_EQ(words[wordIndex], word);
 
     data.setPosition(endPosition);
     if (3 != wordIndex) {
@@ -119,13 +121,13 @@ TEST(TextWordGet, QuotesAreKept) {
   const char* expected[] = {R"("quotes")", R"("around words")"};
   AssemblyContext data(input, nullptr);
 
-  std::string word;
+  std::string_view word;
   spv_position_t endPosition = {};
   ASSERT_EQ(SPV_SUCCESS, data.getWord(&word, &endPosition));
   EXPECT_EQ(8u, endPosition.column);
   EXPECT_EQ(0u, endPosition.line);
   EXPECT_EQ(8u, endPosition.index);
-  EXPECT_STREQ(expected[0], word.c_str());
+  EXPECT_EQ(expected[0], word);
 
   // Move to the next word.
   data.setPosition(endPosition);
@@ -135,7 +137,7 @@ TEST(TextWordGet, QuotesAreKept) {
   EXPECT_EQ(23u, endPosition.column);
   EXPECT_EQ(0u, endPosition.line);
   EXPECT_EQ(23u, endPosition.index);
-  EXPECT_STREQ(expected[1], word.c_str());
+  EXPECT_EQ(expected[1], word);
 }
 
 TEST(TextWordGet, QuotesBetweenWordsActLikeGlue) {
@@ -143,13 +145,13 @@ TEST(TextWordGet, QuotesBetweenWordsActLikeGlue) {
   const char* expected[] = {R"(quotes" "between)", "words"};
   AssemblyContext data(input, nullptr);
 
-  std::string word;
+  std::string_view word;
   spv_position_t endPosition = {};
   ASSERT_EQ(SPV_SUCCESS, data.getWord(&word, &endPosition));
   EXPECT_EQ(16u, endPosition.column);
   EXPECT_EQ(0u, endPosition.line);
   EXPECT_EQ(16u, endPosition.index);
-  EXPECT_STREQ(expected[0], word.c_str());
+  EXPECT_EQ(expected[0], word);
 
   // Move to the next word.
   data.setPosition(endPosition);
@@ -159,13 +161,13 @@ TEST(TextWordGet, QuotesBetweenWordsActLikeGlue) {
   EXPECT_EQ(22u, endPosition.column);
   EXPECT_EQ(0u, endPosition.line);
   EXPECT_EQ(22u, endPosition.index);
-  EXPECT_STREQ(expected[1], word.c_str());
+  EXPECT_EQ(expected[1], word);
 }
 
 TEST(TextWordGet, QuotingWhitespace) {
   AutoText input(QUOTE "white " NEWLINE TAB " space" QUOTE);
   // Whitespace surrounded by quotes acts like glue.
-  std::string word;
+  std::string_view word;
   spv_position_t endPosition = {};
   ASSERT_EQ(SPV_SUCCESS,
             AssemblyContext(input, nullptr).getWord(&word, &endPosition));
@@ -177,43 +179,43 @@ TEST(TextWordGet, QuotingWhitespace) {
 
 TEST(TextWordGet, QuoteAlone) {
   AutoText input(QUOTE);
-  std::string word;
+  std::string_view word;
   spv_position_t endPosition = {};
   ASSERT_EQ(SPV_SUCCESS,
             AssemblyContext(input, nullptr).getWord(&word, &endPosition));
   ASSERT_EQ(1u, endPosition.column);
   ASSERT_EQ(0u, endPosition.line);
   ASSERT_EQ(1u, endPosition.index);
-  ASSERT_STREQ(QUOTE, word.c_str());
+  ASSERT_EQ(QUOTE, word);
 }
 
 TEST(TextWordGet, EscapeAlone) {
   AutoText input(BACKSLASH);
-  std::string word;
+  std::string_view word;
   spv_position_t endPosition = {};
   ASSERT_EQ(SPV_SUCCESS,
             AssemblyContext(input, nullptr).getWord(&word, &endPosition));
   ASSERT_EQ(1u, endPosition.column);
   ASSERT_EQ(0u, endPosition.line);
   ASSERT_EQ(1u, endPosition.index);
-  ASSERT_STREQ(BACKSLASH, word.c_str());
+  ASSERT_EQ(BACKSLASH, word);
 }
 
 TEST(TextWordGet, EscapeAtEndOfInput) {
   AutoText input("word" BACKSLASH);
-  std::string word;
+  std::string_view word;
   spv_position_t endPosition = {};
   ASSERT_EQ(SPV_SUCCESS,
             AssemblyContext(input, nullptr).getWord(&word, &endPosition));
   ASSERT_EQ(5u, endPosition.column);
   ASSERT_EQ(0u, endPosition.line);
   ASSERT_EQ(5u, endPosition.index);
-  ASSERT_STREQ("word" BACKSLASH, word.c_str());
+  ASSERT_EQ("word" BACKSLASH, word);
 }
 
 TEST(TextWordGet, Escaping) {
   AutoText input("w" BACKSLASH QUOTE "o" BACKSLASH NEWLINE "r" BACKSLASH ";d");
-  std::string word;
+  std::string_view word;
   spv_position_t endPosition = {};
   ASSERT_EQ(SPV_SUCCESS,
             AssemblyContext(input, nullptr).getWord(&word, &endPosition));
@@ -225,29 +227,29 @@ TEST(TextWordGet, Escaping) {
 
 TEST(TextWordGet, EscapingEscape) {
   AutoText input("word" BACKSLASH BACKSLASH " abc");
-  std::string word;
+  std::string_view word;
   spv_position_t endPosition = {};
   ASSERT_EQ(SPV_SUCCESS,
             AssemblyContext(input, nullptr).getWord(&word, &endPosition));
   ASSERT_EQ(6u, endPosition.column);
   ASSERT_EQ(0u, endPosition.line);
   ASSERT_EQ(6u, endPosition.index);
-  ASSERT_STREQ("word" BACKSLASH BACKSLASH, word.c_str());
+  ASSERT_EQ("word" BACKSLASH BACKSLASH, word);
 }
 
 TEST(TextWordGet, CRLF) {
   AutoText input("abc\r\nd");
   AssemblyContext data(input, nullptr);
-  std::string word;
+  std::string_view word;
   spv_position_t pos = {};
   ASSERT_EQ(SPV_SUCCESS, data.getWord(&word, &pos));
   EXPECT_EQ(3u, pos.column);
-  EXPECT_STREQ("abc", word.c_str());
+  EXPECT_EQ("abc", word);
   data.setPosition(pos);
   data.advance();
   ASSERT_EQ(SPV_SUCCESS, data.getWord(&word, &pos));
   EXPECT_EQ(1u, pos.column);
-  EXPECT_STREQ("d", word.c_str());
+  EXPECT_EQ("d", word);
 }
 
 }  // namespace
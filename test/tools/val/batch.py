@@ -0,0 +1,179 @@
+# Copyright (c) 2024 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import placeholder
+import expect
+import re
+import tempfile
+
+from spirv_test_framework import inside_spirv_testsuite
+
+
+def empty_main_assembly():
+  return """
+         OpCapability Shader
+         OpMemoryModel Logical GLSL450
+         OpEntryPoint Vertex %4 "main"
+         OpName %4 "main"
+    %2 = OpTypeVoid
+    %3 = OpTypeFunction %2
+    %4 = OpFunction %2 None %3
+    %5 = OpLabel
+         OpReturn
+         OpFunctionEnd"""
+
+
+def missing_terminator_assembly():
+  return """
+         OpCapability Shader
+         OpMemoryModel Logical GLSL450
+         OpEntryPoint Vertex %4 "main"
+         OpName %4 "main"
+    %2 = OpTypeVoid
+    %3 = OpTypeFunction %2
+    %4 = OpFunction %2 None %3
+    %5 = OpLabel
+         OpFunctionEnd"""
+
+
+def summary_line(status, has_messages):
+  """Returns a regular expression matching the summary line of one file."""
+  return (r'\{"file": "[^"]*\.spv", "status": "' + status +
+          r'", "read_ms": [0-9.]+, "validate_ms": [0-9.]+, "messages": \[' +
+          (r'".+"' if has_messages else '') + r'\]\}\n')
+
+
+class FileList(placeholder.PlaceHolder):
+  """Stands for a list of files for --batch, naming the given shaders.
+
+    The list also has a comment and an empty line, which are skipped.
+    """
+
+  def __init__(self, shaders):
+    self.shaders = shaders
+    self.filename = None
+
+  def instantiate_for_spirv_args(self, testcase):
+    lines = ['# The shaders to validate.', '']
+    lines += [
+        shader.instantiate_for_spirv_args(testcase) for shader in self.shaders
+    ]
+    list_fd, self.filename = tempfile.mkstemp(
+        dir=testcase.directory, suffix='.txt')
+    list_file = os.fdopen(list_fd, 'w')
+    list_file.write('\n'.join(lines) + '\n')
+    list_file.close()
+    return '@' + self.filename
+
+  def instantiate_for_expectation(self, testcase):
+    assert self.filename is not None
+    return self.filename
+
+
+@inside_spirv_testsuite('SpirvValBatch')
+class TestBatchListFile(expect.ReturnCodeIsZero, expect.StdoutMatch):
+  """Tests that the files named in a list are validated in order."""
+
+  spirv_args = [
+      '--batch',
+      FileList([
+          placeholder.FileSPIRVShader(empty_main_assembly(), '.spvasm'),
+          placeholder.FileSPIRVShader(empty_main_assembly(), '.spvasm'),
+      ])
+  ]
+  expected_stdout = re.compile('^' + summary_line('valid', False) * 2 + '$')
+
+
+@inside_spirv_testsuite('SpirvValBatch')
+class TestBatchFailsWhenOneFileIsInvalid(expect.ReturnCodeIsNonZero,
+                                         expect.StdoutMatch,
+                                         expect.StderrMatch):
+  """Tests that every file is reported, and the exit code is an error."""
+
+  spirv_args = [
+      '--batch',
+      FileList([placeholder.FileSPIRVShader(empty_main_assembly(), '.spvasm')]),
+      placeholder.FileSPIRVShader(missing_terminator_assembly(), '.spvasm'),
+  ]
+  expected_stdout = re.compile('^' + summary_line('valid', False) +
+                               summary_line('invalid', True) + '$')
+  expected_stderr = re.compile(r'\.spv: error: ')
+
+
+@inside_spirv_testsuite('SpirvValBatch')
+class TestBatchUnreadableFile(expect.ReturnCodeIsNonZero, expect.StdoutMatch):
+  """Tests that a missing file is reported as unreadable."""
+
+  spirv_args = ['--batch', 'does-not-exist.spv']
+  expected_stdout = re.compile(
+      r'^\{"file": "does-not-exist\.spv", "status": "unreadable", '
+      r'"read_ms": [0-9.]+, "validate_ms": [0-9.]+, '
+      r'"messages": \["error: cannot read the file"\]\}\n$')
+
+
+@inside_spirv_testsuite('SpirvValBatch')
+class TestBatchMoreJobsThanFiles(expect.ReturnCodeIsZero, expect.StdoutMatch):
+  """Tests that asking for more threads than files is fine."""
+
+  spirv_args = [
+      '--batch', '--jobs', '64',
+      placeholder.FileSPIRVShader(empty_main_assembly(), '.spvasm')
+  ]
+  expected_stdout = re.compile('^' + summary_line('valid', False) + '$')
+
+
+@inside_spirv_testsuite('SpirvValBatch')
+class TestJobsRequiresBatch(expect.ErrorMessage):
+  """Tests that --jobs is rejected without --batch."""
+
+  spirv_args = [
+      '--jobs', '2',
+      placeholder.FileSPIRVShader(empty_main_assembly(), '.spvasm')
+  ]
+  expected_error = 'error: --jobs is only allowed with --batch\n'
+
+
+@inside_spirv_testsuite('SpirvValBatch')
+class TestJobsRejectsNegativeNumbers(expect.ErrorMessage):
+  """Tests that a negative number of jobs does not wrap around."""
+
+  spirv_args = [
+      '--batch', '--jobs', '-1',
+      placeholder.FileSPIRVShader(empty_main_assembly(), '.spvasm')
+  ]
+  expected_error = 'error: Invalid number of jobs: -1 (expected 1 to 1024)\n'
+
+
+@inside_spirv_testsuite('SpirvValBatch')
+class TestJobsRejectsTrailingCharacters(expect.ErrorMessage):
+  """Tests that the number of jobs must be a whole number."""
+
+  spirv_args = [
+      '--batch', '--jobs', '4x',
+      placeholder.FileSPIRVShader(empty_main_assembly(), '.spvasm')
+  ]
+  expected_error = 'error: Invalid number of jobs: 4x (expected 1 to 1024)\n'
+
+
+@inside_spirv_testsuite('SpirvValBatch')
+class TestJobsRejectsTooManyJobs(expect.ErrorMessage):
+  """Tests that an absurd number of jobs is rejected."""
+
+  spirv_args = [
+      '--batch', '--jobs', '4294967297',
+      placeholder.FileSPIRVShader(empty_main_assembly(), '.spvasm')
+  ]
+  expected_error = ('error: Invalid number of jobs: 4294967297 '
+                    '(expected 1 to 1024)\n')
@@ -22,6 +22,14 @@ namespace {
 
 using BitUtilsTest = ::testing::Test;
 
+TEST(BitUtilsTest, CountTrailingZeros) {
+  EXPECT_EQ(0u, CountTrailingZeros(1u));
+  EXPECT_EQ(0u, CountTrailingZeros(0xFFFFFFFFu));
+  EXPECT_EQ(3u, CountTrailingZeros(0x8u));
+  EXPECT_EQ(3u, CountTrailingZeros(0x18u));
+  EXPECT_EQ(31u, CountTrailingZeros(0x80000000u));
+}
+
 TEST(BitUtilsTest, MutateBitsWholeWord) {
   const uint32_t zero_u32 = 0;
   const uint32_t max_u32 = ~0;
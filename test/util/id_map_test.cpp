@@ -0,0 +1,210 @@
+// Copyright (c) 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "source/util/id_map.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+// Returns the entries of |map|, in iteration order.
+template <typename T>
+std::vector<std::pair<uint32_t, T>> Entries(const IdMap<T>& map) {
+  std::vector<std::pair<uint32_t, T>> entries;
+  for (const auto& entry : map) entries.emplace_back(entry.first, entry.second);
+  return entries;
+}
+
+TEST(IdMapTest, Empty) {
+  IdMap<int> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(0u, map.size());
+  EXPECT_EQ(0u, map.count(1));
+  EXPECT_TRUE(map.find(1) == map.end());
+  EXPECT_TRUE(map.begin() == map.end());
+}
+
+TEST(IdMapTest, SubscriptMapsDefaultValue) {
+  IdMap<int> map;
+  EXPECT_EQ(0, map[5]);
+  EXPECT_EQ(1u, map.size());
+  EXPECT_EQ(1u, map.count(5));
+  map[5] = 7;
+  EXPECT_EQ(7, map[5]);
+  EXPECT_EQ(1u, map.size());
+}
+
+TEST(IdMapTest, EmplaceKeepsExistingValue) {
+  IdMap<std::string> map;
+  auto first = map.emplace(3, "a");
+  EXPECT_TRUE(first.second);
+  EXPECT_EQ(3u, first.first->first);
+  EXPECT_EQ("a", first.first->second);
+
+  auto second = map.insert({3, "b"});
+  EXPECT_FALSE(second.second);
+  EXPECT_EQ("a", second.first->second);
+  EXPECT_EQ(1u, map.size());
+}
+
+TEST(IdMapTest, FindMappedId) {
+  IdMap<int> map;
+  map[1000] = 4;
+  const IdMap<int>& const_map = map;
+  auto where = const_map.find(1000);
+  ASSERT_TRUE(where != const_map.end());
+  EXPECT_EQ(1000u, where->first);
+  EXPECT_EQ(4, where->second);
+  EXPECT_TRUE(const_map.find(999) == const_map.end());
+  EXPECT_TRUE(const_map.find(1u << 30) == const_map.end());
+}
+
+TEST(IdMapTest, IteratesInIdOrder) {
+  IdMap<int> map;
+  map[700] = 3;
+  map[2] = 1;
+  map[5000] = 4;
+  map[3] = 2;
+  EXPECT_THAT(Entries(map),
+              ElementsAre(Pair(2, 1), Pair(3, 2), Pair(700, 3), Pair(5000, 4)));
+}
+
+TEST(IdMapTest, EraseUnmapsAndResetsValue) {
+  IdMap<int> map;
+  map[1] = 1;
+  map[2] = 2;
+  EXPECT_EQ(1u, map.erase(1));
+  EXPECT_EQ(0u, map.erase(1));
+  EXPECT_EQ(0u, map.erase(12345));
+  EXPECT_EQ(1u, map.size());
+  EXPECT_EQ(0u, map.count(1));
+  EXPECT_EQ(0, map[1]);
+}
+
+TEST(IdMapTest, EraseIterator) {
+  IdMap<int> map;
+  for (uint32_t id = 0; id < 1000; id += 3) map[id] = 1;
+  for (auto where = map.begin(); where != map.end();) {
+    where = where->first % 2 ? map.erase(where) : std::next(where);
+  }
+  for (const auto& entry : map) EXPECT_EQ(0u, entry.first % 2);
+  EXPECT_EQ(167u, map.size());
+}
+
+TEST(IdMapTest, ValuesDoNotMoveWhenMapGrows) {
+  IdMap<int> map;
+  int* value = &map[1];
+  for (uint32_t id = 2; id < 100000; id += 7) map[id] = 1;
+  EXPECT_EQ(value, &map[1]);
+}
+
+TEST(IdMapTest, LargeIds) {
+  IdMap<int> map;
+  map[0x3FFFFF] = 1;
+  map[0] = 2;
+  EXPECT_THAT(Entries(map), ElementsAre(Pair(0, 2), Pair(0x3FFFFF, 1)));
+}
+
+TEST(IdMapTest, Copy) {
+  IdMap<std::vector<int>> map;
+  map[4].push_back(1);
+  map[400].push_back(2);
+  IdMap<std::vector<int>> copy = map;
+  map[4].push_back(3);
+  EXPECT_EQ(std::vector<int>{1}, copy[4]);
+  EXPECT_EQ(std::vector<int>{2}, copy[400]);
+  EXPECT_EQ(2u, copy.size());
+}
+
+TEST(IdMapTest, At) {
+  IdMap<int> map;
+  map[300] = 1;
+  map.at(300) = 2;
+  const IdMap<int>& const_map = map;
+  EXPECT_EQ(2, const_map.at(300));
+  EXPECT_EQ(1u, map.size());
+}
+
+TEST(IdMapTest, Equality) {
+  IdMap<int> lhs;
+  IdMap<int> rhs;
+  EXPECT_EQ(lhs, rhs);
+  lhs[3] = 1;
+  lhs[700] = 2;
+  EXPECT_NE(lhs, rhs);
+  rhs[700] = 2;
+  rhs[3] = 1;
+  EXPECT_EQ(lhs, rhs);
+  rhs[700] = 3;
+  EXPECT_NE(lhs, rhs);
+  // An erased id leaves an allocated page, which does not matter.
+  rhs.erase(700);
+  rhs[5] = 2;
+  rhs.erase(5);
+  lhs.erase(700);
+  EXPECT_EQ(lhs, rhs);
+}
+
+TEST(IdMapTest, Clear) {
+  IdMap<int> map;
+  map[4] = 1;
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(map.begin() == map.end());
+  EXPECT_EQ(0, map[4]);
+}
+
+TEST(IdMapTest, AtAbortsOnUnmappedIds) {
+  IdMap<int> map;
+  map[3] = 1;
+  const IdMap<int>& const_map = map;
+  EXPECT_EQ(1, map.at(3));
+  EXPECT_DEATH(map.at(4), "id 4 is not mapped");
+  EXPECT_DEATH(const_map.at(5000), "id 5000 is not mapped");
+  map.erase(3);
+  EXPECT_DEATH(map.at(3), "id 3 is not mapped");
+}
+
+TEST(IdMapTest, MatchesStdMap) {
+  IdMap<uint32_t> map;
+  std::map<uint32_t, uint32_t> expected;
+  uint32_t seed = 1;
+  for (uint32_t i = 0; i < 10000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    const uint32_t id = (seed >> 8) % 3000;
+    if (seed % 3) {
+      map[id] = i;
+      expected[id] = i;
+    } else {
+      EXPECT_EQ(expected.erase(id), map.erase(id));
+    }
+  }
+  const std::vector<std::pair<uint32_t, uint32_t>> expected_entries(
+      expected.begin(), expected.end());
+  EXPECT_EQ(expected.size(), map.size());
+  EXPECT_EQ(expected_entries, Entries(map));
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
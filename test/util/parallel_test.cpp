@@ -0,0 +1,84 @@
+// Copyright (c) 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "source/util/parallel.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+TEST(ParallelTest, HardwareThreadCountIsPositive) {
+  EXPECT_GE(HardwareThreadCount(), 1u);
+}
+
+TEST(ParallelTest, CallsEachIndexOnce) {
+  for (const uint32_t num_threads : {0u, 1u, 2u, 8u, 100u}) {
+    std::vector<std::atomic<int>> calls(1000);
+    ParallelFor(calls.size(), num_threads, [&calls](size_t i) { ++calls[i]; });
+    for (const auto& count : calls) EXPECT_EQ(1, count.load()) << num_threads;
+  }
+}
+
+TEST(ParallelTest, NoIndices) {
+  int calls = 0;
+  ParallelFor(0, 4, [&calls](size_t) { ++calls; });
+  EXPECT_EQ(0, calls);
+}
+
+TEST(ParallelTest, WritesAreVisibleAfterwards) {
+  std::vector<size_t> squares(257);
+  ParallelFor(squares.size(), 4, [&squares](size_t i) { squares[i] = i * i; });
+  for (size_t i = 0; i < squares.size(); ++i) EXPECT_EQ(i * i, squares[i]);
+}
+
+TEST(ParallelTest, ThreadIndicesAreInRange) {
+  for (const uint32_t num_threads : {0u, 1u, 3u, 8u}) {
+    std::vector<uint32_t> thread_of(500);
+    ParallelForWithThreadIndex(thread_of.size(), num_threads,
+                               [&thread_of](uint32_t thread, size_t i) {
+                                 thread_of[i] = thread;
+                               });
+    for (const auto thread : thread_of) {
+      EXPECT_LT(thread, std::max(1u, num_threads)) << num_threads;
+    }
+  }
+}
+
+TEST(ParallelTest, ThreadIndexIsNotShared) {
+  // Each thread index owns one slot, which is only ever touched by the calls
+  // with that index.
+  const uint32_t num_threads = 4;
+  std::vector<int> busy(num_threads);
+  std::vector<size_t> calls(num_threads);
+  std::atomic<int> overlaps(0);
+  ParallelForWithThreadIndex(
+      2000, num_threads, [&busy, &calls, &overlaps](uint32_t thread, size_t) {
+        if (busy[thread]++) ++overlaps;
+        ++calls[thread];
+        --busy[thread];
+      });
+  EXPECT_EQ(0, overlaps.load());
+  size_t total = 0;
+  for (const auto count : calls) total += count;
+  EXPECT_EQ(2000u, total);
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
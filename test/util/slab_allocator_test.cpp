@@ -0,0 +1,152 @@
+// Copyright (c) 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "source/util/slab_allocator.h"
+#include "source/util/small_vector.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+bool IsAligned(const void* block) {
+  return reinterpret_cast<uintptr_t>(block) % alignof(std::max_align_t) == 0;
+}
+
+TEST(SlabAllocatorTest, BlocksAreDistinctAndAligned) {
+  SlabAllocator* allocator = SlabAllocator::Create();
+  std::vector<void*> blocks;
+  for (size_t size = 1; size < 200; size += 7) {
+    void* block = SlabAllocator::Allocate(allocator, size);
+    EXPECT_TRUE(IsAligned(block)) << size;
+    memset(block, static_cast<int>(size), size);
+    blocks.push_back(block);
+  }
+  EXPECT_EQ(blocks.size(), allocator->num_allocated());
+  size_t size = 1;
+  for (void* block : blocks) {
+    const auto* bytes = static_cast<const unsigned char*>(block);
+    for (size_t i = 0; i < size; ++i) ASSERT_EQ(size & 0xFF, bytes[i]);
+    size += 7;
+  }
+  for (void* block : blocks) SlabAllocator::Free(block);
+  EXPECT_EQ(0u, allocator->num_allocated());
+  allocator->Release();
+}
+
+TEST(SlabAllocatorTest, FreedBlocksAreReused) {
+  SlabAllocator* allocator = SlabAllocator::Create();
+  void* first = SlabAllocator::Allocate(allocator, 100);
+  SlabAllocator::Free(first);
+  EXPECT_EQ(first, SlabAllocator::Allocate(allocator, 100));
+  // A block of another size class does not reuse it.
+  void* other = SlabAllocator::Allocate(allocator, 10);
+  EXPECT_NE(first, other);
+  SlabAllocator::Free(other);
+  SlabAllocator::Free(first);
+  allocator->Release();
+}
+
+TEST(SlabAllocatorTest, ManyBlocksUseFewSlabs) {
+  SlabAllocator* allocator = SlabAllocator::Create();
+  std::vector<void*> blocks;
+  for (int i = 0; i < 10000; ++i) {
+    blocks.push_back(SlabAllocator::Allocate(allocator, 100));
+  }
+  const size_t num_slabs = allocator->num_slabs();
+  EXPECT_LE(num_slabs, 10000 * 128 / SlabAllocator::kSlabSize + 1);
+  for (void* block : blocks) SlabAllocator::Free(block);
+  for (int i = 0; i < 10000; ++i) {
+    blocks[i] = SlabAllocator::Allocate(allocator, 100);
+  }
+  EXPECT_EQ(num_slabs, allocator->num_slabs());
+  for (void* block : blocks) SlabAllocator::Free(block);
+  allocator->Release();
+}
+
+TEST(SlabAllocatorTest, LargeBlocksComeFromTheHeap) {
+  SlabAllocator* allocator = SlabAllocator::Create();
+  void* block =
+      SlabAllocator::Allocate(allocator, SlabAllocator::kMaxBlockSize);
+  EXPECT_TRUE(IsAligned(block));
+  EXPECT_EQ(0u, allocator->num_allocated());
+  EXPECT_EQ(0u, allocator->num_slabs());
+  memset(block, 0, SlabAllocator::kMaxBlockSize);
+  SlabAllocator::Free(block);
+  allocator->Release();
+}
+
+TEST(SlabAllocatorTest, NoAllocator) {
+  void* block = SlabAllocator::Allocate(nullptr, 24);
+  EXPECT_TRUE(IsAligned(block));
+  SlabAllocator::Free(block);
+  SlabAllocator::Free(nullptr);
+}
+
+TEST(SlabAllocatorTest, BlocksOutliveTheOwner) {
+  SlabAllocator* allocator = SlabAllocator::Create();
+  void* block = SlabAllocator::Allocate(allocator, 64);
+  allocator->Release();
+  // The allocator is still alive, since |block| is in use.
+  memset(block, 0, 64);
+  EXPECT_EQ(1u, allocator->num_allocated());
+  SlabAllocator::Free(block);
+}
+
+TEST(SlabStlAllocatorTest, VectorComesFromTheSlabs) {
+  SlabAllocator* allocator = SlabAllocator::Create();
+  {
+    std::vector<uint32_t, SlabStlAllocator<uint32_t>> vec(
+        {1, 2, 3}, SlabStlAllocator<uint32_t>(allocator));
+    EXPECT_EQ(1u, allocator->num_allocated());
+    vec.push_back(4);
+    EXPECT_EQ(1u, allocator->num_allocated());
+    EXPECT_THAT(vec, testing::ElementsAre(1, 2, 3, 4));
+
+    // Copies come from the heap.
+    std::vector<uint32_t, SlabStlAllocator<uint32_t>> copy(vec);
+    EXPECT_EQ(nullptr, copy.get_allocator().slabs());
+    EXPECT_EQ(1u, allocator->num_allocated());
+  }
+  EXPECT_EQ(0u, allocator->num_allocated());
+  allocator->Release();
+}
+
+TEST(SlabStlAllocatorTest, ElementsUseTheAllocator) {
+  using Words = SmallVector<uint32_t, 2, SlabStlAllocator<uint32_t>>;
+  SlabAllocator* allocator = SlabAllocator::Create();
+  {
+    const SlabStlAllocator<Words> slabs(allocator);
+    std::vector<Words, SlabStlAllocator<Words>> vec(slabs);
+    vec.reserve(2);
+    vec.push_back(Words{1});
+    EXPECT_EQ(1u, allocator->num_allocated());
+    // The vector holding the words that spill, and the words themselves.
+    const std::vector<uint32_t> words = {1, 2, 3};
+    vec.emplace_back(words.begin(), words.end());
+    EXPECT_EQ(3u, allocator->num_allocated());
+    EXPECT_EQ(allocator, vec.back().get_allocator().slabs());
+    EXPECT_TRUE(vec.back() == words);
+  }
+  EXPECT_EQ(0u, allocator->num_allocated());
+  allocator->Release();
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
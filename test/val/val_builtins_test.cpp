@@ -3387,6 +3387,81 @@ OpFunctionEnd
               HasSubstr("called with execution model Fragment"));
 }
 
+// Returns a generator for a module whose |num_entry_points| Vertex entry
+// points all write Position through the same chain of helper functions.  If
+// |fragment_entry_point|, one more Fragment entry point calls the chain.
+CodeGenerator GetSharedPositionWriterGenerator(int num_entry_points,
+                                               bool fragment_entry_point) {
+  CodeGenerator generator = CodeGenerator::GetDefaultShaderCodeGenerator();
+  generator.before_types_ = R"(
+OpDecorate %output_type Block
+OpMemberDecorate %output_type 0 BuiltIn Position
+)";
+
+  generator.after_types_ = R"(
+%output_type = OpTypeStruct %f32vec4
+%output_ptr = OpTypePointer Output %output_type
+%output = OpVariable %output_ptr Output
+%output_f32vec4_ptr = OpTypePointer Output %f32vec4
+)";
+
+  for (int i = 0; i < num_entry_points; ++i) {
+    EntryPoint entry_point;
+    entry_point.name = "vmain" + std::to_string(i);
+    entry_point.execution_model = "Vertex";
+    entry_point.interfaces = "%output";
+    entry_point.body = "%vcall" + std::to_string(i) +
+                       " = OpFunctionCall %void %outer\n";
+    generator.entry_points_.push_back(std::move(entry_point));
+  }
+  if (fragment_entry_point) {
+    EntryPoint entry_point;
+    entry_point.name = "fmain";
+    entry_point.execution_model = "Fragment";
+    entry_point.interfaces = "%output";
+    entry_point.execution_modes = "OpExecutionMode %fmain OriginUpperLeft";
+    entry_point.body = "%fcall = OpFunctionCall %void %outer\n";
+    generator.entry_points_.push_back(std::move(entry_point));
+  }
+
+  generator.add_at_the_end_ = R"(
+%outer = OpFunction %void None %func
+%outer_entry = OpLabel
+%inner_call = OpFunctionCall %void %inner
+%outer_position = OpAccessChain %output_f32vec4_ptr %output %u32_0
+OpStore %outer_position %f32vec4_0123
+OpReturn
+OpFunctionEnd
+%inner = OpFunction %void None %func
+%inner_entry = OpLabel
+%inner_position = OpAccessChain %output_f32vec4_ptr %output %u32_0
+OpStore %inner_position %f32vec4_0123
+OpReturn
+OpFunctionEnd
+)";
+  return generator;
+}
+
+TEST_F(ValidateBuiltIns, PositionSharedByManyEntryPoints) {
+  CompileSuccessfully(GetSharedPositionWriterGenerator(100, false).Build(),
+                      SPV_ENV_VULKAN_1_0);
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions(SPV_ENV_VULKAN_1_0));
+}
+
+TEST_F(ValidateBuiltIns, PositionSharedByManyEntryPointsAndFragment) {
+  CompileSuccessfully(GetSharedPositionWriterGenerator(100, true).Build(),
+                      SPV_ENV_VULKAN_1_0);
+  ASSERT_EQ(SPV_ERROR_INVALID_DATA, ValidateInstructions(SPV_ENV_VULKAN_1_0));
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("Vulkan spec allows BuiltIn Position to be used only "
+                        "with Vertex, TessellationControl, "
+                        "TessellationEvaluation or Geometry execution models"));
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("called with execution model Fragment"));
+  // The first reference in module order is reported.
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("%outer_position"));
+}
+
 CodeGenerator GetNoDepthReplacingGenerator() {
   CodeGenerator generator = CodeGenerator::GetDefaultShaderCodeGenerator();
 
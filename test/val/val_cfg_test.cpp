@@ -5118,6 +5118,61 @@ OpFunctionEnd
   EXPECT_EQ(SPV_SUCCESS, ValidateInstructions());
 }
 
+// Returns a module whose entry point has |depth| nested selections.  Each
+// selection header defines an id.  The innermost block uses the id defined
+// by the first header, and also the id of the innermost header in the
+// outermost merge block if |use_after_merge| holds.
+std::string GenerateNestedSelections(int depth, bool use_after_merge) {
+  std::ostringstream text;
+  text << R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%bool = OpTypeBool
+%cond = OpUndef %bool
+%uint = OpTypeInt 32 0
+%uint_1 = OpConstant %uint 1
+%void_fn = OpTypeFunction %void
+%main = OpFunction %void None %void_fn
+)";
+  for (int i = 0; i < depth; ++i) {
+    text << "%header" << i << " = OpLabel\n"
+         << "%def" << i << " = OpIAdd %uint %uint_1 %uint_1\n"
+         << "OpSelectionMerge %merge" << i << " None\n"
+         << "OpBranchConditional %cond %header" << i + 1 << " %merge" << i
+         << "\n";
+  }
+  text << "%header" << depth << " = OpLabel\n"
+       << "%use = OpIAdd %uint %def0 %uint_1\n"
+       << "OpBranch %merge" << depth - 1 << "\n";
+  for (int i = depth - 1; i > 0; --i) {
+    text << "%merge" << i << " = OpLabel\n"
+         << "OpBranch %merge" << i - 1 << "\n";
+  }
+  text << "%merge0 = OpLabel\n";
+  if (use_after_merge) {
+    text << "%bad_use = OpIAdd %uint %def" << depth - 1 << " %uint_1\n";
+  }
+  text << "OpReturn\nOpFunctionEnd\n";
+  return text.str();
+}
+
+TEST_F(ValidateCFG, DeeplyNestedSelectionsGood) {
+  CompileSuccessfully(GenerateNestedSelections(500, false));
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions());
+}
+
+TEST_F(ValidateCFG, DeeplyNestedSelectionsDefinitionDoesNotDominateUse) {
+  CompileSuccessfully(GenerateNestedSelections(500, true));
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("[%def499] defined in block"));
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("does not dominate its use in block"));
+}
+
 }  // namespace
 }  // namespace val
 }  // namespace spvtools
@@ -14,6 +14,7 @@
 
 // Validation tests for decorations
 
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -63,8 +64,8 @@ TEST_F(ValidateDecorations, ValidateOpDecorateRegistration) {
   // Must have 2 decorations.
   EXPECT_THAT(
       vstate_->id_decorations(id),
-      Eq(std::set<Decoration>{Decoration(spv::Decoration::Location, {4}),
-                              Decoration(spv::Decoration::Centroid)}));
+      Eq(std::vector<Decoration>{Decoration(spv::Decoration::Centroid),
+                                 Decoration(spv::Decoration::Location, {4})}));
 }
 
 TEST_F(ValidateDecorations, ValidateOpMemberDecorateRegistration) {
@@ -87,17 +88,18 @@ TEST_F(ValidateDecorations, ValidateOpMemberDecorateRegistration) {
 
   // The array must have 1 decoration.
   const uint32_t arr_id = 1;
-  EXPECT_THAT(
-      vstate_->id_decorations(arr_id),
-      Eq(std::set<Decoration>{Decoration(spv::Decoration::ArrayStride, {4})}));
+  EXPECT_THAT(vstate_->id_decorations(arr_id),
+              Eq(std::vector<Decoration>{
+                  Decoration(spv::Decoration::ArrayStride, {4})}));
 
   // The struct must have 3 decorations.
   const uint32_t struct_id = 2;
   EXPECT_THAT(
       vstate_->id_decorations(struct_id),
-      Eq(std::set<Decoration>{Decoration(spv::Decoration::NonReadable, {}, 2),
-                              Decoration(spv::Decoration::Offset, {2}, 2),
-                              Decoration(spv::Decoration::BufferBlock)}));
+      Eq(std::vector<Decoration>{
+          Decoration(spv::Decoration::BufferBlock),
+          Decoration(spv::Decoration::NonReadable, {}, 2),
+          Decoration(spv::Decoration::Offset, {2}, 2)}));
 }
 
 TEST_F(ValidateDecorations, ValidateOpMemberDecorateOutOfBound) {
@@ -152,9 +154,9 @@ TEST_F(ValidateDecorations, ValidateGroupDecorateRegistration) {
 
   // Decoration group has 3 decorations.
   auto expected_decorations =
-      std::set<Decoration>{Decoration(spv::Decoration::DescriptorSet, {0}),
-                           Decoration(spv::Decoration::RelaxedPrecision),
-                           Decoration(spv::Decoration::Restrict)};
+      std::vector<Decoration>{Decoration(spv::Decoration::RelaxedPrecision),
+                              Decoration(spv::Decoration::Restrict),
+                              Decoration(spv::Decoration::DescriptorSet, {0})};
 
   // Decoration group is applied to id 1, 2, 3, and 4. Note that id 1 (which is
   // the decoration group id) also has all the decorations.
@@ -182,7 +184,7 @@ TEST_F(ValidateDecorations, ValidateGroupMemberDecorateRegistration) {
   EXPECT_EQ(SPV_SUCCESS, ValidateAndRetrieveValidationState());
   // Decoration group has 1 decoration.
   auto expected_decorations =
-      std::set<Decoration>{Decoration(spv::Decoration::Offset, {3}, 3)};
+      std::vector<Decoration>{Decoration(spv::Decoration::Offset, {3}, 3)};
 
   // Decoration group is applied to id 2, 3, and 4.
   EXPECT_THAT(vstate_->id_decorations(2), Eq(expected_decorations));
@@ -9362,6 +9364,69 @@ OpFunctionEnd
   EXPECT_EQ(SPV_SUCCESS, ValidateInstructions(SPV_ENV_VULKAN_1_3));
 }
 
+// Returns a module that converts an address to a PhysicalStorageBuffer
+// pointer to an array of structs, each holding a matrix with the given
+// MatrixStride.
+std::string GeneratePhysicalStorageBufferMatrixArray(uint32_t matrix_stride) {
+  return R"(
+OpCapability Shader
+OpCapability Int64
+OpCapability PhysicalStorageBufferAddresses
+OpMemoryModel PhysicalStorageBuffer64 GLSL450
+OpEntryPoint GLCompute %main "main" %pc
+OpExecutionMode %main LocalSize 1 1 1
+OpDecorate %pc_block Block
+OpMemberDecorate %pc_block 0 Offset 0
+OpDecorate %array ArrayStride 64
+OpMemberDecorate %struct 0 Offset 0
+OpMemberDecorate %struct 0 ColMajor
+OpMemberDecorate %struct 0 MatrixStride )" +
+         std::to_string(matrix_stride) + R"(
+%void = OpTypeVoid
+%long = OpTypeInt 64 0
+%float = OpTypeFloat 32
+%v4float = OpTypeVector %float 4
+%mat4v4float = OpTypeMatrix %v4float 4
+%int = OpTypeInt 32 0
+%int_0 = OpConstant %int 0
+%int_4 = OpConstant %int 4
+%pc_block = OpTypeStruct %long
+%pc_block_ptr = OpTypePointer PushConstant %pc_block
+%pc_long_ptr = OpTypePointer PushConstant %long
+%pc = OpVariable %pc_block_ptr PushConstant
+%struct = OpTypeStruct %mat4v4float
+%array = OpTypeArray %struct %int_4
+%array_ptr = OpTypePointer PhysicalStorageBuffer %array
+%void_fn = OpTypeFunction %void
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+%pc_gep = OpAccessChain %pc_long_ptr %pc %int_0
+%addr = OpLoad %long %pc_gep
+%ptr = OpConvertUToPtr %array_ptr %addr
+OpReturn
+OpFunctionEnd
+)";
+}
+
+TEST_F(ValidateDecorations,
+       PhysicalStorageBufferArrayOfStructsMatrixStrideGood) {
+  CompileSuccessfully(GeneratePhysicalStorageBufferMatrixArray(16),
+                      SPV_ENV_VULKAN_1_3);
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions(SPV_ENV_VULKAN_1_3));
+}
+
+// The member decorations of a struct below a top-level array used to be
+// ignored, so that the matrix was laid out with a stride of 0.
+TEST_F(ValidateDecorations,
+       PhysicalStorageBufferArrayOfStructsMatrixStrideBad) {
+  CompileSuccessfully(GeneratePhysicalStorageBufferMatrixArray(8),
+                      SPV_ENV_VULKAN_1_3);
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions(SPV_ENV_VULKAN_1_3));
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("member 0 is a matrix with stride 8 not satisfying "
+                        "alignment to 16"));
+}
+
 TEST_F(ValidateDecorations, UntypedVariableDuplicateInterface) {
   const std::string spirv = R"(
 OpCapability Shader
@@ -10364,6 +10429,125 @@ OpFunctionEnd
               HasSubstr("member 0 is missing an Offset decoration"));
 }
 
+// Returns a module with |num_variables| BufferBlock variables, then
+// |num_variables| Block variables, all in the Uniform storage class.  Both
+// blocks hold a chain of |depth| nested structs, whose innermost struct
+// holds an array of floats with the given stride.
+std::string GenerateNestedBlocks(uint32_t depth, uint32_t num_variables,
+                                 uint32_t array_stride) {
+  std::ostringstream decorations;
+  std::ostringstream types;
+  decorations << "OpDecorate %block Block\n"
+              << "OpDecorate %buffer_block BufferBlock\n"
+              << "OpMemberDecorate %block 0 Offset 0\n"
+              << "OpMemberDecorate %buffer_block 0 Offset 0\n"
+              << "OpDecorate %array ArrayStride " << array_stride << "\n"
+              << "OpMemberDecorate %s0 0 Offset 0\n"
+              << "OpMemberDecorate %s0 1 Offset 16\n";
+  types << "%s0 = OpTypeStruct %v4float %array\n";
+  uint32_t size = 16 + 3 * array_stride + 4;
+  for (uint32_t i = 1; i < depth; ++i) {
+    const uint32_t float_offset = 16 + (size + 15) / 16 * 16;
+    decorations << "OpMemberDecorate %s" << i << " 0 Offset 0\n"
+                << "OpMemberDecorate %s" << i << " 1 Offset 16\n"
+                << "OpMemberDecorate %s" << i << " 2 Offset " << float_offset
+                << "\n";
+    types << "%s" << i << " = OpTypeStruct %v4float %s" << i - 1
+          << " %float\n";
+    size = float_offset + 4;
+  }
+  types << "%block = OpTypeStruct %s" << depth - 1 << "\n"
+        << "%buffer_block = OpTypeStruct %s" << depth - 1 << "\n"
+        << "%ptr_block = OpTypePointer Uniform %block\n"
+        << "%ptr_buffer_block = OpTypePointer Uniform %buffer_block\n";
+  for (uint32_t i = 0; i < num_variables; ++i) {
+    types << "%buffer_var" << i << " = OpVariable %ptr_buffer_block Uniform\n";
+  }
+  for (uint32_t i = 0; i < num_variables; ++i) {
+    types << "%var" << i << " = OpVariable %ptr_block Uniform\n";
+  }
+
+  return R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+)" + decorations.str() +
+         R"(
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%float = OpTypeFloat 32
+%v4float = OpTypeVector %float 4
+%uint = OpTypeInt 32 0
+%uint_4 = OpConstant %uint 4
+%array = OpTypeArray %float %uint_4
+)" + types.str() +
+         R"(
+%main = OpFunction %void None %fn
+%entry = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+}
+
+TEST_F(ValidateDecorations, DeeplyNestedBlocksGood) {
+  CompileSuccessfully(GenerateNestedBlocks(64, 256, 16), SPV_ENV_VULKAN_1_0);
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions(SPV_ENV_VULKAN_1_0))
+      << getDiagnosticString();
+}
+
+TEST_F(ValidateDecorations, DeeplyNestedBlocksCheckedUnderEachRule) {
+  // The stride is fine for the BufferBlock variables, which are checked
+  // first, but not for the Block variables.
+  CompileSuccessfully(GenerateNestedBlocks(64, 256, 4), SPV_ENV_VULKAN_1_0);
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions(SPV_ENV_VULKAN_1_0));
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("decorated as Block for variable in Uniform storage "
+                        "class must follow standard uniform buffer layout "
+                        "rules: member 1 contains an array with stride 4 not "
+                        "satisfying alignment to 16"));
+}
+
+TEST_F(ValidateDecorations, SharedStructCheckedAtEachOffset) {
+  // %inner is fine at offset 0, but its vector straddles a 16-byte boundary
+  // at offset 8.
+  const std::string spirv = R"(
+OpCapability Shader
+OpExtension "SPV_KHR_storage_buffer_storage_class"
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+OpMemberDecorate %inner 0 Offset 0
+OpMemberDecorate %inner 1 Offset 4
+OpDecorate %first Block
+OpMemberDecorate %first 0 Offset 0
+OpDecorate %second Block
+OpMemberDecorate %second 0 Offset 0
+OpMemberDecorate %second 1 Offset 8
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%float = OpTypeFloat 32
+%v2float = OpTypeVector %float 2
+%inner = OpTypeStruct %float %v2float
+%first = OpTypeStruct %inner
+%second = OpTypeStruct %float %inner
+%ptr_first = OpTypePointer StorageBuffer %first
+%ptr_second = OpTypePointer StorageBuffer %second
+%first_var = OpVariable %ptr_first StorageBuffer
+%second_var = OpVariable %ptr_second StorageBuffer
+%main = OpFunction %void None %fn
+%entry = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+  CompileSuccessfully(spirv, SPV_ENV_VULKAN_1_0);
+  spvValidatorOptionsSetRelaxBlockLayout(getValidatorOptions(), true);
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions(SPV_ENV_VULKAN_1_0));
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("member 1 is an improperly straddling vector at "
+                        "offset 12"));
+}
+
 }  // namespace
 }  // namespace val
 }  // namespace spvtools
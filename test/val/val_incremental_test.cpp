@@ -0,0 +1,196 @@
+// Copyright (c) 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Validation tests for validating a sequence of similar modules.
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "source/val/validate.h"
+#include "spirv-tools/libspirv.hpp"
+
+namespace spvtools {
+namespace val {
+namespace {
+
+using ::testing::HasSubstr;
+
+const spv_target_env kEnv = SPV_ENV_UNIVERSAL_1_3;
+
+// Returns a module with the given number of functions, which the entry point
+// calls.  The functions whose indices are in |bad_opcodes| have an
+// instruction with a wrong result type.  The functions whose indices are in
+// |bad_dominance| use an id whose definition does not dominate the use.  The
+// functions whose indices are in |changed| compute one more value.  If
+// |with_parameter| holds, the first function takes a parameter that the
+// entry point does not pass.
+std::string MakeModule(int num_functions, const std::set<int>& bad_opcodes,
+                       const std::set<int>& bad_dominance,
+                       const std::set<int>& changed,
+                       bool with_parameter = false) {
+  std::ostringstream module;
+  module << R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%bool = OpTypeBool
+%true = OpConstantTrue %bool
+%uint = OpTypeInt 32 0
+%uint_1 = OpConstant %uint 1
+%float = OpTypeFloat 32
+%fn_uint = OpTypeFunction %void %uint
+%main = OpFunction %void None %fn
+%main_entry = OpLabel
+)";
+  for (int i = 0; i < num_functions; ++i) {
+    module << "%call" << i << " = OpFunctionCall %void %f" << i << "\n";
+  }
+  module << "OpReturn\nOpFunctionEnd\n";
+  for (int i = 0; i < num_functions; ++i) {
+    if (with_parameter && i == 0) {
+      module << "%f0 = OpFunction %void None %fn_uint\n"
+             << "%param = OpFunctionParameter %uint\n";
+    } else {
+      module << "%f" << i << " = OpFunction %void None %fn\n";
+    }
+    module << "%entry" << i << " = OpLabel\n"
+           << "OpSelectionMerge %merge" << i << " None\n"
+           << "OpBranchConditional %true %then" << i << " %merge" << i << "\n"
+           << "%then" << i << " = OpLabel\n"
+           << "%def" << i << " = OpIAdd %uint %uint_1 %uint_1\n"
+           << "OpBranch %merge" << i << "\n"
+           << "%merge" << i << " = OpLabel\n";
+    if (changed.count(i)) {
+      module << "%extra" << i << " = OpIMul %uint %uint_1 %uint_1\n";
+    }
+    if (bad_dominance.count(i)) {
+      module << "%use" << i << " = OpIAdd %uint %def" << i << " %uint_1\n";
+    }
+    if (bad_opcodes.count(i)) {
+      module << "%bad" << i << " = OpIAdd %float %uint_1 %uint_1\n";
+    }
+    module << "OpReturn\nOpFunctionEnd\n";
+  }
+  return module.str();
+}
+
+class ValidateIncremental : public ::testing::Test {
+ protected:
+  ValidateIncremental() : tools_(kEnv), validator_(kEnv, nullptr) {
+    validator_.SetMessageConsumer(
+        [this](spv_message_level_t, const char*, const spv_position_t&,
+               const char* message) { incremental_messages_ += message; });
+    tools_.SetMessageConsumer(
+        [this](spv_message_level_t, const char*, const spv_position_t&,
+               const char* message) { full_messages_ += message; });
+  }
+
+  // Validates the given module with the incremental validator, and on its
+  // own.  Expects the same verdict and messages both times, and returns the
+  // verdict.
+  bool ValidateBothWays(const std::string& module) {
+    std::vector<uint32_t> binary;
+    EXPECT_TRUE(tools_.Assemble(module, &binary));
+    incremental_messages_.clear();
+    full_messages_.clear();
+    spv_validator_options options = spvValidatorOptionsCreate();
+    const bool full_verdict =
+        tools_.Validate(binary.data(), binary.size(), options);
+    spvValidatorOptionsDestroy(options);
+    const bool incremental_verdict = validator_.Validate(binary);
+    EXPECT_EQ(full_verdict, incremental_verdict);
+    EXPECT_EQ(full_messages_, incremental_messages_);
+    return incremental_verdict;
+  }
+
+  const std::string& messages() const { return incremental_messages_; }
+
+ private:
+  SpirvTools tools_;
+  IncrementalValidator validator_;
+  std::string incremental_messages_;
+  std::string full_messages_;
+};
+
+TEST_F(ValidateIncremental, ValidModules) {
+  EXPECT_TRUE(ValidateBothWays(MakeModule(20, {}, {}, {})));
+  EXPECT_TRUE(ValidateBothWays(MakeModule(20, {}, {}, {})));
+  EXPECT_TRUE(ValidateBothWays(MakeModule(20, {}, {}, {3})));
+  EXPECT_TRUE(ValidateBothWays(MakeModule(20, {}, {}, {3, 15})));
+}
+
+TEST_F(ValidateIncremental, ReportsOpcodeErrorInChangedFunction) {
+  EXPECT_TRUE(ValidateBothWays(MakeModule(20, {}, {}, {})));
+  EXPECT_FALSE(ValidateBothWays(MakeModule(20, {7}, {}, {})));
+  EXPECT_THAT(messages(), HasSubstr("%bad7 = OpIAdd"));
+}
+
+TEST_F(ValidateIncremental, ReportsDominanceErrorInChangedFunction) {
+  EXPECT_TRUE(ValidateBothWays(MakeModule(20, {}, {}, {})));
+  EXPECT_FALSE(ValidateBothWays(MakeModule(20, {}, {12}, {})));
+  EXPECT_THAT(messages(), HasSubstr("[%def12]"));
+}
+
+TEST_F(ValidateIncremental, ReportsErrorInUnchangedCaller) {
+  // The call in the entry point does not change, but becomes invalid.
+  EXPECT_TRUE(ValidateBothWays(MakeModule(20, {}, {}, {})));
+  EXPECT_FALSE(ValidateBothWays(MakeModule(20, {}, {}, {}, true)));
+  EXPECT_THAT(messages(), HasSubstr("OpFunctionCall"));
+}
+
+TEST_F(ValidateIncremental, ValidatesAgainAfterError) {
+  EXPECT_TRUE(ValidateBothWays(MakeModule(20, {}, {}, {})));
+  EXPECT_FALSE(ValidateBothWays(MakeModule(20, {4}, {}, {})));
+  EXPECT_FALSE(ValidateBothWays(MakeModule(20, {4}, {}, {})));
+  EXPECT_TRUE(ValidateBothWays(MakeModule(20, {}, {}, {4})));
+}
+
+TEST_F(ValidateIncremental, ReportsErrorAfterGlobalChange) {
+  // Changing the type of a constant changes every function that uses it.
+  const std::string module = MakeModule(20, {}, {}, {});
+  EXPECT_TRUE(ValidateBothWays(module));
+  std::string changed = module;
+  const std::string constant = "%uint_1 = OpConstant %uint 1";
+  changed.replace(changed.find(constant), constant.size(),
+                  "%uint_1 = OpConstant %float 1");
+  EXPECT_FALSE(ValidateBothWays(changed));
+}
+
+TEST(ValidateIncrementalWork, ChecksOnlyChangedFunctions) {
+  SpirvTools tools(kEnv);
+  IncrementalValidator validator(kEnv, nullptr);
+  // Returns the number of functions checked in full for the given module.
+  const auto num_checked = [&tools, &validator](const std::string& module) {
+    std::vector<uint32_t> binary;
+    EXPECT_TRUE(tools.Assemble(module, &binary));
+    EXPECT_TRUE(validator.Validate(binary));
+    return validator.num_checked_functions();
+  };
+
+  // The entry point and the 20 functions it calls.
+  EXPECT_EQ(21u, num_checked(MakeModule(20, {}, {}, {})));
+  EXPECT_EQ(0u, num_checked(MakeModule(20, {}, {}, {})));
+  EXPECT_EQ(2u, num_checked(MakeModule(20, {}, {}, {3, 15})));
+  EXPECT_EQ(1u, num_checked(MakeModule(20, {}, {}, {3})));
+}
+
+}  // namespace
+}  // namespace val
+}  // namespace spvtools
@@ -0,0 +1,168 @@
+// Copyright (c) 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests for how the validator stores the instructions of a module.
+
+#include <string>
+
+#include "gmock/gmock.h"
+#include "source/val/instruction.h"
+#include "source/val/validation_state.h"
+#include "test/val/val_fixtures.h"
+
+namespace spvtools {
+namespace val {
+namespace {
+
+using ::testing::Eq;
+
+using ValidateInstructionStorage = spvtest::ValidateBase<bool>;
+
+const std::string kModule = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%int = OpTypeInt 32 0
+%float = OpTypeFloat 32
+%ptr_int = OpTypePointer Function %int
+%ptr_float = OpTypePointer Function %float
+%void_fn = OpTypeFunction %void
+%func = OpFunction %void None %void_fn
+%entry = OpLabel
+%a = OpVariable %ptr_int Function
+%b = OpVariable %ptr_float Function
+%la = OpLoad %int %a
+%lb = OpLoad %float %b
+OpReturn
+OpFunctionEnd
+)";
+
+uint32_t ByteSwap(uint32_t word) {
+  return ((word & 0xFF) << 24) | ((word & 0xFF00) << 8) |
+         ((word >> 8) & 0xFF00) | (word >> 24);
+}
+
+TEST_F(ValidateInstructionStorage, WordsAreInTheModule) {
+  CompileSuccessfully(kModule);
+  ASSERT_EQ(SPV_SUCCESS, ValidateAndRetrieveValidationState());
+  EXPECT_EQ(binary_->code, vstate_->words());
+
+  const uint32_t* module_end = binary_->code + binary_->wordCount;
+  for (const auto& inst : vstate_->ordered_instructions()) {
+    EXPECT_GE(inst.words().data(), binary_->code);
+    EXPECT_LE(inst.words().data() + inst.words().size(), module_end);
+    EXPECT_EQ(inst.c_inst().words, inst.words().data());
+  }
+}
+
+TEST_F(ValidateInstructionStorage, SameOperandLayoutIsShared) {
+  CompileSuccessfully(kModule);
+  ASSERT_EQ(SPV_SUCCESS, ValidateAndRetrieveValidationState());
+
+  const Instruction* a = vstate_->FindDef(9);
+  const Instruction* b = vstate_->FindDef(10);
+  const Instruction* la = vstate_->FindDef(11);
+  const Instruction* lb = vstate_->FindDef(12);
+  ASSERT_EQ(spv::Op::OpVariable, a->opcode());
+  ASSERT_EQ(spv::Op::OpLoad, la->opcode());
+
+  EXPECT_EQ(a->operands().data(), b->operands().data());
+  EXPECT_EQ(la->operands().data(), lb->operands().data());
+  EXPECT_NE(a->operands().data(), la->operands().data());
+
+  // The shared descriptors still describe each instruction.
+  EXPECT_EQ(4u, a->GetOperandAs<uint32_t>(0));
+  EXPECT_EQ(5u, b->GetOperandAs<uint32_t>(0));
+  EXPECT_EQ(9u, la->GetOperandAs<uint32_t>(2));
+  EXPECT_EQ(10u, lb->GetOperandAs<uint32_t>(2));
+}
+
+TEST_F(ValidateInstructionStorage, StringOperands) {
+  CompileSuccessfully(R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+OpName %short "a"
+OpName %long "a_much_longer_name"
+%short = OpTypeVoid
+%long = OpTypeInt 32 0
+)");
+  ASSERT_EQ(SPV_SUCCESS, ValidateAndRetrieveValidationState());
+
+  const auto& instructions = vstate_->ordered_instructions();
+  ASSERT_EQ(spv::Op::OpName, instructions[3].opcode());
+  ASSERT_EQ(spv::Op::OpName, instructions[4].opcode());
+  EXPECT_NE(instructions[3].operands().data(),
+            instructions[4].operands().data());
+  EXPECT_THAT(instructions[3].GetOperandAs<std::string>(1), Eq("a"));
+  EXPECT_THAT(instructions[4].GetOperandAs<std::string>(1),
+              Eq("a_much_longer_name"));
+}
+
+TEST_F(ValidateInstructionStorage, MissingOperandAborts) {
+  CompileSuccessfully(kModule);
+  ASSERT_EQ(SPV_SUCCESS, ValidateAndRetrieveValidationState());
+
+  // OpVariable has no initializer here, so it has 3 operands.
+  const Instruction* a = vstate_->FindDef(9);
+  ASSERT_EQ(3u, a->operands().size());
+  EXPECT_DEATH(a->GetOperandAs<uint32_t>(3), "operand 3 of an instruction");
+  EXPECT_DEATH(a->GetOperandAs<std::string>(3), "operand 3 of an instruction");
+}
+
+TEST_F(ValidateInstructionStorage, ByteSwappedModule) {
+  CompileSuccessfully(kModule);
+  for (uint32_t i = 0; i < binary_->wordCount; ++i) {
+    OverwriteAssembledBinary(i, ByteSwap(binary_->code[i]));
+  }
+  ASSERT_EQ(SPV_SUCCESS, ValidateAndRetrieveValidationState());
+
+  // The instructions reference a copy of the module in host endianness.
+  ASSERT_NE(binary_->code, vstate_->words());
+  ASSERT_EQ(binary_->wordCount, vstate_->num_words());
+  for (uint32_t i = 0; i < binary_->wordCount; ++i) {
+    EXPECT_EQ(ByteSwap(binary_->code[i]), vstate_->words()[i]);
+  }
+  const uint32_t* module_end = vstate_->words() + vstate_->num_words();
+  for (const auto& inst : vstate_->ordered_instructions()) {
+    EXPECT_GE(inst.words().data(), vstate_->words());
+    EXPECT_LE(inst.words().data() + inst.words().size(), module_end);
+  }
+  EXPECT_EQ(9u, vstate_->FindDef(11)->GetOperandAs<uint32_t>(2));
+}
+
+TEST_F(ValidateInstructionStorage, ByteSwappedInvalidModule) {
+  CompileSuccessfully(R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%func = OpFunction %void None %void_fn
+%entry = OpLabel
+%x = OpLoad %void %entry
+OpReturn
+OpFunctionEnd
+)");
+  for (uint32_t i = 0; i < binary_->wordCount; ++i) {
+    OverwriteAssembledBinary(i, ByteSwap(binary_->code[i]));
+  }
+  EXPECT_NE(SPV_SUCCESS, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(), ::testing::HasSubstr("OpLoad"));
+}
+
+}  // namespace
+}  // namespace val
+}  // namespace spvtools
@@ -0,0 +1,114 @@
+// Copyright (c) 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests for the opcodes declared by the per-instruction validation passes.
+
+#include <ostream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "source/opcode.h"
+#include "source/spirv_validator_options.h"
+#include "source/table.h"
+#include "source/val/instruction.h"
+#include "source/val/validate.h"
+#include "source/val/validation_state.h"
+
+namespace spvtools {
+namespace val {
+namespace {
+
+struct OpcodePassCase {
+  std::string name;
+  bool (*handles)(spv::Op opcode);
+  spv_result_t (*pass)(ValidationState_t& _, const Instruction* inst);
+};
+
+std::ostream& operator<<(std::ostream& out, const OpcodePassCase& pass) {
+  return out << pass.name;
+}
+
+static uint32_t kFakeBinary[] = {0};
+
+class ValidateOpcodeDispatch : public testing::TestWithParam<OpcodePassCase> {
+ public:
+  ValidateOpcodeDispatch()
+      : context_(spvContextCreate(SPV_ENV_UNIVERSAL_1_0)),
+        options_(spvValidatorOptionsCreate()),
+        state_(context_, options_, kFakeBinary, 0, 1) {
+    spvOpcodeTableGet(&grammar_, SPV_ENV_UNIVERSAL_1_0);
+  }
+
+  ~ValidateOpcodeDispatch() override {
+    spvContextDestroy(context_);
+    spvValidatorOptionsDestroy(options_);
+  }
+
+ protected:
+  spv_context context_;
+  spv_validator_options options_;
+  ValidationState_t state_;
+  spv_opcode_table grammar_ = nullptr;
+};
+
+TEST_P(ValidateOpcodeDispatch, HandlesSomeOpcode) {
+  bool handles_some = false;
+  for (uint32_t i = 0; i < grammar_->count; ++i) {
+    handles_some |= GetParam().handles(grammar_->entries[i].opcode);
+  }
+  EXPECT_TRUE(handles_some);
+}
+
+TEST_P(ValidateOpcodeDispatch, IgnoresOtherOpcodes) {
+  // Instructions without operands are enough, since the pass must not look
+  // at them.
+  for (uint32_t i = 0; i < grammar_->count; ++i) {
+    const spv::Op opcode = grammar_->entries[i].opcode;
+    if (GetParam().handles(opcode)) continue;
+    const uint32_t word = spvOpcodeMake(1, opcode);
+    spv_parsed_instruction_t parsed = {};
+    parsed.words = &word;
+    parsed.num_words = 1;
+    parsed.opcode = static_cast<uint16_t>(opcode);
+    const Instruction inst(&parsed);
+    EXPECT_EQ(SPV_SUCCESS, GetParam().pass(state_, &inst))
+        << spvOpcodeString(opcode);
+  }
+}
+
+#define OPCODE_PASS(pass) \
+  OpcodePassCase { #pass, pass##Handles, pass }
+
+INSTANTIATE_TEST_SUITE_P(
+    AllPasses, ValidateOpcodeDispatch,
+    testing::Values(
+        OPCODE_PASS(MiscPass), OPCODE_PASS(DebugPass),
+        OPCODE_PASS(AnnotationPass), OPCODE_PASS(ExtensionPass),
+        OPCODE_PASS(ModeSettingPass), OPCODE_PASS(TypePass),
+        OPCODE_PASS(ConstantPass), OPCODE_PASS(MemoryPass),
+        OPCODE_PASS(FunctionPass), OPCODE_PASS(ImagePass),
+        OPCODE_PASS(ConversionPass), OPCODE_PASS(CompositesPass),
+        OPCODE_PASS(ArithmeticsPass), OPCODE_PASS(BitwisePass),
+        OPCODE_PASS(LogicalsPass), OPCODE_PASS(ControlFlowPass),
+        OPCODE_PASS(DerivativesPass), OPCODE_PASS(AtomicsPass),
+        OPCODE_PASS(PrimitivesPass), OPCODE_PASS(BarriersPass),
+        OPCODE_PASS(NonUniformPass), OPCODE_PASS(LiteralsPass),
+        OPCODE_PASS(RayQueryPass), OPCODE_PASS(RayTracingPass),
+        OPCODE_PASS(RayReorderNVPass), OPCODE_PASS(MeshShadingPass)));
+
+#undef OPCODE_PASS
+
+}  // namespace
+}  // namespace val
+}  // namespace spvtools
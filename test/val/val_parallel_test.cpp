@@ -0,0 +1,119 @@
+// Copyright (c) 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Validation tests for checking the functions of a module concurrently.
+
+#include <set>
+#include <sstream>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "test/unit_spirv.h"
+#include "test/val/val_fixtures.h"
+
+namespace spvtools {
+namespace val {
+namespace {
+
+using ::testing::HasSubstr;
+
+// Returns a module with the given number of functions.  The functions whose
+// indices are in |bad_opcodes| have an instruction with a wrong result type.
+// The functions whose indices are in |bad_dominance| use an id whose
+// definition does not dominate the use.
+std::string MakeModule(int num_functions, const std::set<int>& bad_opcodes,
+                       const std::set<int>& bad_dominance) {
+  std::ostringstream module;
+  module << R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%bool = OpTypeBool
+%true = OpConstantTrue %bool
+%uint = OpTypeInt 32 0
+%uint_1 = OpConstant %uint 1
+%float = OpTypeFloat 32
+%main = OpFunction %void None %fn
+%main_entry = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+  for (int i = 0; i < num_functions; ++i) {
+    module << "%f" << i << " = OpFunction %void None %fn\n"
+           << "%entry" << i << " = OpLabel\n"
+           << "OpSelectionMerge %merge" << i << " None\n"
+           << "OpBranchConditional %true %then" << i << " %merge" << i << "\n"
+           << "%then" << i << " = OpLabel\n"
+           << "%def" << i << " = OpIAdd %uint %uint_1 %uint_1\n"
+           << "OpBranch %merge" << i << "\n"
+           << "%merge" << i << " = OpLabel\n";
+    if (bad_dominance.count(i)) {
+      module << "%use" << i << " = OpIAdd %uint %def" << i << " %uint_1\n";
+    }
+    if (bad_opcodes.count(i)) {
+      module << "%bad" << i << " = OpIAdd %float %uint_1 %uint_1\n";
+    }
+    module << "OpReturn\nOpFunctionEnd\n";
+  }
+  return module.str();
+}
+
+class ValidateParallel : public spvtest::ValidateBase<bool> {
+ protected:
+  // Validates the given module serially, then in parallel.  Expects the same
+  // result and diagnostic both times, and returns the result.
+  spv_result_t ValidateBothWays(const std::string& module) {
+    CompileSuccessfully(module, SPV_ENV_UNIVERSAL_1_3);
+    const spv_result_t serial_result =
+        ValidateInstructions(SPV_ENV_UNIVERSAL_1_3);
+    const std::string serial_diagnostic = getDiagnosticString();
+
+    spvValidatorOptionsSetParallel(getValidatorOptions(), true);
+    const spv_result_t parallel_result =
+        ValidateInstructions(SPV_ENV_UNIVERSAL_1_3);
+    EXPECT_EQ(serial_result, parallel_result);
+    EXPECT_EQ(serial_diagnostic, getDiagnosticString());
+    return parallel_result;
+  }
+};
+
+TEST_F(ValidateParallel, ValidModule) {
+  EXPECT_EQ(SPV_SUCCESS, ValidateBothWays(MakeModule(50, {}, {})));
+}
+
+TEST_F(ValidateParallel, ReportsFirstOpcodeError) {
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA,
+            ValidateBothWays(MakeModule(50, {10, 40}, {})));
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("%bad10 = OpIAdd"));
+}
+
+TEST_F(ValidateParallel, ReportsFirstDominanceError) {
+  EXPECT_EQ(SPV_ERROR_INVALID_ID,
+            ValidateBothWays(MakeModule(50, {}, {5, 30})));
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("[%def5]"));
+}
+
+TEST_F(ValidateParallel, ReportsOpcodeErrorsBeforeDominanceErrors) {
+  // The opcodes of all the functions are checked before the dominance.
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA,
+            ValidateBothWays(MakeModule(50, {40}, {5})));
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("%bad40 = OpIAdd"));
+}
+
+}  // namespace
+}  // namespace val
+}  // namespace spvtools
@@ -0,0 +1,219 @@
+// Copyright (c) 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Validation tests for the validator tiers.
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "source/spirv_validator_options.h"
+#include "source/val/validate.h"
+#include "spirv-tools/libspirv.hpp"
+#include "test/val/val_fixtures.h"
+
+namespace spvtools {
+namespace val {
+namespace {
+
+using ::testing::HasSubstr;
+
+using ValidateTier = spvtest::ValidateBase<bool>;
+
+// Returns a module whose function has the given body after its first label.
+std::string MakeModule(const std::string& body) {
+  return R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%bool = OpTypeBool
+%true = OpConstantTrue %bool
+%uint = OpTypeInt 32 0
+%uint_1 = OpConstant %uint 1
+%float = OpTypeFloat 32
+%main = OpFunction %void None %fn
+%entry = OpLabel
+)" + body + R"(
+OpFunctionEnd
+)";
+}
+
+TEST_F(ValidateTier, DefaultIsStandard) {
+  EXPECT_EQ(spv_validator_tier_standard, options_->tier);
+}
+
+TEST_F(ValidateTier, ParseTier) {
+  spv_validator_tier tier = spv_validator_tier_standard;
+  EXPECT_TRUE(spvParseValidatorTier("structural", &tier));
+  EXPECT_EQ(spv_validator_tier_structural, tier);
+  EXPECT_TRUE(spvParseValidatorTier("exhaustive", &tier));
+  EXPECT_EQ(spv_validator_tier_exhaustive, tier);
+  EXPECT_TRUE(spvParseValidatorTier("standard", &tier));
+  EXPECT_EQ(spv_validator_tier_standard, tier);
+  EXPECT_FALSE(spvParseValidatorTier("fast", &tier));
+  EXPECT_FALSE(spvParseValidatorTier(nullptr, &tier));
+  EXPECT_EQ(spv_validator_tier_standard, tier);
+}
+
+TEST_F(ValidateTier, StructuralSkipsOpcodeRules) {
+  const std::string module = MakeModule(R"(
+%bad = OpIAdd %float %uint_1 %uint_1
+OpReturn
+)");
+  CompileSuccessfully(module);
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("OpIAdd"));
+
+  spvValidatorOptionsSetTier(options_, spv_validator_tier_structural);
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions());
+}
+
+TEST_F(ValidateTier, StructuralSkipsDecorationRules) {
+  CompileSuccessfully(R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+OpDecorate %struct Block
+OpMemberDecorate %struct 0 Offset 0
+OpMemberDecorate %struct 1 Offset 2
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%struct = OpTypeStruct %uint %uint
+%ptr = OpTypePointer Uniform %struct
+%var = OpVariable %ptr Uniform
+%main = OpFunction %void None %fn
+%entry = OpLabel
+OpReturn
+OpFunctionEnd
+)");
+  EXPECT_NE(SPV_SUCCESS, ValidateInstructions(SPV_ENV_VULKAN_1_0));
+
+  spvValidatorOptionsSetTier(options_, spv_validator_tier_structural);
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions(SPV_ENV_VULKAN_1_0));
+}
+
+TEST_F(ValidateTier, StructuralChecksLayout) {
+  CompileSuccessfully(R"(
+OpMemoryModel Logical GLSL450
+OpCapability Shader
+)");
+  spvValidatorOptionsSetTier(options_, spv_validator_tier_structural);
+  EXPECT_EQ(SPV_ERROR_INVALID_LAYOUT, ValidateInstructions());
+}
+
+TEST_F(ValidateTier, StructuralChecksBranchTargets) {
+  CompileSuccessfully(MakeModule(R"(
+OpBranch %uint_1
+)"));
+  spvValidatorOptionsSetTier(options_, spv_validator_tier_structural);
+  EXPECT_NE(SPV_SUCCESS, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("OpBranch"));
+}
+
+TEST_F(ValidateTier, StructuralChecksStructuredControlFlow) {
+  CompileSuccessfully(MakeModule(R"(
+OpBranchConditional %true %then %merge
+%then = OpLabel
+OpBranch %merge
+%merge = OpLabel
+OpReturn
+)"));
+  spvValidatorOptionsSetTier(options_, spv_validator_tier_structural);
+  EXPECT_EQ(SPV_ERROR_INVALID_CFG, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("Selection must be structured"));
+}
+
+TEST_F(ValidateTier, StructuralChecksDominance) {
+  CompileSuccessfully(MakeModule(R"(
+OpSelectionMerge %merge None
+OpBranchConditional %true %then %merge
+%then = OpLabel
+%def = OpIAdd %uint %uint_1 %uint_1
+OpBranch %merge
+%merge = OpLabel
+%use = OpIAdd %uint %def %uint_1
+OpReturn
+)"));
+  spvValidatorOptionsSetTier(options_, spv_validator_tier_structural);
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("[%def]"));
+}
+
+TEST_F(ValidateTier, StructuralChecksUndefinedIds) {
+  CompileSuccessfully(MakeModule(R"(
+%use = OpIAdd %uint %undefined %uint_1
+OpReturn
+)"));
+  spvValidatorOptionsSetTier(options_, spv_validator_tier_structural);
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions());
+}
+
+TEST_F(ValidateTier, ExhaustiveMatchesStandard) {
+  const std::string good = MakeModule("OpReturn");
+  const std::string bad = MakeModule(R"(
+%bad = OpIAdd %float %uint_1 %uint_1
+OpReturn
+)");
+  spvValidatorOptionsSetTier(options_, spv_validator_tier_exhaustive);
+  CompileSuccessfully(good);
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions());
+  CompileSuccessfully(bad);
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("OpIAdd"));
+}
+
+TEST_F(ValidateTier, ExhaustiveIncrementalValidator) {
+  const std::string module = MakeModule(R"(
+%sum = OpIAdd %uint %uint_1 %uint_1
+OpReturn
+)");
+  std::string bad = module;
+  const std::string sum = "%sum = OpIAdd %uint";
+  bad.replace(bad.find(sum), sum.size(), "%sum = OpIAdd %float");
+
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<uint32_t> good_binary;
+  std::vector<uint32_t> bad_binary;
+  ASSERT_TRUE(tools.Assemble(module, &good_binary));
+  ASSERT_TRUE(tools.Assemble(bad, &bad_binary));
+
+  // The module has one function.  The standard tier skips its checks when
+  // it has not changed.
+  IncrementalValidator standard(SPV_ENV_UNIVERSAL_1_0, options_);
+  EXPECT_TRUE(standard.Validate(good_binary));
+  EXPECT_EQ(1u, standard.num_checked_functions());
+  EXPECT_TRUE(standard.Validate(good_binary));
+  EXPECT_EQ(0u, standard.num_checked_functions());
+
+  // The exhaustive tier checks it every time.
+  spvValidatorOptionsSetTier(options_, spv_validator_tier_exhaustive);
+  IncrementalValidator validator(SPV_ENV_UNIVERSAL_1_0, options_);
+  EXPECT_TRUE(validator.Validate(good_binary));
+  EXPECT_EQ(1u, validator.num_checked_functions());
+  EXPECT_TRUE(validator.Validate(good_binary));
+  EXPECT_EQ(1u, validator.num_checked_functions());
+  EXPECT_FALSE(validator.Validate(bad_binary));
+  EXPECT_TRUE(validator.Validate(good_binary));
+  EXPECT_EQ(1u, validator.num_checked_functions());
+}
+
+}  // namespace
+}  // namespace val
+}  // namespace spvtools
@@ -74,8 +74,8 @@ int main(int, const char** argv) {
   std::string outFile = flags::o.value();
 
   // Read the input binary.
-  std::vector<uint32_t> contents;
-  if (!ReadBinaryFile<uint32_t>(inFile.c_str(), &contents)) return 1;
+  BinaryFileView<uint32_t> contents;
+  if (!contents.Open(inFile.c_str())) return 1;
   spv_context context = spvContextCreate(kDefaultEnvironment);
   spv_diagnostic diagnostic = nullptr;
 
@@ -17,9 +17,11 @@
 #include <unistd.h>
 #endif
 
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "spirv-tools/libspirv.h"
@@ -64,6 +66,15 @@ Options:
   --offsets         Show byte offsets for each instruction.
 
   --comment         Add comments to make reading easier
+
+  --parallel        Disassemble the functions on multiple threads.  The output
+                    is the same, but large modules are disassembled faster.
+
+  --function <function>
+                    Only disassemble the given function, named by its result
+                    id, like %12, or by the name given to it by OpName or
+                    OpEntryPoint.  The rest of the module is only scanned as
+                    needed, which is much faster for large modules.
 )";
 
 // clang-format off
@@ -80,10 +91,99 @@ FLAG_LONG_bool   (nested_indent,  /* default_value= */ false, /* required= */ fa
 FLAG_LONG_bool   (reorder_blocks, /* default_value= */ false, /* required= */ false);
 FLAG_LONG_bool   (offsets,        /* default_value= */ false, /* required= */ false);
 FLAG_LONG_bool   (comment,        /* default_value= */ false, /* required= */ false);
+FLAG_LONG_bool   (parallel,       /* default_value= */ false, /* required= */ false);
+FLAG_LONG_string (function,       /* default_value= */ "",    /* required= */ false);
 // clang-format on
 
 static const auto kDefaultEnvironment = SPV_ENV_UNIVERSAL_1_5;
 
+// The ids named by debug or entry point instructions with a given name.
+struct NamedIds {
+  std::string name;
+  std::vector<uint32_t> ids;
+};
+
+// Records the id operand of the given instruction if it is immediately
+// followed by a literal string operand equal to the name being searched for.
+// This covers OpName and OpEntryPoint.
+static spv_result_t CollectNamedIds(void* user_data,
+                                    const spv_parsed_instruction_t* inst) {
+  auto named_ids = static_cast<NamedIds*>(user_data);
+  for (uint16_t i = 0; i + 1 < inst->num_operands; ++i) {
+    const spv_parsed_operand_t& id = inst->operands[i];
+    const spv_parsed_operand_t& name = inst->operands[i + 1];
+    if (id.type != SPV_OPERAND_TYPE_ID ||
+        name.type != SPV_OPERAND_TYPE_LITERAL_STRING) {
+      continue;
+    }
+    // The parser has checked the string is null terminated.
+    if (named_ids->name ==
+        reinterpret_cast<const char*>(inst->words + name.offset)) {
+      named_ids->ids.push_back(inst->words[id.offset]);
+    }
+  }
+  return SPV_SUCCESS;
+}
+
+// Moves the file |from| over the file |to|, replacing it if it exists.
+// Returns false if the file could not be moved.
+static bool ReplaceFile(const std::string& from, const std::string& to) {
+#if defined(_WIN32)
+  // Unlike POSIX rename, the Windows one fails if |to| exists.
+  remove(to.c_str());
+#endif
+  return rename(from.c_str(), to.c_str()) == 0;
+}
+
+// Finds the range of words of the function named by |function|, which is
+// either a result id, optionally preceded by '%', or a name.  Returns false
+// and prints an error if there is no such function.
+static bool FindFunction(spv_const_context context,
+                         spv_const_module_index index,
+                         const std::string& function, size_t* begin,
+                         size_t* end) {
+  std::vector<uint32_t> ids;
+  const std::string digits =
+      function.size() > 1 && function[0] == '%' ? function.substr(1) : function;
+  if (!digits.empty() && digits.size() <= 10 &&
+      digits.find_first_not_of("0123456789") == std::string::npos) {
+    const unsigned long long id = std::stoull(digits);
+    if (id <= UINT32_MAX) ids.push_back(static_cast<uint32_t>(id));
+  } else {
+    NamedIds named_ids{function, {}};
+    for (const auto section :
+         {SPV_MODULE_SECTION_ENTRY_POINT, SPV_MODULE_SECTION_DEBUG}) {
+      size_t section_begin = 0;
+      size_t section_end = 0;
+      if (!spvModuleIndexGetSection(index, section, &section_begin,
+                                    &section_end)) {
+        continue;
+      }
+      spv_diagnostic diagnostic = nullptr;
+      if (spvModuleIndexParseRange(context, index, section_begin, section_end,
+                                   &named_ids, nullptr, CollectNamedIds,
+                                   &diagnostic)) {
+        spvDiagnosticPrint(diagnostic);
+        spvDiagnosticDestroy(diagnostic);
+        return false;
+      }
+    }
+    ids = std::move(named_ids.ids);
+  }
+
+  const size_t num_functions = spvModuleIndexGetFunctionCount(index);
+  for (const uint32_t id : ids) {
+    for (size_t i = 0; i < num_functions; ++i) {
+      uint32_t function_id = 0;
+      spvModuleIndexGetFunction(index, i, &function_id, begin, end);
+      if (function_id == id) return true;
+    }
+  }
+  fprintf(stderr, "error: no function %s found in the module.\n",
+          function.c_str());
+  return false;
+}
+
 int main(int, const char** argv) {
   if (!flags::Parse(argv)) {
     return 1;
@@ -137,6 +237,8 @@ int main(int, const char** argv) {
 
   if (flags::comment.value()) options |= SPV_BINARY_TO_TEXT_OPTION_COMMENT;
 
+  if (flags::parallel.value()) options |= SPV_BINARY_TO_TEXT_OPTION_PARALLEL;
+
   if (flags::o.value() == "-") {
     // Print to standard output.
     options |= SPV_BINARY_TO_TEXT_OPTION_PRINT;
@@ -152,24 +254,81 @@ int main(int, const char** argv) {
   }
 
   // Read the input binary.
-  std::vector<uint32_t> contents;
-  if (!ReadBinaryFile<uint32_t>(inFile.c_str(), &contents)) return 1;
+  BinaryFileView<uint32_t> contents;
+  if (!contents.Open(inFile.c_str())) return 1;
 
   // If printing to standard output, then spvBinaryToText should
   // do the printing.  In particular, colour printing on Windows is
   // controlled by modifying console objects synchronously while
   // outputting to the stream rather than by injecting escape codes
   // into the output stream.
-  // If the printing option is off, then save the text in memory, so
-  // it can be emitted later in this function.
+  // If the printing option is off, then stream the text as it is produced to
+  // a temporary file, which replaces the output file once the disassembly
+  // succeeds, so that a failure leaves any existing output file untouched.
+  // The text of a single function is saved in memory, so it can be emitted
+  // later in this function.
   const bool print_to_stdout = SPV_BINARY_TO_TEXT_OPTION_PRINT & options;
   spv_text text = nullptr;
   spv_text* textOrNull = print_to_stdout ? nullptr : &text;
   spv_diagnostic diagnostic = nullptr;
   spv_context context = spvContextCreate(kDefaultEnvironment);
-  spv_result_t error =
-      spvBinaryToText(context, contents.data(), contents.size(), options,
-                      textOrNull, &diagnostic);
+  spv_result_t error = SPV_SUCCESS;
+  if (flags::function.value().empty() && print_to_stdout) {
+    error = spvBinaryToText(context, contents.data(), contents.size(), options,
+                            nullptr, &diagnostic);
+  } else if (flags::function.value().empty()) {
+    // An empty output file name stands for standard output, which has nothing
+    // to replace.
+    const std::string streamFile = outFile.empty() ? outFile : outFile + ".tmp";
+    bool written = false;
+    {
+      OutputFile file(streamFile.c_str(), "w");
+      FILE* fp = file.GetFileHandle();
+      if (fp == nullptr) {
+        fprintf(stderr, "error: could not open file '%s'\n",
+                streamFile.c_str());
+        spvContextDestroy(context);
+        return 1;
+      }
+      auto write = [](void* user_data, const char* str, size_t length) {
+        return fwrite(str, 1, length, static_cast<FILE*>(user_data)) == length
+                   ? SPV_SUCCESS
+                   : SPV_REQUESTED_TERMINATION;
+      };
+      error = spvBinaryToTextStream(context, contents.data(), contents.size(),
+                                    options, fp, write, &diagnostic);
+      written = !error && fflush(fp) == 0 && !ferror(fp);
+    }
+    if (!outFile.empty()) {
+      if (written && !ReplaceFile(streamFile, outFile)) written = false;
+      if (!written) remove(streamFile.c_str());
+    }
+    if (!written && (!error || error == SPV_REQUESTED_TERMINATION)) {
+      fprintf(stderr, "error: could not write to file '%s'\n",
+              outFile.c_str());
+      spvContextDestroy(context);
+      return 1;
+    }
+  } else {
+    // Index the module, so that only the function and what it refers to need
+    // to be parsed.
+    spv_module_index index = nullptr;
+    error = spvModuleIndexCreate(context, contents.data(), contents.size(),
+                                 &index, &diagnostic);
+    if (!error) {
+      size_t begin = 0;
+      size_t end = 0;
+      if (!FindFunction(context, index, flags::function.value(), &begin,
+                        &end)) {
+        spvModuleIndexDestroy(index);
+        spvContextDestroy(context);
+        return 1;
+      }
+      error = spvModuleIndexRangeToText(context, index, begin, end, options,
+                                        textOrNull, &diagnostic);
+    }
+    spvModuleIndexDestroy(index);
+  }
   spvContextDestroy(context);
   if (error) {
     spvDiagnosticPrint(diagnostic);
@@ -177,7 +336,7 @@ int main(int, const char** argv) {
     return error;
   }
 
-  if (!print_to_stdout) {
+  if (text) {
     if (!WriteFile<char>(outFile.c_str(), "w", text->str, text->length)) {
       spvTextDestroy(text);
       return 1;
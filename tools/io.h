@@ -37,6 +37,16 @@
 #define SET_STDOUT_MODE(mode)
 #endif
 
+#if defined(SPIRV_LINUX) || defined(SPIRV_MAC) || defined(SPIRV_ANDROID) || \
+    defined(SPIRV_FREEBSD) || defined(SPIRV_OPENBSD) || defined(SPIRV_GNU)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SPIRV_TOOLS_HAS_MMAP 1
+#endif
+
 // Appends the contents of the |file| to |data|, assuming each element in the
 // file is of type |T|.
 template <typename T>
@@ -121,6 +131,68 @@ bool ReadTextFile(const char* filename, std::vector<T>* data) {
   return succeeded;
 }
 
+// A read-only view of the contents of a binary file as a sequence of elements
+// of type |T|.  Where the platform supports it, a regular file is memory
+// mapped, so its contents are handed to the libraries without being copied.
+// Otherwise, and for the standard input, the contents are read into memory.
+template <typename T>
+class BinaryFileView {
+ public:
+  BinaryFileView() = default;
+  BinaryFileView(const BinaryFileView&) = delete;
+  BinaryFileView& operator=(const BinaryFileView&) = delete;
+
+  ~BinaryFileView() {
+#if defined(SPIRV_TOOLS_HAS_MMAP)
+    if (mapped_) munmap(const_cast<T*>(mapped_), mapped_size_ * sizeof(T));
+#endif
+  }
+
+  // Makes this view show the contents of the file named |filename|.  If
+  // |filename| is nullptr or "-", reads from the standard input.  If any error
+  // occurs, writes error messages to standard error and returns false.
+  bool Open(const char* filename) {
+#if defined(SPIRV_TOOLS_HAS_MMAP)
+    if (MapFile(filename)) return true;
+#endif
+    return ReadBinaryFile<T>(filename, &contents_);
+  }
+
+  const T* data() const { return mapped_ ? mapped_ : contents_.data(); }
+  size_t size() const { return mapped_ ? mapped_size_ : contents_.size(); }
+
+ private:
+#if defined(SPIRV_TOOLS_HAS_MMAP)
+  // Tries to memory map the file named |filename|.  Returns false if it is
+  // not a non-empty regular file with a size that is a multiple of the
+  // element size, or cannot be mapped.  The caller then falls back to reading
+  // it, which reports any error.
+  bool MapFile(const char* filename) {
+    if (!filename || !strcmp("-", filename)) return false;
+    const int fd = open(filename, O_RDONLY);
+    if (fd == -1) return false;
+    struct stat info;
+    void* addr = MAP_FAILED;
+    size_t num_bytes = 0;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0 &&
+        info.st_size % sizeof(T) == 0) {
+      num_bytes = static_cast<size_t>(info.st_size);
+      addr = mmap(nullptr, num_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+    if (addr == MAP_FAILED) return false;
+    mapped_ = static_cast<const T*>(addr);
+    mapped_size_ = num_bytes / sizeof(T);
+    return true;
+  }
+#endif
+
+  const T* mapped_ = nullptr;
+  size_t mapped_size_ = 0;  // In elements of type T.
+  std::vector<T> contents_;
+};
+
 namespace {
 // A class to create and manage a file for outputting data.
 class OutputFile {
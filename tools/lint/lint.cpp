@@ -65,8 +65,8 @@ int main(int, const char** argv) {
 
   spvtools::Linter linter(kDefaultEnvironment);
   linter.SetMessageConsumer(spvtools::utils::CLIMessageConsumer);
-  std::vector<uint32_t> binary;
-  if (!ReadBinaryFile(flags::positional_arguments[0].c_str(), &binary)) {
+  BinaryFileView<uint32_t> binary;
+  if (!binary.Open(flags::positional_arguments[0].c_str())) {
     return 1;
   }
 
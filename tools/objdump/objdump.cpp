@@ -14,9 +14,11 @@
 
 #include <filesystem>
 #include <iostream>
+#include <vector>
 
 #include "extract_source.h"
 #include "source/opt/log.h"
+#include "spirv-tools/libspirv.h"
 #include "tools/io.h"
 #include "tools/util/cli_consumer.h"
 #include "tools/util/flags.h"
@@ -31,6 +33,7 @@ Usage: %s [options] <filename>
 one of the following switches must be given:
   --source        Extract source files obtained from debug symbols, output to stdout.
   --entrypoint    Extracts the entrypoint name of the module, output to stdout.
+  --functions     Lists the result id and word range of each function, output to stdout.
   --compiler-cmd  Extracts the command line used to compile this module, output to stdout.
 
 
@@ -96,6 +99,52 @@ bool OutputSourceFiles(
   return true;
 }
 
+// Prints the name of each entry point in the module.
+spv_result_t PrintEntryPointName(void*, const spv_parsed_instruction_t* inst) {
+  // OpEntryPoint: execution model, function id, name, interface...
+  if (inst->num_operands < 3) return SPV_SUCCESS;
+  const spv_parsed_operand_t& name = inst->operands[2];
+  std::cout << reinterpret_cast<const char*>(inst->words + name.offset)
+            << std::endl;
+  return SPV_SUCCESS;
+}
+
+// Prints the information obtained from the table of contents of the module,
+// without parsing the whole module.  Returns true on success.
+bool DumpFromIndex(const std::vector<uint32_t>& binary, bool entrypoint,
+                   bool functions) {
+  spv_context context = spvContextCreate(SPV_ENV_UNIVERSAL_1_6);
+  spv_diagnostic diagnostic = nullptr;
+  spv_module_index index = nullptr;
+  spv_result_t error = spvModuleIndexCreate(context, binary.data(),
+                                            binary.size(), &index, &diagnostic);
+
+  size_t begin = 0;
+  size_t end = 0;
+  if (!error && entrypoint &&
+      spvModuleIndexGetSection(index, SPV_MODULE_SECTION_ENTRY_POINT, &begin,
+                               &end)) {
+    error = spvModuleIndexParseRange(context, index, begin, end, nullptr,
+                                     nullptr, PrintEntryPointName, &diagnostic);
+  }
+
+  if (!error && functions) {
+    const size_t count = spvModuleIndexGetFunctionCount(index);
+    for (size_t i = 0; i < count; ++i) {
+      uint32_t id = 0;
+      spvModuleIndexGetFunction(index, i, &id, &begin, &end);
+      std::cout << "%" << id << ": words " << begin << " to " << end
+                << std::endl;
+    }
+  }
+
+  if (error) spvDiagnosticPrint(diagnostic);
+  spvDiagnosticDestroy(diagnostic);
+  spvModuleIndexDestroy(index);
+  spvContextDestroy(context);
+  return error == SPV_SUCCESS;
+}
+
 }  // namespace
 
 // clang-format off
@@ -105,6 +154,7 @@ FLAG_LONG_bool(   version,      /* default_value= */ false, /* required= */ fals
 FLAG_LONG_bool(   source,       /* default_value= */ false, /* required= */ false);
 FLAG_LONG_bool(   entrypoint,   /* default_value= */ false, /* required= */ false);
 FLAG_LONG_bool(   compiler_cmd, /* default_value= */ false, /* required= */ false);
+FLAG_LONG_bool(   functions,    /* default_value= */ false, /* required= */ false);
 FLAG_SHORT_bool(  f,            /* default_value= */ false, /* required= */ false);
 FLAG_LONG_bool(   force,        /* default_value= */ false, /* required= */ false);
 FLAG_LONG_string( outdir,       /* default_value= */ "-",   /* required= */ false);
@@ -128,7 +178,7 @@ int main(int, const char** argv) {
     std::cerr << "Expected exactly one input file." << std::endl;
     return 1;
   }
-  if (flags::entrypoint.value() || flags::compiler_cmd.value()) {
+  if (flags::compiler_cmd.value()) {
     std::cerr << "Unimplemented flags." << std::endl;
     return 1;
   }
@@ -169,6 +219,12 @@ int main(int, const char** argv) {
     }
   }
 
-  // FIXME: implement logic.
+  if (flags::entrypoint.value() || flags::functions.value()) {
+    if (!DumpFromIndex(binary, flags::entrypoint.value(),
+                       flags::functions.value())) {
+      return 1;
+    }
+  }
+
   return 0;
 }
@@ -12,14 +12,22 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "source/spirv_target_env.h"
 #include "source/spirv_validator_options.h"
+#include "source/util/parallel.h"
 #include "spirv-tools/libspirv.hpp"
 #include "tools/io.h"
 #include "tools/util/cli_consumer.h"
@@ -30,10 +38,21 @@ void print_usage(char* argv0) {
       R"(%s - Validate a SPIR-V binary file.
 
 USAGE: %s [options] [<filename>]
+       %s --batch [options] [<filename> | @<list>]...
 
 The SPIR-V binary is read from <filename>. If no file is specified,
 or if the filename is "-", then the binary is read from standard input.
 
+With --batch, each <filename> is validated, as well as each file named in
+<list>, one per line.  Empty lines and lines starting with '#' are ignored.
+If <list> is "-", or if no file is specified, the file names are read from
+standard input.  A <filename> of "-" is the same as @-.  The files are
+validated on several threads, and a summary line is written to standard
+output for each of them, in the order they were given, as a JSON object:
+  {"file": <filename>, "status": "valid" | "invalid" | "unreadable",
+   "read_ms": <time>, "validate_ms": <time>, "messages": [<message>...]}
+The messages are also written to standard error, prefixed by the file name.
+
 NOTE: The validator is a work in progress.
 
 Options:
@@ -68,15 +87,220 @@ Options:
                                    be allowed by the target environment.
   --before-hlsl-legalization       Allows code patterns that are intended to be
                                    fixed by spirv-opt's legalization passes.
+  --parallel                       Check the function bodies on several threads.
+  --batch                          Validate many files, as described above.
+  --jobs                           <number of threads to validate files on>
+                                   Only for --batch.  The default is the number of
+                                   hardware threads.
+  --tier                           {structural|standard|exhaustive}
+                                   How much of the rules to check.  structural only checks
+                                   the layout of the module, its ids and its control flow.
+                                   standard checks all the rules, and is the default.
+                                   exhaustive also never relies on earlier validations.
   --version                        Display validator version information.
   --target-env                     {%s}
                                    Use validation rules from the specified environment.
 )",
-      argv0, argv0, target_env_list.c_str());
+      argv0, argv0, argv0, target_env_list.c_str());
+}
+
+namespace {
+
+// Returns the text of a message from the validator, as printed by
+// spvtools::utils::CLIMessageConsumer, or an empty string if it is not
+// printed.
+std::string FormatMessage(spv_message_level_t level,
+                          const spv_position_t& position,
+                          const char* message) {
+  const char* prefix = nullptr;
+  switch (level) {
+    case SPV_MSG_FATAL:
+    case SPV_MSG_INTERNAL_ERROR:
+    case SPV_MSG_ERROR:
+      prefix = "error";
+      break;
+    case SPV_MSG_WARNING:
+      prefix = "warning";
+      break;
+    case SPV_MSG_INFO:
+      prefix = "info";
+      break;
+    default:
+      return "";
+  }
+  return std::string(prefix) + ": line " + std::to_string(position.index) +
+         ": " + message;
+}
+
+// Returns |text| as a JSON string literal.
+std::string JsonString(const std::string& text) {
+  std::string result = "\"";
+  for (const char c : text) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x",
+                   static_cast<unsigned>(c));
+          result += escaped;
+        } else {
+          result += c;
+        }
+        break;
+    }
+  }
+  return result + "\"";
+}
+
+// Appends to |inputs| the file names listed in the file named |list|, one
+// per line, skipping empty lines and lines starting with '#'.  If |list| is
+// "-", reads the list from the standard input.  Returns false if the list
+// cannot be read.
+bool ReadInputList(const char* list, std::vector<std::string>* inputs) {
+  std::vector<char> contents;
+  if (!ReadTextFile<char>(list, &contents)) return false;
+  std::string line;
+  for (size_t i = 0; i <= contents.size(); ++i) {
+    if (i < contents.size() && contents[i] != '\n') {
+      line += contents[i];
+      continue;
+    }
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (!line.empty() && line[0] != '#') inputs->push_back(line);
+    line.clear();
+  }
+  return true;
+}
+
+// The largest number of threads --jobs accepts.
+constexpr unsigned long kMaxJobs = 1024;
+
+// Parses |str| as the argument of --jobs into |num_threads|.  Returns false
+// unless |str| is a whole decimal number between 1 and kMaxJobs.
+bool ParseJobs(const char* str, uint32_t* num_threads) {
+  // strtoul skips leading spaces and accepts a sign, negating the value.
+  if (!isdigit(static_cast<unsigned char>(str[0]))) return false;
+  char* end = nullptr;
+  errno = 0;
+  const unsigned long jobs = strtoul(str, &end, 10);
+  if (errno != 0 || *end != '\0' || jobs == 0 || jobs > kMaxJobs) {
+    return false;
+  }
+  *num_threads = static_cast<uint32_t>(jobs);
+  return true;
 }
 
+// The outcome of validating one file in batch mode.
+struct BatchResult {
+  enum Status { kValid, kInvalid, kUnreadable };
+  Status status = kUnreadable;
+  double read_ms = 0;
+  double validate_ms = 0;
+  std::vector<std::string> messages;
+};
+
+// The state of a thread validating files in batch mode.  The context is
+// created for the first file, and reused for the next ones.
+struct BatchWorker {
+  std::unique_ptr<spvtools::SpirvTools> tools;
+  // Where the messages of the file being validated go.
+  std::vector<std::string>* messages = nullptr;
+};
+
+// Returns the milliseconds elapsed since |start|.
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Validates each file of |inputs| on |num_threads| threads, and writes the
+// summary of each of them.  Returns true if they are all valid.
+bool ValidateBatch(const std::vector<std::string>& inputs,
+                   spv_target_env target_env,
+                   const spvtools::ValidatorOptions& options,
+                   uint32_t num_threads) {
+  std::vector<BatchResult> results(inputs.size());
+  // No more threads are started than there are files.
+  std::vector<BatchWorker> workers(
+      std::min<size_t>(num_threads, inputs.size()));
+  spvtools::utils::ParallelForWithThreadIndex(
+      inputs.size(), num_threads,
+      [&](uint32_t thread_index, size_t i) {
+        BatchWorker& worker = workers[thread_index];
+        BatchResult& result = results[i];
+        if (!worker.tools) {
+          worker.tools.reset(new spvtools::SpirvTools(target_env));
+          BatchWorker* worker_ptr = &worker;
+          worker.tools->SetMessageConsumer(
+              [worker_ptr](spv_message_level_t level, const char*,
+                           const spv_position_t& position,
+                           const char* message) {
+                std::string text = FormatMessage(level, position, message);
+                if (!text.empty()) worker_ptr->messages->push_back(text);
+              });
+        }
+        worker.messages = &result.messages;
+
+        auto start = std::chrono::steady_clock::now();
+        BinaryFileView<uint32_t> contents;
+        const bool read = contents.Open(inputs[i].c_str());
+        result.read_ms = MillisecondsSince(start);
+        if (!read) {
+          result.status = BatchResult::kUnreadable;
+          result.messages.push_back("error: cannot read the file");
+          return;
+        }
+
+        start = std::chrono::steady_clock::now();
+        const bool valid =
+            worker.tools->Validate(contents.data(), contents.size(), options);
+        result.validate_ms = MillisecondsSince(start);
+        result.status = valid ? BatchResult::kValid : BatchResult::kInvalid;
+      });
+
+  bool all_valid = true;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const BatchResult& result = results[i];
+    const char* status = "valid";
+    if (result.status == BatchResult::kInvalid) status = "invalid";
+    if (result.status == BatchResult::kUnreadable) status = "unreadable";
+    all_valid &= result.status == BatchResult::kValid;
+
+    std::string messages;
+    for (const auto& message : result.messages) {
+      fprintf(stderr, "%s: %s\n", inputs[i].c_str(), message.c_str());
+      if (!messages.empty()) messages += ", ";
+      messages += JsonString(message);
+    }
+    printf(
+        "{\"file\": %s, \"status\": \"%s\", \"read_ms\": %.3f, "
+        "\"validate_ms\": %.3f, \"messages\": [%s]}\n",
+        JsonString(inputs[i]).c_str(), status, result.read_ms,
+        result.validate_ms, messages.c_str());
+  }
+  return all_valid;
+}
+
+}  // namespace
+
 int main(int argc, char** argv) {
-  const char* inFile = nullptr;
+  std::vector<const char*> inFiles;
+  bool batch = false;
+  bool jobs = false;
+  uint32_t num_threads = spvtools::utils::HardwareThreadCount();
   spv_target_env target_env = SPV_ENV_UNIVERSAL_1_6;
   spvtools::ValidatorOptions options;
   bool continue_processing = true;
@@ -144,8 +368,45 @@ int main(int argc, char** argv) {
           continue_processing = false;
           return_code = 1;
         }
+      } else if (0 == strcmp(cur_arg, "--tier")) {
+        if (argi + 1 < argc) {
+          const auto tier_str = argv[++argi];
+          spv_validator_tier tier;
+          if (spvParseValidatorTier(tier_str, &tier)) {
+            options.SetTier(tier);
+          } else {
+            fprintf(stderr, "error: Unrecognized validator tier: %s\n",
+                    tier_str);
+            continue_processing = false;
+            return_code = 1;
+          }
+        } else {
+          fprintf(stderr, "error: Missing argument to --tier\n");
+          continue_processing = false;
+          return_code = 1;
+        }
       } else if (0 == strcmp(cur_arg, "--before-hlsl-legalization")) {
         options.SetBeforeHlslLegalization(true);
+      } else if (0 == strcmp(cur_arg, "--parallel")) {
+        options.SetParallel(true);
+      } else if (0 == strcmp(cur_arg, "--batch")) {
+        batch = true;
+      } else if (0 == strcmp(cur_arg, "--jobs")) {
+        jobs = true;
+        if (argi + 1 < argc) {
+          const auto jobs_str = argv[++argi];
+          if (!ParseJobs(jobs_str, &num_threads)) {
+            fprintf(stderr,
+                    "error: Invalid number of jobs: %s (expected 1 to %lu)\n",
+                    jobs_str, kMaxJobs);
+            continue_processing = false;
+            return_code = 1;
+          }
+        } else {
+          fprintf(stderr, "error: Missing argument to --jobs\n");
+          continue_processing = false;
+          return_code = 1;
+        }
       } else if (0 == strcmp(cur_arg, "--relax-logical-pointer")) {
         options.SetRelaxLogicalPointer(true);
       } else if (0 == strcmp(cur_arg, "--relax-block-layout")) {
@@ -164,26 +425,14 @@ int main(int argc, char** argv) {
         options.SetRelaxStructStore(true);
       } else if (0 == cur_arg[1]) {
         // Setting a filename of "-" to indicate stdin.
-        if (!inFile) {
-          inFile = cur_arg;
-        } else {
-          fprintf(stderr, "error: More than one input file specified\n");
-          continue_processing = false;
-          return_code = 1;
-        }
+        inFiles.push_back(cur_arg);
       } else {
         print_usage(argv[0]);
         continue_processing = false;
         return_code = 1;
       }
     } else {
-      if (!inFile) {
-        inFile = cur_arg;
-      } else {
-        fprintf(stderr, "error: More than one input file specified\n");
-        continue_processing = false;
-        return_code = 1;
-      }
+      inFiles.push_back(cur_arg);
     }
   }
 
@@ -192,8 +441,33 @@ int main(int argc, char** argv) {
     return return_code;
   }
 
-  std::vector<uint32_t> contents;
-  if (!ReadBinaryFile<uint32_t>(inFile, &contents)) return 1;
+  if (jobs && !batch) {
+    fprintf(stderr, "error: --jobs is only allowed with --batch\n");
+    return 1;
+  }
+
+  if (batch) {
+    std::vector<std::string> inputs;
+    if (inFiles.empty()) inFiles.push_back("@-");
+    for (const char* in_file : inFiles) {
+      if (0 == strcmp(in_file, "-")) in_file = "@-";
+      if (in_file[0] != '@') {
+        inputs.push_back(in_file);
+      } else if (!ReadInputList(in_file + 1, &inputs)) {
+        return 1;
+      }
+    }
+    return !ValidateBatch(inputs, target_env, options, num_threads);
+  }
+
+  if (inFiles.size() > 1) {
+    fprintf(stderr, "error: More than one input file specified\n");
+    return 1;
+  }
+  const char* inFile = inFiles.empty() ? nullptr : inFiles[0];
+
+  BinaryFileView<uint32_t> contents;
+  if (!contents.Open(inFile)) return 1;
 
   spvtools::SpirvTools tools(target_env);
   tools.SetMessageConsumer(spvtools::utils::CLIMessageConsumer);
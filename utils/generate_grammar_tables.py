@@ -36,6 +36,20 @@ SPV_EXT_relaxed_printf_string_address_space
 
 OUTPUT_LANGUAGE = 'c'
 
+# Parameters of the lookup indices generated for the info tables.  These must
+# match kTableIndexPageBits and kNoTableIndex in source/table.h.
+TABLE_INDEX_PAGE_BITS = 6
+NO_TABLE_INDEX = 0xFFFF
+# Tables whose keys would need more pages than this are not indexed.
+MAX_TABLE_INDEX_PAGES = 1024
+
+# Parameters of the name hash generated for the info tables.  The hash must
+# match spvNameHash in source/table.h.
+NAME_HASH_FNV_BASIS = 0x811c9dc5
+NAME_HASH_FNV_PRIME = 0x01000193
+# Give up finding a displacement for a bucket after this many attempts.
+MAX_NAME_HASH_DISPLACEMENT = 1 << 20
+
 def make_path_to_file(f):
     """Makes all ancestor directories to the given file, if they don't yet
     exist.
@@ -351,6 +365,151 @@ def generate_instruction(inst, is_ext_inst):
         return str(InstInitializer(opname, caps, exts, operands, min_version, max_version))
 
 
+def generate_table_index(name, keys):
+    """Returns a two-level lookup index over a table whose entries have the
+    given keys, so that a key can be found in constant time.
+
+    The keys are grouped into pages of 2**TABLE_INDEX_PAGE_BITS consecutive
+    values.  Only pages that contain at least one key get slots, which keeps
+    the index small even though SPIR-V enumerant values are very sparse.
+
+    Arguments:
+      - name: the prefix for the generated array names
+      - keys: the key of each table entry, in table order, sorted ascending
+
+    Returns:
+      a tuple of the C definitions of the index arrays, and the C initializer
+      for the spv_table_index_t describing them
+    """
+    assert keys == sorted(keys)
+    assert len(keys) < NO_TABLE_INDEX
+    page_size = 1 << TABLE_INDEX_PAGE_BITS
+    num_pages = (keys[-1] >> TABLE_INDEX_PAGE_BITS) + 1 if keys else 0
+    if num_pages > MAX_TABLE_INDEX_PAGES:
+        # Leave the table unindexed.  Lookups fall back to a binary search.
+        keys = []
+        num_pages = 0
+    pages = [NO_TABLE_INDEX] * num_pages
+    slots = []
+    for position, key in enumerate(keys):
+        page = key >> TABLE_INDEX_PAGE_BITS
+        if pages[page] == NO_TABLE_INDEX:
+            pages[page] = len(slots)
+            slots.extend([NO_TABLE_INDEX] * page_size)
+        slot = pages[page] + (key & (page_size - 1))
+        # Keep the first entry for each key, which is the preferred name.
+        if slots[slot] == NO_TABLE_INDEX:
+            slots[slot] = position
+    assert len(slots) < NO_TABLE_INDEX
+
+    if not keys:
+        return '', '{0, nullptr, nullptr}'
+
+    def format_array(array_name, values):
+        rows = [', '.join(str(v) for v in values[i:i + 16])
+                for i in range(0, len(values), 16)]
+        return 'static const uint16_t {}[] = {{\n  {}}};'.format(
+            array_name, ',\n  '.join(rows))
+
+    pages_name = '{}Pages'.format(name)
+    slots_name = '{}Slots'.format(name)
+    definitions = '{}\n{}'.format(format_array(pages_name, pages),
+                                   format_array(slots_name, slots))
+    initializer = '{{ARRAY_SIZE({}), {}, {}}}'.format(pages_name, pages_name,
+                                                       slots_name)
+    return definitions, initializer
+
+
+def name_hash(seed, name):
+    """Returns the hash of the given name under the given seed.  This is
+    FNV-1a with the seed mixed into the basis, followed by the MurmurHash3
+    finalizer so that every bit of the result depends on the seed."""
+    mask = 0xffffffff
+    h = (NAME_HASH_FNV_BASIS ^ seed) & mask
+    for c in name.encode('utf-8'):
+        h = ((h ^ c) * NAME_HASH_FNV_PRIME) & mask
+    h ^= h >> 16
+    h = (h * 0x85ebca6b) & mask
+    h ^= h >> 13
+    h = (h * 0xc2b2ae35) & mask
+    h ^= h >> 16
+    return h
+
+
+def generate_name_hash(name, names):
+    """Returns a minimal perfect hash from the given names to their positions
+    in a table, so that a name can be found without comparing it against
+    every entry.
+
+    The names are first hashed into buckets.  Buckets with several names get
+    a seed under which their names hash to distinct free slots; buckets with
+    a single name get a free slot directly, stored as the negative of the
+    slot minus one.  A lookup hashes the name twice at most, and must then
+    compare it against the name of the entry in the slot it lands on.
+
+    Arguments:
+      - name: the prefix for the generated array names
+      - names: the name of each table entry, in table order
+
+    Returns:
+      a tuple of the C definitions of the hash arrays, and the C initializer
+      for the spv_name_hash_t describing them
+    """
+    assert len(names) < NO_TABLE_INDEX
+    size = len(names)
+    if not size or len(set(names)) != size:
+        # Leave the table unhashed.  Lookups fall back to a linear search.
+        return '', '{0, nullptr, nullptr}'
+
+    buckets = [[] for _ in range(size)]
+    for position, n in enumerate(names):
+        buckets[name_hash(0, n) % size].append(position)
+
+    displacements = [0] * size
+    positions = [NO_TABLE_INDEX] * size
+    order = sorted(range(size), key=lambda b: len(buckets[b]), reverse=True)
+    for b in order:
+        bucket = buckets[b]
+        if len(bucket) <= 1:
+            break
+        seed = 1
+        while True:
+            slots = [name_hash(seed, names[p]) % size for p in bucket]
+            if (len(set(slots)) == len(slots) and
+                    all(positions[s] == NO_TABLE_INDEX for s in slots)):
+                break
+            seed += 1
+            if seed > MAX_NAME_HASH_DISPLACEMENT:
+                return '', '{0, nullptr, nullptr}'
+        displacements[b] = seed
+        for p, s in zip(bucket, slots):
+            positions[s] = p
+
+    free = (s for s in range(size) if positions[s] == NO_TABLE_INDEX)
+    for b in order:
+        bucket = buckets[b]
+        if len(bucket) != 1:
+            continue
+        s = next(free)
+        displacements[b] = -s - 1
+        positions[s] = bucket[0]
+
+    def format_array(array_type, array_name, values):
+        rows = [', '.join(str(v) for v in values[i:i + 16])
+                for i in range(0, len(values), 16)]
+        return 'static const {} {}[] = {{\n  {}}};'.format(
+            array_type, array_name, ',\n  '.join(rows))
+
+    displacements_name = '{}Displacements'.format(name)
+    positions_name = '{}Positions'.format(name)
+    definitions = '{}\n{}'.format(
+        format_array('int32_t', displacements_name, displacements),
+        format_array('uint16_t', positions_name, positions))
+    initializer = '{{ARRAY_SIZE({}), {}, {}}}'.format(
+        displacements_name, displacements_name, positions_name)
+    return definitions, initializer
+
+
 def generate_instruction_table(inst_table):
     """Returns the info table containing all SPIR-V instructions, sorted by
     opcode, and prefixed by capability arrays.
@@ -373,7 +532,17 @@ def generate_instruction_table(inst_table):
     insts = ['static const spv_opcode_desc_t kOpcodeTableEntries[] = {{\n'
              '  {}\n}};'.format(',\n  '.join(insts))]
 
-    return '{}\n\n{}\n\n{}'.format(caps_arrays, exts_arrays, '\n'.join(insts))
+    index_arrays, index = generate_table_index(
+        'kOpcodeTableIndex', [inst['opcode'] for inst in inst_table])
+    index = '{}\n\nstatic const spv_table_index_t kOpcodeTableIndex = {};'.format(
+        index_arrays, index)
+    hash_arrays, name_hash = generate_name_hash(
+        'kOpcodeTableNameHash', [inst['opname'][2:] for inst in inst_table])
+    index = '{}\n\n{}\n\nstatic const spv_name_hash_t kOpcodeTableNameHash = {};'.format(
+        index, hash_arrays, name_hash)
+
+    return '{}\n\n{}\n\n{}\n\n{}'.format(caps_arrays, exts_arrays,
+                                       '\n'.join(insts), index)
 
 
 def generate_extended_instruction_table(json_grammar, set_name, operand_kind_prefix=""):
@@ -399,7 +568,13 @@ def generate_extended_instruction_table(json_grammar, set_name, operand_kind_pre
     insts = ['static const spv_ext_inst_desc_t {}_entries[] = {{\n'
              '  {}\n}};'.format(set_name, ',\n  '.join(insts))]
 
-    return '{}\n\n{}'.format(caps_arrays, '\n'.join(insts))
+    hash_arrays, name_hash = generate_name_hash(
+        '{}_name_hash'.format(set_name),
+        [inst['opname'] for inst in inst_table])
+    name_hash = '{}\n\nstatic const spv_name_hash_t {}_name_hash = {};'.format(
+        hash_arrays, set_name, name_hash)
+
+    return '{}\n\n{}\n\n{}'.format(caps_arrays, '\n'.join(insts), name_hash)
 
 
 class EnumerantInitializer(object):
@@ -476,10 +651,15 @@ def generate_enum_operand_kind_entry(entry, extension_map):
 
 def generate_enum_operand_kind(enum, synthetic_exts_list):
     """Returns the C definition for the given operand kind.
-    It's a static const named array of spv_operand_desc_t.
+    It's a static const named array of spv_operand_desc_t, followed by
+    the arrays of its lookup index.
 
     Also appends to |synthetic_exts_list| a list of extension lists
     used.
+
+    Returns a tuple of the kind, the name of the array, the C definitions,
+    and the C initializer for the remaining members of the kind's
+    spv_operand_desc_group_t.
     """
     kind = enum.get('kind')
     assert kind is not None
@@ -510,7 +690,32 @@ def generate_enum_operand_kind(enum, synthetic_exts_list):
                 extension_map[value].append(ext)
     synthetic_exts_list.extend(extension_map.values())
 
+    # Index value enums by value, and bit enums by the position of their
+    # single set bit, with 0 for the enumerant with no bits set.  Bit enums
+    # where some enumerant has several bits set are not indexed.
+    values = [functor(e) for e in entries]
+    is_bit_enum = enum.get('category') == 'BitEnum'
+    if is_bit_enum:
+        keys = [v.bit_length() for v in values]
+        if any(v & (v - 1) for v in values):
+            keys = []
+    else:
+        keys = values
+    if not entries:
+        # Index the dummy entry below, as it would be found by a search.
+        keys = [0]
+
     name = '{}_{}Entries'.format(PYGEN_VARIABLE_PREFIX, kind)
+    index_arrays, index = generate_table_index(
+        '{}_{}Index'.format(PYGEN_VARIABLE_PREFIX, kind), keys)
+    hash_arrays, name_hash = generate_name_hash(
+        '{}_{}NameHash'.format(PYGEN_VARIABLE_PREFIX, kind),
+        [e['enumerant'] for e in entries])
+    if hash_arrays:
+        index_arrays = '{}\n{}'.format(index_arrays, hash_arrays).strip()
+    group_rest = '{}, {}, {}'.format('true' if is_bit_enum else 'false',
+                                     index, name_hash)
+
     entries = ['  {}'.format(generate_enum_operand_kind_entry(e, extension_map))
                for e in entries]
     if len(entries) == 0:
@@ -523,8 +728,10 @@ def generate_enum_operand_kind(enum, synthetic_exts_list):
     entries = '\n'.join(template).format(
         name=name,
         entries=',\n'.join(entries))
+    if index_arrays:
+        entries = '{}\n{}'.format(entries, index_arrays)
 
-    return kind, name, entries
+    return kind, name, entries, group_rest
 
 
 def generate_operand_kind_table(enums):
@@ -549,15 +756,15 @@ def generate_operand_kind_table(enums):
     optional_enums = [e for e in enums if e[0] in optional_enums]
     enums.extend(optional_enums)
 
-    enum_kinds, enum_names, enum_entries = zip(*enums)
+    enum_kinds, enum_names, enum_entries, enum_group_rests = zip(*enums)
     # Mark the last few as optional ones.
     enum_quantifiers = [''] * (len(enums) - len(optional_enums)) + ['?'] * len(optional_enums)
     # And we don't want redefinition of them.
     enum_entries = enum_entries[:-len(optional_enums)]
     enum_kinds = [convert_operand_kind(e)
                   for e in zip(enum_kinds, enum_quantifiers)]
-    table_entries = zip(enum_kinds, enum_names, enum_names)
-    table_entries = ['  {{{}, ARRAY_SIZE({}), {}}}'.format(*e)
+    table_entries = zip(enum_kinds, enum_names, enum_names, enum_group_rests)
+    table_entries = ['  {{{}, ARRAY_SIZE({}), {}, {}}}'.format(*e)
                      for e in table_entries]
 
     template = [